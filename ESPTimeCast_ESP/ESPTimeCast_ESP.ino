@@ -20,14 +20,31 @@
 #include <sntp.h>
 #include <time.h>
 #include <WiFiClientSecure.h>
-#include <queue>
+#include <WiFiUdp.h>
 
 #include "mfactoryfont.h"   // Custom font
 #include "tz_lookup.h"      // Timezone lookup, do not duplicate mapping here!
 #include "days_lookup.h"    // Languages for the Days of the Week
 #include "months_lookup.h"  // Languages for the Months of the Year
 #include "weather_lookup.h" // Languages for the Weather
+#include "translit_lookup.h" // UTF-8 -> display charset transliteration
 #include "totp.h"           // TOTP
+#include "config_journal.h" // CRC record format for /config.jnl
+#include "webhook_queue.h"  // Preallocated webhook message pool
+#include "timekeeper.h"     // SNTP packets and clock drift model
+#include "nightscout_history.h" // Glucose reading ring and sparkline
+#include "outbound_http.h"  // HTTP/1.0 keep-alive helpers for the shared client
+#include "fnv1a.h"          // Change-detection hash
+#include "string_helpers.h" // Display text, subscriber counts, base32
+
+// Runtime metrics at /metrics (Prometheus text format). Set to 0 to build
+// without the endpoint and all of its bookkeeping.
+#ifndef ENABLE_METRICS
+#define ENABLE_METRICS 1
+#endif
+#if ENABLE_METRICS
+#include "metrics.h"        // Latency histograms
+#endif
 
 #define HARDWARE_TYPE MD_MAX72XX::FC16_HW
 #define MAX_DEVICES 4
@@ -72,6 +89,7 @@ char openMeteoLongitude[64] = "";
 char weatherUnits[12] = "metric";
 char timeZone[64] = "";
 char language[8] = "en";
+const WeatherTermsMapping *activeWeatherTerms = nullptr;  // Resolved from language
 unsigned long lastWifiConnectTime = 0;
 const unsigned long WIFI_STABILIZE_DELAY = 5000;
 
@@ -98,6 +116,21 @@ int dimStartMinute = 0;
 int dimEndHour = 8;  // 8am default
 int dimEndMinute = 0;
 int dimBrightness = 2;  // Dimming level (0-15)
+int dimFadeSeconds = 0;  // Ramp length at dimming start/end (0 = instant)
+
+// Brightness controller: the dimming window is evaluated once per minute and
+// the intensity register is only written when the level changes
+bool dimWindowActive = false;
+bool dimScheduleDirty = true;  // Re-evaluate the window on the next loop()
+int dimScheduleMinute = -1;
+int appliedIntensity = -1;  // Last level written to the MAX7219s
+int intensityTarget = -2;   // Level the controller is heading to (-1 = off)
+bool fading = false;
+int fadeFrom = 0;
+int fadeTo = 0;
+unsigned long fadeStart = 0;
+unsigned long fadeDuration = 0;
+uint32_t intensityWrites = 0;
 
 // Countdown Globals - NEW
 bool countdownEnabled = false;
@@ -133,13 +166,212 @@ bool shouldFetchWeatherNow = false;
 // Weather fetching timing
 unsigned long lastFetch = 0;
 const unsigned long fetchInterval = 300000;  // 5 minutes
+#define WEATHER_BACKOFF_BASE_MS 30000UL       // First retry after a failure...
+#define WEATHER_BACKOFF_MAX_MS 1800000UL      // ...doubling up to 30 minutes
+#define WEATHER_SERVER_DELAY_MAX_MS 3600000UL // Cap for Retry-After / max-age
+unsigned long nextFetchDelay = fetchInterval;  // From lastFetch to the next scheduled fetch
+uint8_t weatherFailures = 0;                   // Consecutive failed fetches
+
+// Last good observation. Kept in RTC memory (survives a warm reboot) and in
+// LittleFS, so weather shows right after boot; marked stale on the display
+// once it is old or not yet refreshed, dropped after weatherMaxAge minutes.
+#define WEATHER_CACHE_PATH "/weather.bin"
+#define WEATHER_CACHE_MAGIC 0x57433032UL  // "WC02"
+#define WEATHER_STALE_SEC 900             // Three missed fetches
+#define WEATHER_CACHE_SAVE_SEC 1800       // Flash copy refreshed at most this often unless values change
+struct WeatherCacheRecord {
+  uint32_t magic;
+  uint32_t sourceHash;  // weatherSourceHash() of the provider and location it was fetched for
+  uint32_t observedAt;  // Unix time, 0 if the clock was not set yet
+  int16_t temp;         // Rounded, in the units below
+  int8_t humidity;      // -1 = unknown
+  uint8_t imperial;
+  char language[8];
+  char description[64];  // Display charset, already normalized/translated
+  uint32_t crc;          // configJournalCrc32 over everything above
+};
+int weatherMaxAge = 180;  // minutes
+time_t weatherObservedAt = 0;
+unsigned long weatherObservedMillis = 0;
+bool weatherFromCache = false;  // Showing a restored observation, no fetch has succeeded yet
+WeatherCacheRecord weatherCacheSaved = {};  // Last copy written to flash
+#ifdef ESP32
+RTC_NOINIT_ATTR WeatherCacheRecord rtcWeatherCache;
+#else
+#define WEATHER_RTC_OFFSET 32  // RTC user memory, in 4-byte blocks; the first 128 bytes belong to OTA
+#endif
+
+// Fast WiFi connect. The last access point (BSSID + channel) is kept in
+// LittleFS; with it the station associates directly instead of scanning every
+// channel. The address always comes from DHCP (or the static IP setting): a
+// reused lease would have to be dropped later to renew it, which resets every
+// connection and may move the device to another address.
+// The connect runs from loop() so the web server and display keep going.
+enum WifiConnectState {
+  WIFI_CONNECT_IDLE,  // Not started, or gave up (AP mode)
+  WIFI_CONNECT_FAST,  // Direct association to the cached access point
+  WIFI_CONNECT_SCAN,  // Plain WiFi.begin(), full scan
+  WIFI_CONNECT_DONE
+};
+#define WIFI_CACHE_PATH "/wifi.bin"
+#define WIFI_CACHE_MAGIC 0x57463032UL  // "WF02"
+#define WIFI_FAST_TIMEOUT_MS 4000UL    // Then fall back to a scan...
+#define WIFI_CONNECT_TIMEOUT_MS 30000UL  // ...and to AP mode after this, counted from the start
+struct WifiCacheRecord {
+  uint32_t magic;
+  uint32_t ssidHash;  // configJournalCrc32 of the SSID the record belongs to
+  uint8_t bssid[6];
+  uint8_t channel;
+  uint8_t reserved;
+  uint32_t crc;       // configJournalCrc32 over everything above
+};
+WifiConnectState wifiConnectState = WIFI_CONNECT_IDLE;
+unsigned long wifiConnectStart = 0;   // millis() of the first WiFi.begin()
+unsigned long wifiAttemptStart = 0;   // millis() of the current attempt
+WifiCacheRecord wifiCacheSaved = {};  // Last copy written to flash
+
+// Optional static address; empty staticIp means DHCP
+char staticIp[16] = "";
+char staticGateway[16] = "";
+char staticSubnet[16] = "";
+char staticDns[16] = "";
+
+// Boot timing, in millis() since power-on; 0 until reached
+unsigned long bootWifiMs = 0;   // Station connected
+unsigned long bootClockMs = 0;  // First valid NTP time
+bool bootFastPath = false;      // Connected on the direct association
+
+// Background weather fetch engine
+enum WeatherFetchState {
+  WEATHER_IDLE,
+  WEATHER_CONNECTING,
+  WEATHER_SENDING,
+  WEATHER_RECEIVING,
+  WEATHER_PARSING,
+  WEATHER_READY
+};
+
+struct WeatherRequest {
+  WeatherProviderType provider;
+  char host[48];
+  char path[256];
+};
+
+struct WeatherResult {
+  int httpCode;
+  DeserializationError error;
+  uint32_t retryAfterSec;  // From Retry-After (delta-seconds form), 0 = none
+  uint32_t maxAgeSec;      // From Cache-Control: max-age, 0 = none
+  bool hasTemp;
+  float temp;
+  bool hasHumidity;
+  int humidity;
+  bool hasCode;
+  int code;
+  char description[96];
+};
+
+volatile WeatherFetchState weatherFetchState = WEATHER_IDLE;
+WeatherRequest weatherRequest;
+WeatherResult weatherResult;
+unsigned long weatherRequestStart = 0;
+const unsigned long weatherRequestTimeout = 10000;  // Connect to last byte
+#define WEATHER_RX_BUFFER_SIZE 3072                  // Headers + body (ESP8266)
+
+// Heap cost of the most recent fetch per provider: free heap when the request
+// starts minus the lowest free heap seen at a few points while it runs (after
+// connecting, after the headers, during parsing). A lower bound on the real
+// peak, which neither core can measure per request (reported in /api/info)
+uint32_t weatherFetchHeapDropSampled = 0;
+uint32_t youtubeFetchHeapDropSampled = 0;
+uint32_t nightscoutFetchHeapDropSampled = 0;
+
+// Shared outbound HTTPS client: one request in flight at a time, the last
+// connection kept open for a short while when the same host is due again
+// within that time, and on ESP8266 a TLS session per
+// host so reconnects skip the full handshake
+#define OUTBOUND_HOSTS 4
+#define OUTBOUND_TIMEOUT_MS 5000
+#define OUTBOUND_KEEPALIVE_MS 45000UL  // Servers drop idle connections after about a minute
+#define OUTBOUND_DRAIN_MAX 4096        // Unread body bytes worth reading to keep the connection
+#define OUTBOUND_TASK_WAIT_MS 20000    // How long a worker task waits for the client
+#define OUTBOUND_LOOP_BUDGET_MS 4000   // Whole request when it runs inside loop() (ESP8266)
+#define OUTBOUND_ERROR_BUSY -100       // Another request holds the client
+#ifndef ESP32
+// BearSSL buffers on ESP8266. 512-byte records only work with servers that
+// accept max fragment length negotiation (RFC 6066), which is probed once per
+// host; the others get the core's default sizes.
+#define OUTBOUND_MFLN_BYTES 512
+#define OUTBOUND_DEFAULT_RX_BYTES 16384
+#define OUTBOUND_DEFAULT_TX_BYTES 752
+enum OutboundMfln : uint8_t { MFLN_UNKNOWN, MFLN_SUPPORTED, MFLN_UNSUPPORTED };
+#endif
+
+struct OutboundHost {
+  char host[48];
+  uint32_t requests;
+  uint32_t handshakes;   // Full TLS handshakes
+  uint32_t resumed;      // Abbreviated handshakes from the cached session
+  uint32_t reused;       // Requests on a kept-alive connection
+  uint32_t handshakeMs;  // Total connect time of full handshakes
+  uint32_t resumedMs;    // Total connect time of resumed ones
+  unsigned long lastUsed;
+  #ifndef ESP32
+    BearSSL::Session session;
+    OutboundMfln mfln;   // Whether the small buffers can be used
+  #endif
+};
+
+struct OutboundResponse {
+  int status;
+  uint32_t retryAfterSec;  // From Retry-After (delta-seconds form), 0 = none
+  uint32_t maxAgeSec;      // From Cache-Control: max-age, 0 = none
+  char etag[64];           // For If-None-Match on the next request, empty if none
+};
+
+#ifdef ESP32
+WiFiClientSecure outboundClient;
+SemaphoreHandle_t outboundLock = nullptr;
+#else
+BearSSL::WiFiClientSecure outboundClient;
+bool outboundLocked = false;
+#endif
+OutboundHost outboundHosts[OUTBOUND_HOSTS];
+OutboundHost *outboundConnectedHost = nullptr;  // Host of the open connection, if any
+bool outboundKeepAlive = false;                 // The server agreed to keep it open
+unsigned long outboundIdleSince = 0;
+bool outboundBudgeted = false;                  // The request in flight has a deadline
+unsigned long outboundDeadline = 0;
+HttpBodyStream outboundBody;                    // Body of the request in flight
 
 unsigned long lastSwitch = 0;
-unsigned long lastColonBlink = 0;
 int displayMode = 0;  // 0: Clock, 1: Weather, 2: Weather Description, 3: Countdown
 int currentHumidity = -1;
 bool ntpSyncSuccessful = false;
 
+// Display playlist: modes cycle in this order, repeat a mode to weight it
+#define DISPLAY_MODE_COUNT 12
+#define DISPLAY_PLAYLIST_MAX 16
+#define DISPLAY_PLAYLIST_NONE 0xFF
+const char *DEFAULT_DISPLAY_PLAYLIST = "0,5,1,2,3,6,4";
+char displayPlaylist[48] = "0,5,1,2,3,6,4";
+
+struct DisplayModeEntry {
+  uint8_t mode;
+  const char *name;
+  bool (*eligible)();
+  unsigned long *duration;  // Dwell time timed by loop(), nullptr if the mode advances itself
+};
+
+uint8_t playlistModes[DISPLAY_PLAYLIST_MAX];
+uint8_t playlistNext[DISPLAY_PLAYLIST_MAX];  // Next eligible slot after each slot
+uint8_t playlistSlotOf[DISPLAY_MODE_COUNT];  // First slot of each mode
+uint8_t playlistLength = 0;
+uint8_t playlistFirst = DISPLAY_PLAYLIST_NONE;
+uint8_t playlistPos = DISPLAY_PLAYLIST_NONE;  // Slot of the mode on screen
+uint16_t eligibleModes = 0;                  // Bit per display mode
+volatile bool displayModesDirty = true;      // Recompute eligibleModes before the next advance
+
 // NTP Synchronization State Machine
 enum NtpState {
   NTP_IDLE,
@@ -155,11 +387,69 @@ int ntpRetryCount = 0;
 unsigned long lastNtpStatusPrintTime = 0;
 const unsigned long ntpStatusPrintInterval = 1000;  // Print status every 1 seconds (adjust as needed)
 
+// SNTP client. Each round asks ntpServer1 and ntpServer2 at the same time and
+// applies the reply with the lowest round-trip delay, which has the smallest
+// error bound. Between rounds ClockDiscipline corrects the learned drift.
+// WiFi.hostByName() blocks loop(), so server addresses are looked up once and
+// kept; a server is looked up again only after it missed a round.
+#define NTP_LOCAL_PORT 4123
+#define NTP_RESEND_MS 2000UL         // Ask servers that did not answer again
+#define NTP_LOOKUP_RETRY_MS 10000UL  // Between failed lookups of one server
+#define NTP_COLLECT_MS 500UL         // After the first reply, wait this long for the other server
+#define NTP_ROUND_TIMEOUT_MS 10000UL
+#define NTP_RESYNC_MS 3600000UL      // Between successful rounds
+#define NTP_RESYNC_RETRY_MS 300000UL // After a failed background round
+struct NtpServerQuery {
+  IPAddress ip;
+  bool resolved;       // ip is the address of the name hashed in nameHash
+  uint32_t nameHash;   // fnv1a() of the server name, to notice a config change
+  bool lookupFailed;
+  unsigned long lookupAt;  // millis() of the last lookup
+  bool answered;
+  uint64_t sentUs;  // Local Unix time in the request, echoed back by the server
+};
+WiFiUDP ntpUdp;
+bool ntpUdpStarted = false;
+NtpServerQuery ntpQueries[2];
+bool ntpQueryActive = false;
+unsigned long ntpRoundStart = 0;
+unsigned long ntpLastSend = 0;
+unsigned long ntpFirstReply = 0;
+unsigned long ntpRoundEnd = 0;                  // millis() when the last round finished
+unsigned long ntpNextRoundDelay = NTP_RESYNC_MS;  // From ntpRoundEnd to the next background round
+NtpSample ntpBest;
+int8_t ntpBestServer = -1;
+int8_t ntpLastServer = -1;     // Server of the applied sample, -1 before the first
+unsigned long lastNtpSync = 0;  // millis() of the last applied sample
+uint32_t ntpSyncs = 0;
+uint32_t ntpRoundsFailed = 0;
+ClockDiscipline clockDiscipline;
+const char *clockSource = "none";  // "rtc" after a warm reboot, "ntp" once synced
+
+// Clock kept across warm reboots. The ESP32 keeps its system time through a
+// software reset, so only the drift is needed; the ESP8266 adds the time
+// elapsed on the RTC counter, which keeps running through the reset.
+#define CLOCK_RTC_MAGIC 0x434B3031UL  // "CK01"
+struct ClockRtcRecord {
+  uint32_t magic;
+  uint32_t unixSec;
+  uint32_t unixUs;
+  uint32_t rtcCycles;  // ESP8266 RTC counter when the time above was read
+  int32_t driftPpb;
+  uint32_t crc;        // configJournalCrc32 over everything above
+};
+#ifdef ESP32
+RTC_NOINIT_ATTR ClockRtcRecord rtcClock;
+#else
+#define CLOCK_RTC_OFFSET (WEATHER_RTC_OFFSET + sizeof(WeatherCacheRecord) / 4)
+#endif
+
 // Non-blocking IP display globals
 bool showingIp = false;
 int ipDisplayCount = 0;
 const int ipDisplayMax = 2;  // As per working copy for how long IP shows
 String pendingIpToShow = "";
+uint32_t shownIpAddress = 0;  // Station address last scrolled
 
 // Countdown display state - NEW
 bool countdownScrolling = false;
@@ -180,13 +470,84 @@ bool customMessageScrolling = false;
 int customMessagePriority = 0;
 
 // YouTube Settings
+#define YOUTUBE_MAX_CHANNELS 8
+#define YOUTUBE_RETRY_MS 300000UL  // After a failed fetch
 bool youtubeEnabled = false;
 char youtubeApiKey[64] = "";
-char youtubeChannelId[64] = "";
+char youtubeChannelId[YOUTUBE_MAX_CHANNELS * 25 + 8] = "";  // Comma-separated channel IDs
 bool youtubeShortFormat = true;
-String currentSubscriberCount = "";
+
+// All channels are fetched in one request; mode 6 only reads this table
+struct YoutubeChannel {
+  char id[25];       // "UC" + 22 characters
+  char title[16];    // Display charset, shortened
+  long subscribers;  // -1 until fetched, or when the channel hides it
+  char text[12];     // subscribers formatted for the display
+};
+YoutubeChannel youtubeChannels[YOUTUBE_MAX_CHANNELS];
+uint8_t youtubeChannelCount = 0;
+char youtubeEtag[64] = "";             // Of the last full response, for If-None-Match
+bool youtubeFetchFailed = false;       // The last fetch got no usable answer
 unsigned long lastYoutubeFetch = 0;
+unsigned long youtubeFetchDelay = 0;   // From lastYoutubeFetch to the next fetch
 const unsigned long youtubeFetchInterval = 1800000; // 30 minutes
+uint16_t youtubeListGeneration = 0;    // Bumped when the channel list is reloaded
+
+// Fetched like Nightscout: on ESP32 in a task, published from loop()
+enum YoutubeFetchState {
+  YOUTUBE_IDLE,
+  YOUTUBE_FETCHING,
+  YOUTUBE_READY
+};
+
+struct YoutubeResult {
+  uint16_t generation;  // youtubeListGeneration when the request was made
+  uint8_t count;
+  YoutubeChannel channels[YOUTUBE_MAX_CHANNELS];  // Copy of the table, filled in by the parser
+  int httpCode;
+  bool parsed;
+  char etag[64];
+  uint32_t heapDrop;
+};
+
+volatile YoutubeFetchState youtubeFetchState = YOUTUBE_IDLE;
+char youtubeRequestUrl[512];
+char youtubeRequestEtag[64];
+YoutubeResult youtubeResult;
+unsigned long youtubeRequestStart = 0;
+
+// Nightscout: polled in the background on its own schedule, display mode 4
+// only shows what is in the history
+#define NIGHTSCOUT_POLL_MS 150000UL   // 2.5 minutes, half the CGM interval
+#define NIGHTSCOUT_RETRY_MS 60000UL
+#define NIGHTSCOUT_READING_SEC 300    // CGM reading interval
+#define NIGHTSCOUT_STALE_SEC 900      // Older readings show as stale, with their age
+#define NIGHTSCOUT_URL_SIZE 256
+char nightscoutUrl[NIGHTSCOUT_URL_SIZE] = "";
+GlucoseHistory glucoseHistory;
+
+enum NightscoutFetchState {
+  NIGHTSCOUT_IDLE,
+  NIGHTSCOUT_FETCHING,
+  NIGHTSCOUT_READY
+};
+
+struct NightscoutResult {
+  int httpCode;
+  bool parsed;
+  uint8_t count;
+  GlucoseReading readings[GLUCOSE_HISTORY_SIZE];  // Newest first, as Nightscout sends them
+  uint32_t heapDrop;
+};
+
+volatile NightscoutFetchState nightscoutFetchState = NIGHTSCOUT_IDLE;
+char nightscoutRequestUrl[NIGHTSCOUT_URL_SIZE + 16];
+NightscoutResult nightscoutResult;
+unsigned long nightscoutRequestStart = 0;
+unsigned long nightscoutLastPoll = 0;   // millis() of the last finished poll
+unsigned long nightscoutPollDelay = 0;  // From nightscoutLastPoll to the next poll
+uint32_t nightscoutFailures = 0;        // Consecutive failed polls
+uint8_t sparklineGlyphs[4][9];          // Parola user characters 1-4: width + 8 columns
 
 // Webhook
 bool webhooksEnabled = false;
@@ -194,26 +555,21 @@ char webhookKey[32] = "";
 int webhookQueueSize = 5;
 bool webhookQuietHours = true;
 
-struct WebhookMessage {
-  String text;
-  int priority;  // 0=low, 1=normal, 2=high
-  int duration;  // milliseconds
-  bool scroll;
-  unsigned long timestamp;
-};
-
-struct WebhookMessageCompare {
-  bool operator()(const WebhookMessage& a, const WebhookMessage& b) {
-    if (a.priority != b.priority) {
-      return a.priority < b.priority;
-    }
-    return a.timestamp > b.timestamp;
-  }
-};
+#define WEBHOOK_DEFAULT_TTL_MS 600000UL  // Undisplayed messages are dropped after 10 minutes
+#define WEBHOOK_BATCH_MAX_BYTES 4096      // /webhook/batch body limit
+#define WEBHOOK_BATCH_MAX_ITEMS WEBHOOK_POOL_SIZE
 
-std::priority_queue<WebhookMessage, std::vector<WebhookMessage>, WebhookMessageCompare> messageQueue;
+WebhookQueue messageQueue;  // Sized from webhookQueueSize in setup()
 WebhookMessage currentWebhookMessage;
 bool processingWebhook = false;
+#ifdef ESP32
+portMUX_TYPE webhookMux = portMUX_INITIALIZER_UNLOCKED;  // Pushed from async_tcp, popped in loop()
+#define WEBHOOK_LOCK() portENTER_CRITICAL(&webhookMux)
+#define WEBHOOK_UNLOCK() portEXIT_CRITICAL(&webhookMux)
+#else  // ESP8266
+#define WEBHOOK_LOCK()
+#define WEBHOOK_UNLOCK()
+#endif
 
 // --- NEW GLOBAL VARIABLES FOR IMMEDIATE COUNTDOWN FINISH ---
 bool countdownFinished = false;                       // Tracks if the countdown has permanently finished
@@ -230,6 +586,173 @@ const unsigned long descriptionDuration = 3000;    // 3s for short text
 static unsigned long descScrollEndTime = 0;        // for post-scroll delay (re-used for scroll timing)
 const unsigned long descriptionScrollPause = 300;  // 300ms pause after scroll
 
+// Display timeline: multi-frame effects run as a list of keyframes, advanced
+// one step per loop() so nothing blocks the web server, webhooks or NTP
+enum KeyframeType {
+  FRAME_TEXT,      // Static text held for holdMs
+  FRAME_SCROLL,    // Scroll through until the animation completes
+  FRAME_SCROLL_IN  // Scroll in and stay until the animation completes
+};
+
+enum TimelineId {
+  TIMELINE_NONE,
+  TIMELINE_CLOCK_SCROLL_IN,
+  TIMELINE_HOURGLASS,
+  TIMELINE_COUNTDOWN_SECONDS,
+  TIMELINE_COUNTDOWN_LINE,
+  TIMELINE_NIGHTSCOUT,
+  TIMELINE_YOUTUBE,
+  TIMELINE_IP_OUTRO
+};
+
+#define TIMELINE_MAX_FRAMES 16
+#define TIMELINE_TEXT_POOL 256
+
+struct Keyframe {
+  KeyframeType type;
+  textPosition_t align;
+  uint8_t charSpacing;
+  uint16_t textOffset;  // Into Timeline::text
+  unsigned long holdMs;
+};
+
+struct Timeline {
+  TimelineId id;
+  int mode;  // displayMode that owns the timeline
+  uint8_t count;
+  uint8_t index;
+  bool frameStarted;
+  unsigned long frameStart;
+  uint16_t textUsed;
+  Keyframe frames[TIMELINE_MAX_FRAMES];
+  char text[TIMELINE_TEXT_POOL];  // Parola keeps the pointer while animating
+};
+Timeline timeline = {};
+
+// Longest gap between two loop() calls (reported in /api/info)
+unsigned long lastLoopEntry = 0;
+unsigned long loopStallMax = 0;
+
+// Render cache: static frames are only pushed to the matrix when they change
+uint32_t renderCacheHash = 0;
+bool renderCacheValid = false;
+uint32_t framesComposed = 0;  // renderText() calls
+uint32_t framesPushed = 0;    // Frames actually written over SPI
+uint32_t timeFormatsBuilt = 0;
+
+// Status events (SSE): loop() samples a few values and pushes the ones that
+// changed to the clients of /api/events
+#define STATUS_EVENTS_MAX_CLIENTS 4
+#define STATUS_EVENTS_INTERVAL_MS 250
+AsyncEventSource statusEvents("/api/events");
+char shownText[96] = "";  // What the matrix shows, as UTF-8
+uint32_t shownTextHash = 0;
+volatile bool statusEventsResync = false;  // A client connected and needs everything
+unsigned long lastStatusEventCheck = 0;
+uint32_t statusEventsSent = 0;
+struct StatusSnapshot {
+  int mode;
+  uint32_t textHash;
+  uint32_t weatherHash;
+  uint8_t queueDepth;
+  int intensity;
+  int ntp;
+};
+StatusSnapshot sentStatus = {};
+
+#if ENABLE_METRICS
+// Runtime metrics: loop() interval, fetches per provider and web handler time
+#define METRICS_MAX_ROUTES 48
+const uint32_t metricsLatencyBoundsUs[] = { 250, 500, 1000, 2500, 5000, 10000, 25000, 50000, 100000, 250000, 500000, 1000000 };
+const uint32_t metricsFetchBoundsMs[] = { 100, 250, 500, 1000, 2000, 3000, 5000, 7500, 10000, 15000 };
+#define METRICS_BOUNDS(b) b, (uint8_t)(sizeof(b) / sizeof(b[0]))
+
+enum FetchProvider {
+  FETCH_WEATHER,
+  FETCH_YOUTUBE,
+  FETCH_NIGHTSCOUT,
+  FETCH_PROVIDER_COUNT
+};
+
+enum FetchOutcome {
+  FETCH_OK,
+  FETCH_HTTP_ERROR,       // Server answered with something other than 200
+  FETCH_PARSE_ERROR,      // 200, but the body was unusable
+  FETCH_TRANSPORT_ERROR,  // Connect, TLS or timeout failure
+  FETCH_NOT_MODIFIED,     // 304 to a conditional request, cached data still valid
+  FETCH_OUTCOME_COUNT
+};
+
+struct FetchMetric {
+  LatencyHistogram duration;
+  uint32_t outcomes[FETCH_OUTCOME_COUNT];
+};
+
+struct RouteMetric {
+  const char *uri;
+  uint32_t count;
+  uint64_t totalUs;
+  uint32_t maxUs;
+};
+
+unsigned long lastLoopEntryUs = 0;
+LatencyHistogram loopIntervalHistogram(METRICS_BOUNDS(metricsLatencyBoundsUs));
+LatencyHistogram handlerHistogram(METRICS_BOUNDS(metricsLatencyBoundsUs));
+FetchMetric fetchMetrics[FETCH_PROVIDER_COUNT] = {
+  { LatencyHistogram(METRICS_BOUNDS(metricsFetchBoundsMs)), {} },
+  { LatencyHistogram(METRICS_BOUNDS(metricsFetchBoundsMs)), {} },
+  { LatencyHistogram(METRICS_BOUNDS(metricsFetchBoundsMs)), {} },
+};
+RouteMetric routeMetrics[METRICS_MAX_ROUTES];
+uint8_t routeMetricCount = 0;
+uint32_t metricsScrapes = 0;
+#endif
+
+// Config store: small changes are batched in RAM and appended to a CRC journal
+// after a quiet period; the journal is folded into /config.json when it grows
+#define CONFIG_PATH "/config.json"
+#define CONFIG_TMP_PATH "/config.tmp"
+#define CONFIG_BAK_PATH "/config.bak"
+#define CONFIG_JOURNAL_PATH "/config.jnl"
+#define CONFIG_DEBOUNCE_MS 2000           // Flush after this long without changes...
+#define CONFIG_DEBOUNCE_MAX_MS 10000      // ...or this long after the first one
+#define CONFIG_JOURNAL_COMPACT_BYTES 2048
+#define CONFIG_JOURNAL_READ_MAX 8192
+DynamicJsonDocument pendingConfig(512);
+bool configPending = false;
+unsigned long configPendingSince = 0;
+unsigned long configPendingLast = 0;
+uint32_t configAppends = 0;
+uint32_t configCompactions = 0;
+// Sanitized GET /config.json body, rebuilt only when configGeneration moves on
+volatile uint32_t configGeneration = 1;  // Bumped on every config change
+uint32_t configSnapshotGeneration = 0;
+bool configSnapshotAPMode = false;
+String configSnapshot;
+char configSnapshotETag[12] = "";
+uint32_t configSnapshotBuilds = 0;
+
+// Web UI assets, registered from /assets.json (written by Scripts/build_web_assets.py)
+#define WEB_ASSET_MANIFEST "/assets.json"
+#define WEB_ASSET_MAX 12
+struct WebAsset {
+  String file;  // Gzipped file on LittleFS
+  String type;
+  String etag;
+};
+WebAsset webAssets[WEB_ASSET_MAX];
+uint8_t webAssetCount = 0;
+#ifdef ESP32
+SemaphoreHandle_t configMutex = nullptr;  // Web handlers run on the async_tcp task
+#define CONFIG_LOCK() \
+  do { if (configMutex) xSemaphoreTakeRecursive(configMutex, portMAX_DELAY); } while (0)
+#define CONFIG_UNLOCK() \
+  do { if (configMutex) xSemaphoreGiveRecursive(configMutex); } while (0)
+#else  // ESP8266
+#define CONFIG_LOCK()
+#define CONFIG_UNLOCK()
+#endif
+
 // --- Safe WiFi credential getters ---
 const char *getSafeSsid() {
   return isAPMode ? "" : ssid;
@@ -292,20 +815,11 @@ void generateTOTPSecret() {
   Serial.print(F("[AUTH] Generated TOTP Secret: "));
   Serial.println(totpSecretBase32);
 
-  DynamicJsonDocument doc(2048);
-  File configFile = LittleFS.open("/config.json", "r");
-  if (configFile) {
-    deserializeJson(doc, configFile);
-    configFile.close();
-  }
-
-  doc["totpSecret"] = totpSecretBase32;
-
-  File f = LittleFS.open("/config.json", "w");
-  if (f) {
-    serializeJson(doc, f);
-    f.close();
-  }
+  // Persist right away: the user is about to scan it into an authenticator
+  DynamicJsonDocument patch(128);
+  patch["totpSecret"] = totpSecretBase32;
+  configUpdate(patch);
+  configFlush();
 }
 
 bool checkAuth(AsyncWebServerRequest *request) {
@@ -335,231 +849,472 @@ bool secureCompare(const char* a, const char* b) {
   return result == 0;
 }
 
-void base32_encode(const uint8_t *data, int length, char *result, int resultSize) {
-  const char *base32_alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZ234567";
-  int count = 0;
-  int buffer = 0;
-  int bitsLeft = 0;
+// Scroll flipped
+textEffect_t getEffectiveScrollDirection(textEffect_t desiredDirection, bool isFlipped) {
+  if (isFlipped) {
+    // If the display is horizontally flipped, reverse the horizontal scroll direction
+    if (desiredDirection == PA_SCROLL_LEFT) {
+      return PA_SCROLL_RIGHT;
+    } else if (desiredDirection == PA_SCROLL_RIGHT) {
+      return PA_SCROLL_LEFT;
+    }
+  }
+  return desiredDirection;
+}
 
-  for (int i = 0; i < length; i++) {
-    buffer <<= 8;
-    buffer |= data[i];
-    bitsLeft += 8;
+// -----------------------------------------------------------------------------
+// Render Cache
+// -----------------------------------------------------------------------------
+// Anything that draws without renderText() (scrolls, clears) must call this
+void invalidateRenderCache() {
+  renderCacheValid = false;
+}
 
-    while (bitsLeft >= 5) {
-      if (count >= resultSize - 1) break;
-      int index = (buffer >> (bitsLeft - 5)) & 0x1F;
-      result[count++] = base32_alphabet[index];
-      bitsLeft -= 5;
+// Records the text on the matrix for /api/events. The display charset is
+// Latin-1 based, so bytes >= 0x80 are widened to UTF-8.
+void noteShownText(const char *text) {
+  uint32_t hash = fnv1a(text);
+  if (hash == shownTextHash) return;
+  shownTextHash = hash;
+
+  size_t n = 0;
+  for (const uint8_t *p = (const uint8_t *)text; *p && n + 3 < sizeof(shownText); p++) {
+    if (*p < 0x20) continue;
+    if (*p < 0x80) {
+      shownText[n++] = *p;
+    } else {
+      shownText[n++] = 0xC0 | (*p >> 6);
+      shownText[n++] = 0x80 | (*p & 0x3F);
     }
   }
+  shownText[n] = '\0';
+}
 
-  if (bitsLeft > 0 && count < resultSize - 1) {
-    int index = (buffer << (5 - bitsLeft)) & 0x1F;
-    result[count++] = base32_alphabet[index];
-  }
+// Prints a static frame with the current alignment and char spacing, skipping
+// the SPI update when the frame is identical to the one already shown
+void renderText(const char *text) {
+  framesComposed++;
+
+  // Over everything that affects the pixels
+  uint32_t hash = fnv1a(text);
+  hash = fnv1aByte((uint8_t)P.getTextAlignment(), hash);
+  hash = fnv1aByte(P.getCharSpacing(), hash);
+  hash = fnv1aByte((uint8_t)P.getInvert(), hash);
+
+  if (renderCacheValid && hash == renderCacheHash) return;
+
+  P.print(text);
+  noteShownText(text);
+  renderCacheHash = hash;
+  renderCacheValid = true;
+  framesPushed++;
+}
+
+void renderText(const String &text) {
+  renderText(text.c_str());
+}
+
+void renderText(const __FlashStringHelper *text) {
+  char buffer[32];
+  strncpy_P(buffer, (PGM_P)text, sizeof(buffer) - 1);
+  buffer[sizeof(buffer) - 1] = '\0';
+  renderText(buffer);
+}
+
+// -----------------------------------------------------------------------------
+// Display Timeline
+// -----------------------------------------------------------------------------
+void timelineStart(TimelineId id) {
+  timeline.id = id;
+  timeline.mode = displayMode;
+  timeline.count = 0;
+  timeline.index = 0;
+  timeline.frameStarted = false;
+  timeline.textUsed = 0;
+}
 
-  result[count] = '\0';
+bool timelineAdd(KeyframeType type, const char *text, unsigned long holdMs, textPosition_t align, uint8_t charSpacing) {
+  size_t len = strlen(text);
+  if (timeline.count >= TIMELINE_MAX_FRAMES || timeline.textUsed + len + 1 > TIMELINE_TEXT_POOL) {
+    Serial.println(F("[TIMELINE] Timeline full, frame dropped"));
+    return false;
+  }
+  Keyframe &frame = timeline.frames[timeline.count++];
+  frame.type = type;
+  frame.align = align;
+  frame.charSpacing = charSpacing;
+  frame.textOffset = timeline.textUsed;
+  frame.holdMs = holdMs;
+  memcpy(timeline.text + timeline.textUsed, text, len + 1);
+  timeline.textUsed += len + 1;
+  return true;
 }
 
-void base32_decode(const char *encoded, uint8_t *result, int resultSize) {
-  int buffer = 0;
-  int bitsLeft = 0;
-  int count = 0;
+bool timelineActive(TimelineId id) {
+  return timeline.id == id;
+}
 
-  for (int i = 0; encoded[i] && count < resultSize; i++) {
-    char ch = encoded[i];
+void timelineCancel() {
+  timeline.id = TIMELINE_NONE;
+}
 
-    if (ch == ' ' || ch == '\n' || ch == '\r' || ch == '\t' || ch == '=') continue;
+// Runs one step of the current keyframe. Returns true once, when the last
+// frame has finished; the timeline is then idle again.
+bool timelineService() {
+  if (timeline.id == TIMELINE_NONE) return true;
+  if (timeline.index >= timeline.count) {
+    timeline.id = TIMELINE_NONE;
+    return true;
+  }
 
-    int val = -1;
-    if (ch >= 'A' && ch <= 'Z') {
-      val = ch - 'A';
-    } else if (ch >= 'a' && ch <= 'z') {
-      val = ch - 'a';
-    } else if (ch >= '2' && ch <= '7') {
-      val = ch - '2' + 26;
+  Keyframe &frame = timeline.frames[timeline.index];
+  const char *text = timeline.text + frame.textOffset;
+
+  if (!timeline.frameStarted) {
+    timeline.frameStarted = true;
+    timeline.frameStart = millis();
+    P.setTextAlignment(frame.align);
+    P.setCharSpacing(frame.charSpacing);
+    textEffect_t scrollDir = getEffectiveScrollDirection(PA_SCROLL_LEFT, flipDisplay);
+    switch (frame.type) {
+      case FRAME_TEXT:
+        renderText(text);
+        break;
+      case FRAME_SCROLL:
+        invalidateRenderCache();
+        P.displayScroll(text, frame.align, scrollDir, GENERAL_SCROLL_SPEED);
+        noteShownText(text);
+        break;
+      case FRAME_SCROLL_IN:
+        invalidateRenderCache();
+        P.displayText(text, frame.align, GENERAL_SCROLL_SPEED, 0, scrollDir, PA_NO_EFFECT);
+        noteShownText(text);
+        break;
     }
+  }
 
-    if (val == -1) continue;
+  bool done;
+  if (frame.type == FRAME_TEXT) {
+    done = millis() - timeline.frameStart >= frame.holdMs;
+  } else {
+    done = P.displayAnimate();
+  }
 
-    buffer <<= 5;
-    buffer |= val;
-    bitsLeft += 5;
+  if (done) {
+    timeline.index++;
+    timeline.frameStarted = false;
+    if (timeline.index >= timeline.count) {
+      timeline.id = TIMELINE_NONE;
+      return true;
+    }
+  }
+  return false;
+}
 
-    if (bitsLeft >= 8) {
-      result[count++] = (buffer >> (bitsLeft - 8)) & 0xFF;
-      bitsLeft -= 8;
+// -----------------------------------------------------------------------------
+// Config Store
+// -----------------------------------------------------------------------------
+// /config.json is the base snapshot. Small updates (countdown, auth toggles)
+// are merged into pendingConfig and, once the UI goes quiet, appended to
+// /config.jnl as one CRC-checked record. Full rewrites go through /config.tmp
+// and a rename, so a power cut leaves either the old or the new file.
+
+// Merges src into dst, RFC 7386 style: objects recurse and, with applyNulls,
+// null removes a key. Without it nulls are kept, so patches can be combined.
+void mergeJson(JsonVariant dst, JsonVariantConst src, bool applyNulls) {
+  if (!src.is<JsonObjectConst>()) {
+    dst.set(src);
+    return;
+  }
+  if (!dst.is<JsonObject>()) dst.to<JsonObject>();
+  for (JsonPairConst kvp : src.as<JsonObjectConst>()) {
+    JsonVariantConst value = kvp.value();
+    if (applyNulls && value.isNull()) {
+      dst.remove(kvp.key().c_str());
+    } else if (value.is<JsonObjectConst>()) {
+      if (!dst[kvp.key()].is<JsonObject>()) dst[kvp.key()].to<JsonObject>();
+      mergeJson(dst[kvp.key()], value, applyNulls);
+    } else {
+      dst[kvp.key()] = value;
     }
   }
 }
 
-// Scroll flipped
-textEffect_t getEffectiveScrollDirection(textEffect_t desiredDirection, bool isFlipped) {
-  if (isFlipped) {
-    // If the display is horizontally flipped, reverse the horizontal scroll direction
-    if (desiredDirection == PA_SCROLL_LEFT) {
-      return PA_SCROLL_RIGHT;
-    } else if (desiredDirection == PA_SCROLL_RIGHT) {
-      return PA_SCROLL_LEFT;
+void replayJournalRecord(const char *payload, size_t len, void *ctx) {
+  DynamicJsonDocument patch(CONFIG_JOURNAL_MAX_PAYLOAD * 2);
+  if (deserializeJson(patch, payload, len)) return;  // CRC passed, so only if the format changed
+  mergeJson(*(JsonDocument *)ctx, patch, true);
+}
+
+// Applies the valid records of /config.jnl to doc
+void replayConfigJournal(JsonDocument &doc) {
+  File f = LittleFS.open(CONFIG_JOURNAL_PATH, "r");
+  if (!f) return;
+
+  size_t size = f.size();
+  size_t toRead = size < CONFIG_JOURNAL_READ_MAX ? size : CONFIG_JOURNAL_READ_MAX;
+  uint8_t *buf = (uint8_t *)malloc(toRead);
+  if (!buf) {
+    f.close();
+    Serial.println(F("[CONFIG] Not enough memory to replay journal"));
+    return;
+  }
+  size_t got = f.read(buf, toRead);
+  f.close();
+
+  size_t valid = configJournalScan(buf, got, replayJournalRecord, &doc);
+  free(buf);
+  if (valid < size) {
+    Serial.printf("[CONFIG] Journal: %u of %u bytes valid, ignoring the tail\n", (unsigned)valid, (unsigned)size);
+  }
+}
+
+// Current effective config: base file + journal + unflushed changes.
+// Returns false if /config.json exists but cannot be parsed.
+bool configLoadDocument(JsonDocument &doc) {
+  CONFIG_LOCK();
+  doc.clear();
+  bool ok = true;
+  File f = LittleFS.open(CONFIG_PATH, "r");
+  if (f) {
+    DeserializationError err = deserializeJson(doc, f);
+    f.close();
+    if (err) {
+      Serial.print(F("[CONFIG] Error parsing config.json: "));
+      Serial.println(err.f_str());
+      ok = false;
     }
   }
-  return desiredDirection;
+  if (ok) {
+    replayConfigJournal(doc);
+    if (configPending) mergeJson(doc, pendingConfig, true);
+  }
+  CONFIG_UNLOCK();
+  return ok;
 }
 
-// Normalize text for LED display
-String normalizeDisplayText(String str, bool weatherMode = false) {
-  // Serbian Cyrillic → Latin
-  str.replace("а", "a");
-  str.replace("б", "b");
-  str.replace("в", "v");
-  str.replace("г", "g");
-  str.replace("д", "d");
-  str.replace("ђ", "dj");
-  str.replace("е", "e");
-  str.replace("ё", "e");  // Russian
-  str.replace("ж", "z");
-  str.replace("з", "z");
-  str.replace("и", "i");
-  str.replace("й", "j");  // Russian
-  str.replace("ј", "j");  // Serbian
-  str.replace("к", "k");
-  str.replace("л", "l");
-  str.replace("љ", "lj");
-  str.replace("м", "m");
-  str.replace("н", "n");
-  str.replace("њ", "nj");
-  str.replace("о", "o");
-  str.replace("п", "p");
-  str.replace("р", "r");
-  str.replace("с", "s");
-  str.replace("т", "t");
-  str.replace("ћ", "c");
-  str.replace("у", "u");
-  str.replace("ф", "f");
-  str.replace("х", "h");
-  str.replace("ц", "c");
-  str.replace("ч", "c");
-  str.replace("џ", "dz");
-  str.replace("ш", "s");
-  str.replace("щ", "sh");  // Russian
-  str.replace("ы", "y");   // Russian
-  str.replace("э", "e");   // Russian
-  str.replace("ю", "yu");  // Russian
-  str.replace("я", "ya");  // Russian
-
-  // Latin diacritics → ASCII
-  str.replace("å", "a");
-  str.replace("ä", "a");
-  str.replace("à", "a");
-  str.replace("á", "a");
-  str.replace("â", "a");
-  str.replace("ã", "a");
-  str.replace("ā", "a");
-  str.replace("ă", "a");
-  str.replace("ą", "a");
-
-  str.replace("æ", "ae");
-
-  str.replace("ç", "c");
-  str.replace("č", "c");
-  str.replace("ć", "c");
-
-  str.replace("ď", "d");
-
-  str.replace("é", "e");
-  str.replace("è", "e");
-  str.replace("ê", "e");
-  str.replace("ë", "e");
-  str.replace("ē", "e");
-  str.replace("ė", "e");
-  str.replace("ę", "e");
-
-  str.replace("ğ", "g");
-  str.replace("ģ", "g");
-
-  str.replace("ĥ", "h");
-
-  str.replace("í", "i");
-  str.replace("ì", "i");
-  str.replace("î", "i");
-  str.replace("ï", "i");
-  str.replace("ī", "i");
-  str.replace("į", "i");
-
-  str.replace("ĵ", "j");
-
-  str.replace("ķ", "k");
-
-  str.replace("ľ", "l");
-  str.replace("ł", "l");
-
-  str.replace("ñ", "n");
-  str.replace("ń", "n");
-  str.replace("ņ", "n");
-
-  str.replace("ó", "o");
-  str.replace("ò", "o");
-  str.replace("ô", "o");
-  str.replace("ö", "o");
-  str.replace("õ", "o");
-  str.replace("ø", "o");
-  str.replace("ō", "o");
-  str.replace("ő", "o");
-
-  str.replace("œ", "oe");
-
-  str.replace("ŕ", "r");
-
-  str.replace("ś", "s");
-  str.replace("š", "s");
-  str.replace("ș", "s");
-  str.replace("ŝ", "s");
-
-  str.replace("ß", "ss");
-
-  str.replace("ť", "t");
-  str.replace("ț", "t");
-
-  str.replace("ú", "u");
-  str.replace("ù", "u");
-  str.replace("û", "u");
-  str.replace("ü", "u");
-  str.replace("ū", "u");
-  str.replace("ů", "u");
-  str.replace("ű", "u");
-
-  str.replace("ŵ", "w");
-
-  str.replace("ý", "y");
-  str.replace("ÿ", "y");
-  str.replace("ŷ", "y");
-
-  str.replace("ž", "z");
-  str.replace("ź", "z");
-  str.replace("ż", "z");
+bool configFileValid(const char *path) {
+  File f = LittleFS.open(path, "r");
+  if (!f) return false;
+  DynamicJsonDocument doc(2048);
+  DeserializationError err = deserializeJson(doc, f);
+  f.close();
+  return !err;
+}
 
-  str.toUpperCase();
+// Atomically replaces /config.json with doc. Everything in the journal and in
+// pendingConfig must already be merged into doc (use configLoadDocument()).
+bool configWriteFull(JsonDocument &doc, bool keepBackup) {
+  CONFIG_LOCK();
+  bool ok = false;
+  // The backup should be the previous effective config, not a stale base
+  if (keepBackup && LittleFS.exists(CONFIG_JOURNAL_PATH)) configCompact();
 
-  String result = "";
-  for (unsigned int i = 0; i < str.length(); i++) {
-    char c = str.charAt(i);
+  File f = LittleFS.open(CONFIG_TMP_PATH, "w");
+  if (!f) {
+    Serial.println(F("[CONFIG] ERROR: Failed to open /config.tmp for writing!"));
+  } else {
+    size_t bytesWritten = serializeJson(doc, f);
+    f.close();
+    Serial.printf("[CONFIG] Bytes written to /config.tmp: %u\n", (unsigned)bytesWritten);
 
-    if (weatherMode) {
-      if ((c >= 'A' && c <= 'Z') || c == ' ') {
-        result += c;
+    // Read back before it replaces anything
+    if (bytesWritten == 0 || !configFileValid(CONFIG_TMP_PATH)) {
+      Serial.println(F("[CONFIG] ERROR: Verification of /config.tmp failed!"));
+      LittleFS.remove(CONFIG_TMP_PATH);
+    } else {
+      // From here a valid /config.tmp wins at boot (see recoverConfigFiles)
+      if (keepBackup && LittleFS.exists(CONFIG_PATH)) {
+        LittleFS.remove(CONFIG_BAK_PATH);
+        LittleFS.rename(CONFIG_PATH, CONFIG_BAK_PATH);
+      }
+      LittleFS.remove(CONFIG_JOURNAL_PATH);
+      ok = LittleFS.rename(CONFIG_TMP_PATH, CONFIG_PATH);
+      if (ok) {
+        pendingConfig.clear();
+        configPending = false;
+        configGeneration++;
+      } else {
+        Serial.println(F("[CONFIG] ERROR: Failed to rename /config.tmp"));
       }
     }
+  }
+  CONFIG_UNLOCK();
+  return ok;
+}
 
-    else {
-      if ((c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') ||
-          c == ' ' || c == '.' || c == ',' || c == '!' ||
-          c == ':' || c == '-' || c == '_' || c == '%') {
-        result += c;
+// Folds the journal and pending changes into a fresh /config.json
+bool configCompact() {
+  DynamicJsonDocument doc(2048);
+  CONFIG_LOCK();  // No update may land between the load and the rewrite
+  bool ok = configLoadDocument(doc) && configWriteFull(doc, false);
+  if (ok) configCompactions++;
+  CONFIG_UNLOCK();
+  Serial.println(ok ? F("[CONFIG] Journal compacted") : F("[CONFIG] Journal compaction failed"));
+  return ok;
+}
+
+// Queues a partial update. Written by serviceConfigStore() after the debounce,
+// or right away by configFlush().
+void configUpdate(JsonDocument &patch) {
+  CONFIG_LOCK();
+  // Replaced strings are not reclaimed, so flush before the pool runs out
+  if (configPending && pendingConfig.memoryUsage() + patch.memoryUsage() * 2 > pendingConfig.capacity()) {
+    configFlush();
+  }
+  mergeJson(pendingConfig, patch, false);
+  unsigned long now = millis();
+  if (!configPending) configPendingSince = now;
+  configPendingLast = now;
+  configPending = true;
+  configGeneration++;
+  CONFIG_UNLOCK();
+}
+
+// Appends pending changes to the journal as one record
+bool configFlush() {
+  CONFIG_LOCK();
+  if (!configPending) {
+    CONFIG_UNLOCK();
+    return true;
+  }
+
+  bool ok = false;
+  size_t len = measureJson(pendingConfig);
+  if (len > CONFIG_JOURNAL_MAX_PAYLOAD || !LittleFS.exists(CONFIG_PATH)) {
+    ok = configCompact();  // Too big for one record, or nothing to patch
+  } else {
+    uint8_t *record = (uint8_t *)malloc(CONFIG_JOURNAL_HEADER_SIZE + len + 1);
+    if (record) {
+      uint8_t *payload = record + CONFIG_JOURNAL_HEADER_SIZE;
+      serializeJson(pendingConfig, (char *)payload, len + 1);
+      configJournalHeader(record, payload, len);
+
+      File f = LittleFS.open(CONFIG_JOURNAL_PATH, "a");
+      size_t written = 0;
+      size_t journalSize = 0;
+      if (f) {
+        written = f.write(record, CONFIG_JOURNAL_HEADER_SIZE + len);
+        journalSize = f.size();
+        f.close();
+      }
+      free(record);
+
+      if (written == CONFIG_JOURNAL_HEADER_SIZE + len) {
+        pendingConfig.clear();
+        configPending = false;
+        configAppends++;
+        ok = true;
+        Serial.printf("[CONFIG] Journaled %u byte update (journal %u bytes)\n", (unsigned)len, (unsigned)journalSize);
+        if (journalSize > CONFIG_JOURNAL_COMPACT_BYTES) configCompact();
+      } else {
+        // A short write would hide every later record behind it
+        Serial.println(F("[CONFIG] Journal append failed, compacting"));
+        ok = configCompact();
       }
     }
   }
-  return result;
+  CONFIG_UNLOCK();
+  return ok;
+}
+
+// Called from loop()
+void serviceConfigStore() {
+  if (!configPending) return;
+  unsigned long now = millis();
+  if (now - configPendingLast >= CONFIG_DEBOUNCE_MS || now - configPendingSince >= CONFIG_DEBOUNCE_MAX_MS) {
+    configFlush();
+  }
+}
+
+// Drops pending changes and the journal, e.g. before restoring a backup
+void configDiscardChanges() {
+  CONFIG_LOCK();
+  pendingConfig.clear();
+  configPending = false;
+  LittleFS.remove(CONFIG_JOURNAL_PATH);
+  configGeneration++;
+  CONFIG_UNLOCK();
+}
+
+// Rebuilds the secret-free copy served by GET /config.json and its ETag.
+// Only the web server calls this, so the snapshot has a single writer.
+bool refreshConfigSnapshot() {
+  uint32_t generation = configGeneration;
+  if (configSnapshot.length() > 0 && configSnapshotGeneration == generation && configSnapshotAPMode == isAPMode) {
+    return true;
+  }
+
+  if (!LittleFS.exists(CONFIG_PATH)) return false;
+  DynamicJsonDocument doc(2048);
+  if (!configLoadDocument(doc)) return false;
+
+  // Always sanitize before sending to browser
+  doc[F("ssid")] = getSafeSsid();
+  doc[F("password")] = getSafePassword();
+  doc["adminPassword"] = getSafeAdminPassword();
+  doc["weatherApiKey"] = getSafeWeatherApiKey();
+  doc[F("mode")] = isAPMode ? "ap" : "sta";
+
+  if (doc["youtube"]) doc["youtube"]["apiKey"] = getSafeYoutubeApiKey();
+  doc["webhookKey"] = getSafeWebhookKey();
+
+  configSnapshot = "";
+  configSnapshot.reserve(measureJson(doc) + 1);
+  serializeJson(doc, configSnapshot);
+
+  // Strong validator: FNV-1a of the exact body
+  uint32_t hash = fnv1a(configSnapshot.c_str());
+  snprintf(configSnapshotETag, sizeof(configSnapshotETag), "\"%08lx\"", (unsigned long)hash);
+
+  configSnapshotGeneration = generation;
+  configSnapshotAPMode = isAPMode;
+  configSnapshotBuilds++;
+  return true;
+}
+
+// Finishes or rolls back a write interrupted by a reset. Run once after mounting.
+void recoverConfigFiles() {
+  #ifdef ESP32
+    if (!configMutex) configMutex = xSemaphoreCreateRecursiveMutex();
+  #endif
+
+  if (LittleFS.exists(CONFIG_TMP_PATH)) {
+    if (configFileValid(CONFIG_TMP_PATH)) {
+      // Written from the full effective config, so it supersedes the journal
+      Serial.println(F("[CONFIG] Completing interrupted write from /config.tmp"));
+      LittleFS.remove(CONFIG_JOURNAL_PATH);
+      LittleFS.remove(CONFIG_PATH);
+      LittleFS.rename(CONFIG_TMP_PATH, CONFIG_PATH);
+    } else {
+      Serial.println(F("[CONFIG] Discarding incomplete /config.tmp"));
+      LittleFS.remove(CONFIG_TMP_PATH);
+    }
+  }
+
+  // Missing (crash inside a legacy rename/write pair) or unreadable
+  if (!configFileValid(CONFIG_PATH) && configFileValid(CONFIG_BAK_PATH)) {
+    Serial.println(F("[CONFIG] config.json missing or corrupt, restoring /config.bak"));
+    File src = LittleFS.open(CONFIG_BAK_PATH, "r");
+    File dst = LittleFS.open(CONFIG_TMP_PATH, "w");
+    if (src && dst) {
+      while (src.available()) dst.write(src.read());
+    }
+    if (src) src.close();
+    if (dst) dst.close();
+    LittleFS.remove(CONFIG_JOURNAL_PATH);  // Its records patched the lost base
+    LittleFS.remove(CONFIG_PATH);
+    LittleFS.rename(CONFIG_TMP_PATH, CONFIG_PATH);
+  }
+
+  // Drops a torn tail and starts each boot with an empty journal
+  if (LittleFS.exists(CONFIG_JOURNAL_PATH)) {
+    if (LittleFS.exists(CONFIG_PATH)) {
+      configCompact();
+    } else {
+      LittleFS.remove(CONFIG_JOURNAL_PATH);
+    }
+  }
 }
 
 // -----------------------------------------------------------------------------
@@ -569,7 +1324,7 @@ void loadConfig() {
   Serial.println(F("[CONFIG] Loading configuration..."));
 
   // Check if config.json exists, if not, create default
-  if (!LittleFS.exists("/config.json")) {
+  if (!LittleFS.exists(CONFIG_PATH)) {
     Serial.println(F("[CONFIG] config.json not found, creating with defaults..."));
     DynamicJsonDocument doc(1024);
     doc[F("ssid")] = "";
@@ -583,6 +1338,7 @@ void loadConfig() {
     doc[F("weatherUnits")] = "metric";
     doc[F("clockDuration")] = 10000;
     doc[F("weatherDuration")] = 5000;
+    doc[F("displayPlaylist")] = DEFAULT_DISPLAY_PLAYLIST;
     doc[F("weatherProvider")] = "openmeteo";
     doc[F("weatherApiKey")] = "";
     doc[F("timeZone")] = "";
@@ -596,13 +1352,20 @@ void loadConfig() {
     doc[F("colonBlinkEnabled")] = colonBlinkEnabled;
     doc[F("ntpServer1")] = ntpServer1;
     doc[F("ntpServer2")] = ntpServer2;
+    doc[F("nightscoutUrl")] = "";
     doc[F("dimmingEnabled")] = dimmingEnabled;
     doc[F("dimStartHour")] = dimStartHour;
     doc[F("dimStartMinute")] = dimStartMinute;
     doc[F("dimEndHour")] = dimEndHour;
     doc[F("dimEndMinute")] = dimEndMinute;
     doc[F("dimBrightness")] = dimBrightness;
+    doc[F("dimFadeSeconds")] = dimFadeSeconds;
     doc[F("showWeatherDescription")] = showWeatherDescription;
+    doc[F("weatherMaxAge")] = weatherMaxAge;
+    doc[F("staticIp")] = "";
+    doc[F("staticGateway")] = "";
+    doc[F("staticSubnet")] = "";
+    doc[F("staticDns")] = "";
     doc[F("apiEnabled")] = false;
     doc[F("webhooksEnabled")] = false;
     doc[F("webhookKey")] = "";
@@ -616,10 +1379,7 @@ void loadConfig() {
     countdownObj["label"] = "";
     countdownObj["isDramaticCountdown"] = true;
 
-    File f = LittleFS.open("/config.json", "w");
-    if (f) {
-      serializeJsonPretty(doc, f);
-      f.close();
+    if (configWriteFull(doc, false)) {
       Serial.println(F("[CONFIG] Default config.json created."));
     } else {
       Serial.println(F("[ERROR] Failed to create default config.json"));
@@ -627,19 +1387,14 @@ void loadConfig() {
   }
 
   Serial.println(F("[CONFIG] Attempting to open config.json for reading."));
-  File configFile = LittleFS.open("/config.json", "r");
-  if (!configFile) {
+  if (!LittleFS.exists(CONFIG_PATH)) {
     Serial.println(F("[ERROR] Failed to open config.json for reading. Cannot load config."));
     return;
   }
 
-  DynamicJsonDocument doc(1024);  // Size based on ArduinoJson Assistant + buffer
-  DeserializationError error = deserializeJson(doc, configFile);
-  configFile.close();
-
-  if (error) {
-    Serial.print(F("[ERROR] JSON parse failed during load: "));
-    Serial.println(error.f_str());
+  DynamicJsonDocument doc(2048);  // Same size as the /save document
+  if (!configLoadDocument(doc)) {
+    Serial.println(F("[ERROR] JSON parse failed during load"));
     return;
   }
 
@@ -671,6 +1426,8 @@ void loadConfig() {
   strlcpy(weatherUnits, doc["weatherUnits"] | "metric", sizeof(weatherUnits));
   clockDuration = doc["clockDuration"] | 10000;
   weatherDuration = doc["weatherDuration"] | 5000;
+  strlcpy(displayPlaylist, doc["displayPlaylist"] | DEFAULT_DISPLAY_PLAYLIST, sizeof(displayPlaylist));
+  parseDisplayPlaylist(displayPlaylist);
   strlcpy(timeZone, doc["timeZone"] | "Etc/UTC", sizeof(timeZone));
   if (doc.containsKey("language")) {
     strlcpy(language, doc["language"], sizeof(language));
@@ -678,6 +1435,7 @@ void loadConfig() {
     strlcpy(language, "en", sizeof(language));
     Serial.println(F("[CONFIG] 'language' key not found in config.json, defaulting to 'en'."));
   }
+  activeWeatherTerms = findWeatherTerms(language);
 
   brightness = doc["brightness"] | 7;
   flipDisplay = doc["flipDisplay"] | false;
@@ -687,8 +1445,13 @@ void loadConfig() {
   showHumidity = doc["showHumidity"] | false;
   colonBlinkEnabled = doc.containsKey("colonBlinkEnabled") ? doc["colonBlinkEnabled"].as<bool>() : true;
   showWeatherDescription = doc["showWeatherDescription"] | false;
+  weatherMaxAge = constrain((int)(doc["weatherMaxAge"] | 180), 10, 1440);
   mdnsEnabled = doc["mdnsEnabled"] | true;
   strlcpy(mdnsHostname, doc["mdnsHostname"] | "esptimecast", sizeof(mdnsHostname));
+  strlcpy(staticIp, doc["staticIp"] | "", sizeof(staticIp));
+  strlcpy(staticGateway, doc["staticGateway"] | "", sizeof(staticGateway));
+  strlcpy(staticSubnet, doc["staticSubnet"] | "", sizeof(staticSubnet));
+  strlcpy(staticDns, doc["staticDns"] | "", sizeof(staticDns));
   apiEnabled = doc["apiEnabled"] | false;
   webhooksEnabled = doc["webhooksEnabled"] | false;
   strlcpy(webhookKey, doc["webhookKey"] | "", sizeof(webhookKey));
@@ -703,9 +1466,23 @@ void loadConfig() {
   dimEndHour = doc["dimEndHour"] | 8;
   dimEndMinute = doc["dimEndMinute"] | 0;
   dimBrightness = doc["dimBrightness"] | 0;
+  dimFadeSeconds = constrain((int)(doc["dimFadeSeconds"] | 0), 0, 600);
+  dimScheduleDirty = true;
 
   strlcpy(ntpServer1, doc["ntpServer1"] | "pool.ntp.org", sizeof(ntpServer1));
   strlcpy(ntpServer2, doc["ntpServer2"] | "time.nist.gov", sizeof(ntpServer2));
+  strlcpy(nightscoutUrl, doc["nightscoutUrl"] | "", sizeof(nightscoutUrl));
+
+  // Older configs kept the Nightscout URL in the second NTP server field
+  if (!doc.containsKey("nightscoutUrl") && strncmp(ntpServer2, "https://", 8) == 0) {
+    strlcpy(nightscoutUrl, ntpServer2, sizeof(nightscoutUrl));
+    strlcpy(ntpServer2, "time.nist.gov", sizeof(ntpServer2));
+    DynamicJsonDocument patch(NIGHTSCOUT_URL_SIZE + 128);
+    patch["nightscoutUrl"] = nightscoutUrl;
+    patch["ntpServer2"] = ntpServer2;
+    configUpdate(patch);
+    Serial.println(F("[CONFIG] Moved the Nightscout URL out of ntpServer2"));
+  }
 
   // Weather provider
   String provider = doc["weatherProvider"] | "openmeteo";
@@ -766,6 +1543,8 @@ void loadConfig() {
     youtubeShortFormat = true;
     Serial.println(F("[CONFIG] YouTube object not found, defaulting to disabled."));
   }
+  loadYoutubeChannelList();
+  displayModesDirty = true;
 
   Serial.println(F("[CONFIG] Configuration loaded."));
 }
@@ -778,6 +1557,78 @@ void loadConfig() {
 const char *DEFAULT_AP_PASSWORD = "12345678";
 const char *AP_SSID = "ESPTimeCast";
 
+void printWiFiMode(const char *when) {
+  #ifdef ESP32
+    auto mode = WiFi.getMode();
+  #else  // ESP8266
+    WiFiMode_t mode = WiFi.getMode();
+  #endif
+  Serial.printf("[WIFI] WiFi mode after %s: %s\n", when,
+                mode == WIFI_OFF ? "OFF" : mode == WIFI_STA    ? "STA ONLY"
+                                         : mode == WIFI_AP     ? "AP ONLY"
+                                         : mode == WIFI_AP_STA ? "AP + STA (Error!)"
+                                                               : "UNKNOWN");
+}
+
+uint32_t wifiSsidHash() {
+  return configJournalCrc32((const uint8_t *)ssid, strlen(ssid));
+}
+
+uint32_t wifiCacheCrc(const WifiCacheRecord &rec) {
+  return configJournalCrc32((const uint8_t *)&rec, offsetof(WifiCacheRecord, crc));
+}
+
+bool wifiCacheValid(const WifiCacheRecord &rec) {
+  return rec.magic == WIFI_CACHE_MAGIC && rec.crc == wifiCacheCrc(rec) && rec.ssidHash == wifiSsidHash()
+         && rec.channel >= 1 && rec.channel <= 14;
+}
+
+// The access point to try first
+bool loadWifiCache(WifiCacheRecord &rec) {
+  bool found = false;
+  File f = LittleFS.open(WIFI_CACHE_PATH, "r");
+  if (f) {
+    if (f.read((uint8_t *)&rec, sizeof(rec)) == sizeof(rec) && wifiCacheValid(rec)) {
+      wifiCacheSaved = rec;
+      found = true;
+    }
+    f.close();
+  }
+  return found;
+}
+
+// Stores the access point just connected to, when it changed
+void saveWifiCache() {
+  uint8_t *bssid = WiFi.BSSID();
+  if (!bssid) return;
+
+  WifiCacheRecord rec;
+  memset(&rec, 0, sizeof(rec));
+  rec.magic = WIFI_CACHE_MAGIC;
+  rec.ssidHash = wifiSsidHash();
+  memcpy(rec.bssid, bssid, sizeof(rec.bssid));
+  rec.channel = (uint8_t)WiFi.channel();
+  rec.crc = wifiCacheCrc(rec);
+  if (memcmp(&rec, &wifiCacheSaved, sizeof(rec)) == 0) return;
+
+  File f = LittleFS.open(WIFI_CACHE_PATH, "w");
+  if (!f) {
+    Serial.println(F("[WIFI] Cannot write " WIFI_CACHE_PATH));
+    return;
+  }
+  bool ok = f.write((const uint8_t *)&rec, sizeof(rec)) == sizeof(rec);
+  f.close();
+  if (ok) wifiCacheSaved = rec;
+}
+
+// Static address from the config. Subnet defaults to /24, DNS to the gateway.
+bool getStaticIpConfig(IPAddress &ip, IPAddress &gateway, IPAddress &subnet, IPAddress &dns) {
+  if (!ip.fromString(staticIp) || !gateway.fromString(staticGateway)) return false;
+  if (!subnet.fromString(staticSubnet)) subnet = IPAddress(255, 255, 255, 0);
+  if (!dns.fromString(staticDns)) dns = gateway;
+  return true;
+}
+
 void connectWiFi() {
   Serial.println(F("[WIFI] Connecting to WiFi..."));
 
@@ -804,170 +1655,396 @@ void connectWiFi() {
     Serial.println(WiFi.softAPIP());
     isAPMode = true;
 
-    WiFiMode_t mode = WiFi.getMode();
-    Serial.printf("[WIFI] WiFi mode after setting AP: %s\n",
-                  mode == WIFI_OFF ? "OFF" : mode == WIFI_STA    ? "STA ONLY"
-                                           : mode == WIFI_AP     ? "AP ONLY"
-                                           : mode == WIFI_AP_STA ? "AP + STA (Error!)"
-                                                                 : "UNKNOWN");
+    printWiFiMode("setting AP");
 
     Serial.println(F("[WIFI] AP Mode Started"));
     return;
   }
 
-  // If credentials exist, attempt STA connection
+  // If credentials exist, start the STA connection; serviceWiFiConnect()
+  // follows it from loop()
   WiFi.mode(WIFI_STA);
   WiFi.disconnect(true);
   delay(100);
 
-  WiFi.begin(ssid, password);
-  unsigned long startAttemptTime = millis();
-
-  const unsigned long timeout = 30000;
-  unsigned long animTimer = 0;
-  int animFrame = 0;
-  bool animating = true;
+  IPAddress ip, gateway, subnet, dns;
+  WifiCacheRecord cached;
+  bool haveCache = loadWifiCache(cached);
+  if (getStaticIpConfig(ip, gateway, subnet, dns)) {
+    WiFi.config(ip, gateway, subnet, dns);
+    Serial.printf("[WIFI] Static IP %s\n", ip.toString().c_str());
+  }
 
-  while (animating) {
-    unsigned long now = millis();
-    if (WiFi.status() == WL_CONNECTED) {
-      #ifdef ESP32
-        Serial.println("[WIFI] Connected: " + WiFi.localIP().toString());
-      #else  // ESP8266
-        Serial.println(F("[WIFI] Connected: ") + WiFi.localIP().toString());
-      #endif
-      isAPMode = false;
-
-      WiFiMode_t mode = WiFi.getMode();
-      Serial.printf("[WIFI] WiFi mode after STA connection: %s\n",
-                    mode == WIFI_OFF ? "OFF" : mode == WIFI_STA    ? "STA ONLY"
-                                             : mode == WIFI_AP     ? "AP ONLY"
-                                             : mode == WIFI_AP_STA ? "AP + STA (Error!)"
-                                                                   : "UNKNOWN");
-
-      // --- IP Display initiation ---
-      pendingIpToShow = WiFi.localIP().toString();
-      showingIp = true;
-      ipDisplayCount = 0;  // Reset count for IP display
-      P.displayClear();
-      P.setCharSpacing(1);  // Set spacing for IP scroll
-      textEffect_t actualScrollDirection = getEffectiveScrollDirection(PA_SCROLL_LEFT, flipDisplay);
-      P.displayScroll(pendingIpToShow.c_str(), PA_CENTER, actualScrollDirection, IP_SCROLL_SPEED);
-      // --- END IP Display initiation ---
+  wifiConnectStart = millis();
+  wifiAttemptStart = wifiConnectStart;
+  if (haveCache) {
+    Serial.printf("[WIFI] Fast connect to %02X:%02X:%02X:%02X:%02X:%02X on channel %u\n",
+                  cached.bssid[0], cached.bssid[1], cached.bssid[2],
+                  cached.bssid[3], cached.bssid[4], cached.bssid[5], cached.channel);
+    WiFi.begin(ssid, password, cached.channel, cached.bssid);
+    wifiConnectState = WIFI_CONNECT_FAST;
+  } else {
+    WiFi.begin(ssid, password);
+    wifiConnectState = WIFI_CONNECT_SCAN;
+  }
+}
 
-      animating = false;  // Exit the connection loop
-      break;
-    } else if (now - startAttemptTime >= timeout) {
-      Serial.println(F("[WiFi] Failed. Starting AP mode..."));
-      WiFi.mode(WIFI_AP);
-      WiFi.softAP(AP_SSID, DEFAULT_AP_PASSWORD);
-      Serial.print(F("[WiFi] AP IP address: "));
-      Serial.println(WiFi.softAPIP());
-      dnsServer.start(DNS_PORT, "*", WiFi.softAPIP());
-      isAPMode = true;
-
-      #ifdef ESP32
-        auto mode = WiFi.getMode();
-      #else  // ESP8266
-        WiFiMode_t mode = WiFi.getMode();
-      #endif
-      Serial.printf("[WIFI] WiFi mode after STA failure and setting AP: %s\n",
-                    mode == WIFI_OFF ? "OFF" : mode == WIFI_STA    ? "STA ONLY"
-                                             : mode == WIFI_AP     ? "AP ONLY"
-                                             : mode == WIFI_AP_STA ? "AP + STA (Error!)"
-                                                                   : "UNKNOWN");
-
-      animating = false;
-      Serial.println(F("[WIFI] AP Mode Started"));
-      break;
-    }
-    if (now - animTimer > 750) {
-      animTimer = now;
-      P.setTextAlignment(PA_CENTER);
-      switch (animFrame % 3) {
-        case 0: P.print(F("# ©")); break;
-        case 1: P.print(F("# ª")); break;
-        case 2: P.print(F("# «")); break;
-      }
-      animFrame++;
-    }
-    #ifdef ESP32
-      delay(1);
-    #else // ESP8266
-      yield();
-    #endif
+void onWiFiConnected() {
+  #ifdef ESP32
+    Serial.println("[WIFI] Connected: " + WiFi.localIP().toString());
+  #else  // ESP8266
+    Serial.println(F("[WIFI] Connected: ") + WiFi.localIP().toString());
+  #endif
+  isAPMode = false;
+  printWiFiMode("STA connection");
+
+  unsigned long now = millis();
+  bool fastPath = (wifiConnectState == WIFI_CONNECT_FAST);
+  wifiConnectState = WIFI_CONNECT_DONE;
+  if (bootWifiMs == 0) {
+    bootWifiMs = now;
+    bootFastPath = fastPath;
   }
+  Serial.printf("[WIFI] Connected after %lu ms (%s), %lu ms since boot\n",
+                now - wifiConnectStart, fastPath ? "fast" : "scan", now);
+  saveWifiCache();
+  showIpAddress();
+  setupMDNS();
+  setupTime();
 }
 
-void clearWiFiCredentialsInConfig() {
-  DynamicJsonDocument doc(2048);
+// Scrolls the station address (ipDisplayMax times, then back to the clock)
+void showIpAddress() {
+  shownIpAddress = (uint32_t)WiFi.localIP();
+  pendingIpToShow = WiFi.localIP().toString();
+  showingIp = true;
+  ipDisplayCount = 0;  // Reset count for IP display
+  invalidateRenderCache();
+  P.displayClear();
+  P.setCharSpacing(1);  // Set spacing for IP scroll
+  textEffect_t actualScrollDirection = getEffectiveScrollDirection(PA_SCROLL_LEFT, flipDisplay);
+  invalidateRenderCache();
+  P.displayScroll(pendingIpToShow.c_str(), PA_CENTER, actualScrollDirection, IP_SCROLL_SPEED);
+  noteShownText(pendingIpToShow.c_str());
+}
 
-  // Open existing config, if present
-  File configFile = LittleFS.open("/config.json", "r");
-  if (configFile) {
-    DeserializationError err = deserializeJson(doc, configFile);
-    configFile.close();
-    if (err) {
-      Serial.print(F("[SECURITY] Error parsing config.json: "));
-      Serial.println(err.f_str());
-      return;
+// Called every loop(): finishes the connect started by connectWiFi()
+void serviceWiFiConnect() {
+  if (wifiConnectState == WIFI_CONNECT_IDLE) return;
+
+  unsigned long now = millis();
+  if (wifiConnectState == WIFI_CONNECT_DONE) {
+    // DHCP after a reconnect or a renewal may hand out another address
+    if (!showingIp && WiFi.status() == WL_CONNECTED && (uint32_t)WiFi.localIP() != shownIpAddress) {
+      Serial.println("[WIFI] Address changed: " + WiFi.localIP().toString());
+      showIpAddress();
     }
+    return;
   }
 
-  doc["ssid"] = "";
-  doc["password"] = "";
+  if (WiFi.status() == WL_CONNECTED) {
+    onWiFiConnected();
+    return;
+  }
 
-  // Optionally backup previous config
-  if (LittleFS.exists("/config.json")) {
-    LittleFS.rename("/config.json", "/config.bak");
+  if (wifiConnectState == WIFI_CONNECT_FAST && now - wifiAttemptStart >= WIFI_FAST_TIMEOUT_MS) {
+    Serial.println(F("[WIFI] Fast connect failed, scanning..."));
+    WiFi.disconnect();
+    WiFi.begin(ssid, password);
+    wifiAttemptStart = now;
+    wifiConnectState = WIFI_CONNECT_SCAN;
+    return;
   }
 
-  File f = LittleFS.open("/config.json", "w");
-  if (!f) {
+  if (now - wifiConnectStart >= WIFI_CONNECT_TIMEOUT_MS) {
+    Serial.println(F("[WiFi] Failed. Starting AP mode..."));
+    wifiConnectState = WIFI_CONNECT_IDLE;
+    WiFi.mode(WIFI_AP);
+    WiFi.softAP(AP_SSID, DEFAULT_AP_PASSWORD);
+    Serial.print(F("[WiFi] AP IP address: "));
+    Serial.println(WiFi.softAPIP());
+    dnsServer.start(DNS_PORT, "*", WiFi.softAPIP());
+    isAPMode = true;
+
+    printWiFiMode("STA failure and setting AP");
+
+    Serial.println(F("[WIFI] AP Mode Started"));
+    setupMDNS();
+  }
+}
+
+bool wifiConnecting() {
+  return wifiConnectState == WIFI_CONNECT_FAST || wifiConnectState == WIFI_CONNECT_SCAN;
+}
+
+void clearWiFiCredentialsInConfig() {
+  DynamicJsonDocument patch(64);
+  patch["ssid"] = "";
+  patch["password"] = "";
+  configUpdate(patch);
+
+  // The device reboots next, so write now instead of after the debounce
+  if (!configFlush()) {
     Serial.println(F("[SECURITY] ERROR: Cannot write to /config.json to clear credentials!"));
     return;
   }
-  serializeJson(doc, f);
-  f.close();
   Serial.println(F("[SECURITY] Cleared WiFi credentials in config.json."));
 }
 
 // -----------------------------------------------------------------------------
 // Time / NTP Functions
 // -----------------------------------------------------------------------------
-void setupTime() {
-  #ifdef ESP8266
-    sntp_stop();  // ESP8266 needs explicit stop before reconfiguring
+uint64_t monotonicUs() {
+  #ifdef ESP32
+    return (uint64_t)esp_timer_get_time();
+  #else  // ESP8266
+    return micros64();
   #endif
-  if (!isAPMode) {
-    Serial.println(F("[TIME] Starting NTP sync"));
+}
+
+uint64_t clockNowUs() {
+  struct timeval tv;
+  gettimeofday(&tv, nullptr);
+  return (uint64_t)tv.tv_sec * 1000000ULL + tv.tv_usec;
+}
+
+void setClockUs(uint64_t unixUs) {
+  struct timeval tv;
+  tv.tv_sec = (time_t)(unixUs / 1000000ULL);
+  tv.tv_usec = (suseconds_t)(unixUs % 1000000ULL);
+  settimeofday(&tv, nullptr);
+}
+
+void applyTimeZone() {
+  setenv("TZ", ianaToPosix(timeZone), 1);
+  tzset();
+}
+
+// Starts a round with every server that has an address, looking up the ones
+// without (at most every NTP_LOOKUP_RETRY_MS). False if none has one.
+bool ntpStartQuery() {
+  if (WiFi.status() != WL_CONNECTED) return false;
+  if (!ntpUdpStarted) {
+    ntpUdpStarted = ntpUdp.begin(NTP_LOCAL_PORT);
+    if (!ntpUdpStarted) {
+      Serial.println(F("[TIME] Cannot open NTP socket"));
+      return false;
+    }
   }
 
-  bool serverOk = false;
-  IPAddress resolvedIP;
+  const char *servers[2] = { ntpServer1, ntpServer2 };
+  bool any = false;
+  for (uint8_t i = 0; i < 2; i++) {
+    NtpServerQuery &q = ntpQueries[i];
+    q.answered = false;
+    uint32_t nameHash = fnv1a(servers[i]);
+    if (q.nameHash != nameHash) {
+      q.nameHash = nameHash;
+      q.resolved = false;
+      q.lookupFailed = false;
+    }
+    if (!q.resolved && strlen(servers[i]) > 0 && (!q.lookupFailed || millis() - q.lookupAt >= NTP_LOOKUP_RETRY_MS)) {
+      q.resolved = WiFi.hostByName(servers[i], q.ip) == 1;
+      q.lookupFailed = !q.resolved;
+      q.lookupAt = millis();
+      if (q.lookupFailed) Serial.printf("[TIME] Cannot resolve %s\n", servers[i]);
+    }
+    any |= q.resolved;
+  }
+  if (!any) return false;
+
+  while (ntpUdp.parsePacket() > 0) ntpUdp.flush();  // Late replies from an earlier round
+  ntpQueryActive = true;
+  ntpRoundStart = millis();
+  ntpLastSend = 0;
+  ntpFirstReply = 0;
+  ntpBestServer = -1;
+  return true;
+}
 
-  // Try first server if it's not empty
-  if (strlen(ntpServer1) > 0 && WiFi.hostByName(ntpServer1, resolvedIP) == 1) {
-    serverOk = true;
+void ntpSendRequests() {
+  uint8_t packet[NTP_PACKET_SIZE];
+  for (uint8_t i = 0; i < 2; i++) {
+    NtpServerQuery &q = ntpQueries[i];
+    if (!q.resolved || q.answered) continue;
+    q.sentUs = clockNowUs();
+    ntpBuildRequest(packet, q.sentUs);
+    ntpUdp.beginPacket(q.ip, 123);
+    ntpUdp.write(packet, sizeof(packet));
+    ntpUdp.endPacket();
   }
-  // Try second server if first failed
-  else if (strlen(ntpServer2) > 0 && WiFi.hostByName(ntpServer2, resolvedIP) == 1) {
-    serverOk = true;
+  ntpLastSend = millis();
+}
+
+// At the end of a round: a server that did not answer may have moved (pool
+// names rotate), so its address is looked up again before the next round
+void ntpForgetSilentServers() {
+  for (uint8_t i = 0; i < 2; i++) {
+    if (!ntpQueries[i].answered) ntpQueries[i].resolved = false;
   }
+}
 
-  if (serverOk) {
-    configTime(0, 0, ntpServer1, ntpServer2);  // safe to call now
-    setenv("TZ", ianaToPosix(timeZone), 1);
-    tzset();
-    ntpState = NTP_SYNCING;
-    ntpStartTime = millis();
-    ntpRetryCount = 0;
-    ntpSyncSuccessful = false;
+void applyNtpSample(const NtpSample &sample, int8_t server) {
+  setClockUs(clockNowUs() + sample.offsetUs);
+  clockDiscipline.sync(sample.offsetUs, sample.delayUs, monotonicUs());
+  lastNtpSync = millis();
+  ntpLastServer = server;
+  ntpSyncs++;
+  clockSource = "ntp";
+
+  const char *host = server == 0 ? ntpServer1 : ntpServer2;
+  if (sample.offsetUs >= CLOCK_STEP_LIMIT_US || sample.offsetUs <= -CLOCK_STEP_LIMIT_US) {
+    Serial.printf("[TIME] Clock set from %s (delay %lu ms)\n", host, (unsigned long)(sample.delayUs / 1000));
   } else {
-    Serial.println(F("[TIME] NTP server lookup failed — retry sync in 30 seconds"));
-    ntpSyncSuccessful = false;
-    ntpState = NTP_SYNCING;   // instead of NTP_IDLE
-    ntpStartTime = millis();  // start the failed timer (so retry delay counts from now)
+    Serial.printf("[TIME] Synced to %s: offset %ld us, delay %lu us, drift %ld ppb\n", host,
+                  (long)sample.offsetUs, (unsigned long)sample.delayUs, (long)clockDiscipline.driftPpb());
+  }
+}
+
+// Called every loop(). Returns 1 when a round applied a sample, -1 when a
+// round ended without one, 0 otherwise.
+int serviceNtpQuery() {
+  if (!ntpQueryActive) return 0;
+
+  uint8_t packet[NTP_PACKET_SIZE];
+  int size;
+  while ((size = ntpUdp.parsePacket()) > 0) {
+    uint64_t receivedUs = clockNowUs();
+    IPAddress from = ntpUdp.remoteIP();
+    int len = ntpUdp.read(packet, sizeof(packet));
+    ntpUdp.flush();
+    if (len < NTP_PACKET_SIZE) continue;
+
+    for (uint8_t i = 0; i < 2; i++) {
+      NtpServerQuery &q = ntpQueries[i];
+      NtpSample sample;
+      if (!q.resolved || q.answered || (uint32_t)from != (uint32_t)q.ip) continue;
+      if (!ntpParseReply(packet, len, q.sentUs, receivedUs, sample)) continue;
+      q.answered = true;
+      if (!ntpFirstReply) ntpFirstReply = millis();
+      if (ntpBestServer < 0 || sample.delayUs < ntpBest.delayUs) {
+        ntpBest = sample;
+        ntpBestServer = i;
+      }
+      break;
+    }
+  }
+
+  unsigned long now = millis();
+  bool allAnswered = true;
+  for (uint8_t i = 0; i < 2; i++) {
+    if (ntpQueries[i].resolved && !ntpQueries[i].answered) allAnswered = false;
+  }
+
+  if (ntpBestServer >= 0 && (allAnswered || now - ntpFirstReply >= NTP_COLLECT_MS)) {
+    applyNtpSample(ntpBest, ntpBestServer);
+    ntpForgetSilentServers();
+    ntpQueryActive = false;
+    ntpRoundEnd = now;
+    ntpNextRoundDelay = NTP_RESYNC_MS;
+    return 1;
+  }
+  if (now - ntpRoundStart >= NTP_ROUND_TIMEOUT_MS) {
+    ntpForgetSilentServers();
+    ntpQueryActive = false;
+    ntpRoundEnd = now;
+    ntpNextRoundDelay = NTP_RESYNC_RETRY_MS;
+    ntpRoundsFailed++;
+    return -1;
+  }
+  if (ntpLastSend == 0 || now - ntpLastSend >= NTP_RESEND_MS) {
+    ntpSendRequests();
+  }
+  return 0;
+}
+
+uint32_t clockRtcCrc(const ClockRtcRecord &rec) {
+  return configJournalCrc32((const uint8_t *)&rec, offsetof(ClockRtcRecord, crc));
+}
+
+// Once a second while the clock is valid
+void saveClockToRtc() {
+  ClockRtcRecord rec;
+  uint64_t nowUs = clockNowUs();
+  rec.magic = CLOCK_RTC_MAGIC;
+  rec.unixSec = (uint32_t)(nowUs / 1000000ULL);
+  rec.unixUs = (uint32_t)(nowUs % 1000000ULL);
+  #ifdef ESP32
+    rec.rtcCycles = 0;
+  #else  // ESP8266
+    rec.rtcCycles = system_get_rtc_time();
+  #endif
+  rec.driftPpb = clockDiscipline.driftPpb();
+  rec.crc = clockRtcCrc(rec);
+
+  #ifdef ESP32
+    rtcClock = rec;
+  #else  // ESP8266
+    ESP.rtcUserMemoryWrite(CLOCK_RTC_OFFSET, (uint32_t *)&rec, sizeof(rec));
+  #endif
+}
+
+// Shows the time right away after a warm reboot. Run once after loadConfig();
+// NTP still checks it once WiFi is up.
+void restoreClockFromRtc() {
+  ClockRtcRecord rec;
+  #ifdef ESP32
+    rec = rtcClock;
+    if (rec.magic != CLOCK_RTC_MAGIC || rec.crc != clockRtcCrc(rec)) return;
+    if (time(nullptr) < (time_t)rec.unixSec) return;  // System time did not survive the reset
+  #else  // ESP8266
+    uint32_t reason = ESP.getResetInfoPtr()->reason;
+    if (reason == REASON_DEFAULT_RST || reason == REASON_EXT_SYS_RST) return;  // RTC counter restarted too
+    if (!ESP.rtcUserMemoryRead(CLOCK_RTC_OFFSET, (uint32_t *)&rec, sizeof(rec))) return;
+    if (rec.magic != CLOCK_RTC_MAGIC || rec.crc != clockRtcCrc(rec)) return;
+    // RTC cycles to microseconds; the calibration is a 12-bit fixed-point period
+    uint64_t elapsedUs = ((uint64_t)(system_get_rtc_time() - rec.rtcCycles) * system_rtc_clock_cali_proc()) >> 12;
+    setClockUs((uint64_t)rec.unixSec * 1000000ULL + rec.unixUs + elapsedUs);
+  #endif
+
+  clockDiscipline.restore(rec.driftPpb, monotonicUs());
+  applyTimeZone();
+  ntpState = NTP_SUCCESS;
+  ntpSyncSuccessful = true;
+  displayModesDirty = true;
+  clockSource = "rtc";
+  bootClockMs = millis();
+  Serial.printf("[TIME] Clock restored from RTC memory (drift %ld ppb)\n", (long)rec.driftPpb);
+}
+
+// Once a second: hands out drift corrections and refreshes the RTC copy
+void serviceClock() {
+  if (!ntpSyncSuccessful) return;
+  int32_t correctionUs = clockDiscipline.correction(monotonicUs());
+  if (correctionUs != 0) {
+    setClockUs(clockNowUs() + correctionUs);
+  }
+  saveClockToRtc();
+}
+
+void setupTime() {
+  #ifdef ESP8266
+    sntp_stop();  // The SDK client must not step the clock behind ours
+  #endif
+  applyTimeZone();
+
+  if (ntpSyncSuccessful) {
+    // Restored after a reboot: keep showing it, check it in the background
+    Serial.println(F("[TIME] Checking restored clock against NTP"));
+    ntpStartQuery();
+    return;
+  }
+
+  if (!isAPMode) {
+    Serial.println(F("[TIME] Starting NTP sync"));
+  }
+  ntpState = NTP_SYNCING;
+  ntpStartTime = millis();
+  ntpRetryCount = 0;
+  ntpSyncSuccessful = false;
+  displayModesDirty = true;
+  if (!ntpStartQuery()) {
+    Serial.println(F("[TIME] NTP server lookup failed — retrying"));
   }
 }
 
@@ -1006,6 +2083,8 @@ void printConfigToSerial() {
   Serial.println(clockDuration);
   Serial.print(F("Weather duration: "));
   Serial.println(weatherDuration);
+  Serial.print(F("Display playlist: "));
+  Serial.println(displayPlaylist);
   Serial.print(F("TimeZone (IANA): "));
   Serial.println(timeZone);
   Serial.print(F("Days of the Week/Weather description language: "));
@@ -1030,6 +2109,10 @@ void printConfigToSerial() {
   Serial.println(ntpServer1);
   Serial.print(F("NTP Server 2: "));
   Serial.println(ntpServer2);
+  Serial.print(F("Nightscout URL: "));
+  Serial.println(strlen(nightscoutUrl) ? nightscoutUrl : "(none)");
+  Serial.print(F("Static IP: "));
+  Serial.println(strlen(staticIp) ? staticIp : "DHCP");
   Serial.print(F("Dimming Enabled: "));
   Serial.println(dimmingEnabled);
   Serial.print(F("Dimming Start Hour: "));
@@ -1042,6 +2125,10 @@ void printConfigToSerial() {
   Serial.println(dimEndMinute);
   Serial.print(F("Dimming Brightness: "));
   Serial.println(dimBrightness);
+  Serial.print(F("Dimming Fade Seconds: "));
+  Serial.println(dimFadeSeconds);
+  Serial.print(F("Weather Max Age (min): "));
+  Serial.println(weatherMaxAge);
   Serial.print(F("Countdown Enabled: "));
   Serial.println(countdownEnabled ? "Yes" : "No");
   Serial.print(F("Countdown Target Timestamp: "));
@@ -1062,7 +2149,7 @@ void printConfigToSerial() {
   Serial.println(webhookQuietHours ? "Yes" : "No");
   Serial.print(F("YouTube Enabled: "));
   Serial.println(youtubeEnabled ? "Yes" : "No");
-  Serial.print(F("YouTube Channel ID: "));
+  Serial.print(F("YouTube Channel IDs: "));
   Serial.println(youtubeChannelId);
   Serial.print(F("YouTube Short Format: "));
   Serial.println(youtubeShortFormat ? "Yes" : "No");
@@ -1075,97 +2162,444 @@ void printConfigToSerial() {
 }
 
 // -----------------------------------------------------------------------------
-// Web Server and Captive Portal
+// Status Events
 // -----------------------------------------------------------------------------
-void handleCaptivePortal(AsyncWebServerRequest *request);
+const char *ntpStateName(NtpState state) {
+  switch (state) {
+    case NTP_SYNCING: return "syncing";
+    case NTP_SUCCESS: return "synced";
+    case NTP_FAILED: return "failed";
+    default: return "idle";
+  }
+}
 
-void setupWebServer() {
-  Serial.println(F("[WEBSERVER] Setting up web server..."));
+// Sends one "status" event holding only the fields that changed since the
+// last one (all of them after a client connects). Runs in loop(), so it reads
+// the display and weather globals from the task that writes them.
+void serviceStatusEvents() {
+  unsigned long nowMs = millis();
+  if (nowMs - lastStatusEventCheck < STATUS_EVENTS_INTERVAL_MS) return;
+  lastStatusEventCheck = nowMs;
+  if (statusEvents.count() == 0) return;
+
+  bool full = statusEventsResync;
+  statusEventsResync = false;
+
+  StatusSnapshot current;
+  current.mode = displayMode;
+  current.textHash = shownTextHash;
+  uint32_t hash = fnv1a(currentTemp.c_str());
+  hash = fnv1a(weatherDescription.c_str(), hash);
+  current.weatherHash = fnv1aByte((uint8_t)currentHumidity, hash);
+  current.queueDepth = messageQueue.size();
+  current.intensity = appliedIntensity;
+  current.ntp = ntpState;
+
+  StaticJsonDocument<512> doc;
+  if (full || current.mode != sentStatus.mode) {
+    doc["mode"] = current.mode;
+    doc["modeName"] = displayModeName(current.mode);
+  }
+  if (full || current.textHash != sentStatus.textHash) {
+    doc["text"] = shownText;
+  }
+  if (full || current.weatherHash != sentStatus.weatherHash) {
+    JsonObject weather = doc.createNestedObject("weather");
+    weather["temp"] = currentTemp;
+    weather["humidity"] = currentHumidity;
+    weather["description"] = weatherDescription;
+  }
+  if (full || current.queueDepth != sentStatus.queueDepth) {
+    doc["queue"] = current.queueDepth;
+  }
+  if (full || current.intensity != sentStatus.intensity) {
+    doc["brightness"] = current.intensity;
+  }
+  if (full || current.ntp != sentStatus.ntp) {
+    doc["ntp"] = ntpStateName(ntpState);
+  }
+  sentStatus = current;
+  if (doc.size() == 0) return;
 
-  server.on("/", HTTP_GET, [](AsyncWebServerRequest *request) {
-    Serial.println(F("[WEBSERVER] Request: /"));
-    request->send(LittleFS, "/index.html", "text/html");
-  });
+  char json[512];
+  serializeJson(doc, json, sizeof(json));
+  statusEvents.send(json, "status", nowMs);
+  statusEventsSent++;
+}
 
-  server.on("/css/style.css", HTTP_GET, [](AsyncWebServerRequest *request) {
-    AsyncWebServerResponse *response = request->beginResponse(LittleFS, "/css/style.css", "text/css");
-    response->addHeader("Cache-Control", "public, max-age=31536000");
-    request->send(response);
-  });
+// -----------------------------------------------------------------------------
+// Webhook Messages
+// -----------------------------------------------------------------------------
+// Only urgent messages get through while the display is dimmed
+bool webhookQuietHoursActive(int priority) {
+  return webhookQuietHours && dimmingEnabled && dimWindowActive && priority < 2;  // Kept current by updateBrightness()
+}
 
-  server.on("/js/app.js", HTTP_GET, [](AsyncWebServerRequest *request) {
-    AsyncWebServerResponse *response = request->beginResponse(LittleFS, "/js/app.js", "application/javascript");
-    response->addHeader("Cache-Control", "public, max-age=604800");
-    request->send(response);
-  });
+// The /webhook/batch key from ?key= or X-Webhook-Key, or nullptr when it can
+// only be in the body. Both arrive before the body, so a wrong key is turned
+// away without buffering or parsing anything.
+const char *webhookBatchKey(AsyncWebServerRequest *request) {
+  if (request->hasParam("key")) return request->getParam("key")->value().c_str();
+  if (request->hasHeader("X-Webhook-Key")) return request->getHeader("X-Webhook-Key")->value().c_str();
+  return nullptr;
+}
 
-  server.on("/js/login.js", HTTP_GET, [](AsyncWebServerRequest *request) {
-    AsyncWebServerResponse *response = request->beginResponse(LittleFS, "/js/login.js", "application/javascript");
-    response->addHeader("Cache-Control", "public, max-age=604800");
-    request->send(response);
-  });
+// Shared by /webhook and /webhook/batch. text is normalized in place.
+// scrollMode: 1 = scroll, 0 = static, -1 = scroll if longer than 8 chars.
+WebhookPushResult queueWebhookMessage(String &text, int priority, long durationSec, int scrollMode, long ttlSec, uint32_t source) {
+  text = normalizeDisplayText(text);
+  uint32_t duration = constrain(durationSec, 1L, 3600L) * 1000UL;
+  bool scroll = scrollMode < 0 ? (text.length() > 8) : scrollMode == 1;
+  uint32_t ttl = constrain(ttlSec, 0L, 86400L) * 1000UL;  // 0 keeps the message until it is shown
+
+  // Full queue: displaces the oldest, least urgent message or rejects
+  WEBHOOK_LOCK();
+  WebhookPushResult result = messageQueue.push(text.c_str(), priority, duration, scroll, ttl, source, millis());
+  WEBHOOK_UNLOCK();
+
+  if (result == WEBHOOK_TOO_LONG) {
+    Serial.printf("[WEBHOOK] Message refused: %u chars, at most %d fit\n", text.length(), WEBHOOK_TEXT_MAX - 1);
+  } else if (result != WEBHOOK_REJECTED) {
+    Serial.printf("[WEBHOOK] Message %s: %s (priority=%d)\n",
+                  result == WEBHOOK_COALESCED ? "coalesced" : "queued", text.c_str(), priority);
+  }
+  return result;
+}
+
+// -----------------------------------------------------------------------------
+// Metrics
+// -----------------------------------------------------------------------------
+#if ENABLE_METRICS
+// Values are sampled without locking, so on ESP32 a scrape taken while loop()
+// records may be one sample behind in places; counters never go backwards.
+void metricsLoopTick() {
+  unsigned long nowUs = micros();
+  if (lastLoopEntryUs != 0) loopIntervalHistogram.record(nowUs - lastLoopEntryUs);
+  lastLoopEntryUs = nowUs;
+}
+
+FetchOutcome fetchOutcome(int httpCode, bool parsed) {
+  if (httpCode == HTTP_CODE_OK) return parsed ? FETCH_OK : FETCH_PARSE_ERROR;
+  if (httpCode == HTTP_CODE_NOT_MODIFIED) return FETCH_NOT_MODIFIED;
+  return httpCode < 0 ? FETCH_TRANSPORT_ERROR : FETCH_HTTP_ERROR;
+}
+
+void recordFetch(FetchProvider provider, unsigned long durationMs, FetchOutcome outcome) {
+  fetchMetrics[provider].duration.record(durationMs);
+  fetchMetrics[provider].outcomes[outcome]++;
+}
+
+// Routes are registered once from setupWebServer(); uri must be a literal
+RouteMetric *registerRouteMetric(const char *uri) {
+  for (uint8_t i = 0; i < routeMetricCount; i++) {
+    if (strcmp(routeMetrics[i].uri, uri) == 0) return &routeMetrics[i];
+  }
+  if (routeMetricCount >= METRICS_MAX_ROUTES) return nullptr;
+  RouteMetric *route = &routeMetrics[routeMetricCount++];
+  route->uri = uri;
+  return route;
+}
+
+void recordRoute(RouteMetric *route, uint32_t elapsedUs) {
+  route->count++;
+  route->totalUs += elapsedUs;
+  if (elapsedUs > route->maxUs) route->maxUs = elapsedUs;
+  handlerHistogram.record(elapsedUs);
+}
+
+// value / unitsPerSecond as a decimal without trailing zeros (no float printf)
+const char *formatSeconds(char *buf, size_t len, uint64_t value, uint32_t unitsPerSecond) {
+  int digits = unitsPerSecond == 1000000 ? 6 : 3;
+  snprintf(buf, len, "%lu.%0*lu", (unsigned long)(value / unitsPerSecond), digits, (unsigned long)(value % unitsPerSecond));
+  char *end = buf + strlen(buf) - 1;
+  while (*end == '0') *end-- = '\0';
+  if (*end == '.') *end = '\0';
+  return buf;
+}
+
+void printMetricHeader(Print &out, const char *name, const char *type, const char *help) {
+  out.printf("# HELP %s %s\n# TYPE %s %s\n", name, help, name, type);
+}
+
+// Bucket, sum and count lines of one histogram series; labels may be ""
+void printHistogram(Print &out, const char *name, const char *labels, const LatencyHistogram &h, uint32_t unitsPerSecond) {
+  char value[24];
+  const char *sep = labels[0] ? "," : "";
+  for (uint8_t i = 0; i < h.buckets(); i++) {
+    out.printf("%s_bucket{%s%sle=\"%s\"} %lu\n", name, labels, sep,
+               formatSeconds(value, sizeof(value), h.bound(i), unitsPerSecond), (unsigned long)h.cumulative(i));
+  }
+  out.printf("%s_bucket{%s%sle=\"+Inf\"} %lu\n", name, labels, sep, (unsigned long)h.count());
+  const char *open = labels[0] ? "{" : "";
+  const char *close = labels[0] ? "}" : "";
+  out.printf("%s_sum%s%s%s %s\n", name, open, labels, close, formatSeconds(value, sizeof(value), h.sum(), unitsPerSecond));
+  out.printf("%s_count%s%s%s %lu\n", name, open, labels, close, (unsigned long)h.count());
+}
+
+void sendMetrics(AsyncWebServerRequest *request) {
+  static const char *const providerNames[FETCH_PROVIDER_COUNT] = { "weather", "youtube", "nightscout" };
+  static const char *const outcomeNames[FETCH_OUTCOME_COUNT] = { "ok", "http_error", "parse_error", "transport_error", "not_modified" };
+  char value[24];
+  char labels[48];
+
+  metricsScrapes++;
+  AsyncResponseStream *out = request->beginResponseStream("text/plain; version=0.0.4; charset=utf-8");
+
+  printMetricHeader(*out, "esptimecast_uptime_seconds", "gauge", "Seconds since boot.");
+  out->printf("esptimecast_uptime_seconds %lu\n", millis() / 1000);
+
+  // Boot milestones, once reached
+  if (bootWifiMs) {
+    printMetricHeader(*out, "esptimecast_boot_wifi_seconds", "gauge", "Time from boot to WiFi connected.");
+    out->printf("esptimecast_boot_wifi_seconds{path=\"%s\"} %s\n", bootFastPath ? "fast" : "scan",
+                formatSeconds(value, sizeof(value), bootWifiMs, 1000));
+  }
+  if (bootClockMs) {
+    printMetricHeader(*out, "esptimecast_boot_clock_seconds", "gauge", "Time from boot to the first valid NTP time.");
+    out->printf("esptimecast_boot_clock_seconds %s\n", formatSeconds(value, sizeof(value), bootClockMs, 1000));
+  }
+
+  if (ntpSyncs) {
+    int64_t offsetUs = clockDiscipline.lastOffsetUs();
+    printMetricHeader(*out, "esptimecast_ntp_offset_seconds", "gauge", "Clock offset corrected by the last NTP sync.");
+    out->printf("esptimecast_ntp_offset_seconds %s%s\n", offsetUs < 0 ? "-" : "",
+                formatSeconds(value, sizeof(value), offsetUs < 0 ? -offsetUs : offsetUs, 1000000));
+    printMetricHeader(*out, "esptimecast_ntp_delay_seconds", "gauge", "Round-trip delay of the last applied NTP reply.");
+    out->printf("esptimecast_ntp_delay_seconds %s\n", formatSeconds(value, sizeof(value), clockDiscipline.lastDelayUs(), 1000000));
+  }
+  printMetricHeader(*out, "esptimecast_clock_drift_ppb", "gauge", "Learned rate error of the local clock, positive when slow.");
+  out->printf("esptimecast_clock_drift_ppb %ld\n", (long)clockDiscipline.driftPpb());
+  printMetricHeader(*out, "esptimecast_ntp_syncs_total", "counter", "NTP rounds that set the clock.");
+  out->printf("esptimecast_ntp_syncs_total %lu\n", (unsigned long)ntpSyncs);
+  printMetricHeader(*out, "esptimecast_ntp_failed_rounds_total", "counter", "NTP rounds without a usable reply.");
+  out->printf("esptimecast_ntp_failed_rounds_total %lu\n", (unsigned long)ntpRoundsFailed);
+
+  printMetricHeader(*out, "esptimecast_loop_interval_seconds", "histogram", "Time between two loop() entries.");
+  printHistogram(*out, "esptimecast_loop_interval_seconds", "", loopIntervalHistogram, 1000000);
+  printMetricHeader(*out, "esptimecast_loop_interval_max_seconds", "gauge", "Longest loop() interval since boot.");
+  out->printf("esptimecast_loop_interval_max_seconds %s\n", formatSeconds(value, sizeof(value), loopIntervalHistogram.max(), 1000000));
+  printMetricHeader(*out, "esptimecast_loop_interval_p99_seconds", "gauge", "Estimated 99th percentile loop() interval since boot.");
+  out->printf("esptimecast_loop_interval_p99_seconds %s\n", formatSeconds(value, sizeof(value), loopIntervalHistogram.percentile(99), 1000000));
+
+  printMetricHeader(*out, "esptimecast_fetch_total", "counter", "Completed fetches by provider and outcome.");
+  for (uint8_t p = 0; p < FETCH_PROVIDER_COUNT; p++) {
+    for (uint8_t o = 0; o < FETCH_OUTCOME_COUNT; o++) {
+      out->printf("esptimecast_fetch_total{provider=\"%s\",outcome=\"%s\"} %lu\n",
+                  providerNames[p], outcomeNames[o], (unsigned long)fetchMetrics[p].outcomes[o]);
+    }
+  }
+  printMetricHeader(*out, "esptimecast_fetch_duration_seconds", "histogram", "Fetch time from request to result.");
+  for (uint8_t p = 0; p < FETCH_PROVIDER_COUNT; p++) {
+    snprintf(labels, sizeof(labels), "provider=\"%s\"", providerNames[p]);
+    printHistogram(*out, "esptimecast_fetch_duration_seconds", labels, fetchMetrics[p].duration, 1000);
+  }
+
+  // Per outbound host: how each connection was made and what the TLS setup cost
+  printMetricHeader(*out, "esptimecast_tls_connections_total", "counter", "Outbound requests by host and connection kind.");
+  for (uint8_t i = 0; i < OUTBOUND_HOSTS; i++) {
+    const OutboundHost &slot = outboundHosts[i];
+    if (slot.requests == 0) continue;
+    out->printf("esptimecast_tls_connections_total{host=\"%s\",kind=\"handshake\"} %lu\n", slot.host, (unsigned long)slot.handshakes);
+    out->printf("esptimecast_tls_connections_total{host=\"%s\",kind=\"resumed\"} %lu\n", slot.host, (unsigned long)slot.resumed);
+    out->printf("esptimecast_tls_connections_total{host=\"%s\",kind=\"reused\"} %lu\n", slot.host, (unsigned long)slot.reused);
+  }
+  printMetricHeader(*out, "esptimecast_tls_connect_seconds_total", "counter", "Time spent connecting by host and connection kind.");
+  for (uint8_t i = 0; i < OUTBOUND_HOSTS; i++) {
+    const OutboundHost &slot = outboundHosts[i];
+    if (slot.requests == 0) continue;
+    out->printf("esptimecast_tls_connect_seconds_total{host=\"%s\",kind=\"handshake\"} %s\n", slot.host,
+                formatSeconds(value, sizeof(value), slot.handshakeMs, 1000));
+    out->printf("esptimecast_tls_connect_seconds_total{host=\"%s\",kind=\"resumed\"} %s\n", slot.host,
+                formatSeconds(value, sizeof(value), slot.resumedMs, 1000));
+  }
+
+  printMetricHeader(*out, "esptimecast_http_handler_seconds", "histogram", "Web handler run time, all routes.");
+  printHistogram(*out, "esptimecast_http_handler_seconds", "", handlerHistogram, 1000000);
+  // Per route: only routes that have been hit, to keep the page small
+  printMetricHeader(*out, "esptimecast_http_requests_total", "counter", "Handled requests per route.");
+  for (uint8_t i = 0; i < routeMetricCount; i++) {
+    if (routeMetrics[i].count == 0) continue;
+    out->printf("esptimecast_http_requests_total{route=\"%s\"} %lu\n", routeMetrics[i].uri, (unsigned long)routeMetrics[i].count);
+  }
+  printMetricHeader(*out, "esptimecast_http_handler_seconds_total", "counter", "Total handler run time per route.");
+  for (uint8_t i = 0; i < routeMetricCount; i++) {
+    if (routeMetrics[i].count == 0) continue;
+    out->printf("esptimecast_http_handler_seconds_total{route=\"%s\"} %s\n", routeMetrics[i].uri,
+                formatSeconds(value, sizeof(value), routeMetrics[i].totalUs, 1000000));
+  }
+  printMetricHeader(*out, "esptimecast_http_handler_max_seconds", "gauge", "Longest handler run time per route.");
+  for (uint8_t i = 0; i < routeMetricCount; i++) {
+    if (routeMetrics[i].count == 0) continue;
+    out->printf("esptimecast_http_handler_max_seconds{route=\"%s\"} %s\n", routeMetrics[i].uri,
+                formatSeconds(value, sizeof(value), routeMetrics[i].maxUs, 1000000));
+  }
+
+  uint32_t freeHeap = ESP.getFreeHeap();
+  #ifdef ESP32
+    uint32_t largestBlock = ESP.getMaxAllocHeap();
+  #else  // ESP8266
+    uint32_t largestBlock = ESP.getMaxFreeBlockSize();
+  #endif
+  printMetricHeader(*out, "esptimecast_heap_free_bytes", "gauge", "Free heap.");
+  out->printf("esptimecast_heap_free_bytes %lu\n", (unsigned long)freeHeap);
+  printMetricHeader(*out, "esptimecast_heap_largest_free_block_bytes", "gauge", "Largest allocatable block.");
+  out->printf("esptimecast_heap_largest_free_block_bytes %lu\n", (unsigned long)largestBlock);
+  printMetricHeader(*out, "esptimecast_heap_fragmentation_percent", "gauge", "100 - largest free block / free heap.");
+  out->printf("esptimecast_heap_fragmentation_percent %lu\n", freeHeap ? 100UL - (unsigned long)((uint64_t)largestBlock * 100 / freeHeap) : 0UL);
+
+  printMetricHeader(*out, "esptimecast_display_frames_pushed_total", "counter", "Frames written to the matrix.");
+  out->printf("esptimecast_display_frames_pushed_total %lu\n", (unsigned long)framesPushed);
+  printMetricHeader(*out, "esptimecast_display_frames_composed_total", "counter", "Static frames rendered, pushed or not.");
+  out->printf("esptimecast_display_frames_composed_total %lu\n", (unsigned long)framesComposed);
+
+  printMetricHeader(*out, "esptimecast_metrics_scrapes_total", "counter", "Requests to /metrics.");
+  out->printf("esptimecast_metrics_scrapes_total %lu\n", (unsigned long)metricsScrapes);
+
+  request->send(out);
+}
+#endif
+
+// server.on() that, with metrics enabled, also times the request callback
+void onRoute(const char *uri, WebRequestMethodComposite method, ArRequestHandlerFunction onRequest,
+             ArUploadHandlerFunction onUpload = nullptr, ArBodyHandlerFunction onBody = nullptr) {
+  #if ENABLE_METRICS
+    RouteMetric *route = registerRouteMetric(uri);
+    if (route) {
+      ArRequestHandlerFunction handler = onRequest;
+      onRequest = [route, handler](AsyncWebServerRequest *request) {
+        uint32_t start = micros();
+        handler(request);
+        recordRoute(route, micros() - start);
+      };
+    }
+  #endif
+  server.on(uri, method, onRequest, onUpload, onBody);
+}
 
-  server.on("/js/qrcode.min.js", HTTP_GET, [](AsyncWebServerRequest *request) {
-    AsyncWebServerResponse *response = request->beginResponse(LittleFS, "/js/qrcode.min.js.gz", "application/javascript");
-    response->addHeader("Content-Encoding", "gzip");
-    response->addHeader("Cache-Control", "public, max-age=31536000");
+// -----------------------------------------------------------------------------
+// Web Server and Captive Portal
+// -----------------------------------------------------------------------------
+void handleCaptivePortal(AsyncWebServerRequest *request);
+
+// Hashed URLs never change content, so browsers may keep them forever; the
+// logical URLs (pages, /js/app.js) are revalidated against the ETag instead
+void sendWebAsset(AsyncWebServerRequest *request, uint8_t index, bool immutable) {
+  const WebAsset &asset = webAssets[index];
+  const char *cacheControl = immutable ? "public, max-age=31536000, immutable" : "no-cache";
+
+  if (request->hasHeader("If-None-Match") && request->getHeader("If-None-Match")->value() == asset.etag) {
+    AsyncWebServerResponse *response = request->beginResponse(304);
+    response->addHeader("ETag", asset.etag);
+    response->addHeader("Cache-Control", cacheControl);
     request->send(response);
-  });
+    return;
+  }
 
-  server.on("/config.json", HTTP_GET, [](AsyncWebServerRequest *request) {
-    Serial.println(F("[WEBSERVER] Request: /config.json"));
-    File f = LittleFS.open("/config.json", "r");
-    if (!f) {
-      Serial.println(F("[WEBSERVER] Error opening /config.json"));
-      request->send(500, "application/json", "{\"error\":\"Failed to open config.json\"}");
-      return;
+  if (asset.type == "text/html") {
+    Serial.printf("[WEBSERVER] Request: %s\n", request->url().c_str());
+  }
+  AsyncWebServerResponse *response = request->beginResponse(LittleFS, asset.file, asset.type);
+  response->addHeader("Content-Encoding", "gzip");
+  response->addHeader("ETag", asset.etag);
+  response->addHeader("Cache-Control", cacheControl);
+  request->send(response);
+}
+
+// Registers every asset in /assets.json. Returns false if there is no manifest.
+bool setupWebAssets() {
+  File f = LittleFS.open(WEB_ASSET_MANIFEST, "r");
+  if (!f) return false;
+  DynamicJsonDocument doc(2048);
+  DeserializationError err = deserializeJson(doc, f);
+  f.close();
+  if (err) {
+    Serial.print(F("[WEBSERVER] Error parsing /assets.json: "));
+    Serial.println(err.f_str());
+    return false;
+  }
+
+  for (JsonObject entry : doc["assets"].as<JsonArray>()) {
+    if (webAssetCount >= WEB_ASSET_MAX) {
+      Serial.println(F("[WEBSERVER] Too many assets in /assets.json, ignoring the rest"));
+      break;
     }
-    DynamicJsonDocument doc(2048);
-    DeserializationError err = deserializeJson(doc, f);
-    f.close();
-    if (err) {
-      Serial.print(F("[WEBSERVER] Error parsing /config.json: "));
-      Serial.println(err.f_str());
-      request->send(500, "application/json", "{\"error\":\"Failed to parse config.json\"}");
-      return;
+    const char *path = entry["path"] | "";
+    const char *url = entry["url"] | path;
+    if (!path[0] || !LittleFS.exists(entry["file"] | "")) continue;
+
+    uint8_t index = webAssetCount++;
+    webAssets[index].file = entry["file"].as<const char *>();
+    webAssets[index].type = entry["type"] | "text/plain";
+    webAssets[index].etag = entry["etag"] | "";
+
+    server.on(path, HTTP_GET, [index](AsyncWebServerRequest *request) {
+      sendWebAsset(request, index, false);
+    });
+    if (strcmp(url, path) != 0) {
+      server.on(url, HTTP_GET, [index](AsyncWebServerRequest *request) {
+        sendWebAsset(request, index, true);
+      });
     }
+  }
+  Serial.printf("[WEBSERVER] Registered %u web assets\n", webAssetCount);
+  return true;
+}
+
+void setupWebServer() {
+  Serial.println(F("[WEBSERVER] Setting up web server..."));
+
+  if (!setupWebAssets()) {
+    // Filesystem image from before the asset build step
+    Serial.println(F("[WEBSERVER] /assets.json missing, serving plain pages. Re-upload the data folder."));
+    onRoute("/", HTTP_GET, [](AsyncWebServerRequest *request) {
+      Serial.println(F("[WEBSERVER] Request: /"));
+      request->send(LittleFS, "/index.html", "text/html");
+    });
+    onRoute("/login", HTTP_GET, [](AsyncWebServerRequest *request) {
+      request->send(LittleFS, "/login.html", "text/html");
+    });
+    server.serveStatic("/css/", LittleFS, "/css/");
+    server.serveStatic("/js/", LittleFS, "/js/");
+  }
 
+  onRoute("/config.json", HTTP_GET, [](AsyncWebServerRequest *request) {
+    Serial.println(F("[WEBSERVER] Request: /config.json"));
+    // Reject before touching flash
     if (!isAPMode && authEnabled && !checkAuth(request)) {
       request->send(401, "application/json", "{\"error\":\"Unauthorized\"}");
       return;
     }
 
-    // Always sanitize before sending to browser
-    doc[F("ssid")] = getSafeSsid();
-    doc[F("password")] = getSafePassword();
-    doc["adminPassword"] = getSafeAdminPassword();
-    doc["weatherApiKey"] = getSafeWeatherApiKey();
-    doc[F("mode")] = isAPMode ? "ap" : "sta";
+    if (!refreshConfigSnapshot()) {
+      Serial.println(F("[WEBSERVER] Error reading /config.json"));
+      request->send(500, "application/json", "{\"error\":\"Failed to read config.json\"}");
+      return;
+    }
 
-    if (doc["youtube"]) doc["youtube"]["apiKey"] = getSafeYoutubeApiKey();
-    doc["webhookKey"] = getSafeWebhookKey();
+    if (request->hasHeader("If-None-Match") && request->getHeader("If-None-Match")->value() == configSnapshotETag) {
+      AsyncWebServerResponse *response = request->beginResponse(304);
+      response->addHeader("ETag", configSnapshotETag);
+      response->addHeader("Cache-Control", "private, no-cache");
+      request->send(response);
+      return;
+    }
 
-    String response;
-    serializeJson(doc, response);
-    request->send(200, "application/json", response);
+    AsyncWebServerResponse *response = request->beginResponse(200, "application/json", configSnapshot);
+    response->addHeader("ETag", configSnapshotETag);
+    response->addHeader("Cache-Control", "private, no-cache");  // Revalidate every time, 304 when unchanged
+    request->send(response);
   });
 
-  server.on("/save", HTTP_POST, [](AsyncWebServerRequest *request) {
+  onRoute("/save", HTTP_POST, [](AsyncWebServerRequest *request) {
     Serial.println(F("[WEBSERVER] Request: /save"));
     DynamicJsonDocument doc(2048);
 
-    File configFile = LittleFS.open("/config.json", "r");
-    if (configFile) {
+    if (LittleFS.exists(CONFIG_PATH)) {
       Serial.println(F("[WEBSERVER] Existing config.json found, loading for update..."));
-      DeserializationError err = deserializeJson(doc, configFile);
-      configFile.close();
-      if (err) {
-        Serial.print(F("[WEBSERVER] Error parsing existing config.json: "));
-        Serial.println(err.f_str());
-      }
     } else {
       Serial.println(F("[WEBSERVER] config.json not found, starting with empty doc for save."));
     }
+    configLoadDocument(doc);  // Includes journaled and pending changes
 
     if (!checkAuth(request)) {
       request->send(401, "application/json", "{\"error\":\"Unauthorized\"}");
@@ -1180,6 +2614,7 @@ void setupWebServer() {
       if (n == "brightness") doc[n] = v.toInt();
       else if (n == "clockDuration") doc[n] = v.toInt();
       else if (n == "weatherDuration") doc[n] = v.toInt();
+      else if (n == "displayPlaylist") doc[n] = v;
       else if (n == "flipDisplay") doc[n] = (v == "true" || v == "on" || v == "1");
       else if (n == "twelveHourToggle") doc[n] = (v == "true" || v == "on" || v == "1");
       else if (n == "showDayOfWeek") doc[n] = (v == "true" || v == "on" || v == "1");
@@ -1191,6 +2626,8 @@ void setupWebServer() {
       else if (n == "dimEndHour") doc[n] = v.toInt();
       else if (n == "dimEndMinute") doc[n] = v.toInt();
       else if (n == "dimBrightness") doc[n] = v.toInt();
+      else if (n == "dimFadeSeconds") doc[n] = constrain(v.toInt(), 0, 600);
+      else if (n == "weatherMaxAge") doc[n] = constrain(v.toInt(), 10, 1440);
       else if (n == "showWeatherDescription") doc[n] = (v == "true" || v == "on" || v == "1");
       else if (n == "dimmingEnabled") doc[n] = (v == "true" || v == "on" || v == "1");
       else if (n == "weatherUnits") doc[n] = v;
@@ -1200,6 +2637,14 @@ void setupWebServer() {
           doc[n] = v;
         }
       }
+      else if (n == "staticIp" || n == "staticGateway" || n == "staticSubnet" || n == "staticDns") {
+        IPAddress addr;
+        doc[n] = addr.fromString(v) ? v : "";  // Anything unparsable means DHCP / default
+      }
+      else if (n == "nightscoutUrl") {
+        v.trim();
+        doc[n] = (v.startsWith("https://") && v.length() < NIGHTSCOUT_URL_SIZE) ? v : "";
+      }
       else if (n == "weatherProvider") doc[n] = v;
       else if (n == "weatherApiKey") {
       if (v != "********" && v.length() > 0) {
@@ -1311,64 +2756,25 @@ void setupWebServer() {
       Serial.printf("[SAVE] LittleFS total bytes: %u, used bytes: %u\n", fs_info.totalBytes, fs_info.usedBytes);
     #endif
 
-    if (LittleFS.exists("/config.json")) {
-      Serial.println(F("[SAVE] Renaming /config.json to /config.bak"));
-      LittleFS.rename("/config.json", "/config.bak");
-    }
-    File f = LittleFS.open("/config.json", "w");
-    if (!f) {
-      Serial.println(F("[SAVE] ERROR: Failed to open /config.json for writing!"));
-      DynamicJsonDocument errorDoc(256);
-      errorDoc[F("error")] = "Failed to write config file.";
-      String response;
-      serializeJson(errorDoc, response);
-      request->send(500, "application/json", response);
-      return;
-    }
-
-    size_t bytesWritten = serializeJson(doc, f);
-    Serial.printf("[SAVE] Bytes written to /config.json: %u\n", bytesWritten);
-    f.close();
-    Serial.println(F("[SAVE] /config.json file closed."));
-
-    File verify = LittleFS.open("/config.json", "r");
-    if (!verify) {
-      Serial.println(F("[SAVE] ERROR: Failed to open /config.json for reading during verification!"));
+    // Writes /config.tmp, verifies it, keeps the old file as /config.bak and
+    // only then swaps the new one in
+    if (!configWriteFull(doc, true)) {
+      Serial.println(F("[SAVE] ERROR: Config write or verification failed!"));
       DynamicJsonDocument errorDoc(256);
-      errorDoc[F("error")] = "Verification failed: Could not re-open config file.";
+      errorDoc[F("error")] = "Failed to write config file. Reboot cancelled.";
       String response;
       serializeJson(errorDoc, response);
       request->send(500, "application/json", response);
       return;
     }
 
-    while (verify.available()) {
-      verify.read();
-    }
-    verify.seek(0);
-
-    DynamicJsonDocument test(2048);
-    DeserializationError err = deserializeJson(test, verify);
-    verify.close();
-
-    if (err) {
-      Serial.print(F("[SAVE] Config corrupted after save: "));
-      Serial.println(err.f_str());
-      DynamicJsonDocument errorDoc(256);
-      errorDoc[F("error")] = String("Config corrupted. Reboot cancelled. Error: ") + err.f_str();
-      String response;
-      serializeJson(errorDoc, response);
-      request->send(500, "application/json", response);
-      return;
-    }
-
-    Serial.println(F("[SAVE] Config verification successful."));
-    DynamicJsonDocument okDoc(128);
-    okDoc[F("message")] = "Saved successfully. Rebooting...";
-    String response;
-    serializeJson(okDoc, response);
-    request->send(200, "application/json", response);
-    Serial.println(F("[WEBSERVER] Sending success response and scheduling reboot..."));
+    Serial.println(F("[SAVE] Config verification successful."));
+    DynamicJsonDocument okDoc(128);
+    okDoc[F("message")] = "Saved successfully. Rebooting...";
+    String response;
+    serializeJson(okDoc, response);
+    request->send(200, "application/json", response);
+    Serial.println(F("[WEBSERVER] Sending success response and scheduling reboot..."));
 
     request->onDisconnect([]() {
       Serial.println(F("[WEBSERVER] Client disconnected, rebooting ESP..."));
@@ -1376,11 +2782,22 @@ void setupWebServer() {
     });
   });
 
-  server.on("/restore", HTTP_POST, [](AsyncWebServerRequest *request) {
+  onRoute("/restore", HTTP_POST, [](AsyncWebServerRequest *request) {
     Serial.println(F("[WEBSERVER] Request: /restore"));
-    if (LittleFS.exists("/config.bak")) {
-      File src = LittleFS.open("/config.bak", "r");
-      if (!src) {
+    if (!checkAuth(request)) {
+      request->send(401, "application/json", "{\"error\":\"Unauthorized\"}");
+      return;
+    }
+
+    if (LittleFS.exists(CONFIG_BAK_PATH)) {
+      DynamicJsonDocument doc(2048);
+      File src = LittleFS.open(CONFIG_BAK_PATH, "r");
+      DeserializationError err = DeserializationError::InvalidInput;
+      if (src) {
+        err = deserializeJson(doc, src);
+        src.close();
+      }
+      if (err) {
         Serial.println(F("[WEBSERVER] Failed to open /config.bak"));
         DynamicJsonDocument errorDoc(128);
         errorDoc[F("error")] = "Failed to open backup file.";
@@ -1389,9 +2806,10 @@ void setupWebServer() {
         request->send(500, "application/json", response);
         return;
       }
-      File dst = LittleFS.open("/config.json", "w");
-      if (!dst) {
-        src.close();
+
+      // Journaled and pending changes were made on top of the config being replaced
+      configDiscardChanges();
+      if (!configWriteFull(doc, false)) {
         Serial.println(F("[WEBSERVER] Failed to open /config.json for writing"));
         DynamicJsonDocument errorDoc(128);
         errorDoc[F("error")] = "Failed to open config for writing.";
@@ -1401,17 +2819,6 @@ void setupWebServer() {
         return;
       }
 
-      if (!checkAuth(request)) {
-        request->send(401, "application/json", "{\"error\":\"Unauthorized\"}");
-        return;
-      }
-
-      while (src.available()) {
-        dst.write(src.read());
-      }
-      src.close();
-      dst.close();
-
       DynamicJsonDocument okDoc(128);
       okDoc[F("message")] = "✅ Backup restored! Device will now reboot.";
       String response;
@@ -1432,7 +2839,7 @@ void setupWebServer() {
     }
   });
 
-  server.on("/clear_wifi", HTTP_POST, [](AsyncWebServerRequest *request) {
+  onRoute("/clear_wifi", HTTP_POST, [](AsyncWebServerRequest *request) {
     Serial.println(F("[WEBSERVER] Request: /clear_wifi"));
     clearWiFiCredentialsInConfig();
 
@@ -1448,7 +2855,7 @@ void setupWebServer() {
     });
   });
 
-  server.on("/ap_status", HTTP_GET, [](AsyncWebServerRequest *request) {
+  onRoute("/ap_status", HTTP_GET, [](AsyncWebServerRequest *request) {
     Serial.print(F("[WEBSERVER] Request: /ap_status. isAPMode = "));
     Serial.println(isAPMode);
     String json = "{\"isAP\": ";
@@ -1457,7 +2864,7 @@ void setupWebServer() {
     request->send(200, "application/json", json);
   });
 
-  server.on("/set_brightness", HTTP_POST, [](AsyncWebServerRequest *request) {
+  onRoute("/set_brightness", HTTP_POST, [](AsyncWebServerRequest *request) {
     if (!request->hasParam("value", true)) {
       request->send(400, "application/json", "{\"error\":\"Missing value\"}");
       return;
@@ -1467,6 +2874,7 @@ void setupWebServer() {
     // Handle "off" request
     if (newBrightness == -1) {
       P.displayShutdown(true);  // Fully shut down display driver
+      invalidateRenderCache();
       P.displayClear();
       displayOff = true;
       Serial.println("[WEBSERVER] Display set to OFF (shutdown mode)");
@@ -1480,8 +2888,9 @@ void setupWebServer() {
 
     // Only run robust clear/reset when coming from "off"
     if (displayOff) {
-      P.setIntensity(newBrightness);
-      advanceDisplayModeSafe();
+      writeIntensity(newBrightness);
+      displayModesDirty = true;
+      advanceDisplayMode();
       P.displayShutdown(false);
       brightness = newBrightness;
       displayOff = false;
@@ -1489,14 +2898,14 @@ void setupWebServer() {
     } else {
       // Display already on, just set brightness
       brightness = newBrightness;
-      P.setIntensity(brightness);
+      writeIntensity(brightness);
       Serial.printf("[WEBSERVER] Set brightness to %d\n", brightness);
     }
 
     request->send(200, "application/json", "{\"ok\":true}");
   });
 
-  server.on("/set_flip", HTTP_POST, [](AsyncWebServerRequest *request) {
+  onRoute("/set_flip", HTTP_POST, [](AsyncWebServerRequest *request) {
     bool flip = false;
     if (request->hasParam("value", true)) {
       String v = request->getParam("value", true)->value();
@@ -1505,11 +2914,12 @@ void setupWebServer() {
     flipDisplay = flip;
     P.setZoneEffect(0, flipDisplay, PA_FLIP_UD);
     P.setZoneEffect(0, flipDisplay, PA_FLIP_LR);
+    invalidateRenderCache();  // Redraw a static frame in the new orientation
     Serial.printf("[WEBSERVER] Set flipDisplay to %d\n", flipDisplay);
     request->send(200, "application/json", "{\"ok\":true}");
   });
 
-  server.on("/set_twelvehour", HTTP_POST, [](AsyncWebServerRequest *request) {
+  onRoute("/set_twelvehour", HTTP_POST, [](AsyncWebServerRequest *request) {
     bool twelveHour = false;
     if (request->hasParam("value", true)) {
       String v = request->getParam("value", true)->value();
@@ -1520,7 +2930,7 @@ void setupWebServer() {
     request->send(200, "application/json", "{\"ok\":true}");
   });
 
-  server.on("/set_dayofweek", HTTP_POST, [](AsyncWebServerRequest *request) {
+  onRoute("/set_dayofweek", HTTP_POST, [](AsyncWebServerRequest *request) {
     bool showDay = false;
     if (request->hasParam("value", true)) {
       String v = request->getParam("value", true)->value();
@@ -1531,18 +2941,19 @@ void setupWebServer() {
     request->send(200, "application/json", "{\"ok\":true}");
   });
 
-  server.on("/set_showdate", HTTP_POST, [](AsyncWebServerRequest *request) {
+  onRoute("/set_showdate", HTTP_POST, [](AsyncWebServerRequest *request) {
     bool showDateVal = false;
     if (request->hasParam("value", true)) {
       String v = request->getParam("value", true)->value();
       showDateVal = (v == "1" || v == "true" || v == "on");
     }
     showDate = showDateVal;
+    displayModesDirty = true;
     Serial.printf("[WEBSERVER] Set showDate to %d\n", showDate);
     request->send(200, "application/json", "{\"ok\":true}");
   });
 
-  server.on("/set_humidity", HTTP_POST, [](AsyncWebServerRequest *request) {
+  onRoute("/set_humidity", HTTP_POST, [](AsyncWebServerRequest *request) {
     bool showHumidityNow = false;
     if (request->hasParam("value", true)) {
       String v = request->getParam("value", true)->value();
@@ -1553,7 +2964,7 @@ void setupWebServer() {
     request->send(200, "application/json", "{\"ok\":true}");
   });
 
-  server.on("/set_colon_blink", HTTP_POST, [](AsyncWebServerRequest *request) {
+  onRoute("/set_colon_blink", HTTP_POST, [](AsyncWebServerRequest *request) {
     bool enableBlink = false;
     if (request->hasParam("value", true)) {
       String v = request->getParam("value", true)->value();
@@ -1564,7 +2975,7 @@ void setupWebServer() {
     request->send(200, "application/json", "{\"ok\":true}");
   });
 
-  server.on("/set_language", HTTP_POST, [](AsyncWebServerRequest *request) {
+  onRoute("/set_language", HTTP_POST, [](AsyncWebServerRequest *request) {
     if (!request->hasParam("value", true)) {
       request->send(400, "application/json", "{\"error\":\"Missing value\"}");
       return;
@@ -1575,6 +2986,7 @@ void setupWebServer() {
     lang.toLowerCase();  // Normalize to lowercase
 
     strlcpy(language, lang.c_str(), sizeof(language));              // Safe copy to char[]
+    activeWeatherTerms = findWeatherTerms(language);
     Serial.printf("[WEBSERVER] Set language to '%s'\n", language);  // Use quotes for debug
 
     shouldFetchWeatherNow = true;
@@ -1582,7 +2994,7 @@ void setupWebServer() {
     request->send(200, "application/json", "{\"ok\":true}");
   });
 
-  server.on("/set_weatherdesc", HTTP_POST, [](AsyncWebServerRequest *request) {
+  onRoute("/set_weatherdesc", HTTP_POST, [](AsyncWebServerRequest *request) {
     bool showDesc = false;
     if (request->hasParam("value", true)) {
       String v = request->getParam("value", true)->value();
@@ -1598,11 +3010,12 @@ void setupWebServer() {
     }
 
     showWeatherDescription = showDesc;
+    displayModesDirty = true;
     Serial.printf("[WEBSERVER] Set Show Weather Description to %d\n", showWeatherDescription);
     request->send(200, "application/json", "{\"ok\":true}");
   });
 
-  server.on("/set_units", HTTP_POST, [](AsyncWebServerRequest *request) {
+  onRoute("/set_units", HTTP_POST, [](AsyncWebServerRequest *request) {
     if (request->hasParam("value", true)) {
       String v = request->getParam("value", true)->value();
       if (v == "1" || v == "true" || v == "on") {
@@ -1620,7 +3033,7 @@ void setupWebServer() {
     }
   });
 
-  server.on("/set_countdown_enabled", HTTP_POST, [](AsyncWebServerRequest *request) {
+  onRoute("/set_countdown_enabled", HTTP_POST, [](AsyncWebServerRequest *request) {
     bool enableCountdownNow = false;
     if (request->hasParam("value", true)) {
       String v = request->getParam("value", true)->value();
@@ -1642,11 +3055,12 @@ void setupWebServer() {
     }
 
     countdownEnabled = enableCountdownNow;
+    displayModesDirty = true;
     Serial.printf("[WEBSERVER] Set Countdown Enabled to %d\n", countdownEnabled);
     request->send(200, "application/json", "{\"ok\":true}");
   });
 
-  server.on("/set_dramatic_countdown", HTTP_POST, [](AsyncWebServerRequest *request) {
+  onRoute("/set_dramatic_countdown", HTTP_POST, [](AsyncWebServerRequest *request) {
     bool enableDramaticNow = false;
     if (request->hasParam("value", true)) {
       String v = request->getParam("value", true)->value();
@@ -1672,7 +3086,7 @@ void setupWebServer() {
   });
 
   // API: Send custom message
-  server.on("/api/message", HTTP_POST, [](AsyncWebServerRequest *request) {
+  onRoute("/api/message", HTTP_POST, [](AsyncWebServerRequest *request) {
 
     if (!apiEnabled) {
       request->send(403, "application/json", "{\"error\":\"API disabled\"}");
@@ -1722,7 +3136,7 @@ void setupWebServer() {
   });
 
   // API: Get status
-  server.on("/api/status", HTTP_GET, [](AsyncWebServerRequest *request) {
+  onRoute("/api/status", HTTP_GET, [](AsyncWebServerRequest *request) {
 
     if (!apiEnabled) {
       request->send(403, "application/json", "{\"error\":\"API disabled\"}");
@@ -1753,13 +3167,13 @@ void setupWebServer() {
 
 
   // Get full system information
-  server.on("/api/info", HTTP_GET, [](AsyncWebServerRequest *request) {
+  onRoute("/api/info", HTTP_GET, [](AsyncWebServerRequest *request) {
     if (!apiEnabled) {
       request->send(403, "application/json", "{\"error\":\"API disabled\"}");
       return;
     }
 
-    DynamicJsonDocument doc(2048);
+    DynamicJsonDocument doc(4096);
 
     // System info
     doc["system"]["uptime"] = millis() / 1000;
@@ -1773,10 +3187,12 @@ void setupWebServer() {
     doc["display"]["brightness"] = brightness;
     doc["display"]["off"] = displayOff;
     doc["display"]["flipped"] = flipDisplay;
+    doc["display"]["intensityWrites"] = intensityWrites;
 
     // Config
     doc["config"]["clockDuration"] = clockDuration;
     doc["config"]["weatherDuration"] = weatherDuration;
+    doc["config"]["displayPlaylist"] = displayPlaylist;
     doc["config"]["twelveHour"] = twelveHourToggle;
     doc["config"]["showDayOfWeek"] = showDayOfWeek;
     doc["config"]["showDate"] = showDate;
@@ -1791,12 +3207,94 @@ void setupWebServer() {
     char timeFormatted[6];
     sprintf(timeFormatted, "%02d:%02d", timeinfo.tm_hour, timeinfo.tm_min);
     doc["time"]["formatted"] = timeFormatted;
+    doc["time"]["source"] = clockSource;
+    doc["time"]["server"] = ntpLastServer < 0 ? "" : (ntpLastServer == 0 ? ntpServer1 : ntpServer2);
+    doc["time"]["lastSync"] = ntpSyncs ? (long)((millis() - lastNtpSync) / 1000) : -1;
+    doc["time"]["offsetUs"] = (long)constrain(clockDiscipline.lastOffsetUs(), -2000000000LL, 2000000000LL);
+    doc["time"]["delayUs"] = clockDiscipline.lastDelayUs();
+    doc["time"]["driftPpb"] = clockDiscipline.driftPpb();
+    doc["time"]["syncs"] = ntpSyncs;
+    doc["time"]["failedRounds"] = ntpRoundsFailed;
 
     // Weather
     doc["weather"]["temp"] = currentTemp;
     doc["weather"]["humidity"] = currentHumidity;
     doc["weather"]["description"] = weatherDescription;
     doc["weather"]["lastFetch"] = weatherFetchInitiated ? (millis() - lastFetch) / 1000 : -1;
+    doc["weather"]["stale"] = weatherIsStale();
+    doc["weather"]["age"] = weatherAvailable ? (long)weatherAgeSec() : -1;
+    doc["weather"]["failures"] = weatherFailures;
+    doc["weather"]["nextFetchDelay"] = nextFetchDelay / 1000;
+
+    // Nightscout
+    if (nightscoutModeEligible()) {
+      doc["nightscout"]["readings"] = glucoseHistory.count();
+      doc["nightscout"]["failures"] = nightscoutFailures;
+      doc["nightscout"]["lastPoll"] = nightscoutLastPoll ? (long)((millis() - nightscoutLastPoll) / 1000) : -1;
+      if (glucoseHistory.count() > 0) {
+        const GlucoseReading &latest = glucoseHistory.latest();
+        doc["nightscout"]["mgdl"] = latest.mgdl;
+        doc["nightscout"]["direction"] = glucoseDirectionNames[latest.direction];
+        doc["nightscout"]["age"] = (long)now - (long)latest.time;
+        int delta;
+        if (glucoseHistory.delta(delta, 2 * NIGHTSCOUT_READING_SEC + 60)) doc["nightscout"]["delta"] = delta;
+      }
+    }
+
+    // YouTube
+    if (youtubeModeEligible()) {
+      doc["youtube"]["lastFetch"] = lastYoutubeFetch ? (long)((millis() - lastYoutubeFetch) / 1000) : -1;
+      doc["youtube"]["failed"] = youtubeFetchFailed;
+      JsonArray channels = doc["youtube"].createNestedArray("channels");
+      for (uint8_t i = 0; i < youtubeChannelCount; i++) {
+        JsonObject channel = channels.createNestedObject();
+        channel["id"] = (const char *)youtubeChannels[i].id;
+        channel["title"] = (const char *)youtubeChannels[i].title;
+        channel["subscribers"] = youtubeChannels[i].subscribers;
+      }
+    }
+
+    // Heap cost of the last fetch per provider (bytes, sampled)
+    doc["fetch"]["weatherHeapDropSampled"] = weatherFetchHeapDropSampled;
+    doc["fetch"]["youtubeHeapDropSampled"] = youtubeFetchHeapDropSampled;
+    doc["fetch"]["nightscoutHeapDropSampled"] = nightscoutFetchHeapDropSampled;
+
+    // Outbound connections per host (times in ms, summed)
+    JsonArray outbound = doc.createNestedArray("outbound");
+    for (uint8_t i = 0; i < OUTBOUND_HOSTS; i++) {
+      const OutboundHost &slot = outboundHosts[i];
+      if (slot.requests == 0) continue;
+      JsonObject host = outbound.createNestedObject();
+      host["host"] = (const char *)slot.host;
+      host["requests"] = slot.requests;
+      host["handshakes"] = slot.handshakes;
+      host["resumed"] = slot.resumed;
+      host["reused"] = slot.reused;
+      host["handshakeMs"] = slot.handshakeMs;
+      host["resumedMs"] = slot.resumedMs;
+      #ifndef ESP32
+        if (slot.mfln != MFLN_UNKNOWN) host["smallBuffers"] = slot.mfln == MFLN_SUPPORTED;
+      #endif
+    }
+    doc["loop"]["maxStallMs"] = loopStallMax;
+    doc["render"]["framesComposed"] = framesComposed;
+    doc["render"]["framesPushed"] = framesPushed;
+    doc["render"]["timeFormats"] = timeFormatsBuilt;
+    doc["config"]["journalAppends"] = configAppends;
+    doc["config"]["compactions"] = configCompactions;
+    doc["config"]["pending"] = configPending;
+    doc["config"]["snapshotBuilds"] = configSnapshotBuilds;
+    doc["webhook"]["queued"] = messageQueue.size();
+    doc["webhook"]["coalesced"] = messageQueue.coalesced;
+    doc["webhook"]["evicted"] = messageQueue.evicted;
+    doc["webhook"]["expired"] = messageQueue.expiredCount;
+    doc["webhook"]["rejected"] = messageQueue.rejected;
+    doc["events"]["clients"] = statusEvents.count();
+    doc["events"]["sent"] = statusEventsSent;
+    doc["auth"]["totpReplaysRejected"] = totp.replaysRejected;
+    doc["boot"]["wifiMs"] = bootWifiMs;
+    doc["boot"]["clockMs"] = bootClockMs;
+    doc["boot"]["fastPath"] = bootFastPath;
 
     // Countdown
     if (countdownEnabled) {
@@ -1812,7 +3310,7 @@ void setupWebServer() {
   });
 
   // Control display mode
-  server.on("/api/mode", HTTP_POST, [](AsyncWebServerRequest *request) {
+  onRoute("/api/mode", HTTP_POST, [](AsyncWebServerRequest *request) {
     if (!apiEnabled) {
       request->send(403, "application/json", "{\"error\":\"API disabled\"}");
       return;
@@ -1837,7 +3335,7 @@ void setupWebServer() {
   });
 
   // Control brightness
-  server.on("/api/brightness", HTTP_POST, [](AsyncWebServerRequest *request) {
+  onRoute("/api/brightness", HTTP_POST, [](AsyncWebServerRequest *request) {
     if (!apiEnabled) {
       request->send(403, "application/json", "{\"error\":\"API disabled\"}");
       return;
@@ -1861,7 +3359,7 @@ void setupWebServer() {
           P.displayShutdown(false);
           displayOff = false;
         }
-        P.setIntensity(brightness);
+        writeIntensity(brightness);
       }
 
       String response = "{\"status\":\"ok\",\"brightness\":" + String(brightness) + "}";
@@ -1872,7 +3370,7 @@ void setupWebServer() {
   });
 
   // Refresh weather
-  server.on("/api/weather/refresh", HTTP_POST, [](AsyncWebServerRequest *request) {
+  onRoute("/api/weather/refresh", HTTP_POST, [](AsyncWebServerRequest *request) {
     if (!apiEnabled) {
       request->send(403, "application/json", "{\"error\":\"API disabled\"}");
       return;
@@ -1883,7 +3381,7 @@ void setupWebServer() {
   });
 
   // Get weather data
-  server.on("/api/weather", HTTP_GET, [](AsyncWebServerRequest *request) {
+  onRoute("/api/weather", HTTP_GET, [](AsyncWebServerRequest *request) {
     if (!apiEnabled) {
       request->send(403, "application/json", "{\"error\":\"API disabled\"}");
       return;
@@ -1894,6 +3392,8 @@ void setupWebServer() {
     doc["humidity"] = currentHumidity;
     doc["description"] = weatherDescription;
     doc["available"] = weatherAvailable;
+    doc["stale"] = weatherIsStale();
+    doc["age"] = weatherAvailable ? (long)weatherAgeSec() : -1;
     doc["provider"] = weatherProvider == PROVIDER_OPEN_METEO ? "openmeteo" :
                       weatherProvider == PROVIDER_OPEN_WEATHER ? "openweather" : "pirateweather";
     doc["units"] = weatherUnits;
@@ -1906,7 +3406,7 @@ void setupWebServer() {
   });
 
   // Control countdown
-  server.on("/api/countdown", HTTP_POST, [](AsyncWebServerRequest *request) {
+  onRoute("/api/countdown", HTTP_POST, [](AsyncWebServerRequest *request) {
     if (!apiEnabled) {
       request->send(403, "application/json", "{\"error\":\"API disabled\"}");
       return;
@@ -1933,6 +3433,7 @@ void setupWebServer() {
     }
 
     if (changed) {
+      displayModesDirty = true;
       saveCountdownConfig(countdownEnabled, countdownTargetTimestamp, countdownLabel);
       response["status"] = "ok";
       response["countdown"]["enabled"] = countdownEnabled;
@@ -1948,18 +3449,19 @@ void setupWebServer() {
   });
 
   // Reboot device
-  server.on("/api/reboot", HTTP_POST, [](AsyncWebServerRequest *request) {
+  onRoute("/api/reboot", HTTP_POST, [](AsyncWebServerRequest *request) {
     if (!apiEnabled) {
       request->send(403, "application/json", "{\"error\":\"API disabled\"}");
       return;
     }
 
     request->send(200, "application/json", "{\"status\":\"Rebooting...\"}");
+    configFlush();
     delay(1000);
     ESP.restart();
   });
 
-  server.on("/set_api", HTTP_POST, [](AsyncWebServerRequest *request) {
+  onRoute("/set_api", HTTP_POST, [](AsyncWebServerRequest *request) {
     bool enableApi = false;
     if (request->hasParam("value", true)) {
       String v = request->getParam("value", true)->value();
@@ -1970,7 +3472,7 @@ void setupWebServer() {
     request->send(200, "application/json", "{\"ok\":true}");
   });
 
-  server.on("/set_youtube_enabled", HTTP_POST, [](AsyncWebServerRequest *request) {
+  onRoute("/set_youtube_enabled", HTTP_POST, [](AsyncWebServerRequest *request) {
     bool enableYoutube = false;
     if (request->hasParam("value", true)) {
       String v = request->getParam("value", true)->value();
@@ -1986,24 +3488,135 @@ void setupWebServer() {
     }
 
     youtubeEnabled = enableYoutube;
+    displayModesDirty = true;
     Serial.printf("[WEBSERVER] Set youtubeEnabled to %d\n", youtubeEnabled);
     request->send(200, "application/json", "{\"ok\":true}");
   });
 
-  server.on("/set_youtube_format", HTTP_POST, [](AsyncWebServerRequest *request) {
+  onRoute("/set_youtube_format", HTTP_POST, [](AsyncWebServerRequest *request) {
     bool shortFormat = false;
     if (request->hasParam("value", true)) {
       String v = request->getParam("value", true)->value();
       shortFormat = (v == "1" || v == "true" || v == "on");
     }
     youtubeShortFormat = shortFormat;
-    currentSubscriberCount = "";  // Force refresh
+    formatYoutubeChannels();  // From the stored counts, no refetch
     Serial.printf("[WEBSERVER] Set youtubeShortFormat to %d\n", youtubeShortFormat);
     request->send(200, "application/json", "{\"ok\":true}");
   });
 
+  // Batched webhook: one request, one key check, many messages. Registered
+  // before /webhook, which would otherwise match /webhook/* as well.
+  // Body: [{"message":"...","priority":1,"duration":5,"scroll":true,"ttl":600}, ...]
+  // with the key as ?key= or X-Webhook-Key, or {"key":"...","messages":[...]}
+  onRoute("/webhook/batch", HTTP_POST, [](AsyncWebServerRequest *request) {
+    Serial.println(F("[WEBHOOK] Batch request received"));
+
+    if (!webhooksEnabled) {
+      request->send(403, "application/json", "{\"error\":\"Webhooks disabled\"}");
+      return;
+    }
+    const char *key = webhookBatchKey(request);
+    if (key && !secureCompare(key, webhookKey)) {
+      Serial.println(F("[WEBHOOK] Invalid key"));
+      request->send(403, "application/json", "{\"error\":\"Invalid key\"}");
+      return;
+    }
+    char *body = (char *)request->_tempObject;  // Filled by the body callback below
+    if (request->contentLength() > WEBHOOK_BATCH_MAX_BYTES) {
+      request->send(413, "application/json", "{\"error\":\"Batch too large\"}");
+      return;
+    }
+    if (!body) {
+      request->send(400, "application/json", "{\"error\":\"Missing body\"}");
+      return;
+    }
+
+    DynamicJsonDocument doc(3072);  // Parsed in place, so only the nodes take space
+    DeserializationError err = deserializeJson(doc, body);
+    if (err) {
+      request->send(400, "application/json", "{\"error\":\"Invalid JSON\"}");
+      return;
+    }
+
+    // A key in the body can only be checked once it is parsed
+    if (!key && !secureCompare(doc["key"] | "", webhookKey)) {
+      Serial.println(F("[WEBHOOK] Invalid key"));
+      request->send(403, "application/json", "{\"error\":\"Invalid key\"}");
+      return;
+    }
+
+    JsonArray items = doc.is<JsonArray>() ? doc.as<JsonArray>() : doc["messages"].as<JsonArray>();
+    if (items.isNull()) {
+      request->send(400, "application/json", "{\"error\":\"Expected an array of messages\"}");
+      return;
+    }
+    if (items.size() > WEBHOOK_BATCH_MAX_ITEMS) {
+      request->send(413, "application/json", "{\"error\":\"Too many messages\"}");
+      return;
+    }
+
+    uint32_t source = (uint32_t)request->client()->remoteIP();
+    DynamicJsonDocument response(256 + WEBHOOK_BATCH_MAX_ITEMS * 48);
+    JsonArray results = response.createNestedArray("results");
+    int accepted = 0;
+
+    for (JsonVariant item : items) {
+      JsonObject result = results.createNestedObject();
+      const char *message = item["message"];  // nullptr if missing or not a string
+      if (!message) {
+        result["status"] = "rejected";
+        result["error"] = "missing_message";
+        continue;
+      }
+
+      int priority = item["priority"] | 1;
+      if (webhookQuietHoursActive(priority)) {
+        result["status"] = "quiet_hours";
+        continue;
+      }
+
+      JsonVariant scrollVar = item["scroll"];
+      int scrollMode = scrollVar.isNull() ? -1 : (scrollVar.is<bool>() ? scrollVar.as<bool>() : scrollVar.as<int>() != 0);
+      String text = message;
+      WebhookPushResult pushed = queueWebhookMessage(text, priority, item["duration"] | 5L,
+                                                     scrollMode, item["ttl"] | (long)(WEBHOOK_DEFAULT_TTL_MS / 1000), source);
+      if (pushed == WEBHOOK_REJECTED) {
+        result["status"] = "rejected";
+        result["error"] = "queue_full";
+      } else if (pushed == WEBHOOK_TOO_LONG) {
+        result["status"] = "rejected";
+        result["error"] = "too_long";
+      } else {
+        result["status"] = pushed == WEBHOOK_COALESCED ? "coalesced" : "queued";
+        accepted++;
+      }
+    }
+
+    response["accepted"] = accepted;
+    response["rejected"] = (int)items.size() - accepted;
+    response["queue_size"] = messageQueue.size();
+
+    String json;
+    serializeJson(response, json);
+    request->send(200, "application/json", json);
+  }, nullptr, [](AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total) {
+    // Chunks are copied into one bounded buffer; anything over the limit, or
+    // sent with a wrong key, is never buffered and the handler above answers
+    if (index == 0) {
+      if (!webhooksEnabled || total == 0 || total > WEBHOOK_BATCH_MAX_BYTES) return;
+      const char *key = webhookBatchKey(request);
+      if (key && !secureCompare(key, webhookKey)) return;
+      request->_tempObject = malloc(total + 1);  // Freed with the request
+    }
+    char *body = (char *)request->_tempObject;
+    if (!body || index + len > total) return;
+    memcpy(body + index, data, len);
+    body[index + len] = '\0';
+  });
+
   // Webhook
-  server.on("/webhook", HTTP_POST, [](AsyncWebServerRequest *request) {
+  onRoute("/webhook", HTTP_POST, [](AsyncWebServerRequest *request) {
     Serial.println(F("[WEBHOOK] Request received"));
 
     // Check if webhooks are enabled
@@ -2020,67 +3633,41 @@ void setupWebServer() {
       return;
     }
 
-    // Check quiet hours
-    if (webhookQuietHours && dimmingEnabled) {
-      time_t now = time(nullptr);
-      struct tm timeinfo;
-      localtime_r(&now, &timeinfo);
-      int currentMinutes = timeinfo.tm_hour * 60 + timeinfo.tm_min;
-      int startMinutes = dimStartHour * 60 + dimStartMinute;
-      int endMinutes = dimEndHour * 60 + dimEndMinute;
-
-      bool inQuietHours = false;
-      if (startMinutes < endMinutes) {
-        inQuietHours = (currentMinutes >= startMinutes && currentMinutes < endMinutes);
-      } else {
-        inQuietHours = (currentMinutes >= startMinutes || currentMinutes < endMinutes);
-      }
+    int priority = request->hasParam("priority", true) ?
+                   request->getParam("priority", true)->value().toInt() : 1;
 
-      if (inQuietHours) {
-        int priority = request->hasParam("priority", true) ?
-                      request->getParam("priority", true)->value().toInt() : 1;
-        if (priority < 2) {  // Only urgent messages during quiet hours
-          request->send(202, "application/json", "{\"status\":\"quiet_hours\"}");
-          return;
-        }
-      }
+    // Check quiet hours
+    if (webhookQuietHoursActive(priority)) {
+      request->send(202, "application/json", "{\"status\":\"quiet_hours\"}");
+      return;
     }
 
     // Parse message
-    WebhookMessage msg;
-    String rawMessage = request->hasParam("message", true) ?
+    String text = request->hasParam("message", true) ?
                request->getParam("message", true)->value() : "WEBHOOK";
-    msg.text = normalizeDisplayText(rawMessage);
-
-    msg.priority = request->hasParam("priority", true) ?
-                   request->getParam("priority", true)->value().toInt() : 1;
-    msg.duration = request->hasParam("duration", true) ?
-                   request->getParam("duration", true)->value().toInt() * 1000 : 5000;
-    msg.scroll = request->hasParam("scroll", true) ?
-                 request->getParam("scroll", true)->value() == "1" : (msg.text.length() > 8);
-    msg.timestamp = millis();
-
-    // Check queue size
-    if (messageQueue.size() >= (unsigned int)webhookQueueSize) {
-      // Remove oldest low-priority message or reject
-      if (msg.priority > 1) {
-        // High priority: remove oldest message
-        messageQueue.pop();
-      } else {
-        request->send(429, "application/json", "{\"error\":\"Queue full\"}");
-        return;
-      }
+    long durationSec = request->hasParam("duration", true) ?
+                       request->getParam("duration", true)->value().toInt() : 5;
+    int scrollMode = request->hasParam("scroll", true) ?
+                     (request->getParam("scroll", true)->value() == "1" ? 1 : 0) : -1;
+    // ttl in seconds, 0 keeps the message until it is shown
+    long ttlSec = request->hasParam("ttl", true) ?
+                  request->getParam("ttl", true)->value().toInt() : (long)(WEBHOOK_DEFAULT_TTL_MS / 1000);
+    uint32_t source = (uint32_t)request->client()->remoteIP();  // Coalesce repeats per sender
+
+    WebhookPushResult result = queueWebhookMessage(text, priority, durationSec, scrollMode, ttlSec, source);
+    if (result == WEBHOOK_REJECTED) {
+      request->send(429, "application/json", "{\"error\":\"Queue full\"}");
+      return;
+    }
+    if (result == WEBHOOK_TOO_LONG) {
+      request->send(413, "application/json", "{\"error\":\"Message too long\"}");
+      return;
     }
-
-    // Add to queue
-    messageQueue.push(msg);
-    Serial.printf("[WEBHOOK] Message queued: %s (priority=%d)\n",
-                  msg.text.c_str(), msg.priority);
 
     // Response
     DynamicJsonDocument response(256);
-    response["status"] = "queued";
-    response["message"] = msg.text;
+    response["status"] = result == WEBHOOK_COALESCED ? "coalesced" : "queued";
+    response["message"] = text;
     response["queue_size"] = messageQueue.size();
 
     String json;
@@ -2089,7 +3676,7 @@ void setupWebServer() {
   });
 
   // Live toggle
-  server.on("/set_webhooks", HTTP_POST, [](AsyncWebServerRequest *request) {
+  onRoute("/set_webhooks", HTTP_POST, [](AsyncWebServerRequest *request) {
     bool enable = false;
     if (request->hasParam("value", true)) {
       String v = request->getParam("value", true)->value();
@@ -2101,7 +3688,7 @@ void setupWebServer() {
   });
 
   // Login endpoint
-  server.on("/auth/login", HTTP_POST, [](AsyncWebServerRequest *request) {
+  onRoute("/auth/login", HTTP_POST, [](AsyncWebServerRequest *request) {
     String password = request->hasParam("password", true) ?
                       request->getParam("password", true)->value() : "";
     String totpCode = request->hasParam("totp", true) ?
@@ -2121,7 +3708,7 @@ void setupWebServer() {
       }
 
       if (!totp.verify(totpCode, now, 2)) {
-        Serial.println(F("[AUTH] Login failed: TOTP invalid"));
+        Serial.println(F("[AUTH] Login failed: TOTP invalid or already used"));
         request->send(401, "application/json", "{\"error\":\"Invalid credentials\"}");
         return;
       }
@@ -2143,7 +3730,7 @@ void setupWebServer() {
     request->send(200, "application/json", json);
   });
 
-  server.on("/auth/status", HTTP_GET, [](AsyncWebServerRequest *request) {
+  onRoute("/auth/status", HTTP_GET, [](AsyncWebServerRequest *request) {
     DynamicJsonDocument response(256);
     response["authEnabled"] = authEnabled;
     response["totpEnabled"] = totpEnabled;
@@ -2162,7 +3749,7 @@ void setupWebServer() {
   });
 
   // QR Code endpoint
-  server.on("/auth/qrcode", HTTP_GET, [](AsyncWebServerRequest *request) {
+  onRoute("/auth/qrcode", HTTP_GET, [](AsyncWebServerRequest *request) {
     if (strlen(totpSecretBase32) == 0) {
       request->send(404, "application/json", "{\"error\":\"No TOTP secret generated\"}");
       return;
@@ -2194,7 +3781,7 @@ void setupWebServer() {
   });
 
   // Generate TOTP endpoint
-  server.on("/auth/generate", HTTP_POST, [](AsyncWebServerRequest *request) {
+  onRoute("/auth/generate", HTTP_POST, [](AsyncWebServerRequest *request) {
     if (!checkAuth(request)) {
       request->send(401);
       return;
@@ -2203,7 +3790,7 @@ void setupWebServer() {
     request->send(200, "application/json", "{\"ok\":true}");
   });
 
-  server.on("/auth/enable", HTTP_POST, [](AsyncWebServerRequest *request) {
+  onRoute("/auth/enable", HTTP_POST, [](AsyncWebServerRequest *request) {
     if (!checkAuth(request)) {
       request->send(401, "application/json", "{\"error\":\"Unauthorized\"}");
       return;
@@ -2218,21 +3805,11 @@ void setupWebServer() {
 
     totpEnabled = enableTotp;
 
-    DynamicJsonDocument doc(2048);
-    File configFile = LittleFS.open("/config.json", "r");
-    if (configFile) {
-      deserializeJson(doc, configFile);
-      configFile.close();
-    }
-
-    doc["authEnabled"] = authEnabled;
-    doc["totpEnabled"] = totpEnabled;
-
-    File f = LittleFS.open("/config.json", "w");
-    if (f) {
-      serializeJson(doc, f);
-      f.close();
-    }
+    DynamicJsonDocument patch(128);
+    patch["authEnabled"] = authEnabled;
+    patch["totpEnabled"] = totpEnabled;
+    configUpdate(patch);
+    configFlush();  // Security settings are not debounced
 
     DynamicJsonDocument response(256);
     response["success"] = true;
@@ -2246,10 +3823,30 @@ void setupWebServer() {
     request->send(200, "application/json", json);
   });
 
-  // Login page
-  server.on("/login", HTTP_GET, [](AsyncWebServerRequest *request) {
-    request->send(LittleFS, "/login.html", "text/html");
+  // Live status push for the UI and dashboards (see serviceStatusEvents)
+  statusEvents.setFilter([](AsyncWebServerRequest *request) {
+    return apiEnabled;
+  });
+  statusEvents.onConnect([](AsyncEventSourceClient *client) {
+    if (statusEvents.count() > STATUS_EVENTS_MAX_CLIENTS) {
+      Serial.println(F("[EVENTS] Too many clients, closing new connection"));
+      client->close();
+      return;
+    }
+    client->send("connected", "hello", millis(), 5000);  // Reconnect after 5 s if dropped
+    statusEventsResync = true;
   });
+  server.addHandler(&statusEvents);
+
+  #if ENABLE_METRICS
+    onRoute("/metrics", HTTP_GET, [](AsyncWebServerRequest *request) {
+      if (!apiEnabled) {
+        request->send(403, "text/plain", "API disabled\n");
+        return;
+      }
+      sendMetrics(request);
+    });
+  #endif
 
   server.begin();
   Serial.println(F("[WEBSERVER] Web server started"));
@@ -2269,289 +3866,868 @@ bool isNumber(const char *str) {
 }
 
 // -----------------------------------------------------------------------------
-// Weather Fetching
+// Weather Cache
 // -----------------------------------------------------------------------------
-String getWeatherDescription(int code, const char* lang) {
-  const char* description = getWeatherByCode(code, lang);
-  return normalizeDisplayText(String(description), true);
+uint32_t weatherCacheCrc(const WeatherCacheRecord &rec) {
+  return configJournalCrc32((const uint8_t *)&rec, offsetof(WeatherCacheRecord, crc));
 }
 
-void fetchOpenWeather() {
-  if (millis() - lastWifiConnectTime < WIFI_STABILIZE_DELAY) {
-    Serial.println(F("[WEATHER] Skipped: WiFi stabilizing..."));
-    return;
-  }
+// Provider and coordinates; an observation fetched for other ones is not shown
+uint32_t weatherSourceHash() {
+  uint32_t hash = fnv1aByte((uint8_t)weatherProvider);
+  hash = fnv1a(openMeteoLatitude, hash);
+  hash = fnv1aByte(',', hash);
+  return fnv1a(openMeteoLongitude, hash);
+}
 
-  Serial.println(F("[WEATHER] Fetching from OpenWeatherMap..."));
+bool weatherCacheValid(const WeatherCacheRecord &rec) {
+  return rec.magic == WEATHER_CACHE_MAGIC && rec.crc == weatherCacheCrc(rec);
+}
 
-  if (strlen(weatherApiKey) == 0) {
-    Serial.println(F("[WEATHER] No API key for OpenWeatherMap"));
-    weatherAvailable = false;
-    return;
+// Seconds since the shown observation was made. Without a clock, one restored
+// from before this boot is at least as old as the uptime.
+unsigned long weatherAgeSec() {
+  time_t now = time(nullptr);
+  if (weatherObservedAt > 0 && now > 1600000000) {  // Clock is set
+    return now > weatherObservedAt ? now - weatherObservedAt : 0;
   }
+  if (!weatherFromCache) return (millis() - weatherObservedMillis) / 1000;
+  return millis() / 1000;
+}
 
-  float lat = atof(openMeteoLatitude);
-  float lon = atof(openMeteoLongitude);
+bool weatherIsStale() {
+  return weatherAvailable && (weatherFromCache || weatherAgeSec() > WEATHER_STALE_SEC);
+}
+
+// Stores the current observation: RTC memory every time, flash only when a
+// shown value changed or the stored timestamp is WEATHER_CACHE_SAVE_SEC old
+void saveWeatherCache() {
+  WeatherCacheRecord rec;
+  memset(&rec, 0, sizeof(rec));
+  rec.magic = WEATHER_CACHE_MAGIC;
+  rec.sourceHash = weatherSourceHash();
+  rec.observedAt = (uint32_t)weatherObservedAt;
+  rec.temp = (int16_t)currentTemp.toInt();
+  rec.humidity = (int8_t)constrain(currentHumidity, -1, 100);
+  rec.imperial = strcmp(weatherUnits, "imperial") == 0;
+  strlcpy(rec.language, language, sizeof(rec.language));
+  strlcpy(rec.description, weatherDescription.c_str(), sizeof(rec.description));
+  rec.crc = weatherCacheCrc(rec);
 
   #ifdef ESP32
-    String url = "https://api.openweathermap.org/data/2.5/weather?";
-  #else // ESP8266
-    String url = "http://api.openweathermap.org/data/2.5/weather?";
+    rtcWeatherCache = rec;
+  #else  // ESP8266
+    ESP.rtcUserMemoryWrite(WEATHER_RTC_OFFSET, (uint32_t *)&rec, sizeof(rec));
   #endif
-  url += "lat=" + String(lat, 6);
-  url += "&lon=" + String(lon, 6);
-  url += "&appid=" + String(weatherApiKey);
 
-  if (strcmp(language, "en") != 0) {
-    url += "&lang=" + String(language);
-  }
+  WeatherCacheRecord a = rec;
+  WeatherCacheRecord b = weatherCacheSaved;
+  a.observedAt = b.observedAt = 0;
+  a.crc = b.crc = 0;
+  bool changed = memcmp(&a, &b, sizeof(a)) != 0;
+  bool aged = rec.observedAt != 0 && rec.observedAt - weatherCacheSaved.observedAt >= WEATHER_CACHE_SAVE_SEC;
+  if (!changed && !aged) return;
 
-  if (strcmp(weatherUnits, "imperial") == 0) {
-    url += "&units=imperial";
-  } else {
-    url += "&units=metric";
+  File f = LittleFS.open(WEATHER_CACHE_PATH, "w");
+  if (!f) {
+    Serial.println(F("[WEATHER] Cannot write " WEATHER_CACHE_PATH));
+    return;
   }
+  bool ok = f.write((const uint8_t *)&rec, sizeof(rec)) == sizeof(rec);
+  f.close();
+  if (ok) weatherCacheSaved = rec;  // A torn write fails the CRC on the next boot
+}
+
+void noteWeatherObserved() {
+  time_t now = time(nullptr);
+  weatherObservedAt = now > 1600000000 ? now : 0;
+  weatherObservedMillis = millis();
+  weatherFromCache = false;
+  saveWeatherCache();
+}
 
-  Serial.print(F("[WEATHER] URL: "));
-  Serial.println(url);
+// Shows the last observation from before the reboot, if any. Run once after
+// loadConfig(); the age check in loop() drops it if it turns out too old.
+void restoreWeatherCache() {
+  WeatherCacheRecord rec;
+  bool found = false;
+  const char *source = "RTC";
 
   #ifdef ESP32
-    WiFiClientSecure client;
-    client.setInsecure();
-  #else // ESP8266
-    WiFiClient client;
+    rec = rtcWeatherCache;
+    found = weatherCacheValid(rec);
+  #else  // ESP8266
+    found = ESP.rtcUserMemoryRead(WEATHER_RTC_OFFSET, (uint32_t *)&rec, sizeof(rec)) && weatherCacheValid(rec);
   #endif
 
-  HTTPClient http;
-  http.begin(client, url);
-  http.setTimeout(5000);
-  http.setReuse(false);
-
-  int httpCode = http.GET();
-
-  if (httpCode == HTTP_CODE_OK) {
-    String payload = http.getString();
-    Serial.println(F("[WEATHER] Response received."));
-
-    StaticJsonDocument<1024> doc;
-    DeserializationError error = deserializeJson(doc, payload);
-
-    if (error) {
-      Serial.print(F("[WEATHER] JSON parse error: "));
-      Serial.println(error.f_str());
-      weatherAvailable = false;
-      http.end();
-      return;
-    }
-
-    if (doc["main"]["temp"]) {
-      float temp = doc["main"]["temp"];
-      currentTemp = String((int)round(temp)) + "º";
-      weatherAvailable = true;
-      Serial.printf("[WEATHER] Temp: %s\n", currentTemp.c_str());
-    }
-
-    if (doc["main"]["humidity"]) {
-      currentHumidity = doc["main"]["humidity"];
-      Serial.printf("[WEATHER] Humidity: %d%%\n", currentHumidity);
-    }
-
-    if (doc["weather"][0]["description"]) {
-      String desc = doc["weather"][0]["description"].as<String>();
-      weatherDescription = normalizeDisplayText(desc, true);
-      translateAPIWeatherTerms(weatherDescription, language);
-      Serial.printf("[WEATHER] Description: %s\n", weatherDescription.c_str());
+  File f = LittleFS.open(WEATHER_CACHE_PATH, "r");
+  if (f) {
+    WeatherCacheRecord stored;
+    if (f.read((uint8_t *)&stored, sizeof(stored)) == sizeof(stored) && weatherCacheValid(stored)) {
+      weatherCacheSaved = stored;
+      if (!found || stored.observedAt > rec.observedAt) {
+        rec = stored;
+        found = true;
+        source = "flash";
+      }
     }
-
-    weatherFetched = true;
-  } else if (httpCode == 401) {
-    Serial.println(F("[WEATHER] Invalid API key"));
-    weatherAvailable = false;
-  } else {
-    Serial.printf("[WEATHER] HTTP GET failed, code: %d\n", httpCode);
-    weatherAvailable = false;
+    f.close();
   }
+  if (!found) return;
 
-  http.end();
-}
-
-void fetchPirateWeather() {
-  if (millis() - lastWifiConnectTime < WIFI_STABILIZE_DELAY) {
-    Serial.println(F("[WEATHER] Skipped: WiFi stabilizing..."));
+  if (rec.sourceHash != weatherSourceHash()) {
+    Serial.println(F("[WEATHER] Cached observation is for another provider or location, ignoring it"));
     return;
   }
-
-  Serial.println(F("[WEATHER] Fetching from PirateWeather..."));
-
-  if (strlen(weatherApiKey) == 0) {
-    Serial.println(F("[WEATHER] No API key for PirateWeather"));
-    weatherAvailable = false;
+  if (rec.imperial != (strcmp(weatherUnits, "imperial") == 0)) {
+    Serial.println(F("[WEATHER] Cached observation is in other units, ignoring it"));
     return;
   }
 
-  float lat = atof(openMeteoLatitude);
-  float lon = atof(openMeteoLongitude);
+  currentTemp = String(rec.temp) + "º";
+  currentHumidity = rec.humidity;
+  rec.description[sizeof(rec.description) - 1] = '\0';
+  weatherDescription = strcmp(rec.language, language) == 0 ? rec.description : "";
+  weatherObservedAt = rec.observedAt;
+  weatherFromCache = true;
+  weatherAvailable = true;
+  displayModesDirty = true;
+  Serial.printf("[WEATHER] Restored last observation from %s: %s\n", source, currentTemp.c_str());
+}
+
+// Called from loop() about once a second
+void checkWeatherAge() {
+  if (!weatherAvailable || weatherAgeSec() <= (unsigned long)weatherMaxAge * 60UL) return;
+  Serial.println(F("[WEATHER] Last observation too old, dropping it"));
+  weatherAvailable = false;
+  displayModesDirty = true;
+}
+
+// After a success: the regular interval, or longer if the provider's max-age
+// says the data will not change sooner. After a failure: exponential backoff
+// with +-25% jitter, but never sooner than the provider's Retry-After.
+void scheduleNextWeatherFetch(const WeatherResult &result, bool ok) {
+  const unsigned long serverDelayMaxSec = WEATHER_SERVER_DELAY_MAX_MS / 1000;
+  if (ok) {
+    weatherFailures = 0;
+    nextFetchDelay = fetchInterval;
+    unsigned long maxAgeMs = min((unsigned long)result.maxAgeSec, serverDelayMaxSec) * 1000UL;
+    if (maxAgeMs > nextFetchDelay) nextFetchDelay = maxAgeMs;
+  } else {
+    if (weatherFailures < 255) weatherFailures++;
+    unsigned long backoff = WEATHER_BACKOFF_BASE_MS << min((int)weatherFailures - 1, 6);
+    if (backoff > WEATHER_BACKOFF_MAX_MS) backoff = WEATHER_BACKOFF_MAX_MS;
+    backoff = backoff * 3 / 4 + random(backoff / 2);
+    unsigned long retryAfterMs = min((unsigned long)result.retryAfterSec, serverDelayMaxSec) * 1000UL;
+    nextFetchDelay = max(backoff, retryAfterMs);
+  }
+  if (nextFetchDelay != fetchInterval) {
+    Serial.printf("[WEATHER] Next fetch in %lus\n", nextFetchDelay / 1000);
+  }
+}
 
+// -----------------------------------------------------------------------------
+// Outbound HTTPS
+// -----------------------------------------------------------------------------
+bool outboundAcquire(uint32_t waitMs) {
   #ifdef ESP32
-    String url = "https://api.pirateweather.net/forecast/";
-  #else // ESP8266
-    String url = "http://api.pirateweather.net/forecast/";
+    return xSemaphoreTake(outboundLock, pdMS_TO_TICKS(waitMs)) == pdTRUE;
+  #else  // ESP8266
+    // Everything runs in loop(), so there is nothing to wait for. The
+    // plain-HTTP weather request has its own client but counts as in flight.
+    if (outboundLocked || weatherFetchState != WEATHER_IDLE) return false;
+    outboundLocked = true;
+    return true;
   #endif
-  url += String(weatherApiKey) + "/";
-  url += String(lat, 6) + "," + String(lon, 6);
-  url += "?units=" + String(strcmp(weatherUnits, "imperial") == 0 ? "us" : "si");
-  url += "&exclude=minutely,hourly,daily,alerts,flags";
+}
 
-  Serial.print(F("[WEATHER] URL: "));
-  Serial.println(url);
+void outboundRelease() {
+  #ifdef ESP32
+    xSemaphoreGive(outboundLock);
+  #else
+    outboundLocked = false;
+  #endif
+}
 
+void setupOutbound() {
   #ifdef ESP32
-    WiFiClientSecure client;
-    client.setInsecure();
-  #else // ESP8266
-    WiFiClient client;
+    outboundLock = xSemaphoreCreateMutex();
+    outboundClient.setInsecure();
+    outboundClient.setHandshakeTimeout(OUTBOUND_TIMEOUT_MS / 1000);
+  #else  // ESP8266
+    outboundClient.setInsecure();
+    outboundClient.setTimeout(OUTBOUND_TIMEOUT_MS);
   #endif
+}
 
-  HTTPClient http;
-  http.begin(client, url);
-  http.setTimeout(5000);
-  http.setReuse(false);
+void outboundClose() {
+  outboundClient.stop();
+  outboundConnectedHost = nullptr;
+  outboundKeepAlive = false;
+}
 
-  int httpCode = http.GET();
+// Stats and session slot for a host; a new host takes the least recently
+// used slot that is not connected
+OutboundHost &outboundHost(const char *host) {
+  OutboundHost *victim = nullptr;
+  for (uint8_t i = 0; i < OUTBOUND_HOSTS; i++) {
+    OutboundHost &slot = outboundHosts[i];
+    if (strcmp(slot.host, host) == 0) return slot;
+    if (&slot == outboundConnectedHost) continue;
+    if (!victim || slot.lastUsed < victim->lastUsed) victim = &slot;
+  }
+  *victim = OutboundHost();
+  strlcpy(victim->host, host, sizeof(victim->host));
+  return *victim;
+}
 
-  if (httpCode == HTTP_CODE_OK) {
-    String payload = http.getString();
-    Serial.println(F("[WEATHER] Response received."));
+// What a step of the request in flight may still take: the step timeout, cut
+// to what is left of the budget
+uint32_t outboundTimeLeft() {
+  if (!outboundBudgeted) return OUTBOUND_TIMEOUT_MS;
+  long left = (long)(outboundDeadline - millis());
+  return left <= 0 ? 0 : min((uint32_t)left, (uint32_t)OUTBOUND_TIMEOUT_MS);
+}
 
-    StaticJsonDocument<2048> doc;
-    DeserializationError error = deserializeJson(doc, payload);
+bool outboundConnect(OutboundHost &slot, uint16_t port) {
+  outboundClose();
+  unsigned long start = millis();
+  #ifdef ESP32
+    // The core's WiFiClientSecure has no session cache, so every new
+    // connection is a full handshake; keep-alive is what saves them here
+    bool ok = outboundClient.connect(slot.host, port, outboundTimeLeft());
+    bool resumed = false;
+  #else  // ESP8266
+    // A resumed session leaves the cached parameters as they were, a full
+    // handshake replaces them
+    uint8_t before[sizeof(BearSSL::Session)];
+    memcpy(before, (const void *)&slot.session, sizeof(before));
+    bool hadSession = slot.handshakes + slot.resumed > 0;
+    if (slot.mfln == MFLN_UNKNOWN) {
+      bool supported = BearSSL::WiFiClientSecure::probeMaxFragmentLength(slot.host, port, OUTBOUND_MFLN_BYTES);
+      slot.mfln = supported ? MFLN_SUPPORTED : MFLN_UNSUPPORTED;
+      Serial.printf("[HTTPS] %s %s %d-byte TLS records\n", slot.host, supported ? "accepts" : "does not accept",
+                    OUTBOUND_MFLN_BYTES);
+    }
+    if (slot.mfln == MFLN_SUPPORTED) {
+      outboundClient.setBufferSizes(OUTBOUND_MFLN_BYTES, OUTBOUND_MFLN_BYTES);
+    } else {
+      outboundClient.setBufferSizes(OUTBOUND_DEFAULT_RX_BYTES, OUTBOUND_DEFAULT_TX_BYTES);
+    }
+    outboundClient.setSession(&slot.session);
+    outboundClient.setTimeout(outboundTimeLeft());  // Bounds the TCP connect and the handshake
+    start = millis();  // Not counting the probe
+    bool ok = outboundTimeLeft() > 0 && outboundClient.connect(slot.host, port);
+    if (!ok && slot.mfln == MFLN_UNSUPPORTED) slot.mfln = MFLN_UNKNOWN;  // The probe may have failed the same way
+    bool resumed = ok && hadSession && memcmp(before, (const void *)&slot.session, sizeof(before)) == 0;
+  #endif
+  unsigned long elapsed = millis() - start;
+  if (!ok) {
+    Serial.printf("[HTTPS] Connect to %s failed\n", slot.host);
+    return false;
+  }
 
-    if (error) {
-      Serial.print(F("[WEATHER] JSON parse error: "));
-      Serial.println(error.f_str());
-      weatherAvailable = false;
-      http.end();
-      return;
-    }
+  if (resumed) {
+    slot.resumed++;
+    slot.resumedMs += elapsed;
+  } else {
+    slot.handshakes++;
+    slot.handshakeMs += elapsed;
+  }
+  outboundConnectedHost = &slot;
+  return true;
+}
 
-    if (doc["currently"]["temperature"]) {
-      float temp = doc["currently"]["temperature"];
-      currentTemp = String((int)round(temp)) + "º";
-      weatherAvailable = true;
-      Serial.printf("[WEATHER] Temp: %s\n", currentTemp.c_str());
-    }
+// Sends the request and reads the status line and headers; the body is left
+// in outboundBody
+int outboundRequest(OutboundHost &slot, const char *path, const char *etag, OutboundResponse &response) {
+  String request = String("GET ") + (path[0] == '/' ? "" : "/") + path + " HTTP/1.0\r\n";
+  request += String("Host: ") + slot.host + "\r\n";
+  request += "User-Agent: ESPTimeCast\r\n";
+  request += "Accept: application/json\r\n";
+  if (etag && etag[0]) request += String("If-None-Match: ") + etag + "\r\n";
+  request += "Connection: keep-alive\r\n\r\n";
+  if (outboundClient.write((const uint8_t *)request.c_str(), request.length()) != request.length()) {
+    return HTTPC_ERROR_SEND_HEADER_FAILED;
+  }
 
-    if (doc["currently"]["humidity"]) {
-      float hum = doc["currently"]["humidity"];
-      currentHumidity = (int)(hum * 100);
-      Serial.printf("[WEATHER] Humidity: %d%%\n", currentHumidity);
+  outboundBody.begin(outboundClient, -1);
+  outboundBody.setTimeout(OUTBOUND_TIMEOUT_MS);
+  if (outboundBudgeted) outboundBody.setDeadline(outboundDeadline);
+  else outboundBody.clearDeadline();
+  char line[192];
+  if (!outboundBody.readLine(line, sizeof(line))) return HTTPC_ERROR_READ_TIMEOUT;
+  int status = httpStatusCode(line);
+  if (status == 0) return HTTPC_ERROR_NO_HTTP_SERVER;
+
+  long contentLength = -1;
+  bool keepAlive = false;
+  for (;;) {
+    if (!outboundBody.readLine(line, sizeof(line))) return HTTPC_ERROR_READ_TIMEOUT;
+    if (line[0] == '\0') break;
+    const char *value;
+    if ((value = httpHeaderValue(line, "Content-Length"))) {
+      contentLength = strtol(value, nullptr, 10);
+    } else if ((value = httpHeaderValue(line, "Connection"))) {
+      keepAlive = strncasecmp(value, "keep-alive", 10) == 0;
+    } else if ((value = httpHeaderValue(line, "Retry-After"))) {
+      response.retryAfterSec = parseRetryAfter(value);
+    } else if ((value = httpHeaderValue(line, "Cache-Control"))) {
+      response.maxAgeSec = parseMaxAge(value, strlen(value));
+    } else if ((value = httpHeaderValue(line, "ETag"))) {
+      strlcpy(response.etag, value, sizeof(response.etag));
     }
+  }
 
-    if (doc["currently"]["summary"]) {
-      String desc = doc["currently"]["summary"].as<String>();
-      weatherDescription = normalizeDisplayText(desc, true);
-      translateAPIWeatherTerms(weatherDescription, language);
-      Serial.printf("[WEATHER] Description: %s\n", weatherDescription.c_str());
-    }
+  // Without a length the end of the body is the end of the connection
+  outboundKeepAlive = keepAlive && contentLength >= 0;
+  outboundBody.begin(outboundClient, contentLength);
+  response.status = status;
+  return status;
+}
 
-    weatherFetched = true;
-  } else {
-    Serial.printf("[WEATHER] HTTP GET failed, code: %d\n", httpCode);
-    weatherAvailable = false;
+// GET on the shared client. A positive result is the HTTP status: the caller
+// then holds the client, reads the body from outboundBody and must call
+// outboundEnd() with the time until its next request. A negative result
+// (transport error, OUTBOUND_ERROR_BUSY) holds nothing. etag (or nullptr)
+// makes the request conditional, so an unchanged resource comes back as 304
+// without a body. waitMs is how long to wait for another request to finish;
+// loop() passes 0. budgetMs (0 = none) is one deadline for the whole request,
+// from connect to the last body byte the caller reads, for callers that run
+// it inside loop(); such a request is not retried and its body not drained.
+int outboundGet(const char *url, const char *etag, OutboundResponse &response, uint32_t waitMs, uint32_t budgetMs) {
+  response = OutboundResponse();
+  char host[48];
+  uint16_t port;
+  const char *path;
+  if (!httpsSplitUrl(url, host, sizeof(host), port, path)) return HTTPC_ERROR_CONNECTION_FAILED;
+  if (!outboundAcquire(waitMs)) return OUTBOUND_ERROR_BUSY;
+
+  outboundBudgeted = budgetMs > 0;
+  outboundDeadline = millis() + budgetMs;
+  OutboundHost &slot = outboundHost(host);
+  slot.requests++;
+  slot.lastUsed = millis();
+
+  bool reuse = outboundConnectedHost == &slot && outboundKeepAlive && outboundClient.connected() &&
+               millis() - outboundIdleSince < OUTBOUND_KEEPALIVE_MS;
+  if (reuse || outboundConnect(slot, port)) {
+    int status = outboundRequest(slot, path, etag, response);
+    if (status < 0 && reuse && !outboundBudgeted) {
+      // The server closed the idle connection in the meantime
+      outboundClose();
+      reuse = false;
+      if (outboundConnect(slot, port)) status = outboundRequest(slot, path, etag, response);
+    }
+    if (status > 0) {
+      if (reuse) slot.reused++;
+      return status;
+    }
+    outboundClose();
+    outboundRelease();
+    return status;
   }
-
-  http.end();
+  outboundRelease();
+  return HTTPC_ERROR_CONNECTION_FAILED;
 }
 
-void fetchOpenMeteo() {
-  if (millis() - lastWifiConnectTime < WIFI_STABILIZE_DELAY) {
-    Serial.println(F("[WEATHER] Skipped: WiFi stabilizing..."));
-    return;
+// Releases the client. The connection is only kept when the caller's next
+// request to the same host (nextRequestMs from now) falls inside the
+// keep-alive window: then what the parser left of the body is read so the
+// connection can serve it, unless the request had a budget. Otherwise it is
+// closed right away, which frees the TLS buffers; on ESP8266 the cached
+// session still makes the reconnect cheap.
+void outboundEnd(unsigned long nextRequestMs) {
+  if (nextRequestMs >= OUTBOUND_KEEPALIVE_MS) outboundKeepAlive = false;
+  if (outboundKeepAlive && !outboundBudgeted && outboundBody.remaining() > 0 &&
+      outboundBody.remaining() <= OUTBOUND_DRAIN_MAX) {
+    unsigned long start = millis();
+    while (!outboundBody.complete() && millis() - start < OUTBOUND_TIMEOUT_MS) {
+      if (outboundBody.read() < 0) {
+        if (!outboundClient.connected()) break;
+        delay(1);
+      }
+    }
   }
+  if (!outboundKeepAlive || !outboundBody.complete()) outboundClose();
+  outboundIdleSince = millis();
+  outboundRelease();
+}
 
-  Serial.println(F("[WEATHER] Fetching from Open-Meteo..."));
+// Called from loop(): closes a kept-alive connection nobody used in time,
+// which gives its TLS buffers back to the heap
+void serviceOutbound() {
+  if (!outboundConnectedHost || millis() - outboundIdleSince < OUTBOUND_KEEPALIVE_MS) return;
+  if (!outboundAcquire(0)) return;
+  if (outboundConnectedHost && millis() - outboundIdleSince >= OUTBOUND_KEEPALIVE_MS) outboundClose();
+  outboundRelease();
+}
 
-  float lat = atof(openMeteoLatitude);
-  float lon = atof(openMeteoLongitude);
+// -----------------------------------------------------------------------------
+// Weather Fetching
+// -----------------------------------------------------------------------------
+void sampleFetchHeapDrop(uint32_t startFreeHeap, uint32_t &drop) {
+  uint32_t freeHeap = ESP.getFreeHeap();
+  if (startFreeHeap > freeHeap && startFreeHeap - freeHeap > drop) {
+    drop = startFreeHeap - freeHeap;
+  }
+}
 
-  #ifdef ESP32
-    String url = "https://api.open-meteo.com/v1/forecast?";
-  #else // ESP8266
-    String url = "http://api.open-meteo.com/v1/forecast?";
-  #endif
-  url += "latitude=" + String(lat, 6);
-  url += "&longitude=" + String(lon, 6);
-  url += "&current=temperature_2m,relative_humidity_2m,weather_code";
+// Retry-After in delta-seconds form; the HTTP-date form is left to the backoff
+uint32_t parseRetryAfter(const char *value) {
+  while (*value == ' ') value++;
+  if (!isdigit((unsigned char)*value)) return 0;
+  return strtoul(value, nullptr, 10);
+}
 
-  if (strcmp(weatherUnits, "imperial") == 0) {
-    url += "&temperature_unit=fahrenheit";
-  } else {
-    url += "&temperature_unit=celsius";
+// max-age from a Cache-Control value, 0 if absent
+uint32_t parseMaxAge(const char *value, size_t len) {
+  for (size_t i = 0; i + 8 <= len; i++) {
+    if (strncasecmp(value + i, "max-age=", 8) == 0) return strtoul(value + i + 8, nullptr, 10);
   }
+  return 0;
+}
 
-  Serial.print(F("[WEATHER] URL: "));
-  Serial.println(url);
+// Picks the caching hints out of a raw header block ending at end
+void parseWeatherHeaders(const char *headers, const char *end, WeatherResult &result) {
+  const char *line = headers;
+  while (line < end) {
+    const char *eol = strstr(line, "\r\n");
+    if (!eol || eol > end) eol = end;
+    if (strncasecmp(line, "Retry-After:", 12) == 0) {
+      result.retryAfterSec = parseRetryAfter(line + 12);
+    } else if (strncasecmp(line, "Cache-Control:", 14) == 0) {
+      result.maxAgeSec = parseMaxAge(line + 14, eol - line - 14);
+    }
+    line = eol + 2;
+  }
+}
 
-  #ifdef ESP32
-    WiFiClientSecure client;
-    client.setInsecure();
-  #else // ESP8266
-    WiFiClient client;
-  #endif
+// Keep only the fields extractWeatherResult() reads, so the document stays
+// tiny no matter how much the provider sends.
+void buildWeatherFilter(JsonDocument &filter, WeatherProviderType provider) {
+  if (provider == PROVIDER_OPEN_WEATHER) {
+    filter["main"]["temp"] = true;
+    filter["main"]["humidity"] = true;
+    filter["weather"][0]["description"] = true;
+  } else if (provider == PROVIDER_PIRATE_WEATHER) {
+    filter["currently"]["temperature"] = true;
+    filter["currently"]["humidity"] = true;
+    filter["currently"]["summary"] = true;
+  } else {
+    filter["current"]["temperature_2m"] = true;
+    filter["current"]["relative_humidity_2m"] = true;
+    filter["current"]["weather_code"] = true;
+  }
+}
 
-  HTTPClient http;
-  http.begin(client, url);
-  http.setTimeout(5000);
-  http.setReuse(false);
+void extractWeatherResult(JsonDocument &doc, WeatherProviderType provider, WeatherResult &result) {
+  if (provider == PROVIDER_OPEN_WEATHER) {
+    if (doc["main"]["temp"]) {
+      result.hasTemp = true;
+      result.temp = doc["main"]["temp"];
+    }
+    if (doc["main"]["humidity"]) {
+      result.hasHumidity = true;
+      result.humidity = doc["main"]["humidity"];
+    }
+    if (doc["weather"][0]["description"]) {
+      strlcpy(result.description, doc["weather"][0]["description"] | "", sizeof(result.description));
+    }
+  } else if (provider == PROVIDER_PIRATE_WEATHER) {
+    if (doc["currently"]["temperature"]) {
+      result.hasTemp = true;
+      result.temp = doc["currently"]["temperature"];
+    }
+    if (doc["currently"]["humidity"]) {
+      float hum = doc["currently"]["humidity"];
+      result.hasHumidity = true;
+      result.humidity = (int)(hum * 100);
+    }
+    if (doc["currently"]["summary"]) {
+      strlcpy(result.description, doc["currently"]["summary"] | "", sizeof(result.description));
+    }
+  } else {
+    if (doc["current"]["temperature_2m"]) {
+      result.hasTemp = true;
+      result.temp = doc["current"]["temperature_2m"];
+    }
+    if (doc["current"]["relative_humidity_2m"]) {
+      result.hasHumidity = true;
+      result.humidity = doc["current"]["relative_humidity_2m"];
+    }
+    if (doc["current"]["weather_code"]) {
+      result.hasCode = true;
+      result.code = doc["current"]["weather_code"];
+    }
+  }
+}
 
-  int httpCode = http.GET();
+// Runs in loop() only, so the globals read by the display and web handlers
+// change in one step once a request has fully completed. A failure keeps the
+// last observation on screen (marked stale) until it ages out.
+// Returns true if the fetch succeeded.
+bool publishWeatherResult(const WeatherResult &result) {
+  WeatherProviderType provider = weatherRequest.provider;
+  displayModesDirty = true;  // Weather availability and description may change
 
-  if (httpCode == HTTP_CODE_OK) {
-    String payload = http.getString();
+  if (result.httpCode == HTTP_CODE_OK) {
     Serial.println(F("[WEATHER] Response received."));
 
-    StaticJsonDocument<1024> doc;
-    DeserializationError error = deserializeJson(doc, payload);
-
-    if (error) {
+    if (result.error) {
       Serial.print(F("[WEATHER] JSON parse error: "));
-      Serial.println(error.f_str());
-      weatherAvailable = false;
-      http.end();
-      return;
+      Serial.println(result.error.f_str());
+      return false;
     }
 
-    if (doc["current"]["temperature_2m"]) {
-      float temp = doc["current"]["temperature_2m"];
-      currentTemp = String((int)round(temp)) + "º";
+    if (result.hasTemp) {
+      currentTemp = String((int)round(result.temp)) + "º";
       weatherAvailable = true;
       Serial.printf("[WEATHER] Temp: %s\n", currentTemp.c_str());
     }
 
-    if (doc["current"]["relative_humidity_2m"]) {
-      currentHumidity = doc["current"]["relative_humidity_2m"];
+    if (result.hasHumidity) {
+      currentHumidity = result.humidity;
       Serial.printf("[WEATHER] Humidity: %d%%\n", currentHumidity);
     }
 
-    if (doc["current"]["weather_code"]) {
-      int code = doc["current"]["weather_code"];
-      weatherDescription = getWeatherDescription(code, language);
-      Serial.printf("[WEATHER] Code: %d, Description: %s\n", code, weatherDescription.c_str());
+    if (provider == PROVIDER_OPEN_METEO) {
+      if (result.hasCode) {
+        weatherDescription = getWeatherDescription(result.code, language);
+        Serial.printf("[WEATHER] Code: %d, Description: %s\n", result.code, weatherDescription.c_str());
+      }
+    } else if (result.description[0] != '\0') {
+      weatherDescription = normalizeDisplayText(String(result.description), true);
+      translateAPIWeatherTerms(weatherDescription, activeWeatherTerms);
+      Serial.printf("[WEATHER] Description: %s\n", weatherDescription.c_str());
     }
 
     weatherFetched = true;
+    if (result.hasTemp) noteWeatherObserved();
+    return true;
+  }
+
+  if (result.httpCode == 401 && provider == PROVIDER_OPEN_WEATHER) {
+    Serial.println(F("[WEATHER] Invalid API key"));
   } else {
-    Serial.printf("[WEATHER] HTTP GET failed, code: %d\n", httpCode);
+    Serial.printf("[WEATHER] HTTP GET failed, code: %d\n", result.httpCode);
+  }
+  return false;
+}
+
+#ifdef ESP32
+TaskHandle_t weatherTaskHandle = nullptr;
+portMUX_TYPE weatherMux = portMUX_INITIALIZER_UNLOCKED;
+
+// Worker task: owns the blocking HTTPS request so loop() keeps animating.
+// weatherRequest is not touched by loop() until the state returns to READY.
+void weatherTask(void *param) {
+  for (;;) {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+    WeatherResult result = {};
+    uint32_t startFreeHeap = ESP.getFreeHeap();
+    uint32_t heapDrop = 0;
+
+    String url = String("https://") + weatherRequest.host + weatherRequest.path;
+    OutboundResponse response;
+    result.httpCode = outboundGet(url.c_str(), nullptr, response, OUTBOUND_TASK_WAIT_MS, 0);
+    sampleFetchHeapDrop(startFreeHeap, heapDrop);
+    if (result.httpCode > 0) {
+      result.retryAfterSec = response.retryAfterSec;
+      result.maxAgeSec = response.maxAgeSec;
+
+      if (result.httpCode == HTTP_CODE_OK) {
+        StaticJsonDocument<128> filter;
+        buildWeatherFilter(filter, weatherRequest.provider);
+        StaticJsonDocument<256> doc;
+        result.error = deserializeJson(doc, outboundBody, DeserializationOption::Filter(filter));
+        sampleFetchHeapDrop(startFreeHeap, heapDrop);
+        if (!result.error) {
+          extractWeatherResult(doc, weatherRequest.provider, result);
+        }
+      }
+      outboundEnd(fetchInterval);
+    }
+
+    weatherFetchHeapDropSampled = heapDrop;
+
+    portENTER_CRITICAL(&weatherMux);
+    weatherResult = result;
+    weatherFetchState = WEATHER_READY;
+    portEXIT_CRITICAL(&weatherMux);
+  }
+}
+#else  // ESP8266
+AsyncClient *weatherClient = nullptr;
+char weatherRxBuffer[WEATHER_RX_BUFFER_SIZE];
+size_t weatherRxLength = 0;
+bool weatherRxOverflow = false;
+uint32_t weatherStartFreeHeap = 0;
+
+void releaseWeatherClient() {
+  if (weatherClient) {
+    AsyncClient *c = weatherClient;
+    weatherClient = nullptr;
+    delete c;  // Closes the connection if it is still open
+  }
+}
+
+void failWeatherRequest(int httpCode) {
+  weatherResult = WeatherResult();
+  weatherResult.httpCode = httpCode;
+  weatherFetchState = WEATHER_READY;
+  releaseWeatherClient();
+}
+
+// Splits the buffered response into status line, headers and body, then
+// parses the body in place (zero-copy) through the field filter. The
+// connection is already closed (HTTP/1.0), so nothing here waits on the
+// network and no heap copy of the payload is ever made.
+void parseWeatherResponse() {
+  WeatherResult result = {};
+  weatherRxBuffer[weatherRxLength] = '\0';
+
+  result.httpCode = HTTPC_ERROR_NO_HTTP_SERVER;
+  if (strncmp(weatherRxBuffer, "HTTP/1.", 7) == 0 && weatherRxLength > 12) {
+    result.httpCode = atoi(weatherRxBuffer + 9);
+  }
+
+  char *body = strstr(weatherRxBuffer, "\r\n\r\n");
+  if (body) parseWeatherHeaders(weatherRxBuffer, body, result);
+
+  if (result.httpCode == HTTP_CODE_OK) {
+    if (!body || weatherRxOverflow) {
+      result.error = DeserializationError::IncompleteInput;
+    } else {
+      StaticJsonDocument<128> filter;
+      buildWeatherFilter(filter, weatherRequest.provider);
+      StaticJsonDocument<256> doc;
+      result.error = deserializeJson(doc, body + 4, DeserializationOption::Filter(filter));
+      if (!result.error) {
+        extractWeatherResult(doc, weatherRequest.provider, result);
+      }
+    }
+  }
+
+  sampleFetchHeapDrop(weatherStartFreeHeap, weatherFetchHeapDropSampled);
+  weatherResult = result;
+}
+#endif
+
+// Queues a request for the background engine. Returns immediately; the
+// result is published by serviceWeatherFetch() once it arrives.
+void beginWeatherRequest(WeatherProviderType provider, const char *host, const String &path) {
+  if (weatherFetchState != WEATHER_IDLE) {
+    Serial.println(F("[WEATHER] Request already in flight, skipping"));
+    return;
+  }
+
+  weatherRequest.provider = provider;
+  strlcpy(weatherRequest.host, host, sizeof(weatherRequest.host));
+  strlcpy(weatherRequest.path, path.c_str(), sizeof(weatherRequest.path));
+  weatherRequestStart = millis();
+
+  #ifdef ESP32
+    Serial.printf("[WEATHER] URL: https://%s%s\n", weatherRequest.host, weatherRequest.path);
+    if (!weatherTaskHandle) {
+      xTaskCreatePinnedToCore(weatherTask, "weather", 10240, nullptr, 1, &weatherTaskHandle, 0);
+    }
+    weatherFetchState = WEATHER_CONNECTING;
+    xTaskNotifyGive(weatherTaskHandle);
+  #else  // ESP8266
+    Serial.printf("[WEATHER] URL: http://%s%s\n", weatherRequest.host, weatherRequest.path);
+    weatherRxLength = 0;
+    weatherRxOverflow = false;
+    weatherStartFreeHeap = ESP.getFreeHeap();
+    weatherFetchHeapDropSampled = 0;
+    weatherFetchState = WEATHER_CONNECTING;
+
+    weatherClient = new AsyncClient();
+    weatherClient->onConnect([](void *arg, AsyncClient *c) {
+      if (weatherFetchState == WEATHER_CONNECTING) weatherFetchState = WEATHER_SENDING;
+    }, nullptr);
+    weatherClient->onData([](void *arg, AsyncClient *c, void *data, size_t len) {
+      size_t room = sizeof(weatherRxBuffer) - 1 - weatherRxLength;
+      if (len > room) {
+        len = room;
+        weatherRxOverflow = true;
+      }
+      memcpy(weatherRxBuffer + weatherRxLength, data, len);
+      weatherRxLength += len;
+      sampleFetchHeapDrop(weatherStartFreeHeap, weatherFetchHeapDropSampled);
+    }, nullptr);
+    weatherClient->onError([](void *arg, AsyncClient *c, int8_t error) {
+      Serial.printf("[WEATHER] Connection error: %s\n", c->errorToString(error));
+    }, nullptr);
+    weatherClient->onDisconnect([](void *arg, AsyncClient *c) {
+      if (weatherFetchState == WEATHER_RECEIVING) {
+        weatherFetchState = WEATHER_PARSING;
+      } else if (weatherFetchState == WEATHER_CONNECTING || weatherFetchState == WEATHER_SENDING) {
+        weatherResult = WeatherResult();
+        weatherResult.httpCode = HTTPC_ERROR_CONNECTION_FAILED;
+        weatherFetchState = WEATHER_READY;
+      }
+    }, nullptr);
+
+    if (!weatherClient->connect(weatherRequest.host, 80)) {
+      failWeatherRequest(HTTPC_ERROR_CONNECTION_FAILED);
+    }
+  #endif
+}
+
+// Called on every loop() pass. Each call does at most one small step.
+void serviceWeatherFetch() {
+  switch (weatherFetchState) {
+    case WEATHER_IDLE:
+      return;
+
+  #ifndef ESP32
+    case WEATHER_SENDING:
+      {
+        String request = String("GET ") + weatherRequest.path + " HTTP/1.0\r\n";
+        request += String("Host: ") + weatherRequest.host + "\r\n";
+        request += "User-Agent: ESPTimeCast\r\n";
+        request += "Accept: application/json\r\n";
+        request += "Connection: close\r\n\r\n";
+        if (weatherClient && weatherClient->space() >= request.length()) {
+          weatherClient->write(request.c_str(), request.length());
+          weatherFetchState = WEATHER_RECEIVING;
+        }
+        break;
+      }
+
+    case WEATHER_PARSING:
+      releaseWeatherClient();
+      parseWeatherResponse();
+      weatherFetchState = WEATHER_READY;
+      return;  // Publish on the next pass to spread the work
+  #endif
+
+    case WEATHER_READY:
+      {
+        #ifdef ESP32
+          portENTER_CRITICAL(&weatherMux);
+          WeatherResult result = weatherResult;
+          portEXIT_CRITICAL(&weatherMux);
+        #else
+          releaseWeatherClient();
+          WeatherResult result = weatherResult;
+        #endif
+        weatherFetchState = WEATHER_IDLE;
+        #if ENABLE_METRICS
+          recordFetch(FETCH_WEATHER, millis() - weatherRequestStart, fetchOutcome(result.httpCode, !result.error));
+        #endif
+        scheduleNextWeatherFetch(result, publishWeatherResult(result));
+        return;
+      }
+
+    default:
+      break;
+  }
+
+  #ifndef ESP32
+    // The ESP32 task is bounded by HTTPClient's own timeouts
+    if (millis() - weatherRequestStart > weatherRequestTimeout) {
+      Serial.println(F("[WEATHER] Request timed out"));
+      failWeatherRequest(HTTPC_ERROR_READ_TIMEOUT);
+    }
+  #endif
+}
+
+void fetchOpenWeather() {
+  if (millis() - lastWifiConnectTime < WIFI_STABILIZE_DELAY) {
+    Serial.println(F("[WEATHER] Skipped: WiFi stabilizing..."));
+    return;
+  }
+
+  Serial.println(F("[WEATHER] Fetching from OpenWeatherMap..."));
+
+  if (strlen(weatherApiKey) == 0) {
+    Serial.println(F("[WEATHER] No API key for OpenWeatherMap"));
+    weatherAvailable = false;
+    displayModesDirty = true;
+    return;
+  }
+
+  float lat = atof(openMeteoLatitude);
+  float lon = atof(openMeteoLongitude);
+
+  String path = "/data/2.5/weather?";
+  path += "lat=" + String(lat, 6);
+  path += "&lon=" + String(lon, 6);
+  path += "&appid=" + String(weatherApiKey);
+
+  if (strcmp(language, "en") != 0) {
+    path += "&lang=" + String(language);
+  }
+
+  if (strcmp(weatherUnits, "imperial") == 0) {
+    path += "&units=imperial";
+  } else {
+    path += "&units=metric";
+  }
+
+  beginWeatherRequest(PROVIDER_OPEN_WEATHER, "api.openweathermap.org", path);
+}
+
+void fetchPirateWeather() {
+  if (millis() - lastWifiConnectTime < WIFI_STABILIZE_DELAY) {
+    Serial.println(F("[WEATHER] Skipped: WiFi stabilizing..."));
+    return;
+  }
+
+  Serial.println(F("[WEATHER] Fetching from PirateWeather..."));
+
+  if (strlen(weatherApiKey) == 0) {
+    Serial.println(F("[WEATHER] No API key for PirateWeather"));
     weatherAvailable = false;
+    displayModesDirty = true;
+    return;
   }
 
-  http.end();
+  float lat = atof(openMeteoLatitude);
+  float lon = atof(openMeteoLongitude);
+
+  String path = "/forecast/";
+  path += String(weatherApiKey) + "/";
+  path += String(lat, 6) + "," + String(lon, 6);
+  path += "?units=" + String(strcmp(weatherUnits, "imperial") == 0 ? "us" : "si");
+  path += "&exclude=minutely,hourly,daily,alerts,flags";
+
+  beginWeatherRequest(PROVIDER_PIRATE_WEATHER, "api.pirateweather.net", path);
+}
+
+void fetchOpenMeteo() {
+  if (millis() - lastWifiConnectTime < WIFI_STABILIZE_DELAY) {
+    Serial.println(F("[WEATHER] Skipped: WiFi stabilizing..."));
+    return;
+  }
+
+  Serial.println(F("[WEATHER] Fetching from Open-Meteo..."));
+
+  float lat = atof(openMeteoLatitude);
+  float lon = atof(openMeteoLongitude);
+
+  String path = "/v1/forecast?";
+  path += "latitude=" + String(lat, 6);
+  path += "&longitude=" + String(lon, 6);
+  path += "&current=temperature_2m,relative_humidity_2m,weather_code";
+
+  if (strcmp(weatherUnits, "imperial") == 0) {
+    path += "&temperature_unit=fahrenheit";
+  } else {
+    path += "&temperature_unit=celsius";
+  }
+
+  beginWeatherRequest(PROVIDER_OPEN_METEO, "api.open-meteo.com", path);
 }
 
 void fetchWeather() {
   if (WiFi.status() != WL_CONNECTED) {
     Serial.println(F("[WEATHER] Skipped: WiFi not connected"));
     weatherAvailable = false;
+    displayModesDirty = true;
     weatherFetched = false;
     return;
   }
@@ -2563,6 +4739,7 @@ void fetchWeather() {
       lat < -90.0 || lat > 90.0 || lon < -180.0 || lon > 180.0) {
     Serial.println(F("[WEATHER] Skipped: Need valid coordinates"));
     weatherAvailable = false;
+    displayModesDirty = true;
     return;
   }
 
@@ -2579,100 +4756,420 @@ void fetchWeather() {
 // YouTube
 // -----------------------------------------------------------------------------
 
-String formatSubscriberCount(long subscribers) {
-  if (!youtubeShortFormat) {
-    return String(subscribers);
+// Splits youtubeChannelId ("UCa,UCb") into the channel table. Counts start
+// over, and so does the ETag, which belongs to the old list.
+void loadYoutubeChannelList() {
+  youtubeChannelCount = 0;
+  const char *p = youtubeChannelId;
+  while (*p && youtubeChannelCount < YOUTUBE_MAX_CHANNELS) {
+    while (*p == ',' || *p == ' ') p++;
+    const char *start = p;
+    while (*p && *p != ',' && *p != ' ') p++;
+    size_t len = p - start;
+    if (len == 0 || len >= sizeof(youtubeChannels[0].id)) continue;
+
+    YoutubeChannel &channel = youtubeChannels[youtubeChannelCount];
+    memcpy(channel.id, start, len);
+    channel.id[len] = '\0';
+    bool duplicate = false;
+    for (uint8_t i = 0; i < youtubeChannelCount; i++) {
+      if (strcmp(youtubeChannels[i].id, channel.id) == 0) duplicate = true;
+    }
+    if (duplicate) continue;
+    channel.title[0] = '\0';
+    channel.subscribers = -1;
+    youtubeChannelCount++;
   }
+  formatYoutubeChannels();
+
+  youtubeEtag[0] = '\0';
+  youtubeFetchFailed = false;
+  lastYoutubeFetch = 0;
+  youtubeFetchDelay = 0;
+  youtubeListGeneration++;  // A fetch in flight is for the old list
+  displayModesDirty = true;
+}
 
-  if (subscribers >= 1000000000) {
-    float billions = subscribers / 1000000000.0;
-    return String(billions, 3) + "B";
+void formatYoutubeChannels() {
+  for (uint8_t i = 0; i < youtubeChannelCount; i++) {
+    YoutubeChannel &channel = youtubeChannels[i];
+    if (channel.subscribers < 0) {
+      strcpy(channel.text, "---");
+    } else {
+      strlcpy(channel.text, formatSubscriberCount(channel.subscribers, youtubeShortFormat).c_str(), sizeof(channel.text));
+    }
   }
-  else if (subscribers >= 1000000) {
-    float millions = subscribers / 1000000.0;
-    return String(millions, 3) + "M";
+}
+
+// Reads the items array one channel at a time into the result's copy of the
+// channel table. Channels missing from the response (unknown ID) or hiding
+// their count are left at -1.
+bool parseYoutubeItems(Stream &stream, YoutubeResult &result, uint32_t startFreeHeap) {
+  StaticJsonDocument<128> filter;
+  filter["id"] = true;
+  filter["snippet"]["title"] = true;
+  filter["statistics"]["subscriberCount"] = true;
+
+  for (uint8_t i = 0; i < result.count; i++) result.channels[i].subscribers = -1;
+  if (!stream.find("\"items\"") || !stream.find("[")) return false;
+
+  uint8_t found = 0;
+  do {
+    StaticJsonDocument<256> item;
+    if (deserializeJson(item, stream, DeserializationOption::Filter(filter))) break;
+    const char *id = item["id"] | "";
+    for (uint8_t i = 0; i < result.count; i++) {
+      YoutubeChannel &channel = result.channels[i];
+      if (strcmp(channel.id, id) != 0) continue;
+      normalizeDisplayText(item["snippet"]["title"] | "", channel.title, sizeof(channel.title));
+      JsonVariant count = item["statistics"]["subscriberCount"];
+      channel.subscribers = count.isNull() ? -1 : count.as<long>();
+      found++;
+    }
+    sampleFetchHeapDrop(startFreeHeap, result.heapDrop);
+  } while (stream.findUntil(",", "]"));
+  return found > 0;
+}
+
+// One request for every channel. With the ETag of the last full response the
+// API answers 304 when nothing changed, and the stored counts stay as they are.
+void buildYoutubeRequest() {
+  String url = "https://www.googleapis.com/youtube/v3/channels?";
+  url += "part=snippet,statistics";
+  url += "&fields=items(id,snippet/title,statistics/subscriberCount)";
+  url += "&id=";
+  for (uint8_t i = 0; i < youtubeChannelCount; i++) {
+    if (i) url += ",";
+    url += youtubeChannels[i].id;
   }
-  else if (subscribers >= 1000) {
-    float thousands = subscribers / 1000.0;
+  url += "&key=" + String(youtubeApiKey);
+  strlcpy(youtubeRequestUrl, url.c_str(), sizeof(youtubeRequestUrl));
+  strlcpy(youtubeRequestEtag, youtubeEtag, sizeof(youtubeRequestEtag));
 
-    if (subscribers % 1000 == 0) {
-      return String((int)thousands) + "K";
-    }
+  youtubeResult.generation = youtubeListGeneration;
+  youtubeResult.count = youtubeChannelCount;
+  memcpy(youtubeResult.channels, youtubeChannels, sizeof(youtubeChannels));
+}
 
-    char buffer[20];
-    sprintf(buffer, "%.3f", thousands);
+// Runs the request set up by buildYoutubeRequest(); touches nothing but
+// youtubeResult, so it can run in a task
+void runYoutubeFetch(YoutubeResult &result) {
+  result.httpCode = 0;
+  result.parsed = false;
+  result.etag[0] = '\0';
+  result.heapDrop = 0;
+  uint32_t startFreeHeap = ESP.getFreeHeap();
 
-    String result = String(buffer);
-    while (result.endsWith("0") && result.indexOf(".") != -1) {
-      result.remove(result.length() - 1);
-    }
-    if (result.endsWith(".")) {
-      result.remove(result.length() - 1);
+  OutboundResponse response;
+  #ifdef ESP32
+    result.httpCode = outboundGet(youtubeRequestUrl, youtubeRequestEtag, response, OUTBOUND_TASK_WAIT_MS, 0);
+  #else // ESP8266
+    result.httpCode = outboundGet(youtubeRequestUrl, youtubeRequestEtag, response, 0, OUTBOUND_LOOP_BUDGET_MS);
+  #endif
+  sampleFetchHeapDrop(startFreeHeap, result.heapDrop);
+  if (result.httpCode > 0) {
+    if (result.httpCode == HTTP_CODE_OK) {
+      result.parsed = parseYoutubeItems(outboundBody, result, startFreeHeap);
+      strlcpy(result.etag, response.etag, sizeof(result.etag));
     }
-
-    return result + "K";
+    outboundEnd(youtubeFetchInterval);
   }
-  else {
-    return String(subscribers);
+}
+
+#ifdef ESP32
+TaskHandle_t youtubeTaskHandle = nullptr;
+portMUX_TYPE youtubeMux = portMUX_INITIALIZER_UNLOCKED;
+
+// Same split as nightscoutTask(): youtubeResult is not touched by loop()
+// until the state is READY
+void youtubeTask(void *param) {
+  for (;;) {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    runYoutubeFetch(youtubeResult);
+    portENTER_CRITICAL(&youtubeMux);
+    youtubeFetchState = YOUTUBE_READY;
+    portEXIT_CRITICAL(&youtubeMux);
   }
 }
+#endif
 
-void fetchYoutubeSubscribers() {
-  if (WiFi.status() != WL_CONNECTED || strlen(youtubeApiKey) == 0 || strlen(youtubeChannelId) == 0) {
-    Serial.println(F("[YouTube] Skipped: WiFi not connected or missing config"));
+void publishYoutubeResult(const YoutubeResult &result) {
+  if (result.generation != youtubeListGeneration) return;  // The list changed meanwhile; it is fetched again
+
+  lastYoutubeFetch = millis();
+  if (result.httpCode == OUTBOUND_ERROR_BUSY) {
+    youtubeFetchDelay = 1000;  // Not a failure: another fetch held the client
     return;
   }
 
-  if (millis() - lastWifiConnectTime < WIFI_STABILIZE_DELAY) {
-    Serial.println(F("[YouTube] Skipped: WiFi stabilizing..."));
+  int httpCode = result.httpCode;
+  if (httpCode == HTTP_CODE_OK) {
+    for (uint8_t i = 0; i < youtubeChannelCount; i++) {
+      strlcpy(youtubeChannels[i].title, result.channels[i].title, sizeof(youtubeChannels[i].title));
+      youtubeChannels[i].subscribers = result.channels[i].subscribers;
+    }
+    formatYoutubeChannels();
+    if (result.parsed) {
+      strlcpy(youtubeEtag, result.etag, sizeof(youtubeEtag));
+      for (uint8_t i = 0; i < youtubeChannelCount; i++) {
+        Serial.printf("[YouTube] %s: %ld (%s)\n", youtubeChannels[i].id, youtubeChannels[i].subscribers, youtubeChannels[i].text);
+      }
+    } else {
+      youtubeEtag[0] = '\0';
+      Serial.println(F("[YouTube] JSON parse error or no data"));
+    }
+  } else if (httpCode == HTTP_CODE_NOT_MODIFIED) {
+    Serial.println(F("[YouTube] Not modified"));
+  } else {
+    Serial.printf("[YouTube] HTTP error: %d\n", httpCode);
+  }
+
+  youtubeFetchFailed = !result.parsed && httpCode != HTTP_CODE_NOT_MODIFIED;
+  youtubeFetchHeapDropSampled = result.heapDrop;
+  youtubeFetchDelay = youtubeFetchFailed ? YOUTUBE_RETRY_MS : youtubeFetchInterval;
+  #if ENABLE_METRICS
+    recordFetch(FETCH_YOUTUBE, lastYoutubeFetch - youtubeRequestStart, fetchOutcome(httpCode, result.parsed));
+  #endif
+}
+
+// Called on every loop() pass: publishes a finished fetch and starts the next
+// one when it is due. Mode 6 only reads youtubeChannels.
+void serviceYoutube() {
+  if (youtubeFetchState == YOUTUBE_READY) {
+    publishYoutubeResult(youtubeResult);
+    youtubeFetchState = YOUTUBE_IDLE;
     return;
   }
+  if (youtubeFetchState != YOUTUBE_IDLE || !youtubeModeEligible()) return;
+  if (WiFi.status() != WL_CONNECTED || millis() - lastWifiConnectTime < WIFI_STABILIZE_DELAY) return;
+
+  unsigned long sinceLast = millis() - lastYoutubeFetch;
+  if (sinceLast < youtubeFetchDelay) return;
+
+  #ifndef ESP32
+    // The TLS request blocks loop() here, for OUTBOUND_LOOP_BUDGET_MS at
+    // most: wait for the plain clock face unless the fetch is a whole
+    // interval late
+    bool displayBusy = displayMode != 0 || timeline.id != TIMELINE_NONE || showingIp || processingWebhook;
+    if (displayBusy && sinceLast - youtubeFetchDelay < youtubeFetchInterval) return;
+  #endif
 
-  Serial.println(F("[YouTube] Fetching subscriber count..."));
+  buildYoutubeRequest();
+  youtubeRequestStart = millis();
+  youtubeFetchState = YOUTUBE_FETCHING;
 
-  String url = "https://www.googleapis.com/youtube/v3/channels?";
-  url += "part=statistics";
-  url += "&id=" + String(youtubeChannelId);
-  url += "&key=" + String(youtubeApiKey);
+  #ifdef ESP32
+    if (!youtubeTaskHandle) {
+      xTaskCreatePinnedToCore(youtubeTask, "youtube", 10240, nullptr, 1, &youtubeTaskHandle, 0);
+    }
+    xTaskNotifyGive(youtubeTaskHandle);
+  #else // ESP8266
+    runYoutubeFetch(youtubeResult);
+    youtubeFetchState = YOUTUBE_READY;  // Published on the next pass
+  #endif
+}
+
+// -----------------------------------------------------------------------------
+// Nightscout
+// -----------------------------------------------------------------------------
+// The configured URL with count= set to the readings wanted; any count the
+// user put in the URL is replaced
+void buildNightscoutRequestUrl(uint8_t count) {
+  char number[8];
+  snprintf(number, sizeof(number), "%u", count);
+  const char *param = strstr(nightscoutUrl, "count=");
+  if (param) {
+    size_t prefix = param + 6 - nightscoutUrl;
+    const char *rest = param + 6;
+    while (isdigit((unsigned char)*rest)) rest++;
+    snprintf(nightscoutRequestUrl, sizeof(nightscoutRequestUrl), "%.*s%s%s", (int)prefix, nightscoutUrl, number, rest);
+  } else {
+    snprintf(nightscoutRequestUrl, sizeof(nightscoutRequestUrl), "%s%ccount=%s", nightscoutUrl,
+             strchr(nightscoutUrl, '?') ? '&' : '?', number);
+  }
+}
+
+// Enough readings to fill the gap since the latest one held, so the history
+// stays continuous across failed polls and reboots
+uint8_t nightscoutFetchCount() {
+  time_t now = time(nullptr);
+  if (glucoseHistory.count() == 0 || now < 1000) return GLUCOSE_HISTORY_SIZE;
+  uint32_t latest = glucoseHistory.latest().time;
+  if ((uint32_t)now <= latest) return 2;
+  uint32_t missed = ((uint32_t)now - latest) / NIGHTSCOUT_READING_SEC + 2;
+  return missed < GLUCOSE_HISTORY_SIZE ? missed : GLUCOSE_HISTORY_SIZE;
+}
+
+// Reads the entries array one element at a time through the field filter,
+// so memory use does not grow with the number of readings asked for
+bool parseNightscoutEntries(Stream &stream, NightscoutResult &result, uint32_t startFreeHeap) {
+  StaticJsonDocument<96> filter;
+  filter["sgv"] = true;
+  filter["glucose"] = true;
+  filter["direction"] = true;
+  filter["date"] = true;
 
+  if (!stream.find("[")) return false;
+  do {
+    StaticJsonDocument<192> entry;
+    DeserializationError error = deserializeJson(entry, stream, DeserializationOption::Filter(filter));
+    if (error) break;  // Also the end of an empty array
+
+    int mgdl = entry["glucose"] | entry["sgv"] | -1;
+    if (mgdl > 0 && mgdl < 1000) {
+      GlucoseReading &reading = result.readings[result.count++];
+      reading.time = (uint32_t)((entry["date"] | 0.0) / 1000.0);  // Milliseconds since the epoch
+      reading.mgdl = mgdl;
+      reading.direction = glucoseDirectionFromName(entry["direction"]);
+    }
+    sampleFetchHeapDrop(startFreeHeap, result.heapDrop);
+  } while (result.count < GLUCOSE_HISTORY_SIZE && stream.findUntil(",", "]"));
+  return result.count > 0;
+}
+
+void runNightscoutFetch(const char *url, NightscoutResult &result) {
+  result = NightscoutResult();
+  uint32_t startFreeHeap = ESP.getFreeHeap();
+
+  OutboundResponse response;
   #ifdef ESP32
-    WiFiClientSecure client;
-    client.setInsecure();
+    result.httpCode = outboundGet(url, nullptr, response, OUTBOUND_TASK_WAIT_MS, 0);
   #else // ESP8266
-    BearSSL::WiFiClientSecure client;
-    client.setInsecure();
-    client.setBufferSizes(512, 512);
+    result.httpCode = outboundGet(url, nullptr, response, 0, OUTBOUND_LOOP_BUDGET_MS);
   #endif
+  sampleFetchHeapDrop(startFreeHeap, result.heapDrop);
+  if (result.httpCode > 0) {
+    if (result.httpCode == HTTP_CODE_OK) {
+      result.parsed = parseNightscoutEntries(outboundBody, result, startFreeHeap);
+    }
+    outboundEnd(NIGHTSCOUT_POLL_MS);
+  }
+}
 
-  HTTPClient https;
-  https.begin(client, url);
-  https.setTimeout(5000);
+#ifdef ESP32
+TaskHandle_t nightscoutTaskHandle = nullptr;
+portMUX_TYPE nightscoutMux = portMUX_INITIALIZER_UNLOCKED;
+
+// Same split as weatherTask(): the request runs here and loop() publishes the
+// result. nightscoutResult is not touched by loop() until the state is READY.
+void nightscoutTask(void *param) {
+  for (;;) {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    runNightscoutFetch(nightscoutRequestUrl, nightscoutResult);
+    portENTER_CRITICAL(&nightscoutMux);
+    nightscoutFetchState = NIGHTSCOUT_READY;
+    portEXIT_CRITICAL(&nightscoutMux);
+  }
+}
+#endif
 
-  int httpCode = https.GET();
+// Redraws the Parola user characters 1-4 that make up the trend graph
+void rebuildSparkline() {
+  uint8_t columns[MAX_DEVICES * 8];
+  glucoseHistory.sparkline(columns, sizeof(columns));
+  for (uint8_t c = 0; c < 4; c++) {
+    sparklineGlyphs[c][0] = 8;
+    memcpy(&sparklineGlyphs[c][1], columns + c * 8, 8);
+  }
+  invalidateRenderCache();
+}
 
-  if (httpCode == HTTP_CODE_OK) {
-    String payload = https.getString();
-    StaticJsonDocument<2048> doc;
-    DeserializationError error = deserializeJson(doc, payload);
+void publishNightscoutResult(const NightscoutResult &result) {
+  nightscoutLastPoll = millis();
+  if (result.httpCode == OUTBOUND_ERROR_BUSY) {
+    nightscoutPollDelay = 1000;  // Not a failure: another fetch held the client
+    return;
+  }
 
-    if (!error && doc["items"][0]["statistics"]["subscriberCount"]) {
-      long subscribers = doc["items"][0]["statistics"]["subscriberCount"].as<long>();
-      currentSubscriberCount = formatSubscriberCount(subscribers);
+  nightscoutFetchHeapDropSampled = result.heapDrop;
+  #if ENABLE_METRICS
+    recordFetch(FETCH_NIGHTSCOUT, nightscoutLastPoll - nightscoutRequestStart, fetchOutcome(result.httpCode, result.parsed));
+  #endif
 
-      Serial.printf("[YouTube] Raw count: %ld, Formatted: %s\n",
-                    subscribers, currentSubscriberCount.c_str());
+  if (!result.parsed) {
+    nightscoutFailures++;
+    nightscoutPollDelay = NIGHTSCOUT_RETRY_MS;
+    if (result.httpCode == HTTP_CODE_OK) {
+      Serial.println(F("[NIGHTSCOUT] No readings in the response"));
     } else {
-      Serial.println(F("[YouTube] JSON parse error or no data"));
-      currentSubscriberCount = "ERR";
+      Serial.printf("[NIGHTSCOUT] GET failed, code: %d\n", result.httpCode);
     }
-  } else {
-    Serial.printf("[YouTube] HTTP error: %d\n", httpCode);
-    currentSubscriberCount = "---";
+    return;
+  }
+  nightscoutFailures = 0;
+  nightscoutPollDelay = NIGHTSCOUT_POLL_MS;
+
+  // Oldest first; the history ignores readings it already holds
+  time_t now = time(nullptr);
+  uint8_t added = 0;
+  for (int i = result.count - 1; i >= 0; i--) {
+    GlucoseReading reading = result.readings[i];
+    if (reading.time == 0) {
+      // Undated entries can only be placed by arrival: take the newest one,
+      // at most once per reading interval
+      if (i != 0 || now < 1000) continue;
+      if (glucoseHistory.count() > 0 && (uint32_t)now - glucoseHistory.latest().time < NIGHTSCOUT_READING_SEC) continue;
+      reading.time = (uint32_t)now;
+    }
+    if (glucoseHistory.add(reading)) added++;
   }
 
-  https.end();
-  client.stop();
-  lastYoutubeFetch = millis();
+  if (added > 0) {
+    rebuildSparkline();
+    const GlucoseReading &latest = glucoseHistory.latest();
+    Serial.printf("[NIGHTSCOUT] %d mg/dL %s, %u new reading(s)\n", latest.mgdl, glucoseDirectionNames[latest.direction], added);
+  }
+}
+
+// Called on every loop() pass: publishes a finished poll and starts the next
+// one when it is due
+void serviceNightscout() {
+  if (nightscoutFetchState == NIGHTSCOUT_READY) {
+    publishNightscoutResult(nightscoutResult);
+    nightscoutFetchState = NIGHTSCOUT_IDLE;
+    return;
+  }
+  if (nightscoutFetchState != NIGHTSCOUT_IDLE || !nightscoutModeEligible()) return;
+  if (WiFi.status() != WL_CONNECTED || millis() - lastWifiConnectTime < WIFI_STABILIZE_DELAY) return;
+
+  unsigned long sinceLast = millis() - nightscoutLastPoll;
+  if (sinceLast < nightscoutPollDelay) return;
+
+  #ifndef ESP32
+    // The TLS request blocks loop() here, for OUTBOUND_LOOP_BUDGET_MS at
+    // most: wait for the plain clock face unless the poll is a whole
+    // interval late
+    bool displayBusy = displayMode != 0 || timeline.id != TIMELINE_NONE || showingIp || processingWebhook;
+    if (displayBusy && sinceLast - nightscoutPollDelay < NIGHTSCOUT_POLL_MS) return;
+  #endif
+
+  buildNightscoutRequestUrl(nightscoutFetchCount());
+  nightscoutRequestStart = millis();
+  nightscoutFetchState = NIGHTSCOUT_FETCHING;
+
+  #ifdef ESP32
+    if (!nightscoutTaskHandle) {
+      xTaskCreatePinnedToCore(nightscoutTask, "nightscout", 10240, nullptr, 1, &nightscoutTaskHandle, 0);
+    }
+    xTaskNotifyGive(nightscoutTaskHandle);
+  #else // ESP8266
+    runNightscoutFetch(nightscoutRequestUrl, nightscoutResult);
+    nightscoutFetchState = NIGHTSCOUT_READY;  // Published on the next pass
+  #endif
+}
+
+// Display charset arrows for the Nightscout trend directions
+char nightscoutArrow(uint8_t direction) {
+  switch (direction) {
+    case GLUCOSE_DIR_FLAT: return 139;
+    case GLUCOSE_DIR_SINGLE_UP: return 134;
+    case GLUCOSE_DIR_DOUBLE_UP: return 135;
+    case GLUCOSE_DIR_SINGLE_DOWN: return 136;
+    case GLUCOSE_DIR_DOUBLE_DOWN: return 137;
+    case GLUCOSE_DIR_FORTY_FIVE_UP: return 138;
+    case GLUCOSE_DIR_FORTY_FIVE_DOWN: return 140;
+    default: return '?';
+  }
 }
 
 // -----------------------------------------------------------------------------
@@ -2693,7 +5190,6 @@ DisplayMode key:
 
 void setup() {
   Serial.begin(115200);
-  delay(1000);
   Serial.println();
   Serial.println(F("[SETUP] Starting setup..."));
 
@@ -2708,65 +5204,293 @@ void setup() {
       yield();
     }
   }
-  Serial.println(F("[SETUP] LittleFS file system mounted successfully."));
+  Serial.println(F("[SETUP] LittleFS file system mounted successfully."));
+  recoverConfigFiles();
+
+  P.begin();  // Initialize Parola library
+
+  P.setCharSpacing(0);
+  P.setFont(mFactory);
+  for (uint8_t c = 0; c < 4; c++) {
+    sparklineGlyphs[c][0] = 8;
+    P.addChar(c + 1, sparklineGlyphs[c]);  // Parola keeps the pointer; rebuildSparkline() redraws in place
+  }
+  loadConfig();  // This function now has internal yields and prints
+  messageQueue.begin(webhookQueueSize);
+  restoreWeatherCache();
+  restoreClockFromRtc();
+  setupOutbound();
+
+  writeIntensity(brightness);
+  P.setZoneEffect(0, flipDisplay, PA_FLIP_UD);
+  P.setZoneEffect(0, flipDisplay, PA_FLIP_LR);
+
+  Serial.println(F("[SETUP] Parola (LED Matrix) initialized"));
+
+  #if defined(ESP32)
+    WiFi.setSleep(false);
+    WiFi.setAutoReconnect(true);
+    WiFi.persistent(false);
+    WiFi.onEvent([](WiFiEvent_t event, WiFiEventInfo_t info) {
+      if (event == ARDUINO_EVENT_WIFI_STA_GOT_IP) {
+        Serial.println(F("[WIFI] Got IP"));
+        lastWifiConnectTime = millis();
+      } else if (event == ARDUINO_EVENT_WIFI_STA_DISCONNECTED) {
+        Serial.println(F("[WIFI] Disconnected"));
+      }
+    });
+
+  #elif defined(ESP8266)
+    WiFi.setAutoReconnect(true);
+    WiFi.persistent(false);
+    wifiGotIPHandler = WiFi.onStationModeGotIP([](const WiFiEventStationModeGotIP &ev) {
+      Serial.println(F("[WIFI] Got IP"));
+      lastWifiConnectTime = millis();
+    });
+    wifiDisconnectHandler = WiFi.onStationModeDisconnected([](const WiFiEventStationModeDisconnected &ev) {
+      Serial.printf("[WIFI] Disconnected (reason: %d)\n", ev.reason);
+    });
+  #endif
+
+  connectWiFi();
+
+  if (isAPMode) {
+    Serial.println(F("[SETUP] No WiFi credentials. Device is in AP Mode."));
+  } else {
+    Serial.println(F("[SETUP] WiFi connecting in the background."));
+  }
+
+  setupWebServer();
+  Serial.println(F("[SETUP] Webserver setup complete"));
+  if (isAPMode) {
+    setupMDNS();  // In STA mode mDNS and NTP start once connected
+  }
+  Serial.println(F("[SETUP] Setup complete"));
+  Serial.println();
+  printConfigToSerial();
+  displayMode = 0;
+  lastSwitch = millis();
+}
+
+// -----------------------------------------------------------------------------
+// Brightness Control
+// -----------------------------------------------------------------------------
+// Writes the intensity register only when the level actually changes
+void writeIntensity(int level) {
+  if (level == appliedIntensity) return;
+  P.setIntensity(level);
+  appliedIntensity = level;
+  intensityWrites++;
+}
+
+bool isInDimWindow(const struct tm &t) {
+  int curTotal = t.tm_hour * 60 + t.tm_min;
+  int startTotal = dimStartHour * 60 + dimStartMinute;
+  int endTotal = dimEndHour * 60 + dimEndMinute;
+  // Overnight-aware
+  if (startTotal < endTotal) {
+    return curTotal >= startTotal && curTotal < endTotal;
+  }
+  return curTotal >= startTotal || curTotal < endTotal;
+}
+
+// Called every loop() with the cached local time. The dimming window is only
+// re-evaluated when the minute changes; fades step once per level change.
+void updateBrightness(const struct tm &t) {
+  bool windowChanged = false;
+  if (dimScheduleDirty || t.tm_min != dimScheduleMinute) {
+    dimScheduleDirty = false;
+    dimScheduleMinute = t.tm_min;
+    bool active = isInDimWindow(t);
+    windowChanged = (active != dimWindowActive);
+    dimWindowActive = active;
+  }
+
+  int target = (dimmingEnabled && dimWindowActive) ? dimBrightness : brightness;
+  bool woke = false;
+
+  if (target == -1) {
+    fading = false;
+    intensityTarget = target;
+    if (!displayOff) {
+      if (dimmingEnabled) {
+        Serial.println(F("[DISPLAY] Turning display OFF (dimming -1)"));
+      } else {
+        Serial.println(F("[DISPLAY] Turning display OFF (brightness -1)"));
+      }
+      P.displayShutdown(true);
+      invalidateRenderCache();
+      P.displayClear();
+      displayOff = true;
+      displayOffByDimming = dimmingEnabled;
+      displayOffByBrightness = !dimmingEnabled;
+    }
+    return;
+  }
+
+  if (displayOff && (dimmingEnabled ? displayOffByDimming : displayOffByBrightness)) {
+    if (dimmingEnabled) {
+      Serial.println(F("[DISPLAY] Waking display (dimming end)"));
+    } else {
+      Serial.println(F("[DISPLAY] Waking display (brightness changed)"));
+    }
+    P.displayShutdown(false);
+    displayOff = false;
+    displayOffByDimming = false;
+    displayOffByBrightness = false;
+    woke = true;
+  }
+
+  if (target != intensityTarget) {
+    // Ramp only across the dimming window edges; slider changes apply at once
+    if (windowChanged && dimmingEnabled && dimFadeSeconds > 0 && (appliedIntensity >= 0 || woke)) {
+      fadeFrom = woke ? 0 : appliedIntensity;
+      fadeTo = target;
+      fadeStart = millis();
+      fadeDuration = (unsigned long)dimFadeSeconds * 1000UL;
+      fading = true;
+      Serial.printf("[DISPLAY] Fading brightness %d -> %d over %ds\n", fadeFrom, fadeTo, dimFadeSeconds);
+    } else {
+      fading = false;
+    }
+    intensityTarget = target;
+  }
+
+  if (fading) {
+    unsigned long elapsed = millis() - fadeStart;
+    if (elapsed >= fadeDuration) {
+      fading = false;
+      writeIntensity(fadeTo);
+    } else {
+      writeIntensity(fadeFrom + (int)((long)(fadeTo - fadeFrom) * (long)elapsed / (long)fadeDuration));
+    }
+  } else {
+    writeIntensity(target);
+  }
+}
+
+// -----------------------------------------------------------------------------
+// Display Playlist
+// -----------------------------------------------------------------------------
+bool clockModeEligible() {
+  return true;  // Clock always valid
+}
+
+bool weatherModeEligible() {
+  return weatherAvailable && strlen(openMeteoLatitude) > 0 && strlen(openMeteoLongitude) > 0;
+}
+
+bool descriptionModeEligible() {
+  return showWeatherDescription && weatherAvailable && weatherDescription.length() > 0;
+}
+
+// The countdown finish trigger in loop() flips countdownFinished when the target passes
+bool countdownModeEligible() {
+  return countdownEnabled && !countdownFinished && ntpSyncSuccessful && countdownTargetTimestamp > 0;
+}
+
+bool nightscoutModeEligible() {
+  return strlen(nightscoutUrl) > 0;
+}
+
+bool dateModeEligible() {
+  return showDate;
+}
+
+bool youtubeModeEligible() {
+  return youtubeEnabled && strlen(youtubeApiKey) > 0 && youtubeChannelCount > 0;
+}
+
+const DisplayModeEntry displayModeTable[] = {
+  { 0, "CLOCK", clockModeEligible, &clockDuration },
+  { 1, "WEATHER", weatherModeEligible, &weatherDuration },
+  { 2, "DESCRIPTION", descriptionModeEligible, nullptr },
+  { 3, "COUNTDOWN", countdownModeEligible, nullptr },
+  { 4, "NIGHTSCOUT", nightscoutModeEligible, nullptr },
+  { 5, "DATE", dateModeEligible, &weatherDuration },
+  { 6, "YOUTUBE", youtubeModeEligible, nullptr },
+};
+#define DISPLAY_MODE_TABLE_COUNT (sizeof(displayModeTable) / sizeof(displayModeTable[0]))
+
+const DisplayModeEntry *findDisplayModeEntry(int mode) {
+  for (size_t i = 0; i < DISPLAY_MODE_TABLE_COUNT; i++) {
+    if (displayModeTable[i].mode == mode) return &displayModeTable[i];
+  }
+  return nullptr;
+}
 
-  P.begin();  // Initialize Parola library
+const char *displayModeName(int mode) {
+  const DisplayModeEntry *entry = findDisplayModeEntry(mode);
+  if (entry) return entry->name;
+  if (mode == 10) return "MESSAGE";
+  if (mode == 11) return "WEBHOOK";
+  return "UNKNOWN";
+}
 
-  P.setCharSpacing(0);
-  P.setFont(mFactory);
-  loadConfig();  // This function now has internal yields and prints
+// 0 for modes that are not advanced by the loop() timer
+unsigned long displayModeDuration(int mode) {
+  const DisplayModeEntry *entry = findDisplayModeEntry(mode);
+  return (entry && entry->duration) ? *entry->duration : 0;
+}
 
-  P.setIntensity(brightness);
-  P.setZoneEffect(0, flipDisplay, PA_FLIP_UD);
-  P.setZoneEffect(0, flipDisplay, PA_FLIP_LR);
+// Parses a comma-separated list of mode numbers, e.g. "0,5,1,0,6".
+// Unknown modes are dropped; an empty result falls back to the default order.
+void parseDisplayPlaylist(const char *spec) {
+  playlistLength = 0;
+  const char *p = spec;
+  while (*p && playlistLength < DISPLAY_PLAYLIST_MAX) {
+    while (*p == ' ' || *p == ',') p++;
+    if (!isdigit((unsigned char)*p)) {
+      if (*p) p++;
+      continue;
+    }
+    int mode = 0;
+    while (isdigit((unsigned char)*p)) mode = mode * 10 + (*p++ - '0');
+    if (findDisplayModeEntry(mode)) {
+      playlistModes[playlistLength++] = mode;
+    } else {
+      Serial.printf("[DISPLAY] Ignoring unknown playlist mode %d\n", mode);
+    }
+  }
 
-  Serial.println(F("[SETUP] Parola (LED Matrix) initialized"));
+  if (playlistLength == 0 && spec != DEFAULT_DISPLAY_PLAYLIST) {
+    Serial.println(F("[DISPLAY] Empty playlist, using default order"));
+    parseDisplayPlaylist(DEFAULT_DISPLAY_PLAYLIST);
+    return;
+  }
 
-  connectWiFi();
+  memset(playlistSlotOf, DISPLAY_PLAYLIST_NONE, sizeof(playlistSlotOf));
+  for (int i = playlistLength - 1; i >= 0; i--) {
+    playlistSlotOf[playlistModes[i]] = i;
+  }
+  displayModesDirty = true;
+}
 
-  #if defined(ESP32)
-    WiFi.setSleep(false);
-    WiFi.setAutoReconnect(true);
-    WiFi.persistent(false);
-    WiFi.onEvent([](WiFiEvent_t event, WiFiEventInfo_t info) {
-      if (event == ARDUINO_EVENT_WIFI_STA_GOT_IP) {
-        Serial.println(F("[WIFI] Got IP"));
-        lastWifiConnectTime = millis();
-      } else if (event == ARDUINO_EVENT_WIFI_STA_DISCONNECTED) {
-        Serial.println(F("[WIFI] Disconnected"));
-      }
-    });
+// Re-evaluates every mode predicate once and precomputes the successor of each
+// playlist slot, so advanceDisplayMode() is a table lookup
+void refreshDisplayModes() {
+  displayModesDirty = false;
 
-  #elif defined(ESP8266)
-    WiFi.setAutoReconnect(true);
-    WiFi.persistent(false);
-    wifiGotIPHandler = WiFi.onStationModeGotIP([](const WiFiEventStationModeGotIP &ev) {
-      Serial.println(F("[WIFI] Got IP"));
-      lastWifiConnectTime = millis();
-    });
-    wifiDisconnectHandler = WiFi.onStationModeDisconnected([](const WiFiEventStationModeDisconnected &ev) {
-      Serial.printf("[WIFI] Disconnected (reason: %d)\n", ev.reason);
-    });
-  #endif
+  uint16_t mask = 0;
+  for (size_t i = 0; i < DISPLAY_MODE_TABLE_COUNT; i++) {
+    if (displayModeTable[i].eligible()) mask |= (1 << displayModeTable[i].mode);
+  }
+  eligibleModes = mask;
 
-  if (isAPMode) {
-    Serial.println(F("[SETUP] WiFi connection failed. Device is in AP Mode."));
-  } else if (WiFi.status() == WL_CONNECTED) {
-    Serial.println(F("[SETUP] WiFi connected successfully to local network."));
-  } else {
-    Serial.println(F("[SETUP] WiFi state is uncertain after connection attempt."));
+  playlistFirst = DISPLAY_PLAYLIST_NONE;
+  for (uint8_t i = 0; i < playlistLength; i++) {
+    if (mask & (1 << playlistModes[i])) {
+      playlistFirst = i;
+      break;
+    }
   }
 
-  setupWebServer();
-  Serial.println(F("[SETUP] Webserver setup complete"));
-  setupMDNS();
-  Serial.println(F("[SETUP] Setup complete"));
-  Serial.println();
-  printConfigToSerial();
-  setupTime();
-  displayMode = 0;
-  lastSwitch = millis();
-  lastColonBlink = millis();
+  // Walking backwards, 'next' is the first eligible slot after i (wrapping around)
+  uint8_t next = playlistFirst;
+  for (int i = playlistLength - 1; i >= 0; i--) {
+    playlistNext[i] = next;
+    if (mask & (1 << playlistModes[i])) next = i;
+  }
 }
 
 void advanceDisplayMode() {
@@ -2777,186 +5501,74 @@ void advanceDisplayMode() {
     lastSwitch = millis();
     return;
   }
-  String ntpField = String(ntpServer2);
-  bool nightscoutConfigured = ntpField.startsWith("https://");
-
-  if (displayMode == 0) {  // Clock -> ...
-    if (showDate) {
-      displayMode = 5;  // Date mode right after Clock
-      Serial.println(F("[DISPLAY] Switching to display mode: DATE (from Clock)"));
-    } else if (weatherAvailable && (strlen(openMeteoLatitude) > 0) && (strlen(openMeteoLongitude) > 0)) {
-      displayMode = 1;
-      Serial.println(F("[DISPLAY] Switching to display mode: WEATHER (from Clock)"));
-    } else if (countdownEnabled && !countdownFinished && ntpSyncSuccessful && countdownTargetTimestamp > 0 && countdownTargetTimestamp > time(nullptr)) {
-      displayMode = 3;
-      Serial.println(F("[DISPLAY] Switching to display mode: COUNTDOWN (from Clock, weather skipped)"));
-    } else if (nightscoutConfigured) {
-      displayMode = 4;  // Clock -> Nightscout (if weather & countdown are skipped)
-      Serial.println(F("[DISPLAY] Switching to display mode: NIGHTSCOUT (from Clock, weather & countdown skipped)"));
-    } else {
-      displayMode = 0;
-      Serial.println(F("[DISPLAY] Staying in CLOCK (from Clock)"));
-    }
-  } else if (displayMode == 5) {  // Date mode
-    if (weatherAvailable && (strlen(openMeteoLatitude) > 0) && (strlen(openMeteoLongitude) > 0)) {
-      displayMode = 1;
-      Serial.println(F("[DISPLAY] Switching to display mode: WEATHER (from Date)"));
-    } else if (countdownEnabled && !countdownFinished && ntpSyncSuccessful && countdownTargetTimestamp > 0 && countdownTargetTimestamp > time(nullptr)) {
-      displayMode = 3;
-      Serial.println(F("[DISPLAY] Switching to display mode: COUNTDOWN (from Date, weather skipped)"));
-    } else if (nightscoutConfigured) {
-      displayMode = 4;
-      Serial.println(F("[DISPLAY] Switching to display mode: NIGHTSCOUT (from Date, weather & countdown skipped)"));
-    } else {
-      displayMode = 0;
-      Serial.println(F("[DISPLAY] Switching to display mode: CLOCK (from Date)"));
-    }
-  } else if (displayMode == 1) {  // Weather -> ...
-    if (showWeatherDescription && weatherAvailable && weatherDescription.length() > 0) {
-      displayMode = 2;
-      Serial.println(F("[DISPLAY] Switching to display mode: DESCRIPTION (from Weather)"));
-    } else if (countdownEnabled && !countdownFinished && ntpSyncSuccessful && countdownTargetTimestamp > 0 && countdownTargetTimestamp > time(nullptr)) {
-      displayMode = 3;
-      Serial.println(F("[DISPLAY] Switching to display mode: COUNTDOWN (from Weather, description skipped)"));
-    } else if (youtubeEnabled && strlen(youtubeApiKey) > 0 && strlen(youtubeChannelId) > 0) {
-      displayMode = 6;  // Weather -> YouTube (if description & countdown are skipped)
-      Serial.println(F("[DISPLAY] Switching to display mode: YOUTUBE (from Weather, description & countdown skipped)"));
-    } else if (nightscoutConfigured) {
-      displayMode = 4;  // Weather -> Nightscout (if description, countdown & youtube are skipped)
-      Serial.println(F("[DISPLAY] Switching to display mode: NIGHTSCOUT (from Weather, all skipped)"));
-    } else {
-      displayMode = 0;
-      Serial.println(F("[DISPLAY] Switching to display mode: CLOCK (from Weather)"));
-    }
-  } else if (displayMode == 2) {  // Weather Description -> ...
-    if (countdownEnabled && !countdownFinished && ntpSyncSuccessful && countdownTargetTimestamp > 0 && countdownTargetTimestamp > time(nullptr)) {
-      displayMode = 3;
-      Serial.println(F("[DISPLAY] Switching to display mode: COUNTDOWN (from Description)"));
-    } else if (youtubeEnabled && strlen(youtubeApiKey) > 0 && strlen(youtubeChannelId) > 0) {
-      displayMode = 6;  // Description -> YouTube (if countdown is skipped)
-      Serial.println(F("[DISPLAY] Switching to display mode: YOUTUBE (from Description, countdown skipped)"));
-    } else if (nightscoutConfigured) {
-      displayMode = 4;  // Description -> Nightscout (if countdown & youtube are skipped)
-      Serial.println(F("[DISPLAY] Switching to display mode: NIGHTSCOUT (from Description, countdown & youtube skipped)"));
-    } else {
-      displayMode = 0;
-      Serial.println(F("[DISPLAY] Switching to display mode: CLOCK (from Description)"));
-    }
-  } else if (displayMode == 3) {  // Countdown -> YouTube, Nightscout or Clock
-    if (youtubeEnabled && strlen(youtubeApiKey) > 0 && strlen(youtubeChannelId) > 0) {
-      displayMode = 6;  // Countdown -> YouTube
-      Serial.println(F("[DISPLAY] Switching to display mode: YOUTUBE (from Countdown)"));
-    } else if (nightscoutConfigured) {
-      displayMode = 4;  // Countdown -> Nightscout (if youtube is skipped)
-      Serial.println(F("[DISPLAY] Switching to display mode: NIGHTSCOUT (from Countdown, YouTube skipped)"));
-    } else {
-      displayMode = 0;
-      Serial.println(F("[DISPLAY] Switching to display mode: CLOCK (from Countdown)"));
-    }
-  } else if (displayMode == 6) {  // YouTube -> Nightscout or Clock
-    String ntpField = String(ntpServer2);
-    bool nightscoutConfigured = ntpField.startsWith("https://");
-    if (nightscoutConfigured) {
-      displayMode = 4;
-      Serial.println(F("[DISPLAY] Switching to display mode: NIGHTSCOUT (from YouTube)"));
-    } else {
-      displayMode = 0;
-      Serial.println(F("[DISPLAY] Switching to display mode: CLOCK (from YouTube)"));
-    }
-  } else if (displayMode == 4) {  // Nightscout -> Clock
-    displayMode = 0;
-    Serial.println(F("[DISPLAY] Switching to display mode: CLOCK (from Nightscout)"));
-  } else if (displayMode == 10) {  // Message -> Clock
-    displayMode = 0;
-    Serial.println(F("[DISPLAY] Switching to display mode: CLOCK (from Message)"));
-  } else if (displayMode == 11) {  // Webhook -> Clock
-    displayMode = 0;
-    Serial.println(F("[DISPLAY] Switching to display mode: CLOCK (from Webhook)"));
+
+  if (displayModesDirty) refreshDisplayModes();
+
+  // Continue after the current mode's slot; modes entered from outside the
+  // playlist (message, webhook, API) restart it from the top
+  uint8_t slot = playlistPos;
+  if (slot >= playlistLength || playlistModes[slot] != oldMode) {
+    slot = (oldMode >= 0 && oldMode < DISPLAY_MODE_COUNT) ? playlistSlotOf[oldMode] : DISPLAY_PLAYLIST_NONE;
   }
+  uint8_t next = (slot != DISPLAY_PLAYLIST_NONE) ? playlistNext[slot] : playlistFirst;
 
-  // --- Common cleanup/reset logic remains the same ---
-  lastSwitch = millis();
-}
+  if (next == DISPLAY_PLAYLIST_NONE) {
+    displayMode = 0;  // Nothing in the playlist is eligible
+    playlistPos = playlistSlotOf[0];
+  } else {
+    displayMode = playlistModes[next];
+    playlistPos = next;
+  }
 
-void advanceDisplayModeSafe() {
-  int attempts = 0;
-  const int MAX_ATTEMPTS = 6;  // Number of possible modes + 1
-  int startMode = displayMode;
-  bool valid = false;
-  do {
-    advanceDisplayMode();  // One step advance
-    attempts++;
-    // Recalculate validity for the new mode
-    valid = false;
-    String ntpField = String(ntpServer2);
-    bool nightscoutConfigured = ntpField.startsWith("https://");
-
-    if (displayMode == 0) valid = true;  // Clock always valid
-    else if (displayMode == 5 && showDate) valid = true;
-    else if (displayMode == 1 && weatherAvailable && (strlen(openMeteoLatitude) > 0) && (strlen(openMeteoLongitude) > 0)) valid = true;
-    else if (displayMode == 2 && showWeatherDescription && weatherAvailable && weatherDescription.length() > 0) valid = true;
-    else if (displayMode == 3 && countdownEnabled && !countdownFinished && ntpSyncSuccessful) valid = true;
-    else if (displayMode == 4 && nightscoutConfigured) valid = true;
-    else if (displayMode == 10 && showCustomMessage) valid = true;
-
-    // If we've looped back to where we started, break to avoid infinite loop
-    if (displayMode == startMode) break;
-
-    if (valid) break;
-  } while (attempts < MAX_ATTEMPTS);
-
-  // If no valid mode found, fall back to Clock
-  if (!valid) {
-    displayMode = 0;
-    Serial.println(F("[DISPLAY] Safe fallback to CLOCK"));
+  if (displayMode == oldMode) {
+    Serial.printf("[DISPLAY] Staying in %s\n", displayModeName(displayMode));
+  } else {
+    Serial.printf("[DISPLAY] Switching to display mode: %s (from %s)\n", displayModeName(displayMode), displayModeName(oldMode));
   }
   lastSwitch = millis();
 }
 
 //config save after countdown finishes
+// Debounced: repeated changes from the UI end up as a single journal record
 bool saveCountdownConfig(bool enabled, time_t targetTimestamp, const String &label) {
-  DynamicJsonDocument doc(2048);
-
-  File configFile = LittleFS.open("/config.json", "r");
-  if (configFile) {
-    DeserializationError err = deserializeJson(doc, configFile);
-    configFile.close();
-    if (err) {
-      Serial.print(F("[saveCountdownConfig] Error parsing config.json: "));
-      Serial.println(err.f_str());
-      return false;
-    }
-  }
+  DynamicJsonDocument patch(256);
 
-  JsonObject countdownObj = doc["countdown"].is<JsonObject>() ? doc["countdown"].as<JsonObject>() : doc.createNestedObject("countdown");
+  JsonObject countdownObj = patch.createNestedObject("countdown");
   countdownObj["enabled"] = enabled;
   countdownObj["targetTimestamp"] = targetTimestamp;
   countdownObj["label"] = label;
   countdownObj["isDramaticCountdown"] = isDramaticCountdown;
-  doc.remove("countdownEnabled");
-  doc.remove("countdownDate");
-  doc.remove("countdownTime");
-  doc.remove("countdownLabel");
+  // null removes the legacy flat keys
+  patch["countdownEnabled"] = nullptr;
+  patch["countdownDate"] = nullptr;
+  patch["countdownTime"] = nullptr;
+  patch["countdownLabel"] = nullptr;
+
+  configUpdate(patch);
+  Serial.println(F("[saveCountdownConfig] Countdown update queued."));
+  return true;
+}
 
-  if (LittleFS.exists("/config.json")) {
-    LittleFS.rename("/config.json", "/config.bak");
-  }
 
-  File f = LittleFS.open("/config.json", "w");
-  if (!f) {
-    Serial.println(F("[saveCountdownConfig] ERROR: Cannot write to /config.json"));
-    return false;
+void loop() {
+  unsigned long loopEntry = millis();
+  if (lastLoopEntry != 0 && loopEntry - lastLoopEntry > loopStallMax) {
+    loopStallMax = loopEntry - lastLoopEntry;
   }
+  lastLoopEntry = loopEntry;
+  #if ENABLE_METRICS
+    metricsLoopTick();
+  #endif
 
-  size_t bytesWritten = serializeJson(doc, f);
-  f.close();
-
-  Serial.printf("[saveCountdownConfig] Config updated. %u bytes written.\n", bytesWritten);
-  return true;
-}
+  // A timeline belongs to the mode that started it
+  if (timeline.id != TIMELINE_NONE && timeline.mode != displayMode) {
+    timelineCancel();
+  }
 
+  serviceConfigStore();
+  serviceStatusEvents();
+  serviceWiFiConnect();
 
-void loop() {
   if (isAPMode) {
     dnsServer.processNextRequest();
   }
@@ -2967,17 +5579,34 @@ void loop() {
     }
   #endif
 
-  static bool colonVisible = true;
-  const unsigned long colonBlinkInterval = 800;
-  if (millis() - lastColonBlink > colonBlinkInterval) {
-    colonVisible = !colonVisible;
-    lastColonBlink = millis();
-  }
+  // Colon lit for the first half of every second, in step with the digits
+  struct timeval colonTime;
+  gettimeofday(&colonTime, nullptr);
+  bool colonVisible = colonTime.tv_usec < 500000;
 
   static unsigned long ntpAnimTimer = 0;
   static int ntpAnimFrame = 0;
   static bool tzSetAfterSync = false;
 
+  // WiFi connecting animation; the web server is already up meanwhile
+  static unsigned long wifiAnimTimer = 0;
+  static int wifiAnimFrame = 0;
+  if (wifiConnecting() && !ntpSyncSuccessful) {  // A restored clock shows meanwhile
+    unsigned long now = millis();
+    if (now - wifiAnimTimer > 750) {
+      wifiAnimTimer = now;
+      wifiAnimFrame++;
+    }
+    P.setTextAlignment(PA_CENTER);
+    switch (wifiAnimFrame % 3) {
+      case 0: renderText(F("# ©")); break;
+      case 1: renderText(F("# ª")); break;
+      case 2: renderText(F("# «")); break;
+    }
+    yield();
+    return;
+  }
+
   // AP Mode animation
   static unsigned long apAnimTimer = 0;
   static int apAnimFrame = 0;
@@ -2989,20 +5618,26 @@ void loop() {
     }
     P.setTextAlignment(PA_CENTER);
     switch (apAnimFrame % 3) {
-      case 0: P.print(F("= ©")); break;
-      case 1: P.print(F("= ª")); break;
-      case 2: P.print(F("= «")); break;
+      case 0: renderText(F("= ©")); break;
+      case 1: renderText(F("= ª")); break;
+      case 2: renderText(F("= «")); break;
     }
     yield();
     return;
   }
 
   if (!processingWebhook && !messageQueue.empty() && !showingIp) {
-    WebhookMessage msg = messageQueue.top();
+    WEBHOOK_LOCK();
+    messageQueue.expire(millis());
+    const WebhookMessage *next = messageQueue.peek();
+    int nextPriority = next ? next->priority : -1;
+    WEBHOOK_UNLOCK();
 
     bool shouldProcess = false;
 
-    switch(msg.priority) {
+    switch(nextPriority) {
+      case -1:  // Everything expired
+        break;
       case 2:  // HIGH - Interrupts everything
         shouldProcess = true;
         break;
@@ -3017,80 +5652,35 @@ void loop() {
     }
 
     if (shouldProcess) {
-      messageQueue.pop();
-      currentWebhookMessage = msg;
-      processingWebhook = true;
-      displayMode = 11;
-      lastSwitch = millis();
-      Serial.printf("[WEBHOOK] Processing: %s (priority=%d)\n",
-                    msg.text.c_str(), msg.priority);
+      WEBHOOK_LOCK();
+      bool popped = messageQueue.pop(currentWebhookMessage);
+      WEBHOOK_UNLOCK();
+      if (popped) {
+        processingWebhook = true;
+        displayMode = 11;
+        lastSwitch = millis();
+        Serial.printf("[WEBHOOK] Processing: %s (priority=%d)\n",
+                      currentWebhookMessage.text, currentWebhookMessage.priority);
+      }
     }
   }
 
-  // Dimming
+  // Local time is only recomputed when the second changes
   time_t now_time = time(nullptr);
-  struct tm timeinfo;
-  localtime_r(&now_time, &timeinfo);
-  int curHour = timeinfo.tm_hour;
-  int curMinute = timeinfo.tm_min;
-  int curTotal = curHour * 60 + curMinute;
-  int startTotal = dimStartHour * 60 + dimStartMinute;
-  int endTotal = dimEndHour * 60 + dimEndMinute;
-  bool isDimmingActive = false;
-
-  if (dimmingEnabled) {
-    // Determine if dimming is active (overnight-aware)
-    if (startTotal < endTotal) {
-      isDimmingActive = (curTotal >= startTotal && curTotal < endTotal);
-    } else {
-      isDimmingActive = (curTotal >= startTotal || curTotal < endTotal);
-    }
-
-    int targetBrightness = isDimmingActive ? dimBrightness : brightness;
-
-    if (targetBrightness == -1) {
-      if (!displayOff) {
-        Serial.println(F("[DISPLAY] Turning display OFF (dimming -1)"));
-        P.displayShutdown(true);
-        P.displayClear();
-        displayOff = true;
-        displayOffByDimming = true;
-        displayOffByBrightness = false;
-      }
-    } else {
-      if (displayOff && displayOffByDimming) {
-        Serial.println(F("[DISPLAY] Waking display (dimming end)"));
-        P.displayShutdown(false);
-        displayOff = false;
-        displayOffByDimming = false;
-      }
-      P.setIntensity(targetBrightness);
-    }
-  } else {
-    // Dimming disabled: just obey brightness slider
-    if (brightness == -1) {
-      if (!displayOff) {
-        Serial.println(F("[DISPLAY] Turning display OFF (brightness -1)"));
-        P.displayShutdown(true);
-        P.displayClear();
-        displayOff = true;
-        displayOffByBrightness = true;
-        displayOffByDimming = false;
-      }
-    } else {
-      if (displayOff && displayOffByBrightness) {
-        Serial.println(F("[DISPLAY] Waking display (brightness changed)"));
-        P.displayShutdown(false);
-        displayOff = false;
-        displayOffByBrightness = false;
-      }
-      P.setIntensity(brightness);
-    }
+  static struct tm timeinfo;
+  static time_t timeinfoFor = 0;
+  if (now_time != timeinfoFor) {
+    timeinfoFor = now_time;
+    localtime_r(&now_time, &timeinfo);
   }
 
+  // Dimming
+  updateBrightness(timeinfo);
+
   // --- IMMEDIATE COUNTDOWN FINISH TRIGGER ---
   if (countdownEnabled && !countdownFinished && ntpSyncSuccessful && countdownTargetTimestamp > 0 && now_time >= countdownTargetTimestamp) {
     countdownFinished = true;
+    displayModesDirty = true;
     displayMode = 3;  // Let main loop handle animation + TIMES UP
     countdownShowFinishedMessage = true;
     hourglassPlayed = false;
@@ -3102,17 +5692,24 @@ void loop() {
 
   // --- IP Display ---
   if (showingIp) {
-    if (P.displayAnimate()) {
+    if (timelineActive(TIMELINE_IP_OUTRO)) {
+      if (timelineService()) {
+        showingIp = false;
+        displayMode = 0;
+        lastSwitch = millis();
+      }
+    } else if (P.displayAnimate()) {
       ipDisplayCount++;
       if (ipDisplayCount < ipDisplayMax) {
         textEffect_t actualScrollDirection = getEffectiveScrollDirection(PA_SCROLL_LEFT, flipDisplay);
+        invalidateRenderCache();
         P.displayScroll(pendingIpToShow.c_str(), PA_CENTER, actualScrollDirection, 120);
+        noteShownText(pendingIpToShow.c_str());
       } else {
-        showingIp = false;
+        invalidateRenderCache();
         P.displayClear();
-        delay(500);  // Blocking delay as in working copy
-        displayMode = 0;
-        lastSwitch = millis();
+        timelineStart(TIMELINE_IP_OUTRO);
+        timelineAdd(FRAME_TEXT, "", 500, PA_CENTER, 0);  // Short blank pause before the clock
       }
     }
     yield();
@@ -3124,6 +5721,7 @@ void loop() {
     if (!displayOff) {
       Serial.println(F("[DISPLAY] Turning display OFF"));
       P.displayShutdown(true);  // fully off
+      invalidateRenderCache();
       P.displayClear();
       displayOff = true;
     }
@@ -3131,20 +5729,33 @@ void loop() {
   }
 
   // --- NTP State Machine ---
+  int ntpResult = serviceNtpQuery();
   switch (ntpState) {
     case NTP_IDLE: break;
     case NTP_SYNCING:
       {
-        time_t now = time(nullptr);
-        if (now > 1000) {  // NTP sync successful
+        if (ntpResult > 0) {  // NTP sync successful
           Serial.println(F("[TIME] NTP sync successful."));
+          if (bootClockMs == 0) {
+            bootClockMs = millis();
+            Serial.printf("[TIME] First valid clock %lu ms after boot\n", bootClockMs);
+          }
           ntpSyncSuccessful = true;
+          displayModesDirty = true;
           ntpState = NTP_SUCCESS;
         } else if (millis() - ntpStartTime > ntpTimeout || ntpRetryCount >= maxNtpRetries) {
           Serial.println(F("[TIME] NTP sync failed."));
+          if (ntpQueryActive) ntpForgetSilentServers();
+          ntpQueryActive = false;
           ntpSyncSuccessful = false;
+          displayModesDirty = true;
           ntpState = NTP_FAILED;
         } else {
+          // A failed lookup or round starts over until the timeout
+          if (!ntpQueryActive && millis() - ntpRoundEnd >= NTP_RESEND_MS) {
+            ntpRoundEnd = millis();
+            ntpStartQuery();
+          }
           // Periodically print a more descriptive status message
           if (millis() - lastNtpStatusPrintTime >= ntpStatusPrintInterval) {
             Serial.printf("[TIME] NTP sync in progress (attempt %d of %d)...\n", ntpRetryCount + 1, maxNtpRetries);
@@ -3160,11 +5771,17 @@ void loop() {
       }
     case NTP_SUCCESS:
       if (!tzSetAfterSync) {
-        const char *posixTz = ianaToPosix(timeZone);
-        setenv("TZ", posixTz, 1);
-        tzset();
+        applyTimeZone();
         tzSetAfterSync = true;
       }
+      if (ntpResult < 0) {
+        Serial.println(F("[TIME] NTP resync failed, keeping the local clock"));
+      }
+      // Background resync; the clock keeps running on the drift model meanwhile
+      if (!ntpQueryActive && millis() - ntpRoundEnd >= ntpNextRoundDelay && !ntpStartQuery()) {
+        ntpRoundEnd = millis();
+        ntpNextRoundDelay = NTP_RESYNC_RETRY_MS;
+      }
       ntpAnimTimer = 0;
       ntpAnimFrame = 0;
       break;
@@ -3188,26 +5805,38 @@ void loop() {
         ntpStartTime = millis();
         ntpState = NTP_SYNCING;
         Serial.println(F("[TIME] Retrying NTP sync..."));
+        ntpStartQuery();
 
         firstRetry = false;
       }
       break;
   }
 
-  // Only advance mode by timer for clock/weather, not description!
-  unsigned long displayDuration = (displayMode == 0) ? clockDuration : weatherDuration;
-  if ((displayMode == 0 || displayMode == 1) && millis() - lastSwitch > displayDuration) {
+  // Only advance by timer for modes with a dwell time; the others (description,
+  // countdown, Nightscout, YouTube) advance themselves when their content is done
+  unsigned long displayDuration = displayModeDuration(displayMode);
+  if (displayDuration > 0 && millis() - lastSwitch > displayDuration) {
     advanceDisplayMode();
   }
 
   // --- MODIFIED WEATHER FETCHING LOGIC ---
+  serviceWeatherFetch();  // Advance any in-flight request by one step
+  serviceNightscout();
+  serviceYoutube();
+  serviceOutbound();
+
+  // Waits out WIFI_STABILIZE_DELAY here rather than skipping a whole interval;
+  // until then the restored observation (if any) is on screen
   if (WiFi.status() == WL_CONNECTED) {
-    if (!weatherFetchInitiated || shouldFetchWeatherNow || (millis() - lastFetch > fetchInterval)) {
+    if (weatherFetchState == WEATHER_IDLE && millis() - lastWifiConnectTime >= WIFI_STABILIZE_DELAY &&
+        (!weatherFetchInitiated || shouldFetchWeatherNow || (millis() - lastFetch > nextFetchDelay))) {
       if (shouldFetchWeatherNow) {
         Serial.println(F("[LOOP] Immediate weather fetch requested by web server."));
         shouldFetchWeatherNow = false;
       } else if (!weatherFetchInitiated) {
         Serial.println(F("[LOOP] Initial weather fetch."));
+      } else if (weatherFailures > 0) {
+        Serial.printf("[LOOP] Weather retry %u.\n", weatherFailures);
       } else {
         Serial.println(F("[LOOP] Regular interval weather fetch."));
       }
@@ -3221,60 +5850,66 @@ void loop() {
     shouldFetchWeatherNow = false;
   }
 
-  const char *const *daysOfTheWeek = getDaysOfWeek(language);
-  const char *daySymbol = daysOfTheWeek[timeinfo.tm_wday];
-
-  // build base HH:MM first ---
-  char baseTime[9];
-  if (twelveHourToggle) {
-    int hour12 = timeinfo.tm_hour % 12;
-    if (hour12 == 0) hour12 = 12;
-    sprintf(baseTime, "%d:%02d", hour12, timeinfo.tm_min);
-  } else {
-    sprintf(baseTime, "%02d:%02d", timeinfo.tm_hour, timeinfo.tm_min);
-  }
-
-  // add seconds only if colon blink enabled AND weekday hidden ---
-  char timeWithSeconds[12];
-  if (!showDayOfWeek && colonBlinkEnabled) {
-    // Remove any leading space from baseTime
-    const char *trimmedBase = baseTime;
-    if (baseTime[0] == ' ') trimmedBase++;  // skip leading space
-    sprintf(timeWithSeconds, "%s:%02d", trimmedBase, timeinfo.tm_sec);
-  } else {
-    strcpy(timeWithSeconds, baseTime);  // no seconds
+  static unsigned long lastWeatherAgeCheck = 0;
+  if (millis() - lastWeatherAgeCheck >= 1000) {
+    lastWeatherAgeCheck = millis();
+    checkWeatherAge();
+    serviceClock();
   }
 
-  // keep spacing logic the same ---
-  char timeSpacedStr[24];
-  int j = 0;
-  for (int i = 0; timeWithSeconds[i] != '\0'; i++) {
-    timeSpacedStr[j++] = timeWithSeconds[i];
-    if (timeWithSeconds[i + 1] != '\0') {
-      timeSpacedStr[j++] = ' ';
+  // Rebuild the time text only when one of its inputs changes: the second (when
+  // shown), the minute, the weekday or the clock settings
+  static String formattedTime;
+  static uint32_t formattedTimeKey = 0xFFFFFFFF;
+  static const char *const *formattedTimeDays = nullptr;
+  const char *const *daysOfTheWeek = getDaysOfWeek(language);
+  bool showSeconds = !showDayOfWeek && colonBlinkEnabled;
+  uint32_t timeKey = ((uint32_t)timeinfo.tm_wday << 20) | ((uint32_t)timeinfo.tm_hour << 14) | ((uint32_t)timeinfo.tm_min << 8) | ((showSeconds ? timeinfo.tm_sec : 63) << 2) | (twelveHourToggle << 1) | showDayOfWeek;
+
+  if (timeKey != formattedTimeKey || daysOfTheWeek != formattedTimeDays) {
+    formattedTimeKey = timeKey;
+    formattedTimeDays = daysOfTheWeek;
+    timeFormatsBuilt++;
+    const char *daySymbol = daysOfTheWeek[timeinfo.tm_wday];
+
+    // build base HH:MM first ---
+    char baseTime[9];
+    if (twelveHourToggle) {
+      int hour12 = timeinfo.tm_hour % 12;
+      if (hour12 == 0) hour12 = 12;
+      sprintf(baseTime, "%d:%02d", hour12, timeinfo.tm_min);
+    } else {
+      sprintf(baseTime, "%02d:%02d", timeinfo.tm_hour, timeinfo.tm_min);
     }
-  }
-  timeSpacedStr[j] = '\0';
 
-  // build final string ---
-  String formattedTime;
-  if (showDayOfWeek) {
-    formattedTime = String(daySymbol) + "   " + String(timeSpacedStr);
-  } else {
-    formattedTime = String(timeSpacedStr);
-  }
+    // add seconds only if colon blink enabled AND weekday hidden ---
+    char timeWithSeconds[12];
+    if (showSeconds) {
+      // Remove any leading space from baseTime
+      const char *trimmedBase = baseTime;
+      if (baseTime[0] == ' ') trimmedBase++;  // skip leading space
+      sprintf(timeWithSeconds, "%s:%02d", trimmedBase, timeinfo.tm_sec);
+    } else {
+      strcpy(timeWithSeconds, baseTime);  // no seconds
+    }
 
-  unsigned long currentDisplayDuration = 0;
-  if (displayMode == 0) {
-    currentDisplayDuration = clockDuration;
-  } else if (displayMode == 1) {  // Weather
-    currentDisplayDuration = weatherDuration;
-  }
+    // keep spacing logic the same ---
+    char timeSpacedStr[24];
+    int j = 0;
+    for (int i = 0; timeWithSeconds[i] != '\0'; i++) {
+      timeSpacedStr[j++] = timeWithSeconds[i];
+      if (timeWithSeconds[i + 1] != '\0') {
+        timeSpacedStr[j++] = ' ';
+      }
+    }
+    timeSpacedStr[j] = '\0';
 
-  // Only advance mode by timer for clock/weather static (Mode 0 & 1).
-  // Other modes (2, 3) have their own internal timers/conditions for advancement.
-  if ((displayMode == 0 || displayMode == 1) && (millis() - lastSwitch > currentDisplayDuration)) {
-    advanceDisplayMode();
+    // build final string ---
+    if (showDayOfWeek) {
+      formattedTime = String(daySymbol) + "   " + String(timeSpacedStr);
+    } else {
+      formattedTime = String(timeSpacedStr);
+    }
   }
 
   // Persistent variables (declare near top of file or loop)
@@ -3290,7 +5925,9 @@ void loop() {
         static bool msgScrollInit = false;
         if (!msgScrollInit) {
           textEffect_t scrollDir = getEffectiveScrollDirection(PA_SCROLL_LEFT, flipDisplay);
+          invalidateRenderCache();
           P.displayScroll(customMessage.c_str(), PA_CENTER, scrollDir, GENERAL_SCROLL_SPEED);
+          noteShownText(customMessage.c_str());
           msgScrollInit = true;
         }
         if (P.displayAnimate()) {
@@ -3304,7 +5941,7 @@ void loop() {
         }
       } else {
         P.setTextAlignment(PA_CENTER);
-        P.print(customMessage.c_str());
+        renderText(customMessage.c_str());
       }
     } else {
       showCustomMessage = false;
@@ -3325,9 +5962,9 @@ void loop() {
       } else if (millis() - ntpAnimTimer > 750) {
         ntpAnimTimer = millis();
         switch (ntpAnimFrame % 3) {
-          case 0: P.print(F("S Y N C ®")); break;
-          case 1: P.print(F("S Y N C ¯")); break;
-          case 2: P.print(F("S Y N C °")); break;
+          case 0: renderText(F("S Y N C ®")); break;
+          case 1: renderText(F("S Y N C ¯")); break;
+          case 2: renderText(F("S Y N C °")); break;
         }
         ntpAnimFrame++;
       }
@@ -3343,11 +5980,11 @@ void loop() {
           errorAltTimer = millis();
           showNtpError = !showNtpError;
         }
-        P.print(showNtpError ? F("?/") : F("?*"));
+        renderText(showNtpError ? F("?/") : F("?*"));
       } else if (!ntpSyncSuccessful) {
-        P.print(F("?/"));
+        renderText(F("?/"));
       } else if (!weatherAvailable) {
-        P.print(F("?*"));
+        renderText(F("?*"));
       }
     }
     // --- DISPLAY CLOCK ---
@@ -3365,21 +6002,18 @@ void loop() {
         shouldScrollIn = true;  // only scroll in if weather was scrolling
       }
 
-      if (shouldScrollIn && !clockScrollDone) {
-        textEffect_t inDir = getEffectiveScrollDirection(PA_SCROLL_LEFT, flipDisplay);
-
-        P.displayText(
-          timeString.c_str(),
-          PA_CENTER,
-          GENERAL_SCROLL_SPEED,
-          0,
-          inDir,
-          PA_NO_EFFECT);
-        while (!P.displayAnimate()) yield();
-        clockScrollDone = true;  // mark scroll done
+      if ((shouldScrollIn && !clockScrollDone) || timelineActive(TIMELINE_CLOCK_SCROLL_IN)) {
+        if (!timelineActive(TIMELINE_CLOCK_SCROLL_IN)) {
+          timelineStart(TIMELINE_CLOCK_SCROLL_IN);
+          timelineAdd(FRAME_SCROLL_IN, timeString.c_str(), 0, PA_CENTER, 0);
+        }
+        if (timelineService()) {
+          clockScrollDone = true;  // mark scroll done
+        }
       } else {
         P.setTextAlignment(PA_CENTER);
-        P.print(timeString);
+        renderText(timeString);
+        noteShownText(formattedTime.c_str());  // Not the blinking colon frames
       }
     }
 
@@ -3406,7 +6040,8 @@ void loop() {
       } else {
         weatherDisplay = currentTemp + tempSymbol;
       }
-      P.print(weatherDisplay.c_str());
+      if (weatherIsStale()) weatherDisplay += '.';  // Old or restored after a reboot
+      renderText(weatherDisplay.c_str());
       weatherWasAvailable = true;
     } else {
       if (weatherWasAvailable) {
@@ -3417,11 +6052,12 @@ void loop() {
         String timeString = formattedTime;
         if (!colonVisible) timeString.replace(":", " ");
         P.setCharSpacing(0);
-        P.print(timeString);
+        renderText(timeString);
+        noteShownText(formattedTime.c_str());
       } else {
         P.setCharSpacing(0);
         P.setTextAlignment(PA_CENTER);
-        P.print(F("?*"));
+        renderText(F("?*"));
       }
     }
     yield();
@@ -3439,7 +6075,9 @@ void loop() {
     if (desc.length() > 8) {
       if (!descScrolling) {
         textEffect_t actualScrollDirection = getEffectiveScrollDirection(PA_SCROLL_LEFT, flipDisplay);
+        invalidateRenderCache();
         P.displayScroll(descBuffer, PA_CENTER, actualScrollDirection, GENERAL_SCROLL_SPEED);
+        noteShownText(descBuffer);
         descScrolling = true;
         descScrollEndTime = 0;  // reset end time at start
       }
@@ -3462,7 +6100,7 @@ void loop() {
       if (descStartTime == 0) {
         P.setTextAlignment(PA_CENTER);
         P.setCharSpacing(1);
-        P.print(descBuffer);
+        renderText(descBuffer);
         descStartTime = millis();
       }
       if (millis() - descStartTime > descriptionDuration) {
@@ -3491,6 +6129,7 @@ void loop() {
         // Target invalid or in the future, don't show "TIMES UP" yet, advance display instead
         countdownShowFinishedMessage = false;
         countdownFinished = false;
+        displayModesDirty = true;
         countdownFinishedMessageStartTime = 0;
         hourglassPlayed = false;  // Reset if we decide not to show it
         Serial.println("[COUNTDOWN-FINISH] Countdown target invalid or not reached yet, skipping 'TIMES UP'. Advancing display.");
@@ -3506,22 +6145,28 @@ void loop() {
 
       // --- Initial Combined Sequence: Play Hourglass THEN start Flashing ---
       // This 'if' runs ONLY ONCE when the "finished" sequence begins.
-      if (!hourglassPlayed) {                          // <-- This is the single entry point for the combined sequence
-        countdownFinished = true;                      // Mark as finished overall
-        countdownShowFinishedMessage = true;           // Confirm we are in the finished sequence
-        countdownFinishedMessageStartTime = millis();  // Start the 15-second timer for the flashing duration
-
-        // 1. Play Hourglass Animation (Blocking)
-        const char *hourglassFrames[] = { "¡", "¢", "£", "¤" };
-        for (int repeat = 0; repeat < 3; repeat++) {
-          for (int i = 0; i < 4; i++) {
-            P.setTextAlignment(PA_CENTER);
-            P.setCharSpacing(0);
-            P.print(hourglassFrames[i]);
-            delay(350);  // This is blocking! (Total ~4.2 seconds for hourglass)
+      if (!hourglassPlayed) {  // <-- This is the single entry point for the combined sequence
+        if (!timelineActive(TIMELINE_HOURGLASS)) {
+          countdownFinished = true;  // Mark as finished overall
+          displayModesDirty = true;
+          countdownShowFinishedMessage = true;  // Confirm we are in the finished sequence
+          countdownFinishedMessageStartTime = millis();  // Start the 15-second timer for the flashing duration
+
+          // 1. Queue the Hourglass Animation (~4.2 seconds, one frame per loop)
+          const char *hourglassFrames[] = { "¡", "¢", "£", "¤" };
+          timelineStart(TIMELINE_HOURGLASS);
+          for (int repeat = 0; repeat < 3; repeat++) {
+            for (int i = 0; i < 4; i++) {
+              timelineAdd(FRAME_TEXT, hourglassFrames[i], 350, PA_CENTER, 0);
+            }
           }
         }
+        if (!timelineService()) {
+          yield();
+          return;  // Hourglass still playing
+        }
         Serial.println("[COUNTDOWN-FINISH] Played hourglass animation.");
+        invalidateRenderCache();
         P.displayClear();  // Clear display after hourglass animation
 
         // 2. Initialize Flashing "TIMES UP" for its very first frame
@@ -3529,7 +6174,7 @@ void loop() {
         lastFlashingSwitch = millis();  // Set initial time for first flash frame
         P.setTextAlignment(PA_CENTER);
         P.setCharSpacing(0);
-        P.print(flashFrames[flashingMessageFrame]);             // Display the first frame immediately
+        renderText(flashFrames[flashingMessageFrame]);             // Display the first frame immediately
         flashingMessageFrame = (flashingMessageFrame + 1) % 2;  // Prepare for the next frame
 
         hourglassPlayed = true;  // <-- Mark that this initial combined sequence has completed!
@@ -3542,10 +6187,11 @@ void loop() {
       if (millis() - countdownFinishedMessageStartTime < 15000) {  // Flashing duration
         if (millis() - lastFlashingSwitch >= 500) {                // Check for flashing interval
           lastFlashingSwitch = millis();
+          invalidateRenderCache();
           P.displayClear();
           P.setTextAlignment(PA_CENTER);
           P.setCharSpacing(0);
-          P.print(flashFrames[flashingMessageFrame]);
+          renderText(flashFrames[flashingMessageFrame]);
           flashingMessageFrame = (flashingMessageFrame + 1) % 2;
         }
         P.displayAnimate();  // Ensure display updates
@@ -3561,6 +6207,7 @@ void loop() {
         // Final cleanup (persisted)
         countdownEnabled = false;
         countdownTargetTimestamp = 0;
+        displayModesDirty = true;
         countdownLabel[0] = '\0';
         saveCountdownConfig(false, 0, "");
 
@@ -3579,6 +6226,15 @@ void loop() {
       // The new variable `isDramaticCountdown` toggles between the two modes
       if (isDramaticCountdown) {
         // --- EXISTING DRAMATIC COUNTDOWN LOGIC ---
+        if (timelineActive(TIMELINE_COUNTDOWN_SECONDS)) {
+          if (timelineService()) {  // Seconds & label finished
+            countdownSegment++;
+            segmentStartTime = millis();
+          }
+          yield();
+          return;
+        }
+
         long days = timeRemaining / (24 * 3600);
         long hours = (timeRemaining % (24 * 3600)) / 3600;
         long minutes = (timeRemaining % 3600) / 60;
@@ -3587,6 +6243,7 @@ void loop() {
 
         if (segmentStartTime == 0 || (millis() - segmentStartTime > SEGMENT_DISPLAY_DURATION)) {
           segmentStartTime = millis();
+          invalidateRenderCache();
           P.displayClear();
 
           switch (countdownSegment) {
@@ -3622,29 +6279,22 @@ void loop() {
             case 3:
               {  // Seconds & Label Scroll
                 time_t segmentStartTime = time(nullptr);
-                unsigned long segmentStartMillis = millis();
+                const unsigned long firstHold = SEGMENT_DISPLAY_DURATION - 400;
 
                 long nowRemaining = countdownTargetTimestamp - segmentStartTime;
                 long currentSecond = nowRemaining % 60;
                 char secondsBuf[10];
                 sprintf(secondsBuf, "%02ld %s", currentSecond, currentSecond == 1 ? "SEC" : "SECS");
-                String secondsText = String(secondsBuf);
-                Serial.printf("[COUNTDOWN-STATIC] Displaying segment 3: %s\n", secondsText.c_str());
+                Serial.printf("[COUNTDOWN-STATIC] Displaying segment 3: %s\n", secondsBuf);
+                invalidateRenderCache();
                 P.displayClear();
-                P.setTextAlignment(PA_CENTER);
-                P.setCharSpacing(1);
-                P.print(secondsText.c_str());
-                delay(SEGMENT_DISPLAY_DURATION - 400);
+                timelineStart(TIMELINE_COUNTDOWN_SECONDS);
+                timelineAdd(FRAME_TEXT, secondsBuf, firstHold, PA_CENTER, 1);
 
-                unsigned long elapsed = millis() - segmentStartMillis;
-                long adjustedSecond = (countdownTargetTimestamp - segmentStartTime - (elapsed / 1000)) % 60;
+                // Second keyframe shows the count as it will be once the first hold ends
+                long adjustedSecond = (countdownTargetTimestamp - segmentStartTime - (long)(firstHold / 1000)) % 60;
                 sprintf(secondsBuf, "%02ld %s", adjustedSecond, adjustedSecond == 1 ? "SEC" : "SECS");
-                secondsText = String(secondsBuf);
-                P.displayClear();
-                P.setTextAlignment(PA_CENTER);
-                P.setCharSpacing(1);
-                P.print(secondsText.c_str());
-                delay(400);
+                timelineAdd(FRAME_TEXT, secondsBuf, 400, PA_CENTER, 1);
 
                 String label;
                 if (strlen(countdownLabel) > 0) {
@@ -3664,17 +6314,10 @@ void loop() {
                   label = fallbackLabels[randomIndex];
                 }
 
-                P.setTextAlignment(PA_LEFT);
-                P.setCharSpacing(1);
-                textEffect_t actualScrollDirection = getEffectiveScrollDirection(PA_SCROLL_LEFT, flipDisplay);
-                P.displayScroll(label.c_str(), PA_LEFT, actualScrollDirection, GENERAL_SCROLL_SPEED);
-
-                while (!P.displayAnimate()) {
-                  yield();
-                }
-                countdownSegment++;
-                segmentStartTime = millis();
-                break;
+                timelineAdd(FRAME_SCROLL, label.c_str(), 0, PA_LEFT, 1);
+                timelineService();  // Show the first keyframe now
+                yield();
+                return;  // countdownSegment advances when the timeline finishes
               }
             case 4:  // Exit countdown
               Serial.println("[COUNTDOWN-STATIC] All segments and label displayed. Advancing to Clock.");
@@ -3696,14 +6339,14 @@ void loop() {
           if (currentSegmentText.length() > 0) {
             P.setTextAlignment(PA_CENTER);
             P.setCharSpacing(1);
-            P.print(currentSegmentText.c_str());
+            renderText(currentSegmentText.c_str());
           }
         }
         P.displayAnimate();
       }
 
       // --- NEW: SINGLE-LINE COUNTDOWN LOGIC ---
-      else {
+      else if (!timelineActive(TIMELINE_COUNTDOWN_LINE)) {
         long days = timeRemaining / (24 * 3600);
         long hours = (timeRemaining % (24 * 3600)) / 3600;
         long minutes = (timeRemaining % 3600) / 60;
@@ -3733,23 +6376,18 @@ void loop() {
           sprintf(buf, "%s IN: %02ldH %02ldM %02ldS", label.c_str(), hours, minutes, seconds);
         }
 
-        String fullString = String(buf);
-
-        // Display the full string and scroll it
-        P.setTextAlignment(PA_LEFT);
-        P.setCharSpacing(1);
-        textEffect_t actualScrollDirection = getEffectiveScrollDirection(PA_SCROLL_LEFT, flipDisplay);
-        P.displayScroll(fullString.c_str(), PA_LEFT, actualScrollDirection, GENERAL_SCROLL_SPEED);
-
-        // Blocking loop to ensure the full message scrolls
-        while (!P.displayAnimate()) {
-          yield();
+        // Display the full string and scroll it, one animation step per loop
+        timelineStart(TIMELINE_COUNTDOWN_LINE);
+        timelineAdd(FRAME_SCROLL, buf, 0, PA_LEFT, 1);
+        timelineService();
+        yield();
+        return;
+      } else {
+        if (timelineService()) {
+          // After scrolling is complete, we're done with this display mode
+          P.setTextAlignment(PA_CENTER);
+          advanceDisplayMode();
         }
-
-        // After scrolling is complete, we're done with this display mode
-        // Move to the next mode and exit the function.
-        P.setTextAlignment(PA_CENTER);
-        advanceDisplayMode();
         yield();
         return;
       }
@@ -3763,146 +6401,86 @@ void loop() {
   }  // End of if (displayMode == 3 && ...)
 
   // --- NIGHTSCOUT Display Mode ---
+  // Readings come from serviceNightscout(); this only shows the history
   if (displayMode == 4) {
-    String ntpField = String(ntpServer2);
-
-    // These static variables will retain their values between calls to this block
-    static unsigned long lastNightscoutFetchTime = 0;
-    const unsigned long NIGHTSCOUT_FETCH_INTERVAL = 150000;  // 2.5 minutes
-    static int currentGlucose = -1;
-    static String currentDirection = "?";
-
-    // Check if it's time to fetch new data or if we have no data yet
-    if (currentGlucose == -1 || millis() - lastNightscoutFetchTime >= NIGHTSCOUT_FETCH_INTERVAL) {
-      WiFiClientSecure client;
-      client.setInsecure();
-      HTTPClient https;
-      https.begin(client, ntpField);
-      #ifdef ESP32
-        https.setConnectTimeout(5000);
-        https.setTimeout(5000);
-      #else  // ESP8266
-        client.setBufferSizes(512, 512);
-        https.setTimeout(5000);  // Sets both connection and response timeout
-      #endif
-
-      Serial.print("[HTTPS] Nightscout fetch initiated...\n");
-      int httpCode = https.GET();
-
-      if (httpCode == HTTP_CODE_OK) {
-        String payload = https.getString();
-        StaticJsonDocument<1024> doc;
-        DeserializationError error = deserializeJson(doc, payload);
-
-        if (!error && doc.is<JsonArray>() && doc.size() > 0) {
-          JsonObject firstReading = doc[0].as<JsonObject>();
-          currentGlucose = firstReading["glucose"] | firstReading["sgv"] | -1;
-          currentDirection = firstReading["direction"] | "?";
-
-          Serial.printf("Nightscout data fetched: mg/dL %d %s\n", currentGlucose, currentDirection.c_str());
-        } else {
-          Serial.println("Failed to parse Nightscout JSON");
-        }
-      } else {
-        Serial.printf("[HTTPS] GET failed, error: %s\n", https.errorToString(httpCode).c_str());
+    if (timelineActive(TIMELINE_NIGHTSCOUT)) {
+      if (timelineService()) {
+        advanceDisplayMode();
       }
-
-      https.end();
-      client.stop();
-      lastNightscoutFetchTime = millis();  // Update the timestamp
+      yield();
+      return;
     }
 
-    // Display the data we have, which is now stored in static variables
-    if (currentGlucose != -1) {
-      char arrow;
-      if (currentDirection == "Flat") arrow = 139;
-      else if (currentDirection == "SingleUp") arrow = 134;
-      else if (currentDirection == "DoubleUp") arrow = 135;
-      else if (currentDirection == "SingleDown") arrow = 136;
-      else if (currentDirection == "DoubleDown") arrow = 137;
-      else if (currentDirection == "FortyFiveUp") arrow = 138;
-      else if (currentDirection == "FortyFiveDown") arrow = 140;
-      else arrow = '?';
-
-      String displayText = String(currentGlucose) + String(arrow);
-
-      P.setTextAlignment(PA_CENTER);
-      P.setCharSpacing(1);
-      P.print(displayText.c_str());
+    timelineStart(TIMELINE_NIGHTSCOUT);
+    if (glucoseHistory.count() > 0) {
+      const GlucoseReading &latest = glucoseHistory.latest();
+      time_t now = time(nullptr);
+      long age = (now > 1000 && (uint32_t)now > latest.time) ? (long)((uint32_t)now - latest.time) : 0;
+      bool stale = age > NIGHTSCOUT_STALE_SEC;
+
+      // Value and trend arrow, then the change since the previous reading,
+      // or how old the value is once it is stale
+      char text[16];
+      snprintf(text, sizeof(text), "%d%c", latest.mgdl, nightscoutArrow(latest.direction));
+      timelineAdd(FRAME_TEXT, text, weatherDuration, PA_CENTER, 1);
+      int delta;
+      if (stale) {
+        if (age < 5940) snprintf(text, sizeof(text), "%ldm", age / 60);
+        else snprintf(text, sizeof(text), "%ldh", age / 3600);
+        timelineAdd(FRAME_TEXT, text, 2000, PA_CENTER, 1);
+      } else if (glucoseHistory.delta(delta, 2 * NIGHTSCOUT_READING_SEC + 60)) {
+        snprintf(text, sizeof(text), "%+d", delta);
+        timelineAdd(FRAME_TEXT, text, 2000, PA_CENTER, 1);
+      }
 
-      delay(weatherDuration);
-      advanceDisplayMode();
-      return;
+      // Trend graph from the Parola user characters built by rebuildSparkline()
+      if (glucoseHistory.count() >= 2) {
+        timelineAdd(FRAME_TEXT, "\x01\x02\x03\x04", weatherDuration, PA_CENTER, 0);
+      }
     } else {
-      // If no data is available after the first fetch attempt, show an error and advance
-      P.setTextAlignment(PA_CENTER);
-      P.setCharSpacing(0);
-      P.print(F("?)"));
-      delay(2000);  // Wait 2 seconds before advancing
-      advanceDisplayMode();
-      return;
+      // Nothing fetched yet: show an error and advance
+      timelineAdd(FRAME_TEXT, "?)", 2000, PA_CENTER, 0);  // Wait 2 seconds before advancing
     }
+    timelineService();
+    yield();
+    return;
   }
 
   // --- YOUTUBE Display Mode ---
+  // Counts come from serviceYoutube(); each channel in turn, no network here
   else if (displayMode == 6 && youtubeEnabled) {
-    if (currentSubscriberCount.length() == 0 ||
-        millis() - lastYoutubeFetch > youtubeFetchInterval) {
-      fetchYoutubeSubscribers();
+    if (timelineActive(TIMELINE_YOUTUBE)) {
+      if (timelineService()) {
+        advanceDisplayMode();
+      }
+      yield();
+      return;
     }
 
-    if (currentSubscriberCount.length() > 0 &&
-        currentSubscriberCount != "---" &&
-        currentSubscriberCount != "ERR") {
-
-      String display = "YT: " + currentSubscriberCount;
-
-      if (display.length() > 10) {
-        static bool youtubeScrolling = false;
-        static unsigned long youtubeScrollEndTime = 0;
-
-        if (!youtubeScrolling) {
-          P.setCharSpacing(1);
-          textEffect_t scrollDir = getEffectiveScrollDirection(PA_SCROLL_LEFT, flipDisplay);
-          P.displayScroll(display.c_str(), PA_CENTER, scrollDir, GENERAL_SCROLL_SPEED);
-          youtubeScrolling = true;
-          youtubeScrollEndTime = 0;
-        }
-
-        if (P.displayAnimate()) {
-          if (youtubeScrollEndTime == 0) {
-            youtubeScrollEndTime = millis();
-          }
-          if (millis() - youtubeScrollEndTime > 300) {
-            youtubeScrolling = false;
-            youtubeScrollEndTime = 0;
-            advanceDisplayMode();
-          }
-        }
+    timelineStart(TIMELINE_YOUTUBE);
+    bool shown = false;
+    char display[32];
+    for (uint8_t i = 0; i < youtubeChannelCount; i++) {
+      const YoutubeChannel &channel = youtubeChannels[i];
+      if (channel.subscribers < 0) continue;
+      if (youtubeChannelCount == 1 || channel.title[0] == '\0') {
+        snprintf(display, sizeof(display), "YT: %s", channel.text);
       } else {
-        P.setTextAlignment(PA_CENTER);
-        P.setCharSpacing(1);
-        P.print(display.c_str());
-
-        if (millis() - lastSwitch > weatherDuration) {
-          advanceDisplayMode();
-        }
+        snprintf(display, sizeof(display), "%s: %s", channel.title, channel.text);
       }
-    } else {
-      P.setTextAlignment(PA_CENTER);
-      P.setCharSpacing(1);
 
-      if (currentSubscriberCount == "ERR") {
-        P.print("YT: ERR");
+      if (strlen(display) > 10) {
+        timelineAdd(FRAME_SCROLL, display, 0, PA_CENTER, 1);
       } else {
-        P.print("YT: ---");
-      }
-
-      if (millis() - lastSwitch > 2000) {
-        advanceDisplayMode();
+        timelineAdd(FRAME_TEXT, display, weatherDuration, PA_CENTER, 1);
       }
+      shown = true;
     }
 
+    if (!shown) {
+      timelineAdd(FRAME_TEXT, youtubeFetchFailed ? "YT: ERR" : "YT: ---", 2000, PA_CENTER, 1);
+    }
+    timelineService();
     yield();
     return;
   }
@@ -3915,8 +6493,10 @@ void loop() {
       static bool webhookScrollInit = false;
       if (!webhookScrollInit) {
         textEffect_t scrollDir = getEffectiveScrollDirection(PA_SCROLL_LEFT, flipDisplay);
-        P.displayScroll(currentWebhookMessage.text.c_str(), PA_CENTER,
+        invalidateRenderCache();
+        P.displayScroll(currentWebhookMessage.text, PA_CENTER,
                        scrollDir, GENERAL_SCROLL_SPEED);
+        noteShownText(currentWebhookMessage.text);
         webhookScrollInit = true;
       }
 
@@ -3931,7 +6511,7 @@ void loop() {
       }
     } else {
       P.setTextAlignment(PA_CENTER);
-      P.print(currentWebhookMessage.text.c_str());
+      renderText(currentWebhookMessage.text);
 
       if (millis() - lastSwitch >= currentWebhookMessage.duration) {
         processingWebhook = false;
@@ -4025,11 +6605,7 @@ void loop() {
 
     P.setTextAlignment(PA_CENTER);
     P.setCharSpacing(0);
-    P.print(dateString);
-
-    if (millis() - lastSwitch > weatherDuration) {
-      advanceDisplayMode();
-    }
+    renderText(dateString);
   }
   yield();
 }
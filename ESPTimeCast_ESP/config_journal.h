@@ -0,0 +1,75 @@
+#ifndef CONFIG_JOURNAL_H
+#define CONFIG_JOURNAL_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Append-only journal of config patches (see the Config Store section of the
+// sketch). Each record is a fixed header followed by a JSON patch:
+//
+//   [0]    CONFIG_JOURNAL_MAGIC
+//   [1]    ~CONFIG_JOURNAL_MAGIC (cheap guard against a torn header)
+//   [2..3] payload length, little endian (never 0)
+//   [4..7] CRC-32 of the payload, little endian
+//   [8..]  payload
+//
+// A record is applied only if it is complete and its CRC matches, so a power
+// cut during an append loses at most that one record.
+
+#define CONFIG_JOURNAL_MAGIC 0xC5
+#define CONFIG_JOURNAL_HEADER_SIZE 8
+#define CONFIG_JOURNAL_MAX_PAYLOAD 1024
+
+inline uint32_t configJournalCrc32(const uint8_t* data, size_t len) {
+    uint32_t crc = 0xFFFFFFFF;
+    for (size_t i = 0; i < len; i++) {
+        crc ^= data[i];
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+        }
+    }
+    return ~crc;
+}
+
+// Fills header[CONFIG_JOURNAL_HEADER_SIZE] for the given payload
+inline void configJournalHeader(uint8_t* header, const uint8_t* payload, uint16_t len) {
+    uint32_t crc = configJournalCrc32(payload, len);
+    header[0] = CONFIG_JOURNAL_MAGIC;
+    header[1] = (uint8_t)~CONFIG_JOURNAL_MAGIC;
+    header[2] = len & 0xFF;
+    header[3] = len >> 8;
+    header[4] = crc & 0xFF;
+    header[5] = (crc >> 8) & 0xFF;
+    header[6] = (crc >> 16) & 0xFF;
+    header[7] = crc >> 24;
+}
+
+typedef void (*ConfigJournalVisitor)(const char* payload, size_t len, void* ctx);
+
+// Calls visit() for each valid record in order and stops at the first torn or
+// corrupt one. Returns the length of the valid prefix; anything after it is
+// garbage from an interrupted append.
+inline size_t configJournalScan(const uint8_t* buf, size_t size, ConfigJournalVisitor visit, void* ctx) {
+    size_t pos = 0;
+    while (size - pos >= CONFIG_JOURNAL_HEADER_SIZE) {
+        const uint8_t* h = buf + pos;
+        if (h[0] != CONFIG_JOURNAL_MAGIC || h[1] != (uint8_t)~CONFIG_JOURNAL_MAGIC) break;
+
+        size_t len = h[2] | (h[3] << 8);
+        // Empty records are never written: a header torn after its magic
+        // bytes, with zeros where the length and CRC should be, would
+        // otherwise pass, since the CRC of nothing is 0
+        if (len == 0 || len > CONFIG_JOURNAL_MAX_PAYLOAD) break;
+        if (size - pos - CONFIG_JOURNAL_HEADER_SIZE < len) break;
+
+        uint32_t crc = (uint32_t)h[4] | ((uint32_t)h[5] << 8) | ((uint32_t)h[6] << 16) | ((uint32_t)h[7] << 24);
+        const uint8_t* payload = h + CONFIG_JOURNAL_HEADER_SIZE;
+        if (configJournalCrc32(payload, len) != crc) break;
+
+        if (visit) visit((const char*)payload, len, ctx);
+        pos += CONFIG_JOURNAL_HEADER_SIZE + len;
+    }
+    return pos;
+}
+
+#endif // CONFIG_JOURNAL_H
@@ -0,0 +1,24 @@
+#ifndef FNV1A_H
+#define FNV1A_H
+
+#include <stdint.h>
+
+// 32-bit FNV-1a, used wherever the sketch only needs to notice a change
+// (render cache, status events, ETags, webhook coalescing). Hashes chain:
+// pass the previous result as seed to cover several values at once.
+
+#define FNV1A_SEED 2166136261UL
+#define FNV1A_PRIME 16777619UL
+
+inline uint32_t fnv1aByte(uint8_t byte, uint32_t seed = FNV1A_SEED) {
+  return (seed ^ byte) * FNV1A_PRIME;
+}
+
+// Over a NUL-terminated string
+inline uint32_t fnv1a(const char* text, uint32_t seed = FNV1A_SEED) {
+  uint32_t hash = seed;
+  for (const char* p = text; *p; p++) hash = fnv1aByte((uint8_t)*p, hash);
+  return hash;
+}
+
+#endif // FNV1A_H
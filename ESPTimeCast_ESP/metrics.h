@@ -0,0 +1,81 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <stdint.h>
+
+// Fixed-bucket latency histogram for the /metrics endpoint. Bucket bounds are
+// a caller-owned ascending array in any unit (microseconds for the loop and
+// the web handlers, milliseconds for fetches); values above the last bound
+// land in an overflow bucket. Recording is a short scan with no allocation.
+
+#define METRICS_MAX_BUCKETS 14
+
+class LatencyHistogram {
+private:
+  const uint32_t* _bounds;
+  uint8_t _buckets;
+  uint32_t _counts[METRICS_MAX_BUCKETS + 1];  // Last one is the overflow bucket
+  uint32_t _count;
+  uint64_t _sum;
+  uint32_t _max;
+
+public:
+  LatencyHistogram(const uint32_t* bounds, uint8_t buckets)
+    : _bounds(bounds), _buckets(buckets > METRICS_MAX_BUCKETS ? METRICS_MAX_BUCKETS : buckets) {
+    reset();
+  }
+
+  void reset() {
+    for (uint8_t i = 0; i <= METRICS_MAX_BUCKETS; i++) _counts[i] = 0;
+    _count = 0;
+    _sum = 0;
+    _max = 0;
+  }
+
+  void record(uint32_t value) {
+    uint8_t i = 0;
+    while (i < _buckets && value > _bounds[i]) i++;
+    _counts[i]++;
+    _count++;
+    _sum += value;
+    if (value > _max) _max = value;
+  }
+
+  uint8_t buckets() const { return _buckets; }
+  uint32_t bound(uint8_t i) const { return _bounds[i]; }
+  uint32_t count() const { return _count; }
+  uint64_t sum() const { return _sum; }
+  uint32_t max() const { return _max; }
+
+  // Number of values <= bound(i); i == buckets() gives the total
+  uint32_t cumulative(uint8_t i) const {
+    uint32_t total = 0;
+    for (uint8_t b = 0; b <= i && b <= _buckets; b++) total += _counts[b];
+    return total;
+  }
+
+  // Estimated percentile (1..100), interpolated linearly inside the bucket
+  // holding the rank. Never above the largest value seen.
+  uint32_t percentile(uint8_t pct) const {
+    if (_count == 0) return 0;
+    uint32_t rank = (uint32_t)(((uint64_t)_count * pct + 99) / 100);
+    if (rank == 0) rank = 1;
+
+    uint32_t below = 0;
+    for (uint8_t i = 0; i <= _buckets; i++) {
+      uint32_t inBucket = _counts[i];
+      if (below + inBucket >= rank) {
+        uint32_t lower = i ? _bounds[i - 1] : 0;
+        uint32_t upper = i < _buckets ? _bounds[i] : _max;
+        if (upper > _max) upper = _max;
+        if (upper <= lower) return upper;
+        uint32_t estimate = lower + (uint32_t)((uint64_t)(upper - lower) * (rank - below) / inBucket);
+        return estimate > _max ? _max : estimate;
+      }
+      below += inBucket;
+    }
+    return _max;
+  }
+};
+
+#endif // METRICS_H
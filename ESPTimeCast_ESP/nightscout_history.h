@@ -0,0 +1,125 @@
+#ifndef NIGHTSCOUT_HISTORY_H
+#define NIGHTSCOUT_HISTORY_H
+
+#include <stdint.h>
+#include <string.h>
+
+// Recent glucose readings from Nightscout, oldest first, in a fixed ring.
+// Readings only enter in time order, so a poll that returns entries the
+// history already holds adds nothing. Times are Unix seconds.
+//
+// sparkline() draws one reading per column, newest at the right, scaled
+// between the lowest and highest reading shown. Columns are display bytes
+// with bit 0 as the top row, the layout of the font and of Parola's user
+// characters.
+
+#define GLUCOSE_HISTORY_SIZE 36         // 3 hours of 5-minute readings
+#define GLUCOSE_SPARKLINE_MIN_SPAN 40   // mg/dL; flatter data is not stretched to full height
+
+enum GlucoseDirection : uint8_t {
+  GLUCOSE_DIR_NONE,
+  GLUCOSE_DIR_DOUBLE_UP,
+  GLUCOSE_DIR_SINGLE_UP,
+  GLUCOSE_DIR_FORTY_FIVE_UP,
+  GLUCOSE_DIR_FLAT,
+  GLUCOSE_DIR_FORTY_FIVE_DOWN,
+  GLUCOSE_DIR_SINGLE_DOWN,
+  GLUCOSE_DIR_DOUBLE_DOWN
+};
+
+static const char* const glucoseDirectionNames[] = {
+  "NONE", "DoubleUp", "SingleUp", "FortyFiveUp", "Flat", "FortyFiveDown", "SingleDown", "DoubleDown"
+};
+
+// Nightscout's direction field; unknown names ("NOT COMPUTABLE", ...) are NONE
+inline uint8_t glucoseDirectionFromName(const char* name) {
+  if (!name) return GLUCOSE_DIR_NONE;
+  for (uint8_t i = 1; i < sizeof(glucoseDirectionNames) / sizeof(glucoseDirectionNames[0]); i++) {
+    if (strcmp(name, glucoseDirectionNames[i]) == 0) return i;
+  }
+  return GLUCOSE_DIR_NONE;
+}
+
+struct GlucoseReading {
+  uint32_t time;    // Unix seconds of the sensor reading
+  int16_t mgdl;
+  uint8_t direction;
+};
+
+class GlucoseHistory {
+private:
+  GlucoseReading _items[GLUCOSE_HISTORY_SIZE];
+  uint8_t _head;   // Next slot to write
+  uint8_t _count;
+
+public:
+  GlucoseHistory() : _head(0), _count(0) {}
+
+  void clear() {
+    _head = 0;
+    _count = 0;
+  }
+
+  // False if the reading is not newer than the latest one
+  bool add(const GlucoseReading& reading) {
+    if (reading.mgdl <= 0) return false;
+    if (_count > 0 && reading.time <= latest().time) return false;
+    _items[_head] = reading;
+    _head = (_head + 1) % GLUCOSE_HISTORY_SIZE;
+    if (_count < GLUCOSE_HISTORY_SIZE) _count++;
+    return true;
+  }
+
+  uint8_t count() const { return _count; }
+
+  // 0 is the oldest reading held
+  const GlucoseReading& at(uint8_t i) const {
+    return _items[(_head + GLUCOSE_HISTORY_SIZE - _count + i) % GLUCOSE_HISTORY_SIZE];
+  }
+
+  const GlucoseReading& latest() const { return at(_count - 1); }
+
+  // Change since the reading before the latest one, if that is at most
+  // maxGapSec older; across a sensor gap the difference means little
+  bool delta(int& change, uint32_t maxGapSec) const {
+    if (_count < 2) return false;
+    const GlucoseReading& last = latest();
+    const GlucoseReading& previous = at(_count - 2);
+    if (last.time - previous.time > maxGapSec) return false;
+    change = last.mgdl - previous.mgdl;
+    return true;
+  }
+
+  // Fills width columns; vertical steps between neighbouring readings are
+  // drawn so the line stays connected
+  void sparkline(uint8_t* columns, uint8_t width) const {
+    memset(columns, 0, width);
+    uint8_t shown = _count < width ? _count : width;
+    if (shown == 0) return;
+
+    int lo = 32767, hi = -32768;
+    for (uint8_t i = _count - shown; i < _count; i++) {
+      if (at(i).mgdl < lo) lo = at(i).mgdl;
+      if (at(i).mgdl > hi) hi = at(i).mgdl;
+    }
+    if (hi - lo < GLUCOSE_SPARKLINE_MIN_SPAN) {
+      lo = (lo + hi - GLUCOSE_SPARKLINE_MIN_SPAN) / 2;
+      hi = lo + GLUCOSE_SPARKLINE_MIN_SPAN;
+    }
+
+    int previousRow = -1;
+    for (uint8_t i = 0; i < shown; i++) {
+      int value = at(_count - shown + i).mgdl;
+      int row = 7 - ((value - lo) * 7 + (hi - lo) / 2) / (hi - lo);
+      int from = row, to = row;
+      if (previousRow >= 0 && previousRow < row) from = previousRow + 1;
+      if (previousRow > row) to = previousRow - 1;
+      uint8_t column = 0;
+      for (int r = from; r <= to; r++) column |= 1 << r;
+      columns[width - shown + i] = column;
+      previousRow = row;
+    }
+  }
+};
+
+#endif // NIGHTSCOUT_HISTORY_H
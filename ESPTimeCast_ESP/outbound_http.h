@@ -0,0 +1,118 @@
+#ifndef OUTBOUND_HTTP_H
+#define OUTBOUND_HTTP_H
+
+#include <Arduino.h>
+#include <Client.h>
+
+// Pieces of the shared outbound HTTPS client: URL splitting, status and
+// header line parsing, and a body stream that stops at Content-Length.
+// Requests are HTTP/1.0 with Connection: keep-alive, so bodies are never
+// chunked and a connection can stay open once its body is read to the end.
+
+// https://host[:port]/path -> host, port, path ("/" if none; a bare query
+// like "?x" is returned as is and needs a leading "/" in the request line)
+inline bool httpsSplitUrl(const char* url, char* host, size_t hostLen, uint16_t& port, const char*& path) {
+  if (strncmp(url, "https://", 8) != 0) return false;
+  const char* start = url + 8;
+  const char* end = start;
+  while (*end && *end != '/' && *end != ':' && *end != '?') end++;
+  size_t len = end - start;
+  if (len == 0 || len >= hostLen) return false;
+  memcpy(host, start, len);
+  host[len] = '\0';
+
+  port = 443;
+  if (*end == ':') {
+    port = (uint16_t)strtoul(end + 1, nullptr, 10);
+    while (*end && *end != '/' && *end != '?') end++;
+  }
+  path = *end ? end : "/";
+  return port != 0;
+}
+
+// "HTTP/1.1 200 OK" -> 200; 0 if the line is not a status line
+inline int httpStatusCode(const char* line) {
+  if (strncmp(line, "HTTP/1.", 7) != 0 || !line[7] || line[8] != ' ') return 0;
+  return atoi(line + 9);
+}
+
+// Value of header name if line is that header (leading spaces skipped)
+inline const char* httpHeaderValue(const char* line, const char* name) {
+  size_t len = strlen(name);
+  if (strncasecmp(line, name, len) != 0 || line[len] != ':') return nullptr;
+  const char* value = line + len + 1;
+  while (*value == ' ' || *value == '\t') value++;
+  return value;
+}
+
+// Reads from a client up to a byte limit (-1 = none). Timed reads (find,
+// readBytes, ArduinoJson) use this object's own timeout, so the behaviour
+// does not depend on how each core's client interprets setTimeout(). With a
+// deadline, no timed read waits past it, however many reads are left.
+class HttpBodyStream : public Stream {
+private:
+  Client* _client;
+  long _remaining;
+  unsigned long _deadline;  // millis() value, if _hasDeadline
+  bool _hasDeadline;
+
+public:
+  HttpBodyStream() : _client(nullptr), _remaining(0), _deadline(0), _hasDeadline(false) {}
+
+  void setDeadline(unsigned long deadline) {
+    _deadline = deadline;
+    _hasDeadline = true;
+  }
+  void clearDeadline() { _hasDeadline = false; }
+
+  void begin(Client& client, long limit) {
+    _client = &client;
+    _remaining = limit;
+  }
+
+  long remaining() const { return _remaining; }
+  bool complete() const { return _remaining == 0; }
+
+  // One header line without the line end, at most len - 1 characters; the
+  // rest of a longer line is dropped. False on timeout.
+  bool readLine(char* buffer, size_t len) {
+    size_t n = 0;
+    for (;;) {
+      int c = timedRead();
+      if (c < 0) return false;
+      if (c == '\n') break;
+      if (c != '\r' && n + 1 < len) buffer[n++] = (char)c;
+    }
+    buffer[n] = '\0';
+    return true;
+  }
+
+  int available() override {
+    if (!_client || _remaining == 0) return 0;
+    int n = _client->available();
+    return (_remaining > 0 && n > _remaining) ? (int)_remaining : n;
+  }
+
+  int read() override {
+    if (!_client || _remaining == 0) return -1;
+    int c = _client->read();
+    if (c >= 0 && _remaining > 0) _remaining--;
+    if (c < 0 && _hasDeadline) {
+      // Cuts the wait of the timed read in progress (started at
+      // _startMillis) short at the deadline
+      unsigned long left = (long)(_deadline - _startMillis) > 0 ? _deadline - _startMillis : 0;
+      if (left < _timeout) _timeout = left;
+    }
+    return c;
+  }
+
+  int peek() override {
+    if (!_client || _remaining == 0) return -1;
+    return _client->peek();
+  }
+
+  size_t write(uint8_t) override { return 0; }
+  void flush() override {}
+};
+
+#endif // OUTBOUND_HTTP_H
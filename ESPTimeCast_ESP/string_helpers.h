@@ -0,0 +1,124 @@
+#ifndef STRING_HELPERS_H
+#define STRING_HELPERS_H
+
+#include <Arduino.h>
+#include "translit_lookup.h"
+#include "weather_lookup.h"
+
+// String and encoding helpers of the sketch that need nothing from the
+// board, so tests/bench_helpers.cpp can measure them on the host.
+
+// Normalize text for LED display (single pass, see translit_lookup.h)
+inline String normalizeDisplayText(const String &str, bool weatherMode = false) {
+  char buffer[256];
+  normalizeDisplayText(str.c_str(), buffer, sizeof(buffer), weatherMode);
+  return String(buffer);
+}
+
+// Open-Meteo weather code -> display text in the given language
+inline String getWeatherDescription(int code, const char *lang) {
+  const char *description = getWeatherByCode(code, lang);
+  return normalizeDisplayText(String(description), true);
+}
+
+// Subscriber count as shown: exact, or shortened to K / M / B
+inline String formatSubscriberCount(long subscribers, bool shortFormat) {
+  if (!shortFormat) {
+    return String(subscribers);
+  }
+
+  if (subscribers >= 1000000000) {
+    float billions = subscribers / 1000000000.0;
+    return String(billions, 3) + "B";
+  }
+  else if (subscribers >= 1000000) {
+    float millions = subscribers / 1000000.0;
+    return String(millions, 3) + "M";
+  }
+  else if (subscribers >= 1000) {
+    float thousands = subscribers / 1000.0;
+
+    if (subscribers % 1000 == 0) {
+      return String((int)thousands) + "K";
+    }
+
+    char buffer[20];
+    sprintf(buffer, "%.3f", thousands);
+
+    String result = String(buffer);
+    while (result.endsWith("0") && result.indexOf(".") != -1) {
+      result.remove(result.length() - 1);
+    }
+    if (result.endsWith(".")) {
+      result.remove(result.length() - 1);
+    }
+
+    return result + "K";
+  }
+  else {
+    return String(subscribers);
+  }
+}
+
+// RFC 4648 base32, unpadded, for the TOTP secret
+inline void base32_encode(const uint8_t *data, int length, char *result, int resultSize) {
+  const char *base32_alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZ234567";
+  int count = 0;
+  uint32_t buffer = 0;  // Only the low bits matter; unsigned so the shifts may overflow
+  int bitsLeft = 0;
+
+  for (int i = 0; i < length; i++) {
+    buffer <<= 8;
+    buffer |= data[i];
+    bitsLeft += 8;
+
+    while (bitsLeft >= 5) {
+      if (count >= resultSize - 1) break;
+      int index = (buffer >> (bitsLeft - 5)) & 0x1F;
+      result[count++] = base32_alphabet[index];
+      bitsLeft -= 5;
+    }
+  }
+
+  if (bitsLeft > 0 && count < resultSize - 1) {
+    int index = (buffer << (5 - bitsLeft)) & 0x1F;
+    result[count++] = base32_alphabet[index];
+  }
+
+  result[count] = '\0';
+}
+
+// Skips whitespace, padding and anything outside the alphabet; either case
+inline void base32_decode(const char *encoded, uint8_t *result, int resultSize) {
+  uint32_t buffer = 0;  // Only the low bits matter; unsigned so the shifts may overflow
+  int bitsLeft = 0;
+  int count = 0;
+
+  for (int i = 0; encoded[i] && count < resultSize; i++) {
+    char ch = encoded[i];
+
+    if (ch == ' ' || ch == '\n' || ch == '\r' || ch == '\t' || ch == '=') continue;
+
+    int val = -1;
+    if (ch >= 'A' && ch <= 'Z') {
+      val = ch - 'A';
+    } else if (ch >= 'a' && ch <= 'z') {
+      val = ch - 'a';
+    } else if (ch >= '2' && ch <= '7') {
+      val = ch - '2' + 26;
+    }
+
+    if (val == -1) continue;
+
+    buffer <<= 5;
+    buffer |= val;
+    bitsLeft += 5;
+
+    if (bitsLeft >= 8) {
+      result[count++] = (buffer >> (bitsLeft - 8)) & 0xFF;
+      bitsLeft -= 8;
+    }
+  }
+}
+
+#endif // STRING_HELPERS_H
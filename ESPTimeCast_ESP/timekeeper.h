@@ -0,0 +1,139 @@
+#ifndef TIMEKEEPER_H
+#define TIMEKEEPER_H
+
+#include <stdint.h>
+#include <string.h>
+
+// SNTP packet encoding and a drift model for the local clock. All times are
+// microseconds: Unix time for packet timestamps, a monotonic counter
+// (esp_timer / micros64) for the drift model, which is immune to the clock
+// steps it causes.
+//
+// Offset is server time minus local time, so a positive drift means the
+// local clock runs slow and corrections add time.
+
+#define NTP_PACKET_SIZE 48
+#define NTP_UNIX_EPOCH_OFFSET 2208988800UL     // Seconds from 1900 to 1970
+#define CLOCK_DRIFT_MAX_PPB 500000L            // No crystal is off by more than 500 ppm
+#define CLOCK_DRIFT_MIN_SPAN_US 900000000ULL   // Syncs closer than 15 min are too noisy for a rate
+#define CLOCK_STEP_LIMIT_US 1000000LL          // Larger offsets are clock steps, not drift
+#define CLOCK_SLEW_STEP_US 1000                // Drift is corrected in 1 ms steps
+
+struct NtpSample {
+  int64_t offsetUs;   // Server time minus local time
+  uint32_t delayUs;   // Round trip without the server's processing time
+  uint8_t stratum;
+};
+
+inline void ntpWriteTimestamp(uint8_t* p, uint64_t unixUs) {
+  uint32_t sec = (uint32_t)(unixUs / 1000000ULL) + NTP_UNIX_EPOCH_OFFSET;
+  uint32_t frac = (uint32_t)(((unixUs % 1000000ULL) << 32) / 1000000ULL);
+  for (int i = 0; i < 4; i++) {
+    p[i] = sec >> (24 - i * 8);
+    p[4 + i] = frac >> (24 - i * 8);
+  }
+}
+
+inline uint64_t ntpReadTimestamp(const uint8_t* p) {
+  uint32_t sec = ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+  uint32_t frac = ((uint32_t)p[4] << 24) | ((uint32_t)p[5] << 16) | ((uint32_t)p[6] << 8) | p[7];
+  return (uint64_t)(uint32_t)(sec - NTP_UNIX_EPOCH_OFFSET) * 1000000ULL + (((uint64_t)frac * 1000000ULL) >> 32);
+}
+
+// Client request (version 4, mode 3). The server echoes the transmit
+// timestamp back as the originate timestamp, which ties a reply to it.
+inline void ntpBuildRequest(uint8_t* packet, uint64_t sentUs) {
+  memset(packet, 0, NTP_PACKET_SIZE);
+  packet[0] = 0x23;
+  ntpWriteTimestamp(packet + 40, sentUs);
+}
+
+// Checks a reply to the request sent at sentUs and received at receivedUs
+// (both local Unix time) and computes offset and round-trip delay from the
+// four timestamps.
+inline bool ntpParseReply(const uint8_t* packet, size_t len, uint64_t sentUs, uint64_t receivedUs, NtpSample& sample) {
+  if (len < NTP_PACKET_SIZE) return false;
+  uint8_t leap = packet[0] >> 6;
+  uint8_t mode = packet[0] & 0x07;
+  uint8_t stratum = packet[1];
+  if (leap == 3 || mode != 4 || stratum == 0 || stratum > 15) return false;  // Unsynchronized or kiss-o'-death
+
+  uint8_t originate[8];
+  ntpWriteTimestamp(originate, sentUs);
+  if (memcmp(packet + 24, originate, sizeof(originate)) != 0) return false;  // Stale or foreign reply
+
+  static const uint8_t zero[8] = {0};
+  if (memcmp(packet + 32, zero, 8) == 0 || memcmp(packet + 40, zero, 8) == 0) return false;
+  int64_t serverReceived = (int64_t)ntpReadTimestamp(packet + 32);
+  int64_t serverSent = (int64_t)ntpReadTimestamp(packet + 40);
+
+  int64_t t1 = (int64_t)sentUs;
+  int64_t t4 = (int64_t)receivedUs;
+  sample.offsetUs = ((serverReceived - t1) + (serverSent - t4)) / 2;
+  int64_t delay = (t4 - t1) - (serverSent - serverReceived);
+  sample.delayUs = delay > 0 ? (uint32_t)delay : 0;
+  sample.stratum = stratum;
+  return true;
+}
+
+// Learns the rate error of the local clock from consecutive syncs and hands
+// out small corrections between them. After a sync the residual offset is
+// what the current drift estimate missed over the span since the previous
+// one, so the estimate is nudged by offset / span.
+class ClockDiscipline {
+private:
+  int32_t _driftPpb;
+  uint64_t _lastSyncUs;   // Monotonic time of the last sync
+  uint64_t _lastSlewUs;   // Corrections are handed out up to here
+  int64_t _lastOffsetUs;
+  uint32_t _lastDelayUs;
+  bool _synced;
+  bool _slewing;
+
+public:
+  ClockDiscipline()
+    : _driftPpb(0), _lastSyncUs(0), _lastSlewUs(0), _lastOffsetUs(0), _lastDelayUs(0), _synced(false), _slewing(false) {}
+
+  // An NTP sample has just been applied to the clock
+  void sync(int64_t offsetUs, uint32_t delayUs, uint64_t nowUs) {
+    bool step = offsetUs >= CLOCK_STEP_LIMIT_US || offsetUs <= -CLOCK_STEP_LIMIT_US;
+    if (_synced && !step && nowUs - _lastSyncUs >= CLOCK_DRIFT_MIN_SPAN_US) {
+      int64_t drift = _driftPpb + offsetUs * 1000000000LL / (int64_t)(nowUs - _lastSyncUs);
+      if (drift > CLOCK_DRIFT_MAX_PPB) drift = CLOCK_DRIFT_MAX_PPB;
+      if (drift < -CLOCK_DRIFT_MAX_PPB) drift = -CLOCK_DRIFT_MAX_PPB;
+      _driftPpb = (int32_t)drift;
+    }
+    _lastOffsetUs = offsetUs;
+    _lastDelayUs = delayUs;
+    _lastSyncUs = nowUs;
+    _lastSlewUs = nowUs;
+    _synced = true;
+    _slewing = true;
+  }
+
+  // Drift known from before a warm reboot; corrections start right away
+  void restore(int32_t driftPpb, uint64_t nowUs) {
+    if (driftPpb > CLOCK_DRIFT_MAX_PPB || driftPpb < -CLOCK_DRIFT_MAX_PPB) return;
+    _driftPpb = driftPpb;
+    _lastSlewUs = nowUs;
+    _slewing = true;
+  }
+
+  // Microseconds to add to the clock now, in whole CLOCK_SLEW_STEP_US steps;
+  // the remainder carries over to the next call
+  int32_t correction(uint64_t nowUs) {
+    if (!_slewing || _driftPpb == 0) return 0;
+    int64_t due = (int64_t)_driftPpb * (int64_t)(nowUs - _lastSlewUs) / 1000000000LL;
+    if (due > -CLOCK_SLEW_STEP_US && due < CLOCK_SLEW_STEP_US) return 0;
+    due = due / CLOCK_SLEW_STEP_US * CLOCK_SLEW_STEP_US;
+    _lastSlewUs += (uint64_t)(due * 1000000000LL / _driftPpb);
+    return (int32_t)due;
+  }
+
+  bool synced() const { return _synced; }
+  int32_t driftPpb() const { return _driftPpb; }
+  int64_t lastOffsetUs() const { return _lastOffsetUs; }
+  uint32_t lastDelayUs() const { return _lastDelayUs; }
+};
+
+#endif // TIMEKEEPER_H
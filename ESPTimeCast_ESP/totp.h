@@ -4,161 +4,66 @@
 #include <Arduino.h>
 #include <time.h>
 
-// Compatibility macro for ESP8266/ESP32
-#ifdef ESP32
-  #define WDT_FEED() yield()
-#else // ESP8266
-  #ifndef WDT_FEED
-    #define WDT_FEED() ESP.wdtFeed()
-  #endif
-#endif
+// RFC 6238 TOTP (HMAC-SHA1, 6 digits). The key is only needed to derive the
+// HMAC inner and outer SHA-1 states, so setSecret() hashes the padded key
+// blocks once and every code after that costs two compressions: one for the
+// 8-byte counter and one for the 20-byte inner digest. verify() compares
+// integer codes and never touches the heap.
+//
+// A code that has logged in once is not accepted again (RFC 6238 section
+// 5.2): the time steps of recent successful verifications are remembered.
+
+#define TOTP_REPLAY_SLOTS 8  // Must cover the widest verify() window (2 * window + 1)
 
 class SimpleTOTP {
 private:
-  static const int MAX_KEY_LENGTH = 32;
-  uint8_t _hmacKey[MAX_KEY_LENGTH];
-  uint8_t _keyLength;
+  uint32_t _innerState[5];  // SHA-1 state after the key ^ ipad block
+  uint32_t _outerState[5];  // SHA-1 state after the key ^ opad block
+  bool _hasKey;
   uint8_t _timeStep;
-  uint16_t _yieldCounter;
+  uint64_t _usedSteps[TOTP_REPLAY_SLOTS];
+  uint8_t _usedCount;
+  uint8_t _usedNext;
 
-  inline uint32_t rol32(uint32_t number, uint8_t bits) {
+  static inline uint32_t rol32(uint32_t number, uint8_t bits) {
     return ((number << bits) | (number >> (32 - bits)));
   }
 
-  // Safe yield - avoids yield in interrupt contexts
-  inline void safeYield() {
-    _yieldCounter++;
-    if ((_yieldCounter & 0xFF) == 0) {
-      #ifdef ESP8266
-        if (!isInterrupt()) {
-          yield();
-        }
-      #else
-        yield();
-      #endif
-    }
-  }
-
-  void sha1(const uint8_t* data, size_t dataLen, uint8_t* hash) {
-    // SHA1 initial state
-    uint32_t state[5] = {
-      0x67452301UL,
-      0xefcdab89UL,
-      0x98badcfeUL,
-      0x10325476UL,
-      0xc3d2e1f0UL
-    };
-
-    uint32_t w[16];
-    uint8_t buffer[64];
-    size_t bufferOffset = 0;
-    uint64_t totalBits = dataLen * 8;
-
-    // Process data
-    for (size_t i = 0; i < dataLen; i++) {
-      buffer[bufferOffset++] = data[i];
-
-      if (bufferOffset == 64) {
-        // Convert to big-endian words
-        for (int j = 0; j < 16; j++) {
-          w[j] = ((uint32_t)buffer[j*4] << 24) |
-                 ((uint32_t)buffer[j*4+1] << 16) |
-                 ((uint32_t)buffer[j*4+2] << 8) |
-                 ((uint32_t)buffer[j*4+3]);
-        }
-        hashBlock(state, w);
-        bufferOffset = 0;
-      }
-    }
-
-    // Padding
-    buffer[bufferOffset++] = 0x80;
-
-    if (bufferOffset > 56) {
-      while (bufferOffset < 64) {
-        buffer[bufferOffset++] = 0;
-      }
-
-      for (int j = 0; j < 16; j++) {
-        w[j] = ((uint32_t)buffer[j*4] << 24) |
-               ((uint32_t)buffer[j*4+1] << 16) |
-               ((uint32_t)buffer[j*4+2] << 8) |
-               ((uint32_t)buffer[j*4+3]);
-      }
-      hashBlock(state, w);
-      bufferOffset = 0;
-    }
-
-    while (bufferOffset < 56) {
-      buffer[bufferOffset++] = 0;
-    }
-
-    // Add length
-    for (int i = 0; i < 8; i++) {
-      buffer[56 + i] = (totalBits >> ((7 - i) * 8)) & 0xFF;
-    }
-
-    for (int j = 0; j < 16; j++) {
-      w[j] = ((uint32_t)buffer[j*4] << 24) |
-             ((uint32_t)buffer[j*4+1] << 16) |
-             ((uint32_t)buffer[j*4+2] << 8) |
-             ((uint32_t)buffer[j*4+3]);
-    }
-    hashBlock(state, w);
-
-    // Convert result
-    for (int i = 0; i < 5; i++) {
-      hash[i*4] = (state[i] >> 24) & 0xFF;
-      hash[i*4+1] = (state[i] >> 16) & 0xFF;
-      hash[i*4+2] = (state[i] >> 8) & 0xFF;
-      hash[i*4+3] = state[i] & 0xFF;
-    }
-  }
-
-  void hashBlock(uint32_t* state, uint32_t* w) {
+  // One SHA-1 compression over a 16-word big-endian block. The schedule is
+  // kept as a rolling 16-word window instead of 80 expanded words.
+  static void compress(uint32_t* state, uint32_t* w) {
     uint32_t a = state[0];
     uint32_t b = state[1];
     uint32_t c = state[2];
     uint32_t d = state[3];
     uint32_t e = state[4];
-    uint32_t temp;
-
-    // Message schedule
-    uint32_t w_extended[80];
-    for (int i = 0; i < 16; i++) {
-      w_extended[i] = w[i];
-    }
 
-    for (int i = 16; i < 80; i++) {
-      w_extended[i] = rol32(w_extended[i-3] ^ w_extended[i-8] ^
-                           w_extended[i-14] ^ w_extended[i-16], 1);
-      if ((i & 0x0F) == 0) {
-        WDT_FEED();
+    for (int i = 0; i < 80; i++) {
+      uint32_t word;
+      if (i < 16) {
+        word = w[i];
+      } else {
+        word = rol32(w[(i + 13) & 15] ^ w[(i + 8) & 15] ^ w[(i + 2) & 15] ^ w[i & 15], 1);
+        w[i & 15] = word;
       }
-    }
 
-    // Compression
-    for (int i = 0; i < 80; i++) {
+      uint32_t f;
       if (i < 20) {
-        temp = ((b & c) | ((~b) & d)) + 0x5a827999UL;
+        f = (d ^ (b & (c ^ d))) + 0x5a827999UL;
       } else if (i < 40) {
-        temp = (b ^ c ^ d) + 0x6ed9eba1UL;
+        f = (b ^ c ^ d) + 0x6ed9eba1UL;
       } else if (i < 60) {
-        temp = ((b & c) | (b & d) | (c & d)) + 0x8f1bbcdcUL;
+        f = ((b & c) | (d & (b | c))) + 0x8f1bbcdcUL;
       } else {
-        temp = (b ^ c ^ d) + 0xca62c1d6UL;
+        f = (b ^ c ^ d) + 0xca62c1d6UL;
       }
 
-      temp += rol32(a, 5) + e + w_extended[i];
+      uint32_t temp = rol32(a, 5) + f + e + word;
       e = d;
       d = c;
       c = rol32(b, 30);
       b = a;
       a = temp;
-
-      if ((i & 0x0F) == 0) {
-        WDT_FEED();
-      }
     }
 
     state[0] += a;
@@ -168,135 +73,160 @@ private:
     state[4] += e;
   }
 
-  void hmacSha1(const uint8_t* key, uint8_t keyLength,
-                const uint8_t* data, uint8_t dataLen, uint8_t* result) {
-    uint8_t keyBuffer[64];
-    uint8_t innerPad[64];
-    uint8_t outerPad[64];
-    uint8_t innerHash[20];
-
-    // Prepare key
-    memset(keyBuffer, 0, 64);
-    if (keyLength > 64) {
-      sha1(key, keyLength, keyBuffer);
-      keyLength = 20;
-    } else {
-      memcpy(keyBuffer, key, keyLength);
-    }
-
-    // Create pads
-    for (int i = 0; i < 64; i++) {
-      innerPad[i] = keyBuffer[i] ^ 0x36;
-      outerPad[i] = keyBuffer[i] ^ 0x5c;
+  static void loadBlock(uint32_t* w, const uint8_t* block) {
+    for (int j = 0; j < 16; j++) {
+      w[j] = ((uint32_t)block[j*4] << 24) |
+             ((uint32_t)block[j*4+1] << 16) |
+             ((uint32_t)block[j*4+2] << 8) |
+             ((uint32_t)block[j*4+3]);
     }
+  }
 
-    // Inner hash
-    uint8_t tempBuffer[84];
-    memcpy(tempBuffer, innerPad, 64);
-    memcpy(tempBuffer + 64, data, dataLen);
-    sha1(tempBuffer, 64 + dataLen, innerHash);
+  // State after compressing one 64-byte block of key ^ pad
+  static void padState(const uint8_t* key, uint8_t pad, uint32_t* state) {
+    uint8_t block[64];
+    for (int i = 0; i < 64; i++) block[i] = key[i] ^ pad;
+    uint32_t w[16];
+    loadBlock(w, block);
+    state[0] = 0x67452301UL;
+    state[1] = 0xefcdab89UL;
+    state[2] = 0x98badcfeUL;
+    state[3] = 0x10325476UL;
+    state[4] = 0xc3d2e1f0UL;
+    compress(state, w);
+    memset(block, 0, sizeof(block));
+  }
 
-    WDT_FEED();
+  static bool parseCode(const char* text, uint32_t& code) {
+    code = 0;
+    for (int i = 0; i < 6; i++) {
+      if (text[i] < '0' || text[i] > '9') return false;
+      code = code * 10 + (text[i] - '0');
+    }
+    return text[6] == '\0';
+  }
 
-    // Outer hash
-    memcpy(tempBuffer, outerPad, 64);
-    memcpy(tempBuffer + 64, innerHash, 20);
-    sha1(tempBuffer, 84, result);
+  bool stepUsed(uint64_t steps) const {
+    for (uint8_t i = 0; i < _usedCount; i++) {
+      if (_usedSteps[i] == steps) return true;
+    }
+    return false;
   }
 
-  #ifdef ESP8266
-  bool isInterrupt() {
-    uint32_t ps;
-    __asm__ __volatile__("rsr %0,ps":"=a" (ps));
-    return (ps & 0x0F) != 0;
+  void markUsed(uint64_t steps) {
+    _usedSteps[_usedNext] = steps;
+    _usedNext = (_usedNext + 1) % TOTP_REPLAY_SLOTS;
+    if (_usedCount < TOTP_REPLAY_SLOTS) _usedCount++;
   }
-  #endif
 
 public:
-  SimpleTOTP() : _keyLength(0), _timeStep(30), _yieldCounter(0) {
-    memset(_hmacKey, 0, sizeof(_hmacKey));
-  }
+  uint32_t replaysRejected;  // Correct codes refused because they were already used
+
+  SimpleTOTP() : _hasKey(false), _timeStep(30), _usedCount(0), _usedNext(0), replaysRejected(0) {}
 
   SimpleTOTP(const uint8_t* key, size_t keyLen, uint8_t timeStep = 30)
-    : _yieldCounter(0) {
+    : _hasKey(false), _timeStep(timeStep), _usedCount(0), _usedNext(0), replaysRejected(0) {
     setSecret(key, keyLen);
-    _timeStep = timeStep;
   }
 
+  // Keys up to one SHA-1 block (64 bytes); the device uses 20
   bool setSecret(const uint8_t* key, size_t keyLen) {
-    if (keyLen == 0 || keyLen > MAX_KEY_LENGTH) {
+    if (keyLen == 0 || keyLen > 64) {
       return false;
     }
 
-    _keyLength = keyLen;
-    memcpy(_hmacKey, key, keyLen);
+    uint8_t keyBlock[64];
+    memset(keyBlock, 0, sizeof(keyBlock));
+    memcpy(keyBlock, key, keyLen);
+    padState(keyBlock, 0x36, _innerState);
+    padState(keyBlock, 0x5c, _outerState);
+    memset(keyBlock, 0, sizeof(keyBlock));
+
+    _hasKey = true;
+    _usedCount = 0;  // A new secret starts a new history
+    _usedNext = 0;
     return true;
   }
 
+  // The 6-digit code for a time step, as a number
+  uint32_t codeFromSteps(uint64_t steps) {
+    // Inner: counter + padding for 64 + 8 bytes
+    uint32_t inner[5];
+    memcpy(inner, _innerState, sizeof(inner));
+    uint32_t w[16] = {};
+    w[0] = (uint32_t)(steps >> 32);
+    w[1] = (uint32_t)steps;
+    w[2] = 0x80000000UL;
+    w[15] = (64 + 8) * 8;
+    compress(inner, w);
+
+    // Outer: inner digest + padding for 64 + 20 bytes
+    uint32_t hash[5];
+    memcpy(hash, _outerState, sizeof(hash));
+    memset(w, 0, sizeof(w));
+    memcpy(w, inner, sizeof(inner));
+    w[5] = 0x80000000UL;
+    w[15] = (64 + 20) * 8;
+    compress(hash, w);
+
+    // Dynamic truncation over the big-endian digest bytes
+    uint8_t digest[20];
+    for (int i = 0; i < 5; i++) {
+      digest[i*4] = hash[i] >> 24;
+      digest[i*4+1] = hash[i] >> 16;
+      digest[i*4+2] = hash[i] >> 8;
+      digest[i*4+3] = hash[i];
+    }
+    uint8_t offset = digest[19] & 0x0F;
+    uint32_t code = ((uint32_t)(digest[offset] & 0x7F) << 24) |
+                    ((uint32_t)digest[offset + 1] << 16) |
+                    ((uint32_t)digest[offset + 2] << 8) |
+                    ((uint32_t)digest[offset + 3]);
+    return code % 1000000;
+  }
+
   String getCode(time_t timeStamp) {
-    if (_keyLength == 0 || timeStamp == 0) {
+    if (!_hasKey || timeStamp <= 0) {
       return String("000000");
     }
-
-    uint32_t steps = timeStamp / _timeStep;
-    return getCodeFromSteps(steps);
+    return getCodeFromSteps((uint64_t)timeStamp / _timeStep);
   }
 
-  String getCodeFromSteps(uint32_t steps) {
-    if (_keyLength == 0) {
+  String getCodeFromSteps(uint64_t steps) {
+    if (!_hasKey) {
       return String("000000");
     }
-
-    _yieldCounter = 0;
-
-    // Convert steps to 8-byte big-endian
-    uint8_t timeBytes[8];
-    memset(timeBytes, 0, 8);
-    for (int i = 4; i < 8; i++) {
-      timeBytes[i] = (steps >> ((7 - i) * 8)) & 0xFF;
-    }
-
-    // Calculate HMAC
-    uint8_t hash[20];
-    hmacSha1(_hmacKey, _keyLength, timeBytes, 8, hash);
-
-    // Dynamic truncation
-    uint8_t offset = hash[19] & 0x0F;
-    uint32_t code = 0;
-
-    code = ((uint32_t)(hash[offset] & 0x7F) << 24) |
-           ((uint32_t)hash[offset + 1] << 16) |
-           ((uint32_t)hash[offset + 2] << 8) |
-           ((uint32_t)hash[offset + 3]);
-
-    code %= 1000000;
-
-    char buffer[7];
-    sprintf(buffer, "%06lu", (unsigned long)code);
-
+    char buffer[12];
+    snprintf(buffer, sizeof(buffer), "%06lu", (unsigned long)codeFromSteps(steps));
     return String(buffer);
   }
 
-  bool verify(const String& userCode, time_t timestamp, uint8_t windowSize = 1) {
-    if (_keyLength == 0 || userCode.length() != 6) {
+  // Accepts codes from windowSize steps before to windowSize steps after
+  // timestamp, each one only once
+  bool verify(const char* userCode, time_t timestamp, uint8_t windowSize = 1) {
+    uint32_t code;
+    if (!_hasKey || !userCode || !parseCode(userCode, code)) {
       return false;
     }
 
+    int64_t current = (int64_t)timestamp / _timeStep;
     for (int i = -windowSize; i <= windowSize; i++) {
-      WDT_FEED();
-      time_t testTime = timestamp + (i * _timeStep);
-      if (testTime > 0) {
-        WDT_FEED();
-        String expectedCode = getCode(testTime);
-        WDT_FEED();
-        if (expectedCode == userCode) {
-          return true;
-        }
+      int64_t steps = current + i;
+      if (steps <= 0 || codeFromSteps((uint64_t)steps) != code) continue;
+
+      if (stepUsed((uint64_t)steps)) {
+        replaysRejected++;
+        return false;
       }
-      delay(2);
+      markUsed((uint64_t)steps);
+      return true;
     }
     return false;
   }
+
+  bool verify(const String& userCode, time_t timestamp, uint8_t windowSize = 1) {
+    return verify(userCode.c_str(), timestamp, windowSize);
+  }
 };
 
-#endif // TOTP_H
\ No newline at end of file
+#endif // TOTP_H
@@ -0,0 +1,202 @@
+#ifndef TRANSLIT_LOOKUP_H
+#define TRANSLIT_LOOKUP_H
+
+#include <Arduino.h>
+
+// Codepoint -> ASCII transliteration for the LED font (Latin diacritics,
+// Serbian and Russian Cyrillic). Outputs are already upper case.
+// MUST stay sorted by codepoint: normalizeDisplayText() binary-searches it.
+typedef struct {
+    uint16_t codepoint;
+    char ascii[2];  // Second char is 0 for single-letter mappings
+} TranslitMapping;
+
+constexpr TranslitMapping translit_mappings[] PROGMEM = {
+    {0x00DF, {'S', 'S'}},  // ß
+    {0x00E0, {'A', 0}},  // à
+    {0x00E1, {'A', 0}},  // á
+    {0x00E2, {'A', 0}},  // â
+    {0x00E3, {'A', 0}},  // ã
+    {0x00E4, {'A', 0}},  // ä
+    {0x00E5, {'A', 0}},  // å
+    {0x00E6, {'A', 'E'}},  // æ
+    {0x00E7, {'C', 0}},  // ç
+    {0x00E8, {'E', 0}},  // è
+    {0x00E9, {'E', 0}},  // é
+    {0x00EA, {'E', 0}},  // ê
+    {0x00EB, {'E', 0}},  // ë
+    {0x00EC, {'I', 0}},  // ì
+    {0x00ED, {'I', 0}},  // í
+    {0x00EE, {'I', 0}},  // î
+    {0x00EF, {'I', 0}},  // ï
+    {0x00F1, {'N', 0}},  // ñ
+    {0x00F2, {'O', 0}},  // ò
+    {0x00F3, {'O', 0}},  // ó
+    {0x00F4, {'O', 0}},  // ô
+    {0x00F5, {'O', 0}},  // õ
+    {0x00F6, {'O', 0}},  // ö
+    {0x00F8, {'O', 0}},  // ø
+    {0x00F9, {'U', 0}},  // ù
+    {0x00FA, {'U', 0}},  // ú
+    {0x00FB, {'U', 0}},  // û
+    {0x00FC, {'U', 0}},  // ü
+    {0x00FD, {'Y', 0}},  // ý
+    {0x00FF, {'Y', 0}},  // ÿ
+    {0x0101, {'A', 0}},  // ā
+    {0x0103, {'A', 0}},  // ă
+    {0x0105, {'A', 0}},  // ą
+    {0x0107, {'C', 0}},  // ć
+    {0x010D, {'C', 0}},  // č
+    {0x010F, {'D', 0}},  // ď
+    {0x0113, {'E', 0}},  // ē
+    {0x0117, {'E', 0}},  // ė
+    {0x0119, {'E', 0}},  // ę
+    {0x011F, {'G', 0}},  // ğ
+    {0x0123, {'G', 0}},  // ģ
+    {0x0125, {'H', 0}},  // ĥ
+    {0x012B, {'I', 0}},  // ī
+    {0x012F, {'I', 0}},  // į
+    {0x0135, {'J', 0}},  // ĵ
+    {0x0137, {'K', 0}},  // ķ
+    {0x013E, {'L', 0}},  // ľ
+    {0x0142, {'L', 0}},  // ł
+    {0x0144, {'N', 0}},  // ń
+    {0x0146, {'N', 0}},  // ņ
+    {0x014D, {'O', 0}},  // ō
+    {0x0151, {'O', 0}},  // ő
+    {0x0153, {'O', 'E'}},  // œ
+    {0x0155, {'R', 0}},  // ŕ
+    {0x015B, {'S', 0}},  // ś
+    {0x015D, {'S', 0}},  // ŝ
+    {0x0161, {'S', 0}},  // š
+    {0x0165, {'T', 0}},  // ť
+    {0x016B, {'U', 0}},  // ū
+    {0x016F, {'U', 0}},  // ů
+    {0x0171, {'U', 0}},  // ű
+    {0x0175, {'W', 0}},  // ŵ
+    {0x0177, {'Y', 0}},  // ŷ
+    {0x017A, {'Z', 0}},  // ź
+    {0x017C, {'Z', 0}},  // ż
+    {0x017E, {'Z', 0}},  // ž
+    {0x0219, {'S', 0}},  // ș
+    {0x021B, {'T', 0}},  // ț
+    {0x0430, {'A', 0}},  // а
+    {0x0431, {'B', 0}},  // б
+    {0x0432, {'V', 0}},  // в
+    {0x0433, {'G', 0}},  // г
+    {0x0434, {'D', 0}},  // д
+    {0x0435, {'E', 0}},  // е
+    {0x0436, {'Z', 0}},  // ж
+    {0x0437, {'Z', 0}},  // з
+    {0x0438, {'I', 0}},  // и
+    {0x0439, {'J', 0}},  // й
+    {0x043A, {'K', 0}},  // к
+    {0x043B, {'L', 0}},  // л
+    {0x043C, {'M', 0}},  // м
+    {0x043D, {'N', 0}},  // н
+    {0x043E, {'O', 0}},  // о
+    {0x043F, {'P', 0}},  // п
+    {0x0440, {'R', 0}},  // р
+    {0x0441, {'S', 0}},  // с
+    {0x0442, {'T', 0}},  // т
+    {0x0443, {'U', 0}},  // у
+    {0x0444, {'F', 0}},  // ф
+    {0x0445, {'H', 0}},  // х
+    {0x0446, {'C', 0}},  // ц
+    {0x0447, {'C', 0}},  // ч
+    {0x0448, {'S', 0}},  // ш
+    {0x0449, {'S', 'H'}},  // щ
+    {0x044B, {'Y', 0}},  // ы
+    {0x044D, {'E', 0}},  // э
+    {0x044E, {'Y', 'U'}},  // ю
+    {0x044F, {'Y', 'A'}},  // я
+    {0x0451, {'E', 0}},  // ё
+    {0x0452, {'D', 'J'}},  // ђ
+    {0x0458, {'J', 0}},  // ј
+    {0x0459, {'L', 'J'}},  // љ
+    {0x045A, {'N', 'J'}},  // њ
+    {0x045B, {'C', 0}},  // ћ
+    {0x045F, {'D', 'Z'}},  // џ
+};
+
+#define TRANSLIT_MAPPINGS_COUNT (sizeof(translit_mappings)/sizeof(translit_mappings[0]))
+
+constexpr bool translitMappingsSorted(size_t i) {
+    return i + 1 >= TRANSLIT_MAPPINGS_COUNT ||
+           (translit_mappings[i].codepoint < translit_mappings[i + 1].codepoint && translitMappingsSorted(i + 1));
+}
+static_assert(translitMappingsSorted(0), "translit_mappings must be sorted by codepoint");
+
+// Returns the mapping for a codepoint, or nullptr if it has none
+inline const TranslitMapping* findTranslit(uint32_t codepoint) {
+    if (codepoint < translit_mappings[0].codepoint || codepoint > 0xFFFF) return nullptr;
+    size_t lo = 0;
+    size_t hi = TRANSLIT_MAPPINGS_COUNT;
+    while (lo < hi) {
+        size_t mid = (lo + hi) / 2;
+        uint16_t cp = pgm_read_word(&translit_mappings[mid].codepoint);
+        if (cp == codepoint) return &translit_mappings[mid];
+        if (cp < codepoint) lo = mid + 1;
+        else hi = mid;
+    }
+    return nullptr;
+}
+
+inline bool isDisplayChar(char c, bool weatherMode) {
+    if (weatherMode) {
+        return (c >= 'A' && c <= 'Z') || c == ' ';
+    }
+    return (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') ||
+           c == ' ' || c == '.' || c == ',' || c == '!' ||
+           c == ':' || c == '-' || c == '_' || c == '%';
+}
+
+// Single pass over UTF-8 input: decode, transliterate, upper-case and filter
+// into out (always NUL-terminated, truncated to outSize - 1 chars).
+// Unmapped codepoints and malformed bytes (including overlong forms) are
+// dropped.
+// Returns the number of chars written.
+inline size_t normalizeDisplayText(const char* in, char* out, size_t outSize, bool weatherMode = false) {
+    if (outSize == 0) return 0;
+    size_t n = 0;
+    const uint8_t* p = (const uint8_t*)in;
+
+    while (*p && n < outSize - 1) {
+        uint8_t b = *p;
+
+        if (b < 0x80) {
+            char c = (b >= 'a' && b <= 'z') ? (char)(b - 32) : (char)b;
+            if (isDisplayChar(c, weatherMode)) out[n++] = c;
+            p++;
+            continue;
+        }
+
+        uint32_t cp, minimum;
+        int extra;
+        if ((b & 0xE0) == 0xC0) { cp = b & 0x1F; extra = 1; minimum = 0x80; }
+        else if ((b & 0xF0) == 0xE0) { cp = b & 0x0F; extra = 2; minimum = 0x800; }
+        else if ((b & 0xF8) == 0xF0) { cp = b & 0x07; extra = 3; minimum = 0x10000; }
+        else { p++; continue; }  // Stray continuation or invalid lead byte
+
+        p++;
+        int i = 0;
+        for (; i < extra && (*p & 0xC0) == 0x80; i++, p++) {
+            cp = (cp << 6) | (*p & 0x3F);
+        }
+        if (i < extra) continue;  // Truncated sequence
+        if (cp < minimum) continue;  // Overlong form, not the character it spells
+
+        const TranslitMapping* m = findTranslit(cp);
+        if (!m) continue;
+
+        char c0 = (char)pgm_read_byte(&m->ascii[0]);
+        char c1 = (char)pgm_read_byte(&m->ascii[1]);
+        if (isDisplayChar(c0, weatherMode)) out[n++] = c0;
+        if (c1 && n < outSize - 1 && isDisplayChar(c1, weatherMode)) out[n++] = c1;
+    }
+
+    out[n] = '\0';
+    return n;
+}
+
+#endif // TRANSLIT_LOOKUP_H
@@ -1,104 +1,248 @@
 #ifndef TZ_LOOKUP_H
 #define TZ_LOOKUP_H
 
-typedef struct {
-    const char* iana;
-    const char* posix;
-} TimeZoneMapping;
+// GENERATED by Scripts/gen_tz_lookup.py from tzdata 2025b. Do not edit by hand.
+// 597 zones, 94 distinct POSIX rules, 7900 bytes of flash
+// (plain name/rule strings would take 17100).
 
-const TimeZoneMapping tz_mappings[] = {
-    {"Africa/Cairo", "EET-2EEST,M4.5.5/0,M10.5.5/0"},
-    {"Africa/Casablanca", "WET0WEST,M3.5.0/0,M10.5.0/0"},
-    {"Africa/Johannesburg", "SAST-2"},
-    {"America/Anchorage", "AKST9AKDT,M3.2.0,M11.1.0"},
-    {"America/Argentina/Buenos_Aires", "ART3"},
-    {"America/Chicago", "CST6CDT,M3.2.0,M11.1.0"},
-    {"America/Denver", "MST7MDT,M3.2.0,M11.1.0"},
-    {"America/Guatemala", "CST6"},
-    {"America/Halifax", "AST4ADT,M3.2.0,M11.1.0"},
-    {"America/Los_Angeles", "PST8PDT,M3.2.0,M11.1.0"},
-    {"America/Mexico_City", "CST6CDT,M4.1.0,M10.5.0"},
-    {"America/New_York", "EST5EDT,M3.2.0,M11.1.0"},
-    {"America/Phoenix", "MST7"},
-    {"America/Santiago", "CLT4CLST,M9.1.6/24,M4.1.6/24"},
-    {"America/Sao_Paulo", "BRT3"},
-    {"America/St_Johns", "NST3:30NDT,M3.2.0,M11.1.0"},
-    {"America/Toronto", "EST5EDT,M3.2.0,M11.1.0"},
-    {"America/Vancouver", "PST8PDT,M3.2.0,M11.1.0"},
-    {"Asia/Almaty", "ALMT-6"},
-    {"Asia/Amman", "EET-2EEST,M3.5.4/24,M10.5.5/1"},
-    {"Asia/Baghdad", "AST-3"},
-    {"Asia/Bangkok", "ICT-7"},
-    {"Asia/Beirut", "EET-2EEST,M3.5.0/0,M10.5.0/0"},
-    {"Asia/Dhaka", "BDT-6"},
-    {"Asia/Dubai", "GST-4"},
-    {"Asia/Ho_Chi_Minh", "ICT-7"},
-    {"Asia/Hong_Kong", "HKT-8"},
-    {"Asia/Jakarta", "WIB-7"},
-    {"Asia/Jerusalem", "IST-2IDT,M3.4.4/26,M10.5.0"},
-    {"Asia/Karachi", "PKT-5"},
-    {"Asia/Kathmandu", "NPT-5:45"},
-    {"Asia/Kolkata", "IST-5:30"},
-    {"Asia/Kuala_Lumpur", "MYT-8"},
-    {"Asia/Manila", "PST-8"},
-    {"Asia/Seoul", "KST-9"},
-    {"Asia/Shanghai", "CST-8"},
-    {"Asia/Singapore", "SGT-8"},
-    {"Asia/Taipei", "CST-8"},
-    {"Asia/Tashkent", "UZT-5"},
-    {"Asia/Tokyo", "JST-9"},
-    {"Asia/Ulaanbaatar", "ULAT-8"},
-    {"Asia/Yekaterinburg", "YEKT-5"},
-    {"Atlantic/Azores", "AZOT1AZOST,M3.5.0/0,M10.5.0/0"},
-    {"Atlantic/Reykjavik", "GMT0"},
-    {"Australia/Adelaide", "ACST-9:30ACDT,M10.1.0,M4.1.0"},
-    {"Australia/Brisbane", "AEST-10"},
-    {"Australia/Darwin", "ACST-9:30"},
-    {"Australia/Hobart", "AEST-10AEDT,M10.1.0,M4.1.0"},
-    {"Australia/Melbourne", "AEST-10AEDT,M10.1.0,M4.1.0"},
-    {"Australia/Perth", "AWST-8"},
-    {"Australia/Sydney", "AEST-10AEDT,M10.1.0,M4.1.0"},
-    {"Europe/Amsterdam", "CET-1CEST,M3.5.0,M10.5.0/3"},
-    {"Europe/Athens", "EET-2EEST,M3.5.0/3,M10.5.0/4"},
-    {"Europe/Belgrade", "CET-1CEST,M3.5.0,M10.5.0/3"},
-    {"Europe/Berlin", "CET-1CEST,M3.5.0,M10.5.0/3"},
-    {"Europe/Brussels", "CET-1CEST,M3.5.0,M10.5.0/3"},
-    {"Europe/Bucharest", "EET-2EEST,M3.5.0/3,M10.5.0/4"},
-    {"Europe/Copenhagen", "CET-1CEST,M3.5.0,M10.5.0/3"},
-    {"Europe/Dublin", "GMT0IST,M3.5.0/1,M10.5.0"},
-    {"Europe/Helsinki", "EET-2EEST,M3.5.0/3,M10.5.0/4"},
-    {"Europe/Istanbul", "TRT-3"},
-    {"Europe/Kiev", "EET-2EEST,M3.5.0/3,M10.5.0/4"},
-    {"Europe/Lisbon", "WET0WEST,M3.5.0/0,M10.5.0/0"},
-    {"Europe/London", "GMT0BST,M3.5.0/1,M10.5.0"},
-    {"Europe/Madrid", "CET-1CEST,M3.5.0,M10.5.0/3"},
-    {"Europe/Moscow", "MSK-3"},
-    {"Europe/Oslo", "CET-1CEST,M3.5.0,M10.5.0/3"},
-    {"Europe/Paris", "CET-1CEST,M3.5.0,M10.5.0/3"},
-    {"Europe/Prague", "CET-1CEST,M3.5.0,M10.5.0/3"},
-    {"Europe/Rome", "CET-1CEST,M3.5.0,M10.5.0/3"},
-    {"Europe/Stockholm", "CET-1CEST,M3.5.0,M10.5.0/3"},
-    {"Europe/Warsaw", "CET-1CEST,M3.5.0,M10.5.0/3"},
-    {"Pacific/Auckland", "NZST-12NZDT,M9.5.0,M4.1.0"},
-    {"Pacific/Chatham", "CHAST-12:45CHADT,M9.5.0,M4.1.0/3"},
-    {"Pacific/Fiji", "FJT-12"},
-    {"Pacific/Guam", "ChST-10"},
-    {"Pacific/Honolulu", "HST10"},
-    {"Pacific/Port_Moresby", "PGT-10"},
-    {"Pacific/Tahiti", "TAHT10"},
-    {"UTC", "UTC0"},
-    {"Etc/GMT+1", "GMT-1"},
-    {"Etc/GMT-1", "GMT+1"}
+#include <Arduino.h>
+
+#define TZ_ZONE_COUNT 597
+#define TZ_BLOCK_SIZE 16
+#define TZ_BLOCK_COUNT 38
+#define TZ_NAME_MAX_LEN 32
+#define TZ_POSIX_MAX_LEN 44
+
+// De-duplicated POSIX TZ strings, NUL separated
+const char tz_posix_pool[] PROGMEM =
+    "<+00>0<+02>-2,M3.5.0/1,M10.5.0/3\000<+01>-1\000<+02>-2\000<+0330>-3:30\000<+03>-3\000<+0430>-4:3"
+    "0\000<+04>-4\000<+0530>-5:30\000<+0545>-5:45\000<+05>-5\000<+0630>-6:30\000<+06>-6\000<+07>-7"
+    "\000<+0845>-8:45\000<+08>-8\000<+09>-9\000<+1030>-10:30<+11>-11,M10.1.0,M4.1.0\000<+10>-10\000<+"
+    "11>-11\000<+11>-11<+12>,M10.1.0,M4.1.0/3\000<+1245>-12:45<+1345>,M9.5.0/2:45,M4.1.0/3:45\000<+12"
+    ">-12\000<+13>-13\000<+14>-14\000<-01>1\000<-01>1<+00>,M3.5.0/0,M10.5.0/1\000<-02>2\000<-02>2<-01"
+    ">,M3.5.0/-1,M10.5.0/0\000<-03>3\000<-03>3<-02>,M3.2.0,M11.1.0\000<-04>4\000<-04>4<-03>,M9.1.6/24"
+    ",M4.1.6/24\000<-05>5\000<-06>6\000<-06>6<-05>,M9.1.6/22,M4.1.6/22\000<-07>7\000<-08>8\000<-0930>"
+    "9:30\000<-09>9\000<-10>10\000<-11>11\000<-12>12\000ACST-9:30\000ACST-9:30ACDT,M10.1.0,M4.1.0/3"
+    "\000AEST-10\000AEST-10AEDT,M10.1.0,M4.1.0/3\000AKST9AKDT,M3.2.0,M11.1.0\000AST4\000AST4ADT,M3.2."
+    "0,M11.1.0\000AWST-8\000CAT-2\000CET-1\000CET-1CEST,M3.5.0,M10.5.0/3\000CST-8\000CST5CDT,M3.2.0/0"
+    ",M11.1.0/1\000CST6\000CST6CDT,M3.2.0,M11.1.0\000ChST-10\000EAT-3\000EET-2\000EET-2EEST,M3.4.4/50"
+    ",M10.4.4/50\000EET-2EEST,M3.5.0,M10.5.0/3\000EET-2EEST,M3.5.0/0,M10.5.0/0\000EET-2EEST,M3.5.0/3,"
+    "M10.5.0/4\000EET-2EEST,M4.5.5/0,M10.5.4/24\000EST5\000EST5EDT,M3.2.0,M11.1.0\000GMT0\000GMT0BST,"
+    "M3.5.0/1,M10.5.0\000HKT-8\000HST10\000HST10HDT,M3.2.0,M11.1.0\000IST-1GMT0,M10.5.0,M3.5.0/1\000I"
+    "ST-2IDT,M3.4.4/26,M10.5.0\000IST-5:30\000JST-9\000KST-9\000MET-1MEST,M3.5.0,M10.5.0/3\000MSK-3"
+    "\000MST7\000MST7MDT,M3.2.0,M11.1.0\000NST3:30NDT,M3.2.0,M11.1.0\000NZST-12NZDT,M9.5.0,M4.1.0/3"
+    "\000PKT-5\000PST-8\000PST8PDT,M3.2.0,M11.1.0\000SAST-2\000SST11\000UTC0\000WAT-1\000WET0WEST,M3."
+    "5.0/1,M10.5.0\000WIB-7\000WIT-9\000WITA-8\000";
+
+// Offset into tz_posix_pool for each zone, in sorted zone order
+const uint16_t tz_zone_posix[] PROGMEM = {
+    1026, 1026, 840, 738, 840, 840, 1026, 1335, 1026, 1026, 732, 1335,
+    732, 968, 33, 744, 1026, 1026, 840, 840, 1335, 33, 1026, 732,
+    732, 1317, 732, 840, 732, 732, 1335, 1335, 1335, 1026, 1335, 732,
+    732, 1335, 732, 1317, 1317, 840, 1026, 840, 1335, 1335, 1026, 1026,
+    1335, 1026, 1026, 846, 738, 732, 1068, 672, 697, 697, 418, 418,
+    418, 418, 418, 418, 418, 418, 418, 418, 418, 418, 418, 418,
+    697, 418, 998, 1068, 418, 804, 697, 418, 804, 697, 452, 491,
+    1205, 418, 1205, 452, 998, 452, 418, 418, 998, 809, 804, 1205,
+    998, 418, 804, 418, 1200, 452, 697, 1026, 1200, 1200, 1205, 1003,
+    697, 1205, 491, 804, 1294, 1200, 1003, 418, 702, 386, 702, 1003,
+    697, 697, 804, 491, 452, 702, 777, 1200, 1003, 809, 1003, 1003,
+    809, 1003, 1003, 1003, 1003, 1205, 1003, 998, 418, 672, 1003, 1003,
+    809, 697, 452, 491, 1294, 1003, 697, 418, 804, 452, 697, 697,
+    809, 1200, 418, 809, 804, 672, 804, 425, 702, 804, 418, 1003,
+    697, 1003, 1003, 1003, 672, 379, 809, 809, 809, 386, 809, 998,
+    1003, 418, 1200, 1003, 697, 491, 452, 697, 418, 809, 809, 418,
+    804, 809, 491, 418, 1294, 418, 459, 697, 418, 386, 1205, 672,
+    697, 1228, 697, 697, 697, 697, 804, 804, 702, 1003, 1294, 1003,
+    697, 1294, 697, 1200, 809, 672, 1205, 167, 146, 220, 643, 117,
+    1254, 418, 418, 1254, 62, 0, 117, 744, 62, 117, 62, 314,
+    117, 117, 117, 117, 117, 62, 62, 83, 146, 146, 910, 138,
+    167, 1146, 175, 167, 771, 771, 91, 138, 62, 138, 175, 83,
+    117, 939, 852, 771, 852, 146, 1056, 146, 167, 62, 1367, 1373,
+    1119, 70, 314, 1282, 138, 104, 104, 175, 1146, 146, 167, 167,
+    62, 771, 771, 229, 1379, 1288, 83, 939, 146, 146, 138, 117,
+    146, 1367, 1161, 62, 117, 117, 125, 62, 146, 229, 117, 1161,
+    771, 167, 229, 771, 117, 83, 49, 1119, 138, 138, 1155, 146,
+    1379, 167, 167, 138, 220, 146, 220, 175, 125, 117, 83, 348,
+    702, 1341, 341, 1341, 1341, 744, 1341, 1026, 379, 1026, 418, 643,
+    604, 635, 604, 643, 643, 594, 154, 643, 183, 635, 183, 643,
+    643, 594, 725, 635, 604, 643, 643, 643, 725, 604, 491, 379,
+    418, 452, 744, 809, 702, 809, 1003, 1205, 1228, 1294, 804, 1200,
+    459, 505, 777, 939, 998, 1003, 968, 1092, 1026, 1026, 341, 570,
+    578, 586, 379, 418, 452, 491, 498, 537, 544, 563, 1026, 33,
+    220, 229, 314, 323, 332, 41, 62, 83, 117, 138, 146, 167,
+    175, 1026, 1026, 1330, 1330, 1330, 1330, 744, 744, 83, 939, 1031,
+    744, 744, 744, 744, 939, 744, 744, 883, 744, 1092, 744, 1031,
+    939, 1031, 62, 1031, 846, 939, 1194, 939, 1341, 744, 1031, 744,
+    744, 744, 939, 62, 744, 1194, 939, 744, 744, 744, 744, 939,
+    744, 83, 744, 744, 83, 1194, 744, 939, 744, 939, 744, 883,
+    83, 939, 744, 744, 744, 939, 1194, 744, 744, 939, 744, 1031,
+    1031, 1026, 1026, 1026, 1026, 1026, 1062, 1056, 1026, 840, 138, 146,
+    125, 840, 117, 83, 117, 83, 840, 83, 49, 1119, 998, 1155,
+    314, 846, 1167, 1200, 1205, 1294, 1200, 804, 1254, 269, 1205, 771,
+    1294, 323, 1254, 229, 269, 220, 505, 229, 323, 323, 314, 314,
+    498, 563, 229, 832, 1062, 1062, 323, 332, 229, 314, 314, 551,
+    1324, 314, 578, 238, 229, 1324, 175, 544, 229, 229, 220, 570,
+    832, 1324, 570, 314, 323, 220, 314, 314, 220, 744, 1341, 771,
+    1161, 167, 62, 1330, 672, 1068, 1200, 809, 1003, 1003, 1062, 809,
+    1003, 1205, 1294, 1324, 1330, 1330, 1194, 1341, 1330
 };
 
-#define TZ_MAPPINGS_COUNT (sizeof(tz_mappings)/sizeof(tz_mappings[0]))
+// Offset into tz_zone_names of the first (whole) name of each block
+const uint16_t tz_block_index[] PROGMEM = {
+    0, 134, 283, 425, 598, 747, 900, 1052, 1202, 1371, 1515, 1661,
+    1840, 1991, 2161, 2319, 2442, 2572, 2717, 2849, 2993, 3149, 3315, 3455,
+    3620, 3714, 3771, 3883, 4039, 4166, 4295, 4416, 4554, 4668, 4807, 4946,
+    5071, 5213
+};
+
+// Sorted zone names, front-coded: <shared prefix length byte><suffix>\0
+const char tz_zone_names[] PROGMEM =
+    "\000Africa/Abidjan\000\010ccra\000\010ddis_Ababa\000\010lgiers\000\010smara\000\012era\000\007Ba"
+    "mako\000\011ngui\000\012jul\000\010issau\000\010lantyre\000\010razzaville\000\010ujumbura\000"
+    "\007Cairo\000\011sablanca\000\010euta\000\000Africa/Conakry\000\007Dakar\000\011r_es_Salaam\000"
+    "\010jibouti\000\010ouala\000\007El_Aaiun\000\007Freetown\000\007Gaborone\000\007Harare\000\007Jo"
+    "hannesburg\000\010uba\000\007Kampala\000\010hartoum\000\010igali\000\011nshasa\000\007Lagos\000"
+    "\000Africa/Libreville\000\010ome\000\010uanda\000\011bumbashi\000\011saka\000\007Malabo\000\011p"
+    "uto\000\011seru\000\010babane\000\010ogadishu\000\011nrovia\000\007Nairobi\000\010djamena\000"
+    "\010iamey\000\010ouakchott\000\007Ouagadougou\000\000Africa/Porto-Novo\000\007Sao_Tome\000\007Ti"
+    "mbuktu\000\010ripoli\000\010unis\000\007Windhoek\000\001merica/Adak\000\011nchorage\000\012guill"
+    "a\000\012tigua\000\011raguaina\000\012gentina/Buenos_Aires\000\022Catamarca\000\023omodRivadavia"
+    "\000\024rdoba\000\022Jujuy\000\000America/Argentina/La_Rioja\000\022Mendoza\000\022Rio_Gallegos"
+    "\000\022Salta\000\024n_Juan\000\026Luis\000\022Tucuman\000\022Ushuaia\000\012uba\000\011suncion"
+    "\000\011tikokan\000\012ka\000\010Bahia\000\015_Banderas\000\012rbados\000\011elem\000\000America"
+    "/Belize\000\011lanc-Sablon\000\011oa_Vista\000\012gota\000\012ise\000\011uenos_Aires\000\010Camb"
+    "ridge_Bay\000\013po_Grande\000\012ncun\000\012racas\000\012tamarca\000\012yenne\000\013man\000"
+    "\011hicago\000\013huahua\000\011iudad_Juarez\000\000America/Coral_Harbour\000\013doba\000\012sta"
+    "_Rica\000\012yhaique\000\011reston\000\011uiaba\000\012racao\000\010Danmarkshavn\000\012wson\000"
+    "\016_Creek\000\011enver\000\012troit\000\011ominica\000\010Edmonton\000\011irunepe\000\011l_Salv"
+    "ador\000\000America/Ensenada\000\010Fort_Nelson\000\015Wayne\000\014aleza\000\010Glace_Bay\000"
+    "\011odthab\000\012ose_Bay\000\011rand_Turk\000\012enada\000\011uadeloupe\000\013temala\000\013ya"
+    "quil\000\012yana\000\010Halifax\000\012vana\000\011ermosillo\000\000America/Indiana/Indianapolis"
+    "\000\020Knox\000\020Marengo\000\020Petersburg\000\020Tell_City\000\020Vevay\000\021incennes\000"
+    "\020Winamac\000\017polis\000\012uvik\000\011qaluit\000\010Jamaica\000\011ujuy\000\012neau\000"
+    "\010Kentucky/Louisville\000\021Monticello\000\000America/Knox_IN\000\011ralendijk\000\010La_Paz"
+    "\000\011ima\000\011os_Angeles\000\012uisville\000\012wer_Princes\000\010Maceio\000\012nagua\000"
+    "\014us\000\012rigot\000\013tinique\000\012tamoros\000\012zatlan\000\011endoza\000\013ominee\000"
+    "\000America/Merida\000\012tlakatla\000\012xico_City\000\011iquelon\000\011oncton\000\013terrey"
+    "\000\015video\000\014real\000\014serrat\000\010Nassau\000\011ew_York\000\011ipigon\000\011ome"
+    "\000\012ronha\000\013th_Dakota/Beulah\000\025Center\000\000America/North_Dakota/New_Salem\000"
+    "\011uuk\000\010Ojinaga\000\010Panama\000\013gnirtung\000\012ramaribo\000\011hoenix\000\011ort-au"
+    "-Prince\000\014_of_Spain\000\014o_Acre\000\016Velho\000\011uerto_Rico\000\012nta_Arenas\000\010R"
+    "ainy_River\000\012nkin_Inlet\000\011ecife\000\000America/Regina\000\012solute\000\011io_Branco"
+    "\000\011osario\000\010Santa_Isabel\000\015rem\000\014iago\000\014o_Domingo\000\012o_Paulo\000"
+    "\011coresbysund\000\011hiprock\000\011itka\000\011t_Barthelemy\000\013Johns\000\013Kitts\000\013"
+    "Lucia\000\000America/St_Thomas\000\013Vincent\000\011wift_Current\000\010Tegucigalpa\000\011hule"
+    "\000\013nder_Bay\000\011ijuana\000\011oronto\000\013tola\000\010Vancouver\000\011irgin\000\010Wh"
+    "itehorse\000\011innipeg\000\010Yakutat\000\011ellowknife\000\001ntarctica/Casey\000\000Antarctic"
+    "a/Davis\000\014umontDUrville\000\013Macquarie\000\015wson\000\014cMurdo\000\013Palmer\000\013Rot"
+    "hera\000\013South_Pole\000\014yowa\000\013Troll\000\013Vostok\000\001rctic/Longyearbyen\000\001s"
+    "ia/Aden\000\006lmaty\000\006mman\000\006nadyr\000\000Asia/Aqtau\000\010obe\000\006shgabat\000"
+    "\010khabad\000\006tyrau\000\005Baghdad\000\007hrain\000\007ku\000\007ngkok\000\007rnaul\000\006e"
+    "irut\000\006ishkek\000\006runei\000\005Calcutta\000\006hita\000\007oibalsan\000\000Asia/Chongqin"
+    "g\000\007ungking\000\006olombo\000\005Dacca\000\007mascus\000\006haka\000\006ili\000\006ubai\000"
+    "\007shanbe\000\005Famagusta\000\005Gaza\000\005Harbin\000\006ebron\000\006o_Chi_Minh\000\007ng_K"
+    "ong\000\007vd\000\000Asia/Irkutsk\000\006stanbul\000\005Jakarta\000\007yapura\000\006erusalem"
+    "\000\005Kabul\000\007mchatka\000\007rachi\000\007shgar\000\007thmandu\000\010mandu\000\006handyg"
+    "a\000\006olkata\000\006rasnoyarsk\000\006uala_Lumpur\000\007ching\000\000Asia/Kuwait\000\005Maca"
+    "o\000\011u\000\007gadan\000\007kassar\000\007nila\000\006uscat\000\005Nicosia\000\006ovokuznetsk"
+    "\000\011sibirsk\000\005Omsk\000\006ral\000\005Phnom_Penh\000\006ontianak\000\006yongyang\000\005"
+    "Qatar\000\000Asia/Qostanay\000\006yzylorda\000\005Rangoon\000\006iyadh\000\005Saigon\000\007khal"
+    "in\000\007markand\000\006eoul\000\006hanghai\000\006ingapore\000\006rednekolymsk\000\005Taipei"
+    "\000\007shkent\000\006bilisi\000\006ehran\000\007l_Aviv\000\000Asia/Thimbu\000\011phu\000\006oky"
+    "o\000\007msk\000\005Ujung_Pandang\000\006laanbaatar\000\010n_Bator\000\006rumqi\000\006st-Nera"
+    "\000\005Vientiane\000\006ladivostok\000\005Yakutsk\000\007ngon\000\006ekaterinburg\000\007revan"
+    "\000\001tlantic/Azores\000\000Atlantic/Bermuda\000\011Canary\000\013pe_Verde\000\011Faeroe\000"
+    "\013roe\000\011Jan_Mayen\000\011Madeira\000\011Reykjavik\000\011South_Georgia\000\012t_Helena"
+    "\000\013anley\000\001ustralia/ACT\000\013delaide\000\012Brisbane\000\014oken_Hill\000\012Canberr"
+    "a\000\000Australia/Currie\000\012Darwin\000\012Eucla\000\012Hobart\000\012LHI\000\013indeman\000"
+    "\013ord_Howe\000\012Melbourne\000\012NSW\000\013orth\000\012Perth\000\012Queensland\000\012South"
+    "\000\013ydney\000\012Tasmania\000\012Victoria\000\000Australia/West\000\012Yancowinna\000\000Bra"
+    "zil/Acre\000\007DeNoronha\000\007East\000\007West\000\000CET\000\001ST6CDT\000\001anada/Atlantic"
+    "\000\007Central\000\007Eastern\000\007Mountain\000\007Newfoundland\000\007Pacific\000\007Saskatc"
+    "hewan\000\007Yukon\000\000Chile/Continental\000\006EasterIsland\000\001uba\000\000EET\000\001ST"
+    "\000\0035EDT\000\001gypt\000\001ire\000\001tc/GMT\000\007+0\000\0101\000\0110\000\0111\000\0112"
+    "\000\0102\000\0103\000\000Etc/GMT+4\000\0105\000\0106\000\0107\000\0108\000\0109\000\007-0\000"
+    "\0101\000\0110\000\0111\000\0112\000\0113\000\0114\000\0102\000\0103\000\0104\000\000Etc/GMT-5"
+    "\000\0106\000\0107\000\0108\000\0109\000\0070\000\005reenwich\000\004UCT\000\005TC\000\005nivers"
+    "al\000\004Zulu\000\001urope/Amsterdam\000\010ndorra\000\010strakhan\000\010thens\000\007Belfast"
+    "\000\000Europe/Belgrade\000\011rlin\000\010ratislava\000\011ussels\000\010ucharest\000\011dapest"
+    "\000\011singen\000\007Chisinau\000\010openhagen\000\007Dublin\000\007Gibraltar\000\010uernsey"
+    "\000\007Helsinki\000\007Isle_of_Man\000\011tanbul\000\007Jersey\000\000Europe/Kaliningrad\000"
+    "\010iev\000\011rov\000\010yiv\000\007Lisbon\000\010jubljana\000\010ondon\000\010uxembourg\000"
+    "\007Madrid\000\011lta\000\011riehamn\000\010insk\000\010onaco\000\011scow\000\007Nicosia\000\007"
+    "Oslo\000\000Europe/Paris\000\010odgorica\000\010rague\000\007Riga\000\010ome\000\007Samara\000"
+    "\011n_Marino\000\011rajevo\000\013tov\000\010imferopol\000\010kopje\000\010ofia\000\010tockholm"
+    "\000\007Tallinn\000\010irane\000\013spol\000\000Europe/Ulyanovsk\000\010zhgorod\000\007Vaduz\000"
+    "\011tican\000\010ienna\000\011lnius\000\010olgograd\000\007Warsaw\000\007Zagreb\000\011porozhye"
+    "\000\010urich\000\000GB\000\002-Eire\000\001MT\000\003+0\000\003-0\000\000GMT0\000\001reenwich"
+    "\000\000HST\000\001ongkong\000\000Iceland\000\001ndian/Antananarivo\000\007Chagos\000\011ristmas"
+    "\000\010ocos\000\011moro\000\007Kerguelen\000\007Mahe\000\011ldives\000\011uritius\000\011yotte"
+    "\000\007Reunion\000\000Iran\000\001srael\000\000Jamaica\000\002pan\000\000Kwajalein\000\000Libya"
+    "\000\000MET\000\001ST\000\0037MDT\000\001exico/BajaNorte\000\013Sur\000\007General\000\000NZ\000"
+    "\002-CHAT\000\001avajo\000\000PRC\000\000PST8PDT\000\001acific/Apia\000\011uckland\000\010Bougai"
+    "nville\000\010Chatham\000\012uuk\000\010Easter\000\011fate\000\011nderbury\000\010Fakaofo\000"
+    "\011iji\000\011unafuti\000\010Galapagos\000\012mbier\000\011uadalcanal\000\013m\000\000Pacific/H"
+    "onolulu\000\010Johnston\000\010Kanton\000\011iritimati\000\011osrae\000\011wajalein\000\010Majur"
+    "o\000\012rquesas\000\011idway\000\010Nauru\000\011iue\000\011orfolk\000\012umea\000\010Pago_Pago"
+    "\000\012lau\000\011itcairn\000\000Pacific/Pohnpei\000\012nape\000\012rt_Moresby\000\010Rarotonga"
+    "\000\010Saipan\000\012moa\000\010Tahiti\000\012rawa\000\011ongatapu\000\011ruk\000\010Wake\000"
+    "\012llis\000\010Yap\000\001oland\000\002rtugal\000\000ROC\000\000ROK\000\000Singapore\000\000Tur"
+    "key\000\000UCT\000\001S/Alaska\000\005eutian\000\004rizona\000\003Central\000\003East-Indiana"
+    "\000\007ern\000\003Hawaii\000\003Indiana-Starke\000\003Michigan\000\004ountain\000\003Pacific"
+    "\000\003Samoa\000\000UTC\000\001niversal\000\000W-SU\000\001ET\000\000Zulu\000";
+
+// Compares key against a NUL-terminated string in PROGMEM
+inline int tzComparePgm(const char* key, const char* pgm) {
+    for (;; key++, pgm++) {
+        uint8_t a = (uint8_t)*key;
+        uint8_t b = pgm_read_byte(pgm);
+        if (a != b || a == 0) return (int)a - (int)b;
+    }
+}
 
+// Returns the POSIX TZ string for an IANA zone name ("UTC0" if unknown).
+// O(log n): binary search over block heads, then decode one block.
+// The result lives in a static buffer, valid until the next call.
 inline const char* ianaToPosix(const char* iana) {
-    for (size_t i = 0; i < TZ_MAPPINGS_COUNT; i++) {
-        if (strcmp(iana, tz_mappings[i].iana) == 0)
-            return tz_mappings[i].posix;
+    static char posix[TZ_POSIX_MAX_LEN + 1];
+
+    size_t lo = 0;
+    size_t hi = TZ_BLOCK_COUNT;
+    while (lo < hi) {
+        size_t mid = (lo + hi) / 2;
+        const char* head = tz_zone_names + pgm_read_word(&tz_block_index[mid]) + 1;
+        if (tzComparePgm(iana, head) < 0) hi = mid;
+        else lo = mid + 1;
+    }
+    if (lo == 0) return "UTC0";  // fallback
+
+    size_t block = lo - 1;
+    const char* p = tz_zone_names + pgm_read_word(&tz_block_index[block]);
+    char name[TZ_NAME_MAX_LEN + 1];
+
+    for (size_t i = 0; i < TZ_BLOCK_SIZE; i++) {
+        size_t zone = block * TZ_BLOCK_SIZE + i;
+        if (zone >= TZ_ZONE_COUNT) break;
+
+        size_t n = pgm_read_byte(p++);
+        char c;
+        while ((c = (char)pgm_read_byte(p++)) != '\0' && n < TZ_NAME_MAX_LEN) {
+            name[n++] = c;
+        }
+        name[n] = '\0';
+
+        int cmp = strcmp(iana, name);
+        if (cmp == 0) {
+            const char* src = tz_posix_pool + pgm_read_word(&tz_zone_posix[zone]);
+            size_t j = 0;
+            while (j < TZ_POSIX_MAX_LEN && (posix[j] = (char)pgm_read_byte(src + j)) != '\0') j++;
+            posix[j] = '\0';
+            return posix;
+        }
+        if (cmp < 0) break;
     }
     return "UTC0"; // fallback
 }
 
-#endif // TZ_LOOKUP_H
\ No newline at end of file
+#endif // TZ_LOOKUP_H
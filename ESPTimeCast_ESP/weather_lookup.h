@@ -185,81 +185,188 @@ const WeatherTermsMapping weather_terms[] = {
 
 #define WEATHER_TERMS_COUNT (sizeof(weather_terms)/sizeof(weather_terms[0]))
 
-inline void translateAPIWeatherTerms(String& desc, const char* lang) {
-    desc.toUpperCase();
+// Index of each field in WeatherTermsMapping::terms, in declaration order
+enum WeatherTerm : uint8_t {
+    WT_CLEAR, WT_MOSTLY_CLEAR, WT_PARTLY_CLOUDY, WT_MOSTLY_CLOUDY, WT_CLOUDY,
+    WT_OVERCAST, WT_FOG, WT_DRIZZLE, WT_RAIN, WT_HEAVY_RAIN, WT_SNOW, WT_SHOWERS,
+    WT_SNOW_SHOWERS, WT_THUNDERSTORM, WT_HAIL, WT_MIST, WT_LIGHT, WT_MODERATE,
+    WT_HEAVY, WT_BROKEN_CLOUDS, WT_SCATTERED_CLOUDS, WT_FEW_CLOUDS, WT_SLEET,
+    WT_FLURRIES, WT_WIND, WT_HAZE, WT_SMOKE, WT_PRECIPITATION, WT_INTENSITY,
+    WT_FREEZING, WT_SHOWER, WT_EXTREME, WT_VERY, WT_SAND, WT_DUST, WT_ASH,
+    WT_VOLCANIC, WT_SQUALL, WT_TORNADO,
+    WT_COUNT,
+    WT_NONE = 0xFF
+};
+
+static_assert(sizeof(WeatherTermsMapping::terms) == WT_COUNT * sizeof(const char*),
+              "WeatherTerm must list every field of WeatherTermsMapping::terms");
+
+typedef struct {
+    const char* phrase;  // English (OpenWeather/PirateWeather), upper case
+    uint8_t first;       // Term to emit, WT_NONE drops the phrase
+    uint8_t second;      // Optional second term, joined with a space
+} WeatherPhraseMapping;
+
+// English phrase set. MUST stay sorted (byte order): it doubles as an
+// implicit trie that matchWeatherPhrase() walks one character at a time.
+constexpr WeatherPhraseMapping weather_phrases[] = {
+    { "AND",               WT_NONE, WT_NONE },
+    { "ASH",               WT_ASH, WT_NONE },
+    { "BREEZY",            WT_WIND, WT_NONE },
+    { "BROKEN CLOUDS",     WT_BROKEN_CLOUDS, WT_NONE },
+    { "CLEAR",             WT_CLEAR, WT_NONE },
+    { "CLEAR SKY",         WT_CLEAR, WT_NONE },
+    { "CLOUDS",            WT_NONE, WT_NONE },
+    { "CLOUDY",            WT_CLOUDY, WT_NONE },
+    { "DRIZZLE",           WT_DRIZZLE, WT_NONE },
+    { "DUST",              WT_DUST, WT_NONE },
+    { "EXTREME",           WT_EXTREME, WT_NONE },
+    { "FEW CLOUDS",        WT_FEW_CLOUDS, WT_NONE },
+    { "FLURRIES",          WT_FLURRIES, WT_NONE },
+    { "FOG",               WT_FOG, WT_NONE },
+    { "FOGGY",             WT_FOG, WT_NONE },
+    { "FREEZING",          WT_FREEZING, WT_NONE },
+    { "FREEZING RAIN",     WT_RAIN, WT_FREEZING },
+    { "HAIL",              WT_HAIL, WT_NONE },
+    { "HAZE",              WT_HAZE, WT_NONE },
+    { "HAZY",              WT_HAZE, WT_NONE },
+    { "HEAVY",             WT_HEAVY, WT_NONE },
+    { "HEAVY RAIN",        WT_HEAVY_RAIN, WT_NONE },
+    { "INTENSITY",         WT_INTENSITY, WT_NONE },
+    { "LIGHT",             WT_LIGHT, WT_NONE },
+    { "MIST",              WT_MIST, WT_NONE },
+    { "MISTY",             WT_MIST, WT_NONE },
+    { "MODERATE",          WT_MODERATE, WT_NONE },
+    { "MOSTLY CLEAR",      WT_MOSTLY_CLEAR, WT_NONE },
+    { "MOSTLY CLOUDY",     WT_MOSTLY_CLOUDY, WT_NONE },
+    { "OVERCAST",          WT_OVERCAST, WT_NONE },
+    { "OVERCAST CLOUDS",   WT_OVERCAST, WT_NONE },
+    { "PARTLY CLOUDY",     WT_PARTLY_CLOUDY, WT_NONE },
+    { "PRECIPITATION",     WT_PRECIPITATION, WT_NONE },
+    { "RAIN",              WT_RAIN, WT_NONE },
+    { "RAIN AND SNOW",     WT_RAIN, WT_SNOW },
+    { "RAINY",             WT_RAIN, WT_NONE },
+    { "SAND",              WT_SAND, WT_NONE },
+    { "SCATTERED CLOUDS",  WT_SCATTERED_CLOUDS, WT_NONE },
+    { "SHOWER",            WT_SHOWER, WT_NONE },
+    { "SHOWER RAIN",       WT_SHOWERS, WT_NONE },
+    { "SHOWER SLEET",      WT_SHOWER, WT_SLEET },
+    { "SHOWER SNOW",       WT_SNOW_SHOWERS, WT_NONE },
+    { "SHOWERS",           WT_SHOWERS, WT_NONE },
+    { "SKY",               WT_NONE, WT_NONE },
+    { "SLEET",             WT_SLEET, WT_NONE },
+    { "SMOKE",             WT_SMOKE, WT_NONE },
+    { "SMOKY",             WT_SMOKE, WT_NONE },
+    { "SNOW",              WT_SNOW, WT_NONE },
+    { "SNOW SHOWERS",      WT_SNOW_SHOWERS, WT_NONE },
+    { "SNOWY",             WT_SNOW, WT_NONE },
+    { "SQUALL",            WT_SQUALL, WT_NONE },
+    { "SQUALLS",           WT_SQUALL, WT_NONE },
+    { "THUNDERSTORM",      WT_THUNDERSTORM, WT_NONE },
+    { "TORNADO",           WT_TORNADO, WT_NONE },
+    { "VERY",              WT_VERY, WT_NONE },
+    { "VOLCANIC ASH",      WT_VOLCANIC, WT_ASH },
+    { "WIND",              WT_WIND, WT_NONE },
+    { "WINDY",             WT_WIND, WT_NONE },
+    { "WITH",              WT_NONE, WT_NONE }
+};
+
+#define WEATHER_PHRASES_COUNT (sizeof(weather_phrases)/sizeof(weather_phrases[0]))
+
+constexpr int weatherPhraseCompare(const char* a, const char* b) {
+    return (*a != *b || *a == '\0') ? (int)(uint8_t)*a - (int)(uint8_t)*b : weatherPhraseCompare(a + 1, b + 1);
+}
+
+constexpr bool weatherPhrasesSorted(size_t i) {
+    return i + 1 >= WEATHER_PHRASES_COUNT ||
+           (weatherPhraseCompare(weather_phrases[i].phrase, weather_phrases[i + 1].phrase) < 0 && weatherPhrasesSorted(i + 1));
+}
+static_assert(weatherPhrasesSorted(0), "weather_phrases must be sorted");
 
+// Resolve once per language change, not per description
+inline const WeatherTermsMapping* findWeatherTerms(const char* lang) {
     for (size_t i = 0; i < WEATHER_TERMS_COUNT; i++) {
-        if (strcmp(lang, weather_terms[i].lang) == 0) {
-            const WeatherTermsMapping& translation = weather_terms[i];
+        if (strcmp(lang, weather_terms[i].lang) == 0)
+            return &weather_terms[i];
+    }
+    return nullptr;  // English or untranslated: leave descriptions as-is
+}
+
+inline const char* weatherTermText(const WeatherTermsMapping* mapping, uint8_t term) {
+    return (&mapping->terms.clear)[term];
+}
 
-            desc.replace("OVERCAST CLOUDS", translation.terms.overcast);
-            desc.replace("BROKEN CLOUDS", translation.terms.broken_clouds);
-            desc.replace("SCATTERED CLOUDS", translation.terms.scattered_clouds);
-            desc.replace("FEW CLOUDS", translation.terms.few_clouds);
-            desc.replace("CLEAR SKY", translation.terms.clear);
-            desc.replace("VOLCANIC ASH", String(translation.terms.volcanic) + " " + String(translation.terms.ash));
-            desc.replace("FREEZING RAIN", String(translation.terms.rain) + " " + String(translation.terms.freezing));
-            desc.replace("SHOWER RAIN", translation.terms.showers);
-            desc.replace("SHOWER SNOW", translation.terms.snow_showers);
-            desc.replace("SHOWER SLEET", String(translation.terms.shower) + " " + String(translation.terms.sleet));
-            desc.replace("RAIN AND SNOW", String(translation.terms.rain) + " " + String(translation.terms.snow));
-            desc.replace("SNOW SHOWERS", translation.terms.snow_showers);
-            desc.replace("HEAVY RAIN", translation.terms.heavy_rain);
-            desc.replace("MOSTLY CLEAR", translation.terms.mostly_clear);
-            desc.replace("MOSTLY CLOUDY", translation.terms.mostly_cloudy);
-            desc.replace("PARTLY CLOUDY", translation.terms.partly_cloudy);
-            desc.replace("FOGGY", translation.terms.fog);
-            desc.replace("MISTY", translation.terms.mist);
-            desc.replace("HAZY", translation.terms.haze);
-            desc.replace("RAINY", translation.terms.rain);
-            desc.replace("SNOWY", translation.terms.snow);
-            desc.replace("SMOKY", translation.terms.smoke);
-            desc.replace("WINDY", translation.terms.wind);
-            desc.replace("BREEZY", translation.terms.wind);
-            desc.replace("SQUALLS", translation.terms.squall);
-            desc.replace("SQUALL", translation.terms.squall);
-            desc.replace("TORNADO", translation.terms.tornado);
-            desc.replace("SAND", translation.terms.sand);
-            desc.replace("DUST", translation.terms.dust);
-            desc.replace("ASH", translation.terms.ash);
-            desc.replace("CLEAR", translation.terms.clear);
-            desc.replace("CLOUDY", translation.terms.cloudy);
-            desc.replace("OVERCAST", translation.terms.overcast);
-            desc.replace("FOG", translation.terms.fog);
-            desc.replace("MIST", translation.terms.mist);
-            desc.replace("HAZE", translation.terms.haze);
-            desc.replace("DRIZZLE", translation.terms.drizzle);
-            desc.replace("RAIN", translation.terms.rain);
-            desc.replace("SLEET", translation.terms.sleet);
-            desc.replace("SNOW", translation.terms.snow);
-            desc.replace("FLURRIES", translation.terms.flurries);
-            desc.replace("SHOWERS", translation.terms.showers);
-            desc.replace("SHOWER", translation.terms.shower);
-            desc.replace("THUNDERSTORM", translation.terms.thunderstorm);
-            desc.replace("HAIL", translation.terms.hail);
-            desc.replace("WIND", translation.terms.wind);
-            desc.replace("SMOKE", translation.terms.smoke);
-            desc.replace("PRECIPITATION", translation.terms.precipitation);
-            desc.replace("INTENSITY", translation.terms.intensity);
-            desc.replace("FREEZING", translation.terms.freezing);
-            desc.replace("EXTREME", translation.terms.extreme);
-            desc.replace("VERY", translation.terms.very);
-            desc.replace("LIGHT", translation.terms.light);
-            desc.replace("MODERATE", translation.terms.moderate);
-            desc.replace("HEAVY", translation.terms.heavy);
-            desc.replace("CLOUDS", "");
-            desc.replace("SKY", "");
-            desc.replace("WITH", "");
-            desc.replace("AND", "");
+// Longest phrase starting at s. Narrows the sorted table to the entries that
+// share the prefix read so far; an entry ending exactly at that depth sorts
+// first in the range. Returns the match length (0 = none) and its index.
+inline size_t matchWeatherPhrase(const char* s, size_t* index) {
+    size_t lo = 0;
+    size_t hi = WEATHER_PHRASES_COUNT;
+    size_t best = 0;
 
-            while (desc.indexOf("  ") >= 0) {
-                desc.replace("  ", " ");
-            }
-            desc.trim();
+    for (size_t depth = 0; s[depth]; depth++) {
+        char c = s[depth];
+        if (c >= 'a' && c <= 'z') c -= 32;
 
-            break;
+        while (lo < hi && (uint8_t)weather_phrases[lo].phrase[depth] < (uint8_t)c) lo++;
+        size_t end = lo;
+        while (end < hi && weather_phrases[end].phrase[depth] == c) end++;
+        hi = end;
+        if (lo >= hi) break;
+
+        if (weather_phrases[lo].phrase[depth + 1] == '\0') {
+            best = depth + 1;
+            *index = lo;
         }
     }
+    return best;
+}
+
+// Appends text, collapsing runs of spaces and dropping leading ones
+inline void appendWeatherText(char* out, size_t outSize, size_t& n, const char* text) {
+    for (; *text && n < outSize - 1; text++) {
+        if (*text == ' ' && (n == 0 || out[n - 1] == ' ')) continue;
+        out[n++] = *text;
+    }
+}
+
+// Single left-to-right pass: at each position emit the translation of the
+// longest English phrase found there, otherwise copy the character. Output
+// is upper case, space-collapsed and trimmed. No heap use.
+inline size_t translateWeatherTerms(const char* in, char* out, size_t outSize, const WeatherTermsMapping* terms) {
+    if (outSize == 0) return 0;
+    size_t n = 0;
+
+    while (*in) {
+        size_t index = 0;
+        size_t len = terms ? matchWeatherPhrase(in, &index) : 0;
+
+        if (len > 0) {
+            const WeatherPhraseMapping& phrase = weather_phrases[index];
+            if (phrase.first != WT_NONE) {
+                appendWeatherText(out, outSize, n, weatherTermText(terms, phrase.first));
+            }
+            if (phrase.second != WT_NONE) {
+                appendWeatherText(out, outSize, n, " ");
+                appendWeatherText(out, outSize, n, weatherTermText(terms, phrase.second));
+            }
+            in += len;
+        } else {
+            char c[2] = { *in++, '\0' };
+            if (c[0] >= 'a' && c[0] <= 'z') c[0] -= 32;
+            appendWeatherText(out, outSize, n, c);
+        }
+    }
+
+    while (n > 0 && out[n - 1] == ' ') n--;
+    out[n] = '\0';
+    return n;
+}
+
+inline void translateAPIWeatherTerms(String& desc, const WeatherTermsMapping* terms) {
+    char buffer[128];
+    translateWeatherTerms(desc.c_str(), buffer, sizeof(buffer), terms);
+    desc = buffer;
 }
 
 #endif // WEATHER_LOOKUP_H
@@ -60,6 +60,22 @@ function appendBoolCheckboxesToFormData(formData, fields) {
     });
 }
 
+// The firmware knows every IANA zone; offer whatever the browser knows beyond the static list
+function addBrowserTimeZones() {
+    const select = document.getElementById('timeZone');
+    let zones = [];
+    try {
+        zones = Intl.supportedValuesOf('timeZone');
+    } catch (e) {
+        return;
+    }
+    zones.forEach(tz => {
+        if (!select.querySelector(`[value="${tz}"]`)) {
+            select.add(new Option(tz, tz));
+        }
+    });
+}
+
 function toggleWeatherApiKey(provider) {
     const apiKeySection = document.getElementById('weatherApiKeySection');
     apiKeySection.style.display = (provider === 'openweather' || provider === 'pirateweather') ? 'block' : 'none';
@@ -171,13 +187,19 @@ window.onload = function () {
             document.getElementById('language').value = data.language || '';
             document.getElementById('ntpServer1').value = data.ntpServer1 || '';
             document.getElementById('ntpServer2').value = data.ntpServer2 || '';
+            document.getElementById('nightscoutUrl').value = data.nightscoutUrl || '';
             document.getElementById('mdnsHostname').value = data.mdnsHostname || 'esptimecast';
+            document.getElementById('staticIp').value = data.staticIp || '';
+            document.getElementById('staticGateway').value = data.staticGateway || '';
+            document.getElementById('staticSubnet').value = data.staticSubnet || '';
+            document.getElementById('staticDns').value = data.staticDns || '';
             document.getElementById('webhookKey').value = data.webhookKey || '';
             document.getElementById('adminPassword').value = data.adminPassword || '';
 
             document.getElementById('weatherUnits').checked = (data.weatherUnits === 'imperial');
             document.getElementById('clockDuration').value = (data.clockDuration || 10000) / 1000;
             document.getElementById('weatherDuration').value = (data.weatherDuration || 5000) / 1000;
+            document.getElementById('displayPlaylist').value = data.displayPlaylist || '0,5,1,2,3,6,4';
             document.getElementById('weatherProvider').value = data.weatherProvider || 'openmeteo';
             document.getElementById('weatherApiKey').value = data.weatherApiKey || '';
             toggleWeatherApiKey(data.weatherProvider || 'openmeteo');
@@ -240,6 +262,8 @@ window.onload = function () {
                 (data.dimEndMinute !== undefined ? String(data.dimEndMinute).padStart(2, '0') : '00');
 
             document.getElementById('dimBrightness').value = (data.dimBrightness !== undefined ? data.dimBrightness : 2);
+            document.getElementById('dimFadeSeconds').value = (data.dimFadeSeconds !== undefined ? data.dimFadeSeconds : 0);
+            document.getElementById('weatherMaxAge').value = (data.weatherMaxAge !== undefined ? data.weatherMaxAge : 180);
             document.getElementById('dimmingBrightnessValue').textContent = (document.getElementById('dimBrightness').value == -1 ? 'Off' : document.getElementById('dimBrightness').value);
 
             setDimmingFieldsEnabled(!!data.dimmingEnabled);
@@ -286,6 +310,7 @@ window.onload = function () {
 
             setCountdownFieldsEnabled(countdownEnabledEl.checked);
 
+            addBrowserTimeZones();
             if (!data.timeZone) {
                 try {
                     const tz = Intl.DateTimeFormat().resolvedOptions().timeZone;
@@ -357,6 +382,7 @@ async function submitConfig(event) {
         formData.set('dimEndMinute', endMin);
     }
     formData.set('dimBrightness', document.getElementById('dimBrightness').value);
+    formData.set('dimFadeSeconds', document.getElementById('dimFadeSeconds').value);
     formData.set('weatherUnits', document.getElementById('weatherUnits').checked ? 'imperial' : 'metric');
 
     formData.set('mdnsEnabled', document.getElementById('mdnsEnabled').checked ? 'true' : 'false');
@@ -624,6 +650,7 @@ function setDimmingFieldsEnabled(enabled) {
     document.getElementById('dimStartTime').disabled = !enabled;
     document.getElementById('dimEndTime').disabled = !enabled;
     document.getElementById('dimBrightness').disabled = !enabled;
+    document.getElementById('dimFadeSeconds').disabled = !enabled;
 }
 
 // YouTube
@@ -0,0 +1,228 @@
+#ifndef WEBHOOK_QUEUE_H
+#define WEBHOOK_QUEUE_H
+
+#include <stdint.h>
+#include <string.h>
+#include "fnv1a.h"
+
+// Fixed-capacity webhook message queue. All slots are allocated up front and
+// chained into one intrusive FIFO per priority plus a free list, so pushing
+// and popping never touch the heap.
+//
+//  - pop order: highest priority first, oldest first within a priority
+//  - when full, a message may displace the oldest message of the lowest
+//    priority present if that priority is lower than its own (urgent messages
+//    may also displace the oldest urgent one); otherwise it is rejected
+//  - a text already queued from the same source is coalesced into the queued
+//    copy instead of taking another slot
+//  - messages are dropped unread once their TTL runs out
+//  - a text that does not fit a slot is refused, never cut
+
+#define WEBHOOK_POOL_SIZE 20   // Upper bound for the webhookQueueSize setting
+#define WEBHOOK_TEXT_MAX 128   // Including the terminator; longer texts are refused
+#define WEBHOOK_PRIORITIES 3   // 0=low, 1=normal, 2=high
+#define WEBHOOK_SLOT_NONE 0xFF
+
+struct WebhookMessage {
+  char text[WEBHOOK_TEXT_MAX];
+  uint8_t priority;
+  bool scroll;
+  uint16_t repeats;       // Extra copies coalesced into this one
+  uint32_t duration;      // milliseconds
+  uint32_t timestamp;     // millis() when first queued
+  uint32_t ttl;           // milliseconds after the last update, 0 = never expires
+  uint32_t updated;       // millis() of the last push or coalesce
+  uint32_t source;        // Sender identity, e.g. the client IP
+  uint32_t textHash;
+  uint8_t next;
+};
+
+enum WebhookPushResult {
+  WEBHOOK_QUEUED,
+  WEBHOOK_COALESCED,
+  WEBHOOK_QUEUED_EVICTED,  // Queued after dropping an older, less urgent message
+  WEBHOOK_REJECTED,        // Full and nothing less urgent to drop
+  WEBHOOK_TOO_LONG         // Text does not fit WEBHOOK_TEXT_MAX
+};
+
+class WebhookQueue {
+private:
+  WebhookMessage _slots[WEBHOOK_POOL_SIZE];
+  uint8_t _head[WEBHOOK_PRIORITIES];
+  uint8_t _tail[WEBHOOK_PRIORITIES];
+  uint8_t _free;
+  uint8_t _capacity;
+  uint8_t _count;
+
+  static bool expired(const WebhookMessage& m, uint32_t now) {
+    return m.ttl != 0 && now - m.updated >= m.ttl;
+  }
+
+  // Unlinks slot from its priority list; prev is its predecessor or NONE
+  void unlink(uint8_t priority, uint8_t prev, uint8_t slot) {
+    uint8_t next = _slots[slot].next;
+    if (prev == WEBHOOK_SLOT_NONE) _head[priority] = next;
+    else _slots[prev].next = next;
+    if (_tail[priority] == slot) _tail[priority] = prev;
+    _slots[slot].next = _free;
+    _free = slot;
+    _count--;
+  }
+
+public:
+  // Counters since boot
+  uint32_t queued;
+  uint32_t coalesced;
+  uint32_t evicted;
+  uint32_t expiredCount;
+  uint32_t rejected;
+
+  WebhookQueue() {
+    begin(WEBHOOK_POOL_SIZE);
+  }
+
+  // Empties the queue; capacity is clamped to 1..WEBHOOK_POOL_SIZE
+  void begin(int capacity) {
+    if (capacity < 1) capacity = 1;
+    if (capacity > WEBHOOK_POOL_SIZE) capacity = WEBHOOK_POOL_SIZE;
+    _capacity = (uint8_t)capacity;
+    _count = 0;
+    for (uint8_t p = 0; p < WEBHOOK_PRIORITIES; p++) {
+      _head[p] = WEBHOOK_SLOT_NONE;
+      _tail[p] = WEBHOOK_SLOT_NONE;
+    }
+    for (uint8_t i = 0; i < WEBHOOK_POOL_SIZE; i++) {
+      _slots[i].next = (i + 1 < WEBHOOK_POOL_SIZE) ? i + 1 : WEBHOOK_SLOT_NONE;
+    }
+    _free = 0;
+    queued = coalesced = evicted = expiredCount = rejected = 0;
+  }
+
+  uint8_t size() const { return _count; }
+  uint8_t capacity() const { return _capacity; }
+  bool empty() const { return _count == 0; }
+
+  // Drops every message whose TTL has run out. Returns how many were dropped.
+  uint8_t expire(uint32_t now) {
+    uint8_t dropped = 0;
+    for (uint8_t p = 0; p < WEBHOOK_PRIORITIES; p++) {
+      uint8_t prev = WEBHOOK_SLOT_NONE;
+      uint8_t slot = _head[p];
+      while (slot != WEBHOOK_SLOT_NONE) {
+        uint8_t next = _slots[slot].next;
+        if (expired(_slots[slot], now)) {
+          unlink(p, prev, slot);
+          dropped++;
+        } else {
+          prev = slot;
+        }
+        slot = next;
+      }
+    }
+    expiredCount += dropped;
+    return dropped;
+  }
+
+  WebhookPushResult push(const char* text, int priority, uint32_t duration, bool scroll,
+                         uint32_t ttl, uint32_t source, uint32_t now) {
+    if (strlen(text) >= WEBHOOK_TEXT_MAX) return WEBHOOK_TOO_LONG;
+    if (priority < 0) priority = 0;
+    if (priority >= WEBHOOK_PRIORITIES) priority = WEBHOOK_PRIORITIES - 1;
+    expire(now);
+
+    // Coalesce: same text from the same source refreshes the queued copy
+    // (keeping its place in line, or moving it up if now more urgent)
+    uint32_t hash = fnv1a(text);
+    for (uint8_t p = 0; p < WEBHOOK_PRIORITIES; p++) {
+      uint8_t prev = WEBHOOK_SLOT_NONE;
+      for (uint8_t slot = _head[p]; slot != WEBHOOK_SLOT_NONE; prev = slot, slot = _slots[slot].next) {
+        WebhookMessage& m = _slots[slot];
+        if (m.source != source || m.textHash != hash || strcmp(m.text, text) != 0) continue;
+        if (priority > p) {
+          // Re-queue at the higher priority; the slot is reused right away
+          uint32_t firstQueued = m.timestamp;
+          uint16_t repeats = m.repeats;
+          unlink(p, prev, slot);
+          push(text, priority, duration, scroll, ttl, source, now);
+          uint8_t moved = _tail[priority];
+          _slots[moved].timestamp = firstQueued;
+          _slots[moved].repeats = repeats + 1;
+          queued--;
+        } else {
+          m.duration = duration;
+          m.scroll = scroll;
+          m.ttl = ttl;
+          m.updated = now;
+          m.repeats++;
+        }
+        coalesced++;
+        return WEBHOOK_COALESCED;
+      }
+    }
+
+    bool displaced = false;
+    if (_count >= _capacity) {
+      uint8_t victim = WEBHOOK_PRIORITIES;
+      for (uint8_t p = 0; p < WEBHOOK_PRIORITIES; p++) {
+        if (_head[p] != WEBHOOK_SLOT_NONE) {
+          victim = p;
+          break;
+        }
+      }
+      bool canEvict = victim < priority || (victim == priority && priority == WEBHOOK_PRIORITIES - 1);
+      if (victim == WEBHOOK_PRIORITIES || !canEvict) {
+        rejected++;
+        return WEBHOOK_REJECTED;
+      }
+      unlink(victim, WEBHOOK_SLOT_NONE, _head[victim]);
+      evicted++;
+      displaced = true;
+    }
+
+    uint8_t slot = _free;
+    WebhookMessage& m = _slots[slot];
+    _free = m.next;
+
+    memcpy(m.text, text, strlen(text) + 1);
+    m.priority = (uint8_t)priority;
+    m.scroll = scroll;
+    m.repeats = 0;
+    m.duration = duration;
+    m.timestamp = now;
+    m.ttl = ttl;
+    m.updated = now;
+    m.source = source;
+    m.textHash = hash;
+    m.next = WEBHOOK_SLOT_NONE;
+
+    if (_tail[priority] == WEBHOOK_SLOT_NONE) _head[priority] = slot;
+    else _slots[_tail[priority]].next = slot;
+    _tail[priority] = slot;
+    _count++;
+    queued++;
+    return displaced ? WEBHOOK_QUEUED_EVICTED : WEBHOOK_QUEUED;
+  }
+
+  // The message pop() would return, or nullptr
+  const WebhookMessage* peek() const {
+    for (int p = WEBHOOK_PRIORITIES - 1; p >= 0; p--) {
+      if (_head[p] != WEBHOOK_SLOT_NONE) return &_slots[_head[p]];
+    }
+    return nullptr;
+  }
+
+  // Copies the next message into out and frees its slot
+  bool pop(WebhookMessage& out) {
+    for (int p = WEBHOOK_PRIORITIES - 1; p >= 0; p--) {
+      if (_head[p] != WEBHOOK_SLOT_NONE) {
+        uint8_t slot = _head[p];
+        out = _slots[slot];
+        unlink(p, WEBHOOK_SLOT_NONE, slot);
+        return true;
+      }
+    }
+    return false;
+  }
+};
+
+#endif // WEBHOOK_QUEUE_H
@@ -0,0 +1,177 @@
+#!/usr/bin/env python3
+"""Build the web UI in ESPTimeCast_ESP/web/ into the LittleFS image in data/.
+
+Every asset is minified (conservatively: whitespace and comments only),
+gzipped and written under data/ with a .gz suffix:
+
+  - scripts and stylesheets get content-hashed names (app.1a2b3c4d.js) so the
+    browser may cache them forever; the HTML pages are rewritten to point at
+    the hashed names
+  - HTML pages keep their URL ("/", "/login") and are revalidated by ETag
+
+data/assets.json lists every asset for setupWebServer():
+
+  {"assets": [{"path": "/js/app.js", "url": "/js/app.1a2b3c4d.js",
+               "file": "/js/app.1a2b3c4d.js.gz", "type": "application/javascript",
+               "etag": "\\"1a2b3c4d\\""}, ...]}
+
+"path" is the logical URL, "url" the immutable one (equal to "path" for
+pages). Previous build output is removed first; data/config.json is left alone.
+
+Usage: python3 Scripts/build_web_assets.py
+"""
+
+import gzip
+import hashlib
+import json
+import os
+import re
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+SRC = os.path.join(ROOT, "ESPTimeCast_ESP", "web")
+OUT = os.path.join(ROOT, "ESPTimeCast_ESP", "data")
+MANIFEST = "assets.json"
+
+# Source file -> URL it is served at. Pages are listed last so the asset
+# references inside them can be rewritten to the hashed names.
+ASSETS = [
+    ("css/style.css", "/css/style.css"),
+    ("js/qrcode.min.js", "/js/qrcode.min.js"),
+    ("js/app.js", "/js/app.js"),
+    ("js/login.js", "/js/login.js"),
+]
+PAGES = [
+    ("index.html", "/"),
+    ("login.html", "/login"),
+]
+
+TYPES = {
+    ".html": "text/html",
+    ".css": "text/css",
+    ".js": "application/javascript",
+}
+
+
+def minify_css(text):
+    text = re.sub(r"/\*.*?\*/", "", text, flags=re.S)
+    text = re.sub(r"\s+", " ", text)
+    text = re.sub(r"\s*([{};,])\s*", r"\1", text)
+    return text.replace(";}", "}").strip()
+
+
+def minify_js(text):
+    """Drops indentation, blank lines and whole-line // comments.
+
+    Lines inside multi-line template literals are kept verbatim.
+    """
+    out = []
+    in_template = False
+    for line in text.splitlines():
+        if in_template:
+            out.append(line)
+        else:
+            stripped = line.strip()
+            if stripped and not stripped.startswith("//"):
+                out.append(stripped)
+        if line.count("`") % 2:
+            in_template = not in_template
+    return "\n".join(out) + "\n"
+
+
+def minify_html(text):
+    text = re.sub(r"<!--.*?-->", "", text, flags=re.S)
+    out = []
+    verbatim = False
+    for line in text.splitlines():
+        if verbatim:
+            out.append(line)
+        elif line.strip():
+            out.append(line.strip())
+        if re.search(r"<(pre|textarea)\b", line):
+            verbatim = True
+        if re.search(r"</(pre|textarea)>", line):
+            verbatim = False
+    return "\n".join(out) + "\n"
+
+
+def minify(name, text):
+    if ".min." in name:
+        return text
+    ext = os.path.splitext(name)[1]
+    if ext == ".css":
+        return minify_css(text)
+    if ext == ".js":
+        return minify_js(text)
+    if ext == ".html":
+        return minify_html(text)
+    return text
+
+
+def clean_output():
+    for dirpath, _, files in os.walk(OUT):
+        for name in files:
+            if name.endswith(".gz") or name == MANIFEST:
+                os.remove(os.path.join(dirpath, name))
+    for dirpath, dirs, files in os.walk(OUT, topdown=False):
+        if dirpath != OUT and not os.listdir(dirpath):
+            os.rmdir(dirpath)
+
+
+def write_gz(rel, data):
+    path = os.path.join(OUT, rel.lstrip("/"))
+    os.makedirs(os.path.dirname(path), exist_ok=True)
+    # mtime=0 keeps the output byte-identical between runs
+    with open(path, "wb") as f:
+        with gzip.GzipFile(fileobj=f, mode="wb", compresslevel=9, mtime=0, filename="") as gz:
+            gz.write(data)
+    return os.path.getsize(path)
+
+
+def main():
+    clean_output()
+    manifest = []
+    renamed = {}
+    total_src = total_out = 0
+
+    for name, path in ASSETS + PAGES:
+        with open(os.path.join(SRC, name), encoding="utf-8") as f:
+            source = f.read()
+        text = minify(name, source)
+        is_page = (name, path) in PAGES
+        if is_page:
+            for old, new in renamed.items():
+                text = text.replace(f'"{old}"', f'"{new}"')
+
+        data = text.encode("utf-8")
+        digest = hashlib.sha256(data).hexdigest()[:8]
+        if is_page:
+            url = path
+            file = "/" + name + ".gz"
+        else:
+            base, ext = os.path.splitext(path)
+            url = f"{base}.{digest}{ext}"
+            file = url + ".gz"
+            renamed[path] = url
+
+        size = write_gz(file, data)
+        total_src += len(source.encode("utf-8"))
+        total_out += size
+        manifest.append({
+            "path": path,
+            "url": url,
+            "file": file,
+            "type": TYPES[os.path.splitext(name)[1]],
+            "etag": f'"{digest}"',
+        })
+        print(f"  {name:<18} {len(source.encode('utf-8')):7d} -> {len(data):7d} -> {size:6d} bytes  {file}")
+
+    with open(os.path.join(OUT, MANIFEST), "w") as f:
+        json.dump({"assets": manifest}, f, separators=(",", ":"))
+        f.write("\n")
+
+    print(f"  {'total':<18} {total_src:7d} -> {total_out:17d} bytes")
+    print(f"Wrote {len(manifest)} assets and {MANIFEST} to {os.path.relpath(OUT, ROOT)}")
+
+
+if __name__ == "__main__":
+    main()
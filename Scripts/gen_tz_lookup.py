@@ -0,0 +1,283 @@
+#!/usr/bin/env python3
+"""Regenerate ESPTimeCast_ESP/tz_lookup.h from the system tz database.
+
+Every IANA zone (including backward-compatible links) is mapped to the POSIX
+TZ string found in the footer of its TZif file. The data is packed for flash:
+
+  - POSIX strings are de-duplicated into one NUL-separated pool
+  - zone names are sorted and front-coded in blocks of TZ_BLOCK_SIZE; the
+    first name of each block is stored whole so ianaToPosix() can binary
+    search the block heads, then decode at most one block
+
+The script decodes its own output and checks that every zone round-trips
+before writing the header, then prints the flash footprint. It also writes
+the source mapping to tests/tz_zones.txt, against which tests/test_tz.cpp
+checks the C++ decoder.
+
+Usage: python3 Scripts/gen_tz_lookup.py [zoneinfo_dir]
+"""
+
+import os
+import sys
+import zoneinfo
+
+BLOCK_SIZE = 16
+SKIP = {"Factory", "localtime", "posixrules"}
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+OUT = os.path.join(ROOT, "ESPTimeCast_ESP", "tz_lookup.h")
+FIXTURE = os.path.join(ROOT, "tests", "tz_zones.txt")
+
+
+def posix_footer(path):
+    with open(path, "rb") as f:
+        data = f.read()
+    if not data.startswith(b"TZif") or data[4:5] < b"2":
+        raise ValueError(f"{path}: not a TZif v2+ file")
+    # The footer is the last line, wrapped in newlines: "\n<TZ string>\n"
+    footer = data[data.rindex(b"\n", 0, len(data) - 1) + 1:-1]
+    return footer.decode("ascii")
+
+
+def tzdata_version(zoneinfo_dir):
+    try:
+        with open(os.path.join(zoneinfo_dir, "tzdata.zi")) as f:
+            first = f.readline().strip()
+        return first.replace("# version", "").strip()
+    except OSError:
+        return "unknown"
+
+
+def front_code(names):
+    blob = bytearray()
+    block_index = []
+    prev = b""
+    for i, name in enumerate(names):
+        name = name.encode("ascii")
+        if i % BLOCK_SIZE == 0:
+            block_index.append(len(blob))
+            shared = 0
+        else:
+            shared = 0
+            while shared < min(len(prev), len(name), 255) and prev[shared] == name[shared]:
+                shared += 1
+        blob.append(shared)
+        blob += name[shared:]
+        blob.append(0)
+        prev = name
+    return bytes(blob), block_index
+
+
+def lookup(name, blob, block_index, zone_posix, pool):
+    """Python mirror of ianaToPosix() used to verify the encoding."""
+    key = name.encode("ascii")
+    lo, hi = 0, len(block_index)
+    while lo < hi:
+        mid = (lo + hi) // 2
+        start = block_index[mid] + 1
+        head = blob[start:blob.index(0, start)]
+        if key < head:
+            hi = mid
+        else:
+            lo = mid + 1
+    if lo == 0:
+        return None
+    block = lo - 1
+    p = block_index[block]
+    current = b""
+    for i in range(BLOCK_SIZE):
+        zone = block * BLOCK_SIZE + i
+        if zone >= len(zone_posix):
+            break
+        shared = blob[p]
+        end = blob.index(0, p + 1)
+        current = current[:shared] + blob[p + 1:end]
+        p = end + 1
+        if current == key:
+            off = zone_posix[zone]
+            return pool[off:pool.index(0, off)].decode("ascii")
+        if key < current:
+            break
+    return None
+
+
+def c_string(data):
+    out = []
+    for b in data:
+        ch = chr(b)
+        if ch.isalnum() or ch in "/_+-,.:<>":
+            out.append(ch)
+        else:
+            out.append("\\%03o" % b)
+    return "".join(out)
+
+
+def c_string_lines(data, width=96):
+    lines = []
+    line = ""
+    for i in range(len(data)):
+        piece = c_string(data[i:i + 1])
+        if len(line) + len(piece) > width:
+            lines.append(line)
+            line = ""
+        line += piece
+    if line:
+        lines.append(line)
+    return "\n".join(f'    "{l}"' for l in lines)
+
+
+def c_array(values, per_line=12):
+    rows = []
+    for i in range(0, len(values), per_line):
+        rows.append("    " + ", ".join(str(v) for v in values[i:i + per_line]))
+    return ",\n".join(rows)
+
+
+def main():
+    zoneinfo_dir = sys.argv[1] if len(sys.argv) > 1 else "/usr/share/zoneinfo"
+    zoneinfo.reset_tzpath([zoneinfo_dir])
+
+    mapping = {}
+    for name in zoneinfo.available_timezones():
+        if name in SKIP:
+            continue
+        mapping[name] = posix_footer(os.path.join(zoneinfo_dir, name))
+
+    names = sorted(mapping, key=lambda n: n.encode("ascii"))
+
+    pool = bytearray()
+    pool_offsets = {}
+    for posix in sorted(set(mapping.values())):
+        pool_offsets[posix] = len(pool)
+        pool += posix.encode("ascii") + b"\0"
+    zone_posix = [pool_offsets[mapping[n]] for n in names]
+    if len(pool) > 0xFFFF:
+        raise SystemExit("POSIX pool exceeds 16-bit offsets")
+
+    blob, block_index = front_code(names)
+    if len(blob) > 0xFFFF:
+        raise SystemExit("Name blob exceeds 16-bit offsets")
+
+    for name in names:
+        if lookup(name, blob, block_index, zone_posix, pool) != mapping[name]:
+            raise SystemExit(f"Round-trip failed for {name}")
+    for probe in ("", "Nowhere/City", "europe/paris", "Zulu~"):
+        if lookup(probe, blob, block_index, zone_posix, pool) is not None:
+            raise SystemExit(f"Unexpected match for {probe!r}")
+
+    raw = sum(len(n) + 1 + len(p) + 1 for n, p in mapping.items())
+    sizes = {
+        "names": len(blob),
+        "block index": 2 * len(block_index),
+        "zone->posix": 2 * len(zone_posix),
+        "posix pool": len(pool),
+    }
+    total = sum(sizes.values())
+    max_name = max(len(n) for n in names)
+    max_posix = max(len(p) for p in mapping.values())
+    version = tzdata_version(zoneinfo_dir)
+
+    header = f"""#ifndef TZ_LOOKUP_H
+#define TZ_LOOKUP_H
+
+// GENERATED by Scripts/gen_tz_lookup.py from tzdata {version}. Do not edit by hand.
+// {len(names)} zones, {len(pool_offsets)} distinct POSIX rules, {total} bytes of flash
+// (plain name/rule strings would take {raw}).
+
+#include <Arduino.h>
+
+#define TZ_ZONE_COUNT {len(names)}
+#define TZ_BLOCK_SIZE {BLOCK_SIZE}
+#define TZ_BLOCK_COUNT {len(block_index)}
+#define TZ_NAME_MAX_LEN {max_name}
+#define TZ_POSIX_MAX_LEN {max_posix}
+
+// De-duplicated POSIX TZ strings, NUL separated
+const char tz_posix_pool[] PROGMEM =
+{c_string_lines(pool)};
+
+// Offset into tz_posix_pool for each zone, in sorted zone order
+const uint16_t tz_zone_posix[] PROGMEM = {{
+{c_array(zone_posix)}
+}};
+
+// Offset into tz_zone_names of the first (whole) name of each block
+const uint16_t tz_block_index[] PROGMEM = {{
+{c_array(block_index)}
+}};
+
+// Sorted zone names, front-coded: <shared prefix length byte><suffix>\\0
+const char tz_zone_names[] PROGMEM =
+{c_string_lines(blob)};
+
+// Compares key against a NUL-terminated string in PROGMEM
+inline int tzComparePgm(const char* key, const char* pgm) {{
+    for (;; key++, pgm++) {{
+        uint8_t a = (uint8_t)*key;
+        uint8_t b = pgm_read_byte(pgm);
+        if (a != b || a == 0) return (int)a - (int)b;
+    }}
+}}
+
+// Returns the POSIX TZ string for an IANA zone name ("UTC0" if unknown).
+// O(log n): binary search over block heads, then decode one block.
+// The result lives in a static buffer, valid until the next call.
+inline const char* ianaToPosix(const char* iana) {{
+    static char posix[TZ_POSIX_MAX_LEN + 1];
+
+    size_t lo = 0;
+    size_t hi = TZ_BLOCK_COUNT;
+    while (lo < hi) {{
+        size_t mid = (lo + hi) / 2;
+        const char* head = tz_zone_names + pgm_read_word(&tz_block_index[mid]) + 1;
+        if (tzComparePgm(iana, head) < 0) hi = mid;
+        else lo = mid + 1;
+    }}
+    if (lo == 0) return "UTC0";  // fallback
+
+    size_t block = lo - 1;
+    const char* p = tz_zone_names + pgm_read_word(&tz_block_index[block]);
+    char name[TZ_NAME_MAX_LEN + 1];
+
+    for (size_t i = 0; i < TZ_BLOCK_SIZE; i++) {{
+        size_t zone = block * TZ_BLOCK_SIZE + i;
+        if (zone >= TZ_ZONE_COUNT) break;
+
+        size_t n = pgm_read_byte(p++);
+        char c;
+        while ((c = (char)pgm_read_byte(p++)) != '\\0' && n < TZ_NAME_MAX_LEN) {{
+            name[n++] = c;
+        }}
+        name[n] = '\\0';
+
+        int cmp = strcmp(iana, name);
+        if (cmp == 0) {{
+            const char* src = tz_posix_pool + pgm_read_word(&tz_zone_posix[zone]);
+            size_t j = 0;
+            while (j < TZ_POSIX_MAX_LEN && (posix[j] = (char)pgm_read_byte(src + j)) != '\\0') j++;
+            posix[j] = '\\0';
+            return posix;
+        }}
+        if (cmp < 0) break;
+    }}
+    return "UTC0"; // fallback
+}}
+
+#endif // TZ_LOOKUP_H
+"""
+    with open(OUT, "w") as f:
+        f.write(header)
+    with open(FIXTURE, "w") as f:
+        f.write(f"# tzdata {version}: zone<TAB>POSIX TZ, written by Scripts/gen_tz_lookup.py\n")
+        for name in names:
+            f.write(f"{name}\t{mapping[name]}\n")
+
+    print(f"tzdata {version}: {len(names)} zones, {len(pool_offsets)} distinct POSIX rules")
+    for label, size in sizes.items():
+        print(f"  {label:<12} {size:6d} bytes")
+    print(f"  {'total':<12} {total:6d} bytes (plain strings: {raw} bytes)")
+    print(f"Wrote {os.path.relpath(OUT, ROOT)} and {os.path.relpath(FIXTURE, ROOT)}")
+
+
+if __name__ == "__main__":
+    main()
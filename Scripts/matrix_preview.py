@@ -0,0 +1,169 @@
+#!/usr/bin/env python3
+"""Render text the way the 32x8 LED matrix shows it, on the host.
+
+Glyphs come straight from ESPTimeCast_ESP/mfactoryfont.h, so a preview uses
+the same font tables, character spacing and alignment as the firmware: each
+glyph is a width followed by one byte per column, bit 0 being the top row.
+Text is taken as UTF-8 and mapped to the display charset (Latin-1 based, the
+output of normalizeDisplayText()); anything outside it shows as '?'.
+
+  python3 Scripts/matrix_preview.py "12:34"
+  python3 Scripts/matrix_preview.py --align left --spacing 1 "Mon 5"
+  python3 Scripts/matrix_preview.py --scroll --ppm /tmp/frames "Light rain"
+  python3 Scripts/matrix_preview.py --follow http://192.168.1.100/api/events
+
+--scroll dumps every step of a right-to-left scroll (one column per frame,
+as PA_SCROLL_LEFT does). --ppm writes scaled images instead of ASCII: one
+file, or numbered files in a directory when scrolling. --follow connects to
+a device's /api/events stream and redraws whenever the "text" field changes,
+which shows what the real matrix displays without looking at it.
+"""
+
+import argparse
+import json
+import os
+import re
+import sys
+import urllib.request
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+FONT = os.path.join(ROOT, "ESPTimeCast_ESP", "mfactoryfont.h")
+
+COLUMNS = 32  # MAX_DEVICES * 8
+ROWS = 8
+ON, OFF = "#", "."
+LED_SCALE = 8  # Pixels per LED in PPM output
+
+
+def load_font(path=FONT):
+    """Returns a list of 256 glyphs, each a list of column bytes."""
+    with open(path, encoding="utf-8") as f:
+        source = f.read()
+    body = source[source.index("{") + 1:source.rindex("}")]
+    body = re.sub(r"//[^\n]*", "", body)
+    values = [int(v, 0) for v in re.findall(r"0x[0-9a-fA-F]+|\d+", body)]
+
+    glyphs = []
+    pos = 0
+    while pos < len(values) and len(glyphs) < 256:
+        width = values[pos]
+        glyphs.append(values[pos + 1:pos + 1 + width])
+        pos += 1 + width
+    if len(glyphs) != 256:
+        sys.exit(f"{path}: expected 256 glyphs, found {len(glyphs)}")
+    return glyphs
+
+
+def to_display_bytes(text):
+    return text.encode("latin-1", errors="replace")
+
+
+def text_columns(glyphs, text, spacing):
+    """Column bytes for the whole string, with spacing between characters."""
+    columns = []
+    for i, code in enumerate(to_display_bytes(text)):
+        if i:
+            columns.extend([0] * spacing)
+        columns.extend(glyphs[code])
+    return columns
+
+
+def place(columns, align):
+    """Positions static text in the matrix width (cropped like the display)."""
+    if len(columns) >= COLUMNS:
+        return columns[:COLUMNS]
+    pad = COLUMNS - len(columns)
+    left = {"left": 0, "center": pad // 2, "right": pad}[align]
+    return [0] * left + columns + [0] * (pad - left)
+
+
+def scroll_frames(columns):
+    """Text entering from the right until it has fully left on the left."""
+    strip = [0] * COLUMNS + columns + [0] * COLUMNS
+    return [strip[i:i + COLUMNS] for i in range(len(strip) - COLUMNS + 1)]
+
+
+def render_ascii(frame):
+    return "\n".join(
+        "".join(ON if column >> row & 1 else OFF for column in frame) for row in range(ROWS)
+    )
+
+
+def write_ppm(path, frame):
+    """Red LEDs on a dark board, LED_SCALE pixels each with a 1 px gap."""
+    width, height = COLUMNS * LED_SCALE, ROWS * LED_SCALE
+    lit, dark, gap = b"\xff\x20\x10", b"\x30\x08\x08", b"\x00\x00\x00"
+    rows = []
+    for y in range(height):
+        row = bytearray()
+        for x in range(width):
+            if x % LED_SCALE == LED_SCALE - 1 or y % LED_SCALE == LED_SCALE - 1:
+                row += gap
+            else:
+                row += lit if frame[x // LED_SCALE] >> (y // LED_SCALE) & 1 else dark
+        rows.append(bytes(row))
+    with open(path, "wb") as f:
+        f.write(b"P6\n%d %d\n255\n" % (width, height))
+        f.writelines(rows)
+
+
+def show(glyphs, text, args):
+    columns = text_columns(glyphs, text, args.spacing)
+    frames = scroll_frames(columns) if args.scroll else [place(columns, args.align)]
+
+    if args.ppm:
+        if len(frames) == 1:
+            write_ppm(args.ppm, frames[0])
+        else:
+            os.makedirs(args.ppm, exist_ok=True)
+            for i, frame in enumerate(frames):
+                write_ppm(os.path.join(args.ppm, f"frame{i:04d}.ppm"), frame)
+        print(f"Wrote {len(frames)} frame(s) to {args.ppm}", file=sys.stderr)
+        return
+
+    for i, frame in enumerate(frames):
+        if len(frames) > 1:
+            print(f"-- frame {i}")
+        print(render_ascii(frame))
+    if not args.scroll and len(columns) > COLUMNS:
+        print(f"(text is {len(columns)} columns wide, cropped to {COLUMNS}; the firmware scrolls it)", file=sys.stderr)
+
+
+def follow(glyphs, url, args):
+    """Redraws on every status event that carries a new "text" value."""
+    with urllib.request.urlopen(url) as stream:
+        event = None
+        for raw in stream:
+            line = raw.decode("utf-8", errors="replace").rstrip("\r\n")
+            if line.startswith("event:"):
+                event = line[6:].strip()
+            elif line.startswith("data:") and event == "status":
+                data = json.loads(line[5:])
+                if "text" in data:
+                    print(f"\n[{data.get('modeName', '')}] {data['text']}")
+                    show(glyphs, data["text"], args)
+            elif not line:
+                event = None
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("text", nargs="?", help="text to render")
+    parser.add_argument("--align", choices=("left", "center", "right"), default="center")
+    parser.add_argument("--spacing", type=int, default=1, help="blank columns between characters (default 1)")
+    parser.add_argument("--scroll", action="store_true", help="dump every frame of a scroll")
+    parser.add_argument("--ppm", help="write PPM image(s) here instead of printing ASCII")
+    parser.add_argument("--follow", metavar="URL", help="render texts from a device's /api/events")
+    args = parser.parse_args()
+
+    glyphs = load_font()
+    if args.follow:
+        follow(glyphs, args.follow, args)
+    elif args.text is not None:
+        show(glyphs, args.text, args)
+    else:
+        parser.error("give a text or --follow URL")
+
+
+if __name__ == "__main__":
+    main()
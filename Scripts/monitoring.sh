@@ -15,11 +15,9 @@ while true; do
 
     echo "CPU: ${CPU}%, RAM: ${RAM}%, DISK: ${DISK}%"
 
-    curl -X POST $URL -d "key=$KEY" -d "message=CPU ${CPU}%" -d "priority=0"
-    sleep 3
-    curl -X POST $URL -d "key=$KEY" -d "message=RAM ${RAM}%" -d "priority=0"
-    sleep 3
-    curl -X POST $URL -d "key=$KEY" -d "message=DISK ${DISK}%" -d "priority=0"
+    # One request for all three; the device queues them in order
+    curl -X POST "$URL/batch?key=$KEY" -H "Content-Type: application/json" \
+        -d "[{\"message\":\"CPU ${CPU}%\",\"priority\":0},{\"message\":\"RAM ${RAM}%\",\"priority\":0},{\"message\":\"DISK ${DISK}%\",\"priority\":0}]"
 
     sleep 300
 done
@@ -0,0 +1,91 @@
+// Serial, the ESP object and the clocks of the simulated device
+
+#include <Arduino.h>
+#include "simulator.h"
+
+uint64_t hostEpochUs = 0;
+int32_t hostDriftPpm = 0;
+int64_t hostWallOffsetUs = 0;
+bool hostQuiet = false;
+
+HardwareSerial Serial;
+EspClass ESP;
+
+uint64_t hostWorldUs(uint64_t deviceUs) {
+  // A fast crystal means less world time per device microsecond
+  return hostEpochUs + deviceUs - (uint64_t)((int64_t)deviceUs * hostDriftPpm / 1000000);
+}
+
+void hostLog(const char *format, ...) {
+  if (hostQuiet) return;
+  char buf[512];
+  va_list args;
+  va_start(args, format);
+  vsnprintf(buf, sizeof(buf), format, args);
+  va_end(args);
+  printf("[HOST %10.3f] %s\n", hostClockMicros / 1e6, buf);
+}
+
+// ---- Time ----
+
+time_t hostTime(time_t *t) {
+  time_t now = (time_t)(((int64_t)hostClockMicros + hostWallOffsetUs) / 1000000);
+  if (t) *t = now;
+  return now;
+}
+
+int hostGettimeofday(struct timeval *tv, void *tz) {
+  int64_t now = (int64_t)hostClockMicros + hostWallOffsetUs;
+  tv->tv_sec = (time_t)(now / 1000000);
+  tv->tv_usec = (suseconds_t)(now % 1000000);
+  return 0;
+}
+
+int hostSettimeofday(const struct timeval *tv, const struct timezone *tz) {
+  if (tv) hostWallOffsetUs = (int64_t)tv->tv_sec * 1000000 + tv->tv_usec - (int64_t)hostClockMicros;
+  return 0;
+}
+
+// ---- Serial ----
+
+size_t HardwareSerial::write(uint8_t c) {
+  if (!hostQuiet) putchar(c);
+  return 1;
+}
+
+size_t HardwareSerial::write(const uint8_t *buffer, size_t size) {
+  if (!hostQuiet) fwrite(buffer, 1, size, stdout);
+  return size;
+}
+
+// ---- ESP ----
+
+// The heap is not simulated; these are typical values for the running sketch
+uint32_t EspClass::getFreeHeap() { return 24000; }
+uint32_t EspClass::getMaxFreeBlockSize() { return 16000; }
+
+void EspClass::restart() {
+  fflush(stdout);
+  throw HostRestart();
+}
+
+// 512 bytes of RTC user memory, addressed in 4-byte blocks. A simulated boot
+// is always a power-on, so nothing in it survives from an earlier run.
+static uint32_t rtcUserMemory[128];
+
+bool EspClass::rtcUserMemoryRead(uint32_t offset, uint32_t *data, size_t size) {
+  if (offset * 4 + size > sizeof(rtcUserMemory) || size == 0) return false;
+  memcpy(data, rtcUserMemory + offset, size);
+  return true;
+}
+
+bool EspClass::rtcUserMemoryWrite(uint32_t offset, uint32_t *data, size_t size) {
+  if (offset * 4 + size > sizeof(rtcUserMemory) || size == 0) return false;
+  memcpy(rtcUserMemory + offset, data, size);
+  return true;
+}
+
+rst_info *EspClass::getResetInfoPtr() {
+  static rst_info info = {REASON_DEFAULT_RST, 0, 0, 0, 0, 0, 0};
+  return &info;
+}
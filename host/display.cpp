@@ -0,0 +1,192 @@
+// MD_Parola drawing into hostDisplay
+
+#include <MD_Parola.h>
+
+HostDisplay hostDisplay = {};
+
+bool MD_Parola::begin(uint8_t numZones) {
+  clearImage();
+  show();
+  return numZones == 1;
+}
+
+// The font is 256 entries of a width byte followed by that many columns
+void MD_Parola::setFont(MD_MAX72XX::fontType_t *font) {
+  _font = font;
+  const uint8_t *p = font;
+  for (int code = 0; code < 256; code++) {
+    _glyphs[code] = p;
+    p += 1 + *p;
+  }
+}
+
+bool MD_Parola::addChar(uint16_t code, uint8_t *data) {
+  if (code > 255) return false;
+  _userChars[code] = data;
+  return true;
+}
+
+const uint8_t *MD_Parola::glyph(uint8_t code) const {
+  if (_userChars[code]) return _userChars[code];
+  return _font ? _glyphs[code] : nullptr;
+}
+
+int MD_Parola::textWidth() const {
+  int width = 0;
+  for (const char *c = _text; *c; c++) {
+    const uint8_t *g = glyph((uint8_t)*c);
+    if (c != _text) width += _charSpacing;
+    width += g ? g[0] : 0;
+  }
+  return width;
+}
+
+// Where the text rests between scrolling in and out
+int MD_Parola::restingOffset(int width) const {
+  if (width >= HOST_DISPLAY_COLUMNS) return _align == PA_RIGHT ? HOST_DISPLAY_COLUMNS - width : 0;
+  switch (_align) {
+    case PA_CENTER: return (HOST_DISPLAY_COLUMNS - width) / 2;
+    case PA_RIGHT: return HOST_DISPLAY_COLUMNS - width;
+    default: return 0;
+  }
+}
+
+void MD_Parola::clearImage() {
+  memset(_image, 0, sizeof(_image));
+}
+
+void MD_Parola::drawText(int offset) {
+  clearImage();
+  int column = offset;
+  for (const char *c = _text; *c && column < HOST_DISPLAY_COLUMNS; c++) {
+    if (c != _text) column += _charSpacing;
+    const uint8_t *g = glyph((uint8_t)*c);
+    if (!g) continue;
+    for (int i = 0; i < g[0]; i++, column++) {
+      if (column >= 0 && column < HOST_DISPLAY_COLUMNS) _image[column] = g[1 + i];
+    }
+  }
+}
+
+static uint8_t reverseBits(uint8_t b) {
+  b = (uint8_t)((b & 0xF0) >> 4 | (b & 0x0F) << 4);
+  b = (uint8_t)((b & 0xCC) >> 2 | (b & 0x33) << 2);
+  return (uint8_t)((b & 0xAA) >> 1 | (b & 0x55) << 1);
+}
+
+void MD_Parola::show() {
+  uint8_t out[HOST_DISPLAY_COLUMNS];
+  for (int i = 0; i < HOST_DISPLAY_COLUMNS; i++) {
+    uint8_t column = _image[_flipLR ? HOST_DISPLAY_COLUMNS - 1 - i : i];
+    if (_flipUD) column = reverseBits(column);
+    out[i] = _invert ? (uint8_t)~column : column;
+  }
+  if (memcmp(out, hostDisplay.columns, sizeof(out)) != 0) {
+    memcpy(hostDisplay.columns, out, sizeof(out));
+    hostDisplay.updates++;
+  }
+}
+
+void MD_Parola::setInvert(bool invert) {
+  _invert = invert;
+  show();
+}
+
+void MD_Parola::setZoneEffect(uint8_t zone, bool enable, textEffect_t effect) {
+  if (effect == PA_FLIP_UD) _flipUD = enable;
+  if (effect == PA_FLIP_LR) _flipLR = enable;
+  show();
+}
+
+void MD_Parola::setIntensity(uint8_t intensity) {
+  if (hostDisplay.intensity == intensity) return;
+  hostDisplay.intensity = intensity;
+  hostDisplay.updates++;
+}
+
+void MD_Parola::displayShutdown(bool shutdown) {
+  if (hostDisplay.shutdown == shutdown) return;
+  hostDisplay.shutdown = shutdown;
+  hostDisplay.updates++;
+}
+
+void MD_Parola::displayClear() {
+  clearImage();
+  show();
+}
+
+void MD_Parola::displayText(const char *text, textPosition_t align, uint16_t speed, uint16_t pause,
+                            textEffect_t effectIn, textEffect_t effectOut) {
+  _text = text ? text : "";
+  _align = align;
+  _speed = speed;
+  _pause = pause;
+  _effectIn = effectIn;
+  _effectOut = effectOut;
+  _phase = PHASE_IN;
+  int width = textWidth();
+  if (effectIn == PA_SCROLL_LEFT) {
+    _offset = HOST_DISPLAY_COLUMNS;
+  } else if (effectIn == PA_SCROLL_RIGHT) {
+    _offset = -width;
+  } else {
+    _offset = restingOffset(width);
+  }
+  _lastTick = millis() - speed;  // First step on the next displayAnimate()
+}
+
+// One frame of the current phase; true when the animation has finished
+bool MD_Parola::step() {
+  int width = textWidth();
+  int rest = restingOffset(width);
+  switch (_phase) {
+    case PHASE_IN:
+      if (_effectIn == PA_SCROLL_LEFT && _offset > rest) {
+        _offset--;
+      } else if (_effectIn == PA_SCROLL_RIGHT && _offset < rest) {
+        _offset++;
+      } else {
+        _offset = rest;
+      }
+      drawText(_offset);
+      show();
+      if (_offset == rest) _phase = PHASE_PAUSE;
+      return false;
+    case PHASE_PAUSE:
+      _phase = PHASE_OUT;
+      [[fallthrough]];
+    case PHASE_OUT:
+      if (_effectOut == PA_SCROLL_LEFT) {
+        _offset--;
+        if (_offset + width <= 0) _phase = DONE;
+      } else if (_effectOut == PA_SCROLL_RIGHT) {
+        _offset++;
+        if (_offset >= HOST_DISPLAY_COLUMNS) _phase = DONE;
+      } else {
+        _phase = DONE;  // No exit effect: the text stays up
+        return true;
+      }
+      drawText(_offset);
+      show();
+      return _phase == DONE;
+    default:
+      return _phase == DONE;
+  }
+}
+
+bool MD_Parola::displayAnimate() {
+  if (_phase == DONE) return true;
+  if (_phase == IDLE) return false;
+  unsigned long interval = _phase == PHASE_PAUSE ? _pause : _speed;
+  if (millis() - _lastTick < interval) return false;
+  _lastTick = millis();
+  return step();
+}
+
+void MD_Parola::print(const char *text) {
+  _text = text ? text : "";
+  _offset = restingOffset(textWidth());
+  drawText(_offset);
+  show();
+  _phase = DONE;
+}
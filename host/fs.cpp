@@ -0,0 +1,104 @@
+// LittleFS on a host directory
+
+#include <LittleFS.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include "simulator.h"
+
+#define HOST_FS_TOTAL_BYTES (1024 * 1024)  // 1 MB filesystem of a 4 MB flash layout
+#define HOST_FS_BLOCK_SIZE 8192
+
+std::string hostFsDir = "build/fs";
+long hostFsTornWriteAfter = -1;
+
+fs::FS LittleFS;
+
+namespace fs {
+
+size_t File::size() const {
+  if (!_file) return 0;
+  struct stat st;
+  fflush(_file.get());
+  return fstat(fileno(_file.get()), &st) == 0 ? (size_t)st.st_size : 0;
+}
+
+std::string FS::hostPath(const char *path) const {
+  std::string relative = path ? path : "";
+  if (relative.find("..") != std::string::npos) return "";
+  if (!relative.empty() && relative[0] != '/') relative = "/" + relative;
+  return hostFsDir + relative;
+}
+
+static void makeParents(const std::string &path) {
+  for (size_t slash = path.find('/', 1); slash != std::string::npos; slash = path.find('/', slash + 1)) {
+    mkdir(path.substr(0, slash).c_str(), 0755);
+  }
+}
+
+bool FS::begin() {
+  struct stat st;
+  if (stat(hostFsDir.c_str(), &st) == 0) return S_ISDIR(st.st_mode);
+  makeParents(hostFsDir + "/");
+  return true;
+}
+
+File FS::open(const char *path, const char *mode) {
+  std::string host = hostPath(path);
+  if (host.empty()) return File();
+  struct stat st;
+  if (stat(host.c_str(), &st) == 0 && S_ISDIR(st.st_mode)) return File();
+  if (mode[0] != 'r') makeParents(host);
+  std::string hostMode = std::string(mode) + "b";
+  FILE *file = fopen(host.c_str(), hostMode.c_str());
+  return file ? File(file, path) : File();
+}
+
+bool FS::exists(const char *path) {
+  std::string host = hostPath(path);
+  struct stat st;
+  return !host.empty() && stat(host.c_str(), &st) == 0;
+}
+
+bool FS::remove(const char *path) {
+  std::string host = hostPath(path);
+  return !host.empty() && ::remove(host.c_str()) == 0;
+}
+
+bool FS::rename(const char *from, const char *to) {
+  std::string hostFrom = hostPath(from), hostTo = hostPath(to);
+  if (hostFrom.empty() || hostTo.empty()) return false;
+  makeParents(hostTo);
+  return ::rename(hostFrom.c_str(), hostTo.c_str()) == 0;
+}
+
+// Each file takes whole blocks, as on LittleFS
+static size_t usedBlocks(const std::string &dir) {
+  size_t blocks = 0;
+  DIR *d = opendir(dir.c_str());
+  if (!d) return 0;
+  while (struct dirent *entry = readdir(d)) {
+    if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) continue;
+    std::string path = dir + "/" + entry->d_name;
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0) continue;
+    if (S_ISDIR(st.st_mode)) {
+      blocks += 1 + usedBlocks(path);
+    } else {
+      blocks += 1 + (size_t)st.st_size / HOST_FS_BLOCK_SIZE;
+    }
+  }
+  closedir(d);
+  return blocks;
+}
+
+bool FS::info(FSInfo &info) {
+  info.totalBytes = HOST_FS_TOTAL_BYTES;
+  info.usedBytes = (unsigned int)std::min((size_t)HOST_FS_TOTAL_BYTES, (2 + usedBlocks(hostFsDir)) * HOST_FS_BLOCK_SIZE);
+  info.blockSize = HOST_FS_BLOCK_SIZE;
+  info.pageSize = 256;
+  info.maxOpenFiles = 5;
+  info.maxPathLength = 32;
+  return true;
+}
+
+}  // namespace fs
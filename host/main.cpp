@@ -0,0 +1,231 @@
+// Runs the sketch on the host: setup(), then loop() on a simulated clock for
+// the given number of hours, with the network stand-ins polled between
+// passes. Reports the CPU time of each loop() pass, and can dump the matrix
+// whenever it changes.
+
+#include <Arduino.h>
+#include <MD_MAX72xx.h>
+#include <algorithm>
+#include <vector>
+#include "simulator.h"
+
+void setup();
+void loop();
+
+#define HOST_DEFAULT_EPOCH 1767225600ULL  // 2026-01-01 00:00:00 UTC
+#define HOST_LONG_BLOCK_US 100000ULL       // Logged: the display stalls visibly
+
+struct ScheduledRequest {
+  uint64_t atUs;
+  std::string method;
+  std::string target;
+  std::string body;
+};
+
+static void usage(const char *name) {
+  fprintf(stderr,
+          "usage: %s [options]\n"
+          "  --hours H          simulated time to run (default 1)\n"
+          "  --step MS          simulated time between loop() passes (default 5)\n"
+          "  --fs DIR           LittleFS contents (default build/fs)\n"
+          "  --fixtures DIR     HTTP fixtures, one directory per host (default fixtures)\n"
+          "  --frames FILE|-    ASCII dump of the matrix each time it changes\n"
+          "  --ppm DIR          the same as numbered PPM images\n"
+          "  --epoch SECONDS    world time at boot (default 2026-01-01)\n"
+          "  --drift PPM        crystal error of the device, positive runs fast\n"
+          "  --rtt MS           round trip to every server (default 40)\n"
+          "  --no-wifi          keep the access point out of range\n"
+          "  --events           attach a client to /api/events and print its events\n"
+          "  --request \"SEC METHOD /path?query [body]\"  web request at SEC seconds\n"
+          "  --quiet            no Serial output or simulator log\n",
+          name);
+}
+
+static uint64_t cpuNanos() {
+  struct timespec ts;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static bool parseRequest(const char *spec, ScheduledRequest &request) {
+  char method[16], target[512];
+  double seconds;
+  int used = 0;
+  if (sscanf(spec, "%lf %15s %511s %n", &seconds, method, target, &used) < 3 || seconds < 0) return false;
+  request.atUs = (uint64_t)(seconds * 1e6);
+  request.method = method;
+  request.target = target;
+  request.body = spec + used;
+  return true;
+}
+
+static void dumpAscii(FILE *out) {
+  fprintf(out, "t=%.3f intensity=%u%s\n", hostClockMicros / 1e6, hostDisplay.intensity,
+          hostDisplay.shutdown ? " off" : "");
+  for (int row = 0; row < 8; row++) {
+    char line[HOST_DISPLAY_COLUMNS + 2];
+    for (int col = 0; col < HOST_DISPLAY_COLUMNS; col++) {
+      bool lit = !hostDisplay.shutdown && (hostDisplay.columns[col] >> row & 1);
+      line[col] = lit ? '#' : '.';
+    }
+    line[HOST_DISPLAY_COLUMNS] = '\n';
+    line[HOST_DISPLAY_COLUMNS + 1] = '\0';
+    fputs(line, out);
+  }
+  fputc('\n', out);
+}
+
+// Each LED is a 4x4 dot on a dark 5x5 cell; brightness follows the intensity
+static bool dumpPpm(const std::string &dir, unsigned frame) {
+  const int cell = 5, width = HOST_DISPLAY_COLUMNS * cell, height = 8 * cell;
+  char path[512];
+  snprintf(path, sizeof(path), "%s/frame_%06u.ppm", dir.c_str(), frame);
+  FILE *out = fopen(path, "wb");
+  if (!out) return false;
+  fprintf(out, "P6\n%d %d\n255\n", width, height);
+  uint8_t red = (uint8_t)(96 + hostDisplay.intensity * 159 / 15);
+  for (int y = 0; y < height; y++) {
+    for (int x = 0; x < width; x++) {
+      int col = x / cell, row = y / cell;
+      bool dot = x % cell < cell - 1 && y % cell < cell - 1;
+      bool lit = dot && !hostDisplay.shutdown && (hostDisplay.columns[col] >> row & 1);
+      uint8_t pixel[3] = {lit ? red : (uint8_t)(dot ? 32 : 0), (uint8_t)(dot && !lit ? 8 : 0), 0};
+      fwrite(pixel, 1, 3, out);
+    }
+  }
+  fclose(out);
+  return true;
+}
+
+int main(int argc, char **argv) {
+  double hours = 1;
+  unsigned stepMs = 5;
+  const char *framesPath = nullptr;
+  std::string ppmDir;
+  bool events = false;
+  std::vector<ScheduledRequest> requests;
+  hostEpochUs = HOST_DEFAULT_EPOCH * 1000000ULL;
+
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    bool hasValue = i + 1 < argc;
+    if (arg == "--hours" && hasValue) {
+      hours = atof(argv[++i]);
+    } else if (arg == "--step" && hasValue) {
+      stepMs = (unsigned)std::max(1, atoi(argv[++i]));
+    } else if (arg == "--fs" && hasValue) {
+      hostFsDir = argv[++i];
+    } else if (arg == "--fixtures" && hasValue) {
+      hostFixtureDir = argv[++i];
+    } else if (arg == "--frames" && hasValue) {
+      framesPath = argv[++i];
+    } else if (arg == "--ppm" && hasValue) {
+      ppmDir = argv[++i];
+    } else if (arg == "--epoch" && hasValue) {
+      hostEpochUs = strtoull(argv[++i], nullptr, 10) * 1000000ULL;
+    } else if (arg == "--drift" && hasValue) {
+      hostDriftPpm = atoi(argv[++i]);
+    } else if (arg == "--rtt" && hasValue) {
+      hostRttMs = (uint32_t)atoi(argv[++i]);
+    } else if (arg == "--no-wifi") {
+      hostWifiAvailable = false;
+    } else if (arg == "--events") {
+      events = true;
+    } else if (arg == "--request" && hasValue) {
+      ScheduledRequest request;
+      if (!parseRequest(argv[++i], request)) {
+        fprintf(stderr, "bad --request: %s\n", argv[i]);
+        return 2;
+      }
+      requests.push_back(request);
+    } else if (arg == "--quiet") {
+      hostQuiet = true;
+    } else {
+      usage(argv[0]);
+      return 2;
+    }
+  }
+  std::stable_sort(requests.begin(), requests.end(),
+                   [](const ScheduledRequest &a, const ScheduledRequest &b) { return a.atUs < b.atUs; });
+
+  FILE *frames = nullptr;
+  if (framesPath) {
+    frames = strcmp(framesPath, "-") == 0 ? stdout : fopen(framesPath, "w");
+    if (!frames) {
+      perror(framesPath);
+      return 1;
+    }
+  }
+
+  uint64_t endUs = (uint64_t)(hours * 3600e6);
+  std::vector<uint32_t> loopNs;  // CPU time of each pass
+  uint64_t setupNs = 0, slowestAtUs = 0;
+  uint32_t slowestNs = 0;
+  uint64_t longestBlockUs = 0;
+  uint32_t lastUpdates = ~0U;
+  unsigned frameCount = 0;
+  size_t nextRequest = 0;
+  bool eventsAttached = false;
+  const char *ended = "time limit";
+
+  try {
+    uint64_t start = cpuNanos();
+    setup();
+    setupNs = cpuNanos() - start;
+
+    while (hostClockMicros < endUs) {
+      hostNetworkPoll();
+      if (events && !eventsAttached) eventsAttached = hostWebEventsConnect();
+      while (nextRequest < requests.size() && requests[nextRequest].atUs <= hostClockMicros) {
+        const ScheduledRequest &r = requests[nextRequest++];
+        hostWebRequest(r.method.c_str(), r.target.c_str(), r.body.c_str());
+      }
+
+      uint64_t passStartUs = hostClockMicros;
+      start = cpuNanos();
+      loop();
+      uint64_t blockedUs = hostClockMicros - passStartUs;  // delay() and simulated I/O waits
+      if (blockedUs > longestBlockUs) longestBlockUs = blockedUs;
+      if (blockedUs >= HOST_LONG_BLOCK_US) hostLog("loop() blocked for %.0f ms", blockedUs / 1e3);
+      uint32_t ns = (uint32_t)std::min<uint64_t>(cpuNanos() - start, UINT32_MAX);
+      if (ns > slowestNs) {
+        slowestNs = ns;
+        slowestAtUs = hostClockMicros;
+      }
+      loopNs.push_back(ns);
+
+      if (hostDisplay.updates != lastUpdates) {
+        lastUpdates = hostDisplay.updates;
+        if (frames) dumpAscii(frames);
+        if (!ppmDir.empty() && !dumpPpm(ppmDir, frameCount)) {
+          perror(ppmDir.c_str());
+          ppmDir.clear();
+        }
+        frameCount++;
+      }
+      hostClockMicros += stepMs * 1000ULL;
+    }
+  } catch (const HostRestart &) {
+    ended = "ESP.restart()";
+  }
+  if (frames && frames != stdout) fclose(frames);
+
+  fflush(stdout);
+  fprintf(stderr, "\nSimulated %.3f h, ended by %s; %u display changes\n", hostClockMicros / 3600e6, ended,
+          frameCount);
+  fprintf(stderr, "setup(): %.3f ms CPU\n", setupNs / 1e6);
+  if (!loopNs.empty()) {
+    uint64_t total = 0;
+    for (uint32_t ns : loopNs) total += ns;
+    std::vector<uint32_t> sorted = loopNs;
+    std::sort(sorted.begin(), sorted.end());
+    auto percentile = [&](double p) { return sorted[(size_t)(p * (sorted.size() - 1))] / 1e3; };
+    fprintf(stderr,
+            "loop(): %zu passes, CPU per pass mean %.2f us, p50 %.2f us, p99 %.2f us, p99.9 %.2f us, "
+            "max %.2f us at t=%.3f s\n",
+            loopNs.size(), total / 1e3 / loopNs.size(), percentile(0.5), percentile(0.99), percentile(0.999),
+            sorted.back() / 1e3, slowestAtUs / 1e6);
+    fprintf(stderr, "longest simulated time inside one pass: %.1f ms\n", longestBlockUs / 1e3);
+  }
+  return 0;
+}
@@ -0,0 +1,479 @@
+// WiFi, TCP, TLS and UDP of the simulated device, and the servers behind
+// them: HTTP answered from the fixture directory, NTP answered with the
+// world time
+
+#include <ESP8266WiFi.h>
+#include <WiFiClientSecure.h>
+#include <WiFiUdp.h>
+#include <ESPAsyncTCP.h>
+#include <ESP8266mDNS.h>
+#include <sys/stat.h>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include "fnv1a.h"
+#include "timekeeper.h"
+#include "simulator.h"
+
+#define HOST_WIFI_FAST_JOIN_MS 600    // Known BSSID and channel
+#define HOST_WIFI_SCAN_JOIN_MS 2500   // Full scan first
+#define HOST_AP_CHANNEL 6
+#define HOST_HTTP_IDLE_MS 60000UL     // Servers close idle keep-alive connections
+#define HOST_TLS_HANDSHAKE_MS 1200    // ECDHE and certificate parsing on an 80 MHz core
+#define HOST_TLS_RESUME_MS 20
+
+bool hostWifiAvailable = true;
+uint32_t hostRttMs = 40;
+std::string hostFixtureDir = "fixtures";
+
+ESP8266WiFiClass WiFi;
+MDNSResponder MDNS;
+
+static const uint8_t apBssid[6] = {0x02, 0x00, 0x00, 0x5E, 0x00, 0x01};
+static const IPAddress stationIp(192, 168, 1, 50);
+
+// ---- Fixture servers ----
+
+static bool fixturePathOk(const std::string &path) {
+  return path.find("..") == std::string::npos;
+}
+
+bool hostHttpKnownHost(const char *host) {
+  if (!host || !host[0] || !fixturePathOk(host)) return false;
+  struct stat st;
+  return stat((hostFixtureDir + "/" + host).c_str(), &st) == 0 && S_ISDIR(st.st_mode);
+}
+
+static bool readFile(const std::string &path, std::string &out) {
+  std::ifstream in(path, std::ios::binary);
+  if (!in) return false;
+  std::ostringstream data;
+  data << in.rdbuf();
+  out = data.str();
+  return true;
+}
+
+// Value of a request header, empty if absent
+static std::string requestHeader(const std::string &request, const char *name) {
+  size_t len = strlen(name);
+  size_t pos = request.find("\r\n");
+  while (pos != std::string::npos && pos + 2 < request.size()) {
+    size_t start = pos + 2;
+    size_t end = request.find("\r\n", start);
+    if (end == std::string::npos || end == start) break;
+    if (end - start > len && request[start + len] == ':' && strncasecmp(request.c_str() + start, name, len) == 0) {
+      size_t value = start + len + 1;
+      while (value < end && request[value] == ' ') value++;
+      return request.substr(value, end - value);
+    }
+    pos = end;
+  }
+  return "";
+}
+
+std::string hostHttpResponse(const char *host, const std::string &request, bool &keepAlive) {
+  std::string target;
+  size_t space = request.find(' ');
+  if (space != std::string::npos) target = request.substr(space + 1, request.find(' ', space + 1) - space - 1);
+  std::string path = target.substr(0, target.find('?'));
+  if (path.empty() || path.back() == '/') path += "index";
+  keepAlive = strcasecmp(requestHeader(request, "Connection").c_str(), "keep-alive") == 0;
+  const char *connection = keepAlive ? "keep-alive" : "close";
+
+  std::string body;
+  char head[256];
+  if (!fixturePathOk(path) || !readFile(hostFixtureDir + "/" + host + path, body)) {
+    hostLog("HTTP %s%s -> 404 (no fixture)", host, target.c_str());
+    snprintf(head, sizeof(head), "HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\nConnection: %s\r\n\r\n", connection);
+    return head;
+  }
+
+  if (body.compare(0, 7, "HTTP/1.") == 0) {
+    // Raw response; the header block may use plain \n line ends
+    size_t end = body.find("\r\n\r\n");
+    size_t bodyStart = end + 4;
+    if (end == std::string::npos) {
+      end = body.find("\n\n");
+      bodyStart = end == std::string::npos ? body.size() : end + 2;
+    }
+    std::string header = body.substr(0, std::min(end, body.size()));
+    std::string crlf;
+    for (char c : header) {
+      if (c == '\n' && (crlf.empty() || crlf.back() != '\r')) crlf += '\r';
+      crlf += c;
+    }
+    std::string lower = crlf;
+    for (char &c : lower) c = (char)tolower((unsigned char)c);
+    keepAlive = keepAlive && lower.find("connection: keep-alive") != std::string::npos;
+    hostLog("HTTP %s%s -> %.3s (raw fixture)", host, target.c_str(), crlf.c_str() + 9);
+    return crlf + "\r\n\r\n" + body.substr(std::min(bodyStart, body.size()));
+  }
+
+  char etag[16];
+  snprintf(etag, sizeof(etag), "\"%08x\"", fnv1a(body.c_str()));
+  if (requestHeader(request, "If-None-Match") == etag) {
+    hostLog("HTTP %s%s -> 304", host, target.c_str());
+    snprintf(head, sizeof(head), "HTTP/1.1 304 Not Modified\r\nETag: %s\r\nContent-Length: 0\r\nConnection: %s\r\n\r\n",
+             etag, connection);
+    return head;
+  }
+  hostLog("HTTP %s%s -> 200, %zu bytes", host, target.c_str(), body.size());
+  snprintf(head, sizeof(head),
+           "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\nContent-Length: %zu\r\nETag: %s\r\n"
+           "Connection: %s\r\n\r\n",
+           body.size(), etag, connection);
+  return head + body;
+}
+
+IPAddress hostServerAddress(const char *name) {
+  uint32_t hash = fnv1a(name);
+  return IPAddress(10, (uint8_t)(hash >> 16), (uint8_t)(hash >> 8), (uint8_t)(hash | 1));
+}
+
+// Servers are not all equally far away
+static uint32_t serverRttMs(const IPAddress &ip) {
+  return hostRttMs + ip[3] % 20;
+}
+
+// ---- WiFi ----
+
+bool ESP8266WiFiClass::mode(WiFiMode_t mode) {
+  if (!(mode & WIFI_STA)) disconnect();
+  _mode = mode;
+  return true;
+}
+
+wl_status_t ESP8266WiFiClass::begin(const char *ssid, const char *passphrase, int32_t channel, const uint8_t *bssid,
+                                    bool connect) {
+  if (!(_mode & WIFI_STA)) _mode = WIFI_STA;
+  _connected = false;
+  _joining = connect && ssid && ssid[0];
+  _stale = (bssid && memcmp(bssid, apBssid, sizeof(apBssid)) != 0) || (channel && channel != HOST_AP_CHANNEL);
+  _joinAtUs = hostClockMicros + (bssid ? HOST_WIFI_FAST_JOIN_MS : HOST_WIFI_SCAN_JOIN_MS) * 1000ULL;
+  return WL_DISCONNECTED;
+}
+
+bool ESP8266WiFiClass::config(IPAddress local_ip, IPAddress gateway, IPAddress subnet, IPAddress dns1,
+                              IPAddress dns2) {
+  _staticIp = local_ip;
+  return true;
+}
+
+bool ESP8266WiFiClass::disconnect(bool wifioff) {
+  bool was = _connected;
+  _connected = false;
+  _joining = false;
+  if (wifioff) _mode = WIFI_OFF;
+  if (was) {
+    WiFiEventStationModeDisconnected event = {};
+    event.reason = 8;  // WIFI_DISCONNECT_REASON_ASSOC_LEAVE
+    for (auto &weak : _disconnectHandlers) {
+      if (auto handler = weak.lock()) (*handler)(event);
+    }
+  }
+  return true;
+}
+
+wl_status_t ESP8266WiFiClass::status() {
+  return _connected ? WL_CONNECTED : WL_DISCONNECTED;
+}
+
+IPAddress ESP8266WiFiClass::localIP() {
+  if (!_connected) return IPAddress();
+  return _staticIp.isSet() ? _staticIp : stationIp;
+}
+
+uint8_t *ESP8266WiFiClass::BSSID() {
+  static uint8_t bssid[6];
+  memcpy(bssid, apBssid, sizeof(bssid));
+  return _connected ? bssid : nullptr;
+}
+
+int ESP8266WiFiClass::hostByName(const char *hostname, IPAddress &result) {
+  if (!_connected || !hostname || !hostname[0]) return 0;
+  if (result.fromString(hostname)) return 1;
+  delay(hostRttMs);  // Blocks like the SDK's lookup
+  result = hostServerAddress(hostname);
+  return 1;
+}
+
+bool ESP8266WiFiClass::softAP(const char *ssid, const char *passphrase, int channel, int ssid_hidden,
+                              int max_connection) {
+  _mode = (WiFiMode_t)(_mode | WIFI_AP);
+  return true;
+}
+
+WiFiEventHandler ESP8266WiFiClass::onStationModeGotIP(std::function<void(const WiFiEventStationModeGotIP &)> handler) {
+  auto shared = std::make_shared<std::function<void(const WiFiEventStationModeGotIP &)>>(handler);
+  _gotIpHandlers.push_back(shared);
+  return shared;
+}
+
+WiFiEventHandler ESP8266WiFiClass::onStationModeDisconnected(
+  std::function<void(const WiFiEventStationModeDisconnected &)> handler) {
+  auto shared = std::make_shared<std::function<void(const WiFiEventStationModeDisconnected &)>>(handler);
+  _disconnectHandlers.push_back(shared);
+  return shared;
+}
+
+void ESP8266WiFiClass::hostPoll() {
+  if (!_joining || _stale || !hostWifiAvailable || hostClockMicros < _joinAtUs) return;
+  _joining = false;
+  _connected = true;
+  hostLog("WiFi joined, %s", localIP().toString().c_str());
+  WiFiEventStationModeGotIP event;
+  event.ip = localIP();
+  event.mask = IPAddress(255, 255, 255, 0);
+  event.gw = IPAddress(192, 168, 1, 1);
+  for (auto &weak : _gotIpHandlers) {
+    if (auto handler = weak.lock()) (*handler)(event);
+  }
+}
+
+// ---- TCP client ----
+
+// Waits ms, or gives up after the client's timeout as the cores do
+bool WiFiClient::waitWithin(unsigned long ms) {
+  if (ms > _timeout) {
+    delay(_timeout);
+    return false;
+  }
+  delay(ms);
+  return true;
+}
+
+int WiFiClient::connect(const char *host, uint16_t port) {
+  stop();
+  if (WiFi.status() != WL_CONNECTED) return 0;
+  if (!waitWithin(hostRttMs)) return 0;  // Lookup, or the SYN that finds nobody
+  if (!hostHttpKnownHost(host)) return 0;
+  if (!waitWithin(hostRttMs)) return 0;
+  _host = host;
+  _open = true;
+  _lastActivityUs = hostClockMicros;
+  return 1;
+}
+
+size_t WiFiClient::write(const uint8_t *buffer, size_t size) {
+  if (!connected()) return 0;
+  _request.append((const char *)buffer, size);
+  if (_request.find("\r\n\r\n") == std::string::npos) return size;
+
+  bool keepAlive;
+  std::string response = hostHttpResponse(_host.c_str(), _request, keepAlive);
+  _request.clear();
+  _rx.erase(0, _rxPos);
+  _rxPos = 0;
+  _rx += response;
+  _rxAtUs = hostClockMicros + hostRttMs * 1000ULL;
+  _closeAfterResponse = !keepAlive;
+  _lastActivityUs = hostClockMicros;
+  return size;
+}
+
+int WiFiClient::available() {
+  if (hostClockMicros < _rxAtUs) return 0;
+  return (int)(_rx.size() - _rxPos);
+}
+
+int WiFiClient::read() {
+  if (available() <= 0) return -1;
+  _lastActivityUs = hostClockMicros;
+  return (uint8_t)_rx[_rxPos++];
+}
+
+int WiFiClient::read(uint8_t *buffer, size_t size) {
+  size_t n = std::min(size, (size_t)std::max(available(), 0));
+  memcpy(buffer, _rx.data() + _rxPos, n);
+  _rxPos += n;
+  if (n) _lastActivityUs = hostClockMicros;
+  return (int)n;
+}
+
+int WiFiClient::peek() {
+  return available() > 0 ? (uint8_t)_rx[_rxPos] : -1;
+}
+
+void WiFiClient::stop() {
+  _open = false;
+  _closeAfterResponse = false;
+  _request.clear();
+  _rx.clear();
+  _rxPos = 0;
+}
+
+uint8_t WiFiClient::connected() {
+  if (_rxPos < _rx.size()) return 1;  // Unread data counts, as on the cores
+  if (!_open) return 0;
+  if (_closeAfterResponse || hostClockMicros - _lastActivityUs >= HOST_HTTP_IDLE_MS * 1000ULL ||
+      WiFi.status() != WL_CONNECTED) {
+    _open = false;
+    return 0;
+  }
+  return 1;
+}
+
+// ---- TLS client ----
+
+namespace BearSSL {
+
+static uint32_t sessionIds = 0;
+
+int WiFiClientSecure::connect(const char *host, uint16_t port) {
+  if (!WiFiClient::connect(host, port)) return 0;
+  // The handshake gets the client's timeout of its own
+  if (_session && _session->_id && strcmp(_session->_host, host) == 0) {
+    if (!waitWithin(hostRttMs + HOST_TLS_RESUME_MS)) {
+      stop();
+      return 0;
+    }
+  } else {
+    if (!waitWithin(2 * hostRttMs + HOST_TLS_HANDSHAKE_MS)) {
+      stop();
+      return 0;
+    }
+    if (_session) {
+      strlcpy(_session->_host, host, sizeof(_session->_host));
+      _session->_id = ++sessionIds;
+    }
+  }
+  return 1;
+}
+
+bool WiFiClientSecure::probeMaxFragmentLength(const char *host, uint16_t port, uint16_t len) {
+  if (WiFi.status() != WL_CONNECTED) return false;
+  delay(2 * hostRttMs);
+  return hostHttpKnownHost(host);
+}
+
+}  // namespace BearSSL
+
+// ---- Async TCP client ----
+
+static std::vector<AsyncClient *> asyncClients;  // Those with events to come
+
+AsyncClient::AsyncClient() {}
+
+AsyncClient::~AsyncClient() {
+  asyncClients.erase(std::remove(asyncClients.begin(), asyncClients.end(), this), asyncClients.end());
+}
+
+bool AsyncClient::connect(const char *host, uint16_t port) {
+  if (_state != CLOSED || WiFi.status() != WL_CONNECTED) return false;
+  _host = host;
+  _request.clear();
+  _state = CONNECTING;
+  _eventAtUs = hostClockMicros + hostRttMs * 1000ULL;
+  asyncClients.push_back(this);
+  return true;
+}
+
+void AsyncClient::closed() {
+  _state = CLOSED;
+  asyncClients.erase(std::remove(asyncClients.begin(), asyncClients.end(), this), asyncClients.end());
+  if (_onDisconnect) _onDisconnect(_disconnectArg, this);
+}
+
+void AsyncClient::close(bool now) {
+  if (_state != CLOSED) closed();
+}
+
+size_t AsyncClient::add(const char *data, size_t size, uint8_t apiflags) {
+  if (_state != CONNECTED || size > HOST_TCP_SNDBUF) return 0;
+  _request.append(data, size);
+  if (_request.find("\r\n\r\n") != std::string::npos) {
+    _response = hostHttpResponse(_host.c_str(), _request, _keepAlive);
+    _request.clear();
+    _sent = 0;
+    _state = RESPONDING;
+    _eventAtUs = hostClockMicros + hostRttMs * 1000ULL;
+  }
+  return size;
+}
+
+const char *AsyncClient::errorToString(int8_t error) {
+  switch (error) {
+    case -11: return "Not connected";
+    case -13: return "Connection aborted";
+    case -14: return "Connection reset";
+    case -15: return "Connection closed";
+    case -55: return "DNS failed";
+    default: return "Unknown error";
+  }
+}
+
+void AsyncClient::hostPoll() {
+  if (hostClockMicros < _eventAtUs) return;
+  if (_state == CONNECTING) {
+    if (!hostHttpKnownHost(_host.c_str())) {
+      _state = FAILED;
+      if (_onError) _onError(_errorArg, this, -55);
+      closed();
+      return;
+    }
+    _state = CONNECTED;
+    if (_onConnect) _onConnect(_connectArg, this);
+  } else if (_state == RESPONDING) {
+    size_t n = std::min((size_t)HOST_TCP_SEGMENT, _response.size() - _sent);
+    if (n && _onData) _onData(_dataArg, this, (void *)(_response.data() + _sent), n);
+    _sent += n;
+    if (_sent >= _response.size()) {
+      if (_keepAlive) {
+        _state = CONNECTED;
+      } else {
+        closed();
+      }
+    }
+  }
+}
+
+// ---- UDP and the NTP servers ----
+
+int WiFiUDP::endPacket() {
+  if (!_open || WiFi.status() != WL_CONNECTED) return 0;
+  if (_sendPort != 123 || _sendTo[0] != 10 || _send.size() < NTP_PACKET_SIZE || (_send[0] & 0x07) != 3) {
+    return 1;  // Sent, nobody answers
+  }
+
+  // Stratum 2 server: originate = the request's transmit time, receive and
+  // transmit = world time halfway through the round trip
+  uint64_t rttUs = serverRttMs(_sendTo) * 1000ULL;
+  uint64_t serverUs = hostWorldUs(hostClockMicros + rttUs / 2);
+  Datagram reply;
+  reply.atUs = hostClockMicros + rttUs;
+  reply.from = _sendTo;
+  reply.data.assign(NTP_PACKET_SIZE, 0);
+  reply.data[0] = 0x24;  // No leap warning, version 4, server
+  reply.data[1] = 2;
+  reply.data[3] = 0xEC;  // Precision, about 60 ns
+  memcpy(&reply.data[24], &_send[40], 8);
+  ntpWriteTimestamp(&reply.data[32], serverUs);
+  ntpWriteTimestamp(&reply.data[40], serverUs + 25);
+
+  auto pos = _queue.begin();
+  while (pos != _queue.end() && pos->atUs <= reply.atUs) ++pos;
+  _queue.insert(pos, reply);
+  return 1;
+}
+
+int WiFiUDP::parsePacket() {
+  _current.clear();
+  _currentPos = 0;
+  if (_queue.empty() || _queue.front().atUs > hostClockMicros) return 0;
+  _current = _queue.front().data;
+  _currentFrom = _queue.front().from;
+  _queue.pop_front();
+  return (int)_current.size();
+}
+
+// ---- Between loop() passes ----
+
+void hostNetworkPoll() {
+  WiFi.hostPoll();
+  std::vector<AsyncClient *> due = asyncClients;
+  for (AsyncClient *client : due) {
+    // A callback may have deleted another client
+    if (std::find(asyncClients.begin(), asyncClients.end(), client) != asyncClients.end()) client->hostPoll();
+  }
+}
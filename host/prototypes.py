@@ -0,0 +1,132 @@
+#!/usr/bin/env python3
+"""Turn the sketch into a C++ file the way the Arduino builder does.
+
+The builder declares every function of the .ino before the first function
+definition, so the sketch may call functions defined further down. This does
+the same for host/Makefile: the sketch is run through the preprocessor with
+the host flags (so only the functions of the ESP8266 build are seen), every
+top-level function definition is found by brace depth, and its prototype,
+without default arguments, is inserted ahead of the first one. #line
+directives keep compiler messages pointing into the .ino.
+
+Usage: python3 host/prototypes.py SKETCH OUTPUT CXX [preprocessor flags...]
+"""
+
+import re
+import subprocess
+import sys
+
+MARKER = re.compile(r'^# (\d+) "(.*)"')
+NOT_FUNCTIONS = ("struct ", "class ", "union ", "enum ", "namespace ", "template", "typedef ", "extern \"C\"")
+
+
+def sketch_lines(sketch, cxx, flags):
+    """Preprocessed text of the sketch itself, as (line number, text)."""
+    out = subprocess.run([cxx, "-E", "-x", "c++", *flags, sketch], check=True,
+                         capture_output=True, text=True).stdout
+    lines, current, number = [], None, 0
+    for line in out.splitlines():
+        m = MARKER.match(line)
+        if m:
+            number, current = int(m.group(1)), m.group(2)
+            continue
+        if current == sketch:
+            lines.append((number, line))
+        number += 1
+    return lines
+
+
+def mask_literals(text):
+    """Blank out string and character literals so their braces do not count."""
+    out, i = [], 0
+    while i < len(text):
+        c = text[i]
+        if c in "\"'":
+            j = i + 1
+            while j < len(text) and text[j] != c:
+                j += 2 if text[j] == "\\" else 1
+            out.append(c + " " * (j - i - 1) + c)
+            i = j + 1
+        else:
+            out.append(c)
+            i += 1
+    return "".join(out)
+
+
+def strip_defaults(signature):
+    """Drop "= value" from the parameter list."""
+    open_paren = signature.index("(")
+    out, depth, skipping = [signature[:open_paren + 1]], 0, False
+    for c in signature[open_paren + 1:]:
+        if c in "([{<":
+            depth += 1
+        elif c in ")]}>":
+            if depth == 0:
+                skipping = False
+            depth -= 1
+        elif c == "," and depth == 0:
+            skipping = False
+        elif c == "=" and depth == 0:
+            skipping = True
+        if not skipping:
+            out.append(c)
+    return re.sub(r"\s+(?=[,)])", "", "".join(out))
+
+
+def find_functions(lines):
+    """Prototypes of top-level function definitions and the line of the first."""
+    prototypes, first_line = [], None
+    depth, statement, start = 0, "", None
+    for number, line in lines:
+        line = mask_literals(line)
+        if line.lstrip().startswith("#"):
+            continue
+        for c in line:
+            if depth == 0:
+                if c in ";}":
+                    statement, start = "", None
+                    continue
+                if c == "{":
+                    signature = " ".join(statement.split())
+                    if (signature.endswith(")") and "(" in signature and "=" not in signature.split("(")[0]
+                            and not signature.startswith(NOT_FUNCTIONS)):
+                        prototypes.append(strip_defaults(signature) + ";")
+                        if first_line is None:
+                            first_line = start
+                    statement, start = "", None
+                    depth += 1
+                    continue
+                if start is None and not c.isspace():
+                    start = number
+                statement += c
+            elif c == "{":
+                depth += 1
+            elif c == "}":
+                depth -= 1
+        if depth == 0:
+            statement += "\n"
+    return prototypes, first_line
+
+
+def main():
+    if len(sys.argv) < 4:
+        sys.exit(__doc__)
+    sketch, output, cxx, flags = sys.argv[1], sys.argv[2], sys.argv[3], sys.argv[4:]
+    prototypes, first_line = find_functions(sketch_lines(sketch, cxx, flags))
+    if first_line is None:
+        sys.exit(f"{sketch}: no function definitions found")
+
+    with open(sketch, encoding="utf-8") as f:
+        source = f.read().splitlines(keepends=True)
+    with open(output, "w", encoding="utf-8") as f:
+        f.write(f'#line 1 "{sketch}"\n')
+        f.writelines(source[:first_line - 1])
+        f.write(f'#line {first_line} "{sketch}"\n')
+        f.write("\n".join(prototypes) + "\n")
+        f.write(f'#line {first_line} "{sketch}"\n')
+        f.writelines(source[first_line - 1:])
+    print(f"{output}: {len(prototypes)} prototypes before line {first_line}")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,54 @@
+#ifndef HOST_SIMULATOR_H
+#define HOST_SIMULATOR_H
+
+// State shared by the stand-ins in stubs/ and the simulator's main(): the
+// world clock the fake servers answer with, where fixtures and the
+// filesystem live, and the network model. main() owns the settings, the
+// stand-ins read them.
+
+#include <Arduino.h>
+#include <IPAddress.h>
+#include <string>
+
+// World time, Unix microseconds. hostEpochUs is the world time at boot; the
+// device's crystal is off by hostDriftPpm (positive: its millis() run fast),
+// which the sketch's clock discipline has to learn.
+extern uint64_t hostEpochUs;
+extern int32_t hostDriftPpm;
+uint64_t hostWorldUs(uint64_t deviceUs);
+inline uint64_t hostWorldUs() { return hostWorldUs(hostClockMicros); }
+
+// The device's wall clock: Unix time = monotonic clock + offset, 0 at boot
+extern int64_t hostWallOffsetUs;
+
+// Network: WiFi in range, round trip to every server, HTTP fixtures
+extern bool hostWifiAvailable;
+extern uint32_t hostRttMs;
+extern std::string hostFixtureDir;
+extern std::string hostFsDir;  // Root of LittleFS
+extern bool hostQuiet;  // Serial output off
+
+// HTTP answers from fixtures/<host>/<path without the query>. A fixture that
+// starts with a status line is sent as it is; anything else is the body of a
+// 200 with Content-Length and an ETag (answered with 304 to If-None-Match).
+// A host without a fixture directory does not resolve.
+bool hostHttpKnownHost(const char *host);
+std::string hostHttpResponse(const char *host, const std::string &request, bool &keepAlive);
+
+// Runs what the SDK would between loop() passes: WiFi events and the
+// callbacks of asynchronous clients that are due
+void hostNetworkPoll();
+
+// Simulated NTP server address of a name (stable per name)
+IPAddress hostServerAddress(const char *name);
+
+// Requests to the sketch's web server, e.g. ("POST", "/api/message",
+// "text=HELLO&duration=5"); prints the answer like a client would see it
+bool hostWebRequest(const char *method, const char *target, const char *body);
+// Opens a simulated /api/events client; events are printed as they arrive
+bool hostWebEventsConnect();
+
+// Printed by the stand-ins and the simulator, tagged with the simulated time
+void hostLog(const char *format, ...) __attribute__((format(printf, 1, 2)));
+
+#endif // HOST_SIMULATOR_H
@@ -0,0 +1,308 @@
+#ifndef HOST_SIM_ARDUINO_H
+#define HOST_SIM_ARDUINO_H
+
+// Arduino core for the host build of the whole sketch (host/Makefile): the
+// test shim's String and simulated clock, plus Print and Stream, Serial, the
+// ESP object and the few SDK calls the sketch makes. time(), gettimeofday()
+// and settimeofday() are redirected to the simulated clock, so the sketch's
+// wall clock starts at 0 like the device's until NTP sets it.
+
+#include <time.h>
+#include <sys/time.h>
+#include <stdarg.h>
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <string>
+#include <istream>
+#include <ostream>
+#include "../../tests/shim/Arduino.h"
+
+using std::max;
+using std::min;
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define DEC 10
+#define HEX 16
+#define OCT 8
+#define BIN 2
+
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+#define snprintf_P snprintf
+#define sprintf_P sprintf
+#define ICACHE_RAM_ATTR
+#define IRAM_ATTR
+
+class __FlashStringHelper;
+
+// Type of String temporaries on the cores; ArduinoJson names it
+class StringSumHelper : public String {
+public:
+  using String::String;
+  StringSumHelper(const String &s) : String(s) {}
+};
+
+// ---- Simulated time ----
+
+time_t hostTime(time_t *t);
+int hostGettimeofday(struct timeval *tv, void *tz);
+int hostSettimeofday(const struct timeval *tv, const struct timezone *tz);
+#define time(t) hostTime(t)
+#define gettimeofday(tv, tz) hostGettimeofday(tv, tz)
+#define settimeofday(tv, tz) hostSettimeofday(tv, tz)
+
+inline uint64_t micros64() { return hostClockMicros; }
+
+// RTC counter in cycles of the calibrated period, 5.75 us in 12-bit fixed point
+#define HOST_RTC_PERIOD_Q12 23552U
+inline uint32_t system_get_rtc_time() { return (uint32_t)((hostClockMicros << 12) / HOST_RTC_PERIOD_Q12); }
+inline uint32_t system_rtc_clock_cali_proc() { return HOST_RTC_PERIOD_Q12; }
+
+// Seeded the same on every run, so runs can be compared frame by frame
+inline uint32_t hostRandomState = 0x2545F491;
+inline void randomSeed(unsigned long seed) {
+  if (seed) hostRandomState = (uint32_t)seed;
+}
+inline long random(long howbig) {
+  if (howbig <= 0) return 0;
+  hostRandomState ^= hostRandomState << 13;
+  hostRandomState ^= hostRandomState >> 17;
+  hostRandomState ^= hostRandomState << 5;
+  return (long)(hostRandomState % (uint32_t)howbig);
+}
+inline long random(long howsmall, long howbig) {
+  return howsmall >= howbig ? howsmall : howsmall + random(howbig - howsmall);
+}
+
+// ---- Print and Stream ----
+
+class Print;
+
+class Printable {
+public:
+  virtual ~Printable() {}
+  virtual size_t printTo(Print &p) const = 0;
+};
+
+class Print {
+private:
+  size_t printNumber(unsigned long long n, int base, bool negative) {
+    char buf[68];
+    char *p = buf + sizeof(buf) - 1;
+    *p = '\0';
+    if (base < 2) base = 10;
+    do {
+      int digit = (int)(n % base);
+      *--p = (char)(digit < 10 ? '0' + digit : 'A' + digit - 10);
+      n /= base;
+    } while (n);
+    if (negative) *--p = '-';
+    return write(p);
+  }
+
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t c) = 0;
+  virtual size_t write(const uint8_t *buffer, size_t size) {
+    size_t n = 0;
+    while (size--) n += write(*buffer++);
+    return n;
+  }
+  virtual void flush() {}
+  size_t write(const char *s) { return s ? write((const uint8_t *)s, strlen(s)) : 0; }
+  size_t write(const char *buffer, size_t size) { return write((const uint8_t *)buffer, size); }
+
+  size_t printf(const char *format, ...) __attribute__((format(printf, 2, 3))) {
+    char buf[256];
+    va_list args;
+    va_start(args, format);
+    int len = vsnprintf(buf, sizeof(buf), format, args);
+    va_end(args);
+    if (len < 0) return 0;
+    if ((size_t)len < sizeof(buf)) return write((const uint8_t *)buf, len);
+    char *big = new char[len + 1];
+    va_start(args, format);
+    vsnprintf(big, len + 1, format, args);
+    va_end(args);
+    size_t n = write((const uint8_t *)big, len);
+    delete[] big;
+    return n;
+  }
+
+  size_t print(const char *s) { return write(s); }
+  size_t print(const String &s) { return write((const uint8_t *)s.c_str(), s.length()); }
+  size_t print(char c) { return write((uint8_t)c); }
+  size_t print(unsigned char n, int base = DEC) { return printNumber(n, base, false); }
+  size_t print(int n, int base = DEC) { return print((long)n, base); }
+  size_t print(unsigned int n, int base = DEC) { return printNumber(n, base, false); }
+  size_t print(long n, int base = DEC) {
+    if (base == DEC && n < 0) return printNumber(-(unsigned long long)n, base, true);
+    return printNumber((unsigned long)n, base, false);
+  }
+  size_t print(unsigned long n, int base = DEC) { return printNumber(n, base, false); }
+  size_t print(long long n, int base = DEC) {
+    if (base == DEC && n < 0) return printNumber(-(unsigned long long)n, base, true);
+    return printNumber((unsigned long long)n, base, false);
+  }
+  size_t print(unsigned long long n, int base = DEC) { return printNumber(n, base, false); }
+  size_t print(double n, int digits = 2) { return printf("%.*f", digits, n); }
+  size_t print(const Printable &x) { return x.printTo(*this); }
+
+  size_t println() { return write("\r\n"); }
+  template <typename T>
+  size_t println(const T &value) {
+    size_t n = print(value);
+    return n + println();
+  }
+  template <typename T>
+  size_t println(const T &value, int format) {
+    size_t n = print(value, format);
+    return n + println();
+  }
+};
+
+class Stream : public Print {
+protected:
+  unsigned long _timeout = 1000;
+  unsigned long _startMillis = 0;
+
+  // Waits on the simulated clock, which only moves while someone waits
+  int timedRead() {
+    _startMillis = millis();
+    do {
+      int c = read();
+      if (c >= 0) return c;
+      delay(1);
+    } while (millis() - _startMillis < _timeout);
+    return -1;
+  }
+  int timedPeek() {
+    _startMillis = millis();
+    do {
+      int c = peek();
+      if (c >= 0) return c;
+      delay(1);
+    } while (millis() - _startMillis < _timeout);
+    return -1;
+  }
+
+public:
+  virtual int available() = 0;
+  virtual int read() = 0;
+  virtual int peek() = 0;
+
+  void setTimeout(unsigned long timeout) { _timeout = timeout; }
+  unsigned long getTimeout() const { return _timeout; }
+
+  bool find(const char *target) { return findUntil(target, nullptr); }
+  bool find(const char *target, size_t length) { return findUntil(target, length, nullptr, 0); }
+  bool findUntil(const char *target, const char *terminator) {
+    return findUntil(target, strlen(target), terminator, terminator ? strlen(terminator) : 0);
+  }
+  // Matches with backtracking, unlike the cores' single index (which misses
+  // "aab" in "aaab"); nothing in the sketch depends on that difference
+  bool findUntil(const char *target, size_t targetLen, const char *terminator, size_t termLen) {
+    if (targetLen == 0) return true;
+    std::string window;
+    size_t keep = std::max(targetLen, termLen);
+    int c;
+    while ((c = timedRead()) >= 0) {
+      window.push_back((char)c);
+      if (window.size() > keep) window.erase(0, window.size() - keep);
+      if (window.size() >= targetLen && window.compare(window.size() - targetLen, targetLen, target, targetLen) == 0) {
+        return true;
+      }
+      if (termLen && window.size() >= termLen &&
+          window.compare(window.size() - termLen, termLen, terminator, termLen) == 0) {
+        return false;
+      }
+    }
+    return false;
+  }
+
+  size_t readBytes(char *buffer, size_t length) {
+    size_t count = 0;
+    while (count < length) {
+      int c = timedRead();
+      if (c < 0) break;
+      buffer[count++] = (char)c;
+    }
+    return count;
+  }
+  size_t readBytes(uint8_t *buffer, size_t length) { return readBytes((char *)buffer, length); }
+  size_t readBytesUntil(char terminator, char *buffer, size_t length) {
+    size_t count = 0;
+    while (count < length) {
+      int c = timedRead();
+      if (c < 0 || c == terminator) break;
+      buffer[count++] = (char)c;
+    }
+    return count;
+  }
+  String readString() {
+    String out;
+    int c;
+    while ((c = timedRead()) >= 0) out += (char)c;
+    return out;
+  }
+  String readStringUntil(char terminator) {
+    String out;
+    int c;
+    while ((c = timedRead()) >= 0 && c != terminator) out += (char)c;
+    return out;
+  }
+};
+
+// Serial goes to stdout, or nowhere with the simulator's --quiet
+class HardwareSerial : public Stream {
+public:
+  void begin(unsigned long baud) {}
+  size_t write(uint8_t c) override;
+  size_t write(const uint8_t *buffer, size_t size) override;
+  using Print::write;
+  int available() override { return 0; }
+  int read() override { return -1; }
+  int peek() override { return -1; }
+};
+extern HardwareSerial Serial;
+
+// ---- ESP object ----
+
+enum rst_reason {
+  REASON_DEFAULT_RST = 0,
+  REASON_WDT_RST = 1,
+  REASON_EXCEPTION_RST = 2,
+  REASON_SOFT_WDT_RST = 3,
+  REASON_SOFT_RESTART = 4,
+  REASON_DEEP_SLEEP_AWAKE = 5,
+  REASON_EXT_SYS_RST = 6
+};
+
+struct rst_info {
+  uint32_t reason;
+  uint32_t exccause;
+  uint32_t epc1;
+  uint32_t epc2;
+  uint32_t epc3;
+  uint32_t excvaddr;
+  uint32_t depc;
+};
+
+// Thrown by ESP.restart(); the simulator ends the run there, since the
+// sketch's globals cannot be reset for a second boot
+struct HostRestart {};
+
+class EspClass {
+public:
+  uint32_t getFreeHeap();
+  uint32_t getMaxFreeBlockSize();
+  [[noreturn]] void restart();
+  bool rtcUserMemoryRead(uint32_t offset, uint32_t *data, size_t size);
+  bool rtcUserMemoryWrite(uint32_t offset, uint32_t *data, size_t size);
+  rst_info *getResetInfoPtr();
+};
+extern EspClass ESP;
+
+#endif // HOST_SIM_ARDUINO_H
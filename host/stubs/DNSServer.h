@@ -0,0 +1,14 @@
+#ifndef HOST_SIM_DNSSERVER_H
+#define HOST_SIM_DNSSERVER_H
+
+#include <Arduino.h>
+#include <IPAddress.h>
+
+class DNSServer {
+public:
+  bool start(uint16_t port, const String &domainName, const IPAddress &resolvedIP) { return true; }
+  void processNextRequest() {}
+  void stop() {}
+};
+
+#endif // HOST_SIM_DNSSERVER_H
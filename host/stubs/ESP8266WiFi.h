@@ -0,0 +1,120 @@
+#ifndef HOST_SIM_ESP8266WIFI_H
+#define HOST_SIM_ESP8266WIFI_H
+
+// Station and soft AP of the simulated device. The access point is in range
+// unless the simulator runs with --no-wifi; a connect takes a few hundred ms
+// on the cached BSSID and channel, a few seconds with a scan, and never
+// succeeds on a stale BSSID. Clients talk to the fixture servers (see
+// simulator.h).
+
+#include <Arduino.h>
+#include <Client.h>
+#include <IPAddress.h>
+#include <vector>
+
+typedef enum WiFiMode { WIFI_OFF = 0, WIFI_STA = 1, WIFI_AP = 2, WIFI_AP_STA = 3 } WiFiMode_t;
+
+typedef enum {
+  WL_NO_SHIELD = 255,
+  WL_IDLE_STATUS = 0,
+  WL_NO_SSID_AVAIL = 1,
+  WL_SCAN_COMPLETED = 2,
+  WL_CONNECTED = 3,
+  WL_CONNECT_FAILED = 4,
+  WL_CONNECTION_LOST = 5,
+  WL_WRONG_PASSWORD = 6,
+  WL_DISCONNECTED = 7
+} wl_status_t;
+
+struct WiFiEventStationModeGotIP {
+  IPAddress ip;
+  IPAddress mask;
+  IPAddress gw;
+};
+
+struct WiFiEventStationModeDisconnected {
+  String ssid;
+  uint8_t bssid[6];
+  uint8_t reason;
+};
+
+typedef std::shared_ptr<void> WiFiEventHandler;
+
+class ESP8266WiFiClass {
+private:
+  WiFiMode_t _mode = WIFI_OFF;
+  bool _joining = false;
+  bool _connected = false;
+  bool _stale = false;  // Joining a BSSID that is not the access point's
+  uint64_t _joinAtUs = 0;
+  IPAddress _staticIp;
+  std::vector<std::weak_ptr<std::function<void(const WiFiEventStationModeGotIP &)>>> _gotIpHandlers;
+  std::vector<std::weak_ptr<std::function<void(const WiFiEventStationModeDisconnected &)>>> _disconnectHandlers;
+
+public:
+  bool mode(WiFiMode_t mode);
+  WiFiMode_t getMode() const { return _mode; }
+  void persistent(bool persistent) {}
+  bool setAutoReconnect(bool autoReconnect) { return true; }
+
+  wl_status_t begin(const char *ssid, const char *passphrase = nullptr, int32_t channel = 0,
+                    const uint8_t *bssid = nullptr, bool connect = true);
+  bool config(IPAddress local_ip, IPAddress gateway, IPAddress subnet, IPAddress dns1 = IPAddress(),
+              IPAddress dns2 = IPAddress());
+  bool disconnect(bool wifioff = false);
+  wl_status_t status();
+
+  IPAddress localIP();
+  String macAddress() { return String("5C:CF:7F:00:00:01"); }
+  uint8_t *BSSID();
+  int32_t channel() { return _connected ? 6 : 0; }
+  int32_t RSSI() { return _connected ? -58 : 0; }
+  int hostByName(const char *hostname, IPAddress &result);
+
+  bool softAP(const char *ssid, const char *passphrase = nullptr, int channel = 1, int ssid_hidden = 0,
+              int max_connection = 4);
+  bool softAPConfig(IPAddress local_ip, IPAddress gateway, IPAddress subnet) { return true; }
+  IPAddress softAPIP() { return IPAddress(192, 168, 4, 1); }
+
+  WiFiEventHandler onStationModeGotIP(std::function<void(const WiFiEventStationModeGotIP &)> handler);
+  WiFiEventHandler onStationModeDisconnected(std::function<void(const WiFiEventStationModeDisconnected &)> handler);
+
+  // Simulator: finishes a join that is due and runs the event handlers
+  void hostPoll();
+};
+extern ESP8266WiFiClass WiFi;
+
+// A TCP connection to a fixture server, answering HTTP requests
+class WiFiClient : public Client {
+protected:
+  std::string _host;
+  bool _open = false;
+  bool _closeAfterResponse = false;  // The server did not agree to keep-alive
+  std::string _request;
+  std::string _rx;
+  size_t _rxPos = 0;
+  uint64_t _rxAtUs = 0;  // Response bytes arrive one round trip after the request
+  uint64_t _lastActivityUs = 0;
+
+  bool waitWithin(unsigned long ms);
+
+public:
+  WiFiClient() { _timeout = 5000; }  // The cores' default
+  virtual ~WiFiClient() {}
+  int connect(IPAddress ip, uint16_t port) override { return 0; }
+  int connect(const char *host, uint16_t port) override;
+  size_t write(uint8_t c) override { return write(&c, 1); }
+  size_t write(const uint8_t *buffer, size_t size) override;
+  using Print::write;
+  int available() override;
+  int read() override;
+  int read(uint8_t *buffer, size_t size) override;
+  int peek() override;
+  void flush() override {}
+  void stop() override;
+  uint8_t connected() override;
+  operator bool() override { return connected(); }
+  void setNoDelay(bool nodelay) {}
+};
+
+#endif // HOST_SIM_ESP8266WIFI_H
@@ -0,0 +1,14 @@
+#ifndef HOST_SIM_ESP8266MDNS_H
+#define HOST_SIM_ESP8266MDNS_H
+
+#include <Arduino.h>
+
+class MDNSResponder {
+public:
+  bool begin(const char *hostname) { return hostname && hostname[0]; }
+  bool addService(const char *service, const char *proto, uint16_t port) { return true; }
+  bool update() { return true; }
+};
+extern MDNSResponder MDNS;
+
+#endif // HOST_SIM_ESP8266MDNS_H
@@ -0,0 +1,78 @@
+#ifndef HOST_SIM_ESPASYNCTCP_H
+#define HOST_SIM_ESPASYNCTCP_H
+
+// Callback TCP client on the fixture servers. Events are delivered from
+// hostNetworkPoll() between loop() passes, like lwIP does on the device:
+// connect after one round trip, the response a round trip after the request
+// in segments of up to 1460 bytes, one per poll, then the server's close.
+
+#include <Arduino.h>
+#include <IPAddress.h>
+
+class AsyncClient;
+
+typedef std::function<void(void *, AsyncClient *)> AcConnectHandler;
+typedef std::function<void(void *, AsyncClient *, void *data, size_t len)> AcDataHandler;
+typedef std::function<void(void *, AsyncClient *, int8_t error)> AcErrorHandler;
+
+#define ASYNC_MAX_ACK_TIME 5000
+#define HOST_TCP_SEGMENT 1460
+#define HOST_TCP_SNDBUF 2920
+
+class AsyncClient {
+private:
+  enum State { CLOSED, CONNECTING, CONNECTED, RESPONDING, FAILED };
+  State _state = CLOSED;
+  std::string _host;
+  std::string _request;
+  std::string _response;
+  size_t _sent = 0;
+  uint64_t _eventAtUs = 0;
+  bool _keepAlive = false;
+  AcConnectHandler _onConnect, _onDisconnect;
+  AcDataHandler _onData;
+  AcErrorHandler _onError;
+  void *_connectArg = nullptr, *_disconnectArg = nullptr, *_dataArg = nullptr, *_errorArg = nullptr;
+
+  void closed();
+
+public:
+  AsyncClient();
+  ~AsyncClient();
+  AsyncClient(const AsyncClient &) = delete;
+  AsyncClient &operator=(const AsyncClient &) = delete;
+
+  bool connect(const char *host, uint16_t port);
+  bool connect(IPAddress ip, uint16_t port) { return false; }
+  void close(bool now = false);
+  bool connected() const { return _state == CONNECTED || _state == RESPONDING; }
+  size_t space() const { return _state == CONNECTED ? HOST_TCP_SNDBUF : 0; }
+  size_t add(const char *data, size_t size, uint8_t apiflags = 0);
+  bool send() { return true; }
+  size_t write(const char *data) { return write(data, strlen(data)); }
+  size_t write(const char *data, size_t size, uint8_t apiflags = 0) { return add(data, size, apiflags); }
+  IPAddress remoteIP() const { return IPAddress(192, 168, 1, 20); }
+  const char *errorToString(int8_t error);
+
+  void onConnect(AcConnectHandler cb, void *arg = nullptr) {
+    _onConnect = cb;
+    _connectArg = arg;
+  }
+  void onDisconnect(AcConnectHandler cb, void *arg = nullptr) {
+    _onDisconnect = cb;
+    _disconnectArg = arg;
+  }
+  void onData(AcDataHandler cb, void *arg = nullptr) {
+    _onData = cb;
+    _dataArg = arg;
+  }
+  void onError(AcErrorHandler cb, void *arg = nullptr) {
+    _onError = cb;
+    _errorArg = arg;
+  }
+
+  // Simulator: runs the event that is due, if any
+  void hostPoll();
+};
+
+#endif // HOST_SIM_ESPASYNCTCP_H
@@ -0,0 +1,270 @@
+#ifndef HOST_SIM_ESPASYNCWEBSERVER_H
+#define HOST_SIM_ESPASYNCWEBSERVER_H
+
+// Routes of the sketch's web server, reachable through hostWebRequest()
+// (the simulator's --request) instead of a socket. A route matches its URI
+// and everything below it ("/webhook" also takes "/webhook/x"); the first
+// registered match wins, as in the library. Query parameters are GET
+// parameters; a form body gives POST parameters, any other body goes to the
+// route's body callback.
+
+#include <Arduino.h>
+#include <ESPAsyncTCP.h>
+#include <LittleFS.h>
+#include <vector>
+
+typedef enum {
+  HTTP_GET = 0b00000001,
+  HTTP_POST = 0b00000010,
+  HTTP_DELETE = 0b00000100,
+  HTTP_PUT = 0b00001000,
+  HTTP_PATCH = 0b00010000,
+  HTTP_HEAD = 0b00100000,
+  HTTP_OPTIONS = 0b01000000,
+  HTTP_ANY = 0b01111111
+} WebRequestMethod;
+typedef uint8_t WebRequestMethodComposite;
+
+class AsyncWebServerRequest;
+class AsyncEventSourceClient;
+
+typedef std::function<void(AsyncWebServerRequest *request)> ArRequestHandlerFunction;
+typedef std::function<void(AsyncWebServerRequest *request, const String &filename, size_t index, uint8_t *data,
+                           size_t len, bool final)>
+  ArUploadHandlerFunction;
+typedef std::function<void(AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total)>
+  ArBodyHandlerFunction;
+typedef std::function<bool(AsyncWebServerRequest *request)> ArRequestFilterFunction;
+typedef std::function<void(AsyncEventSourceClient *client)> ArEventHandlerFunction;
+typedef std::function<void(void)> ArDisconnectHandler;
+
+class AsyncWebParameter {
+private:
+  String _name;
+  String _value;
+  bool _isForm;
+
+public:
+  AsyncWebParameter(const String &name, const String &value, bool form) : _name(name), _value(value), _isForm(form) {}
+  const String &name() const { return _name; }
+  const String &value() const { return _value; }
+  bool isPost() const { return _isForm; }
+  bool isFile() const { return false; }
+};
+
+class AsyncWebHeader {
+private:
+  String _name;
+  String _value;
+
+public:
+  AsyncWebHeader(const String &name, const String &value) : _name(name), _value(value) {}
+  const String &name() const { return _name; }
+  const String &value() const { return _value; }
+};
+
+class AsyncWebServerResponse {
+protected:
+  int _code;
+  String _contentType;
+  String _content;
+  std::vector<AsyncWebHeader> _headers;
+
+public:
+  AsyncWebServerResponse(int code, const String &contentType, const String &content)
+    : _code(code), _contentType(contentType), _content(content) {}
+  virtual ~AsyncWebServerResponse() {}
+  void addHeader(const String &name, const String &value) { _headers.emplace_back(name, value); }
+  void setCode(int code) { _code = code; }
+  void setContentType(const String &type) { _contentType = type; }
+  int code() const { return _code; }
+  const String &contentType() const { return _contentType; }
+  const String &content() const { return _content; }
+  const std::vector<AsyncWebHeader> &headers() const { return _headers; }
+};
+
+class AsyncResponseStream : public AsyncWebServerResponse, public Print {
+public:
+  AsyncResponseStream(const String &contentType) : AsyncWebServerResponse(200, contentType, String()) {}
+  size_t write(uint8_t c) override {
+    _content.concat((char)c);
+    return 1;
+  }
+  size_t write(const uint8_t *buffer, size_t size) override {
+    _content.concat((const char *)buffer, size);
+    return size;
+  }
+  using Print::write;
+};
+
+class AsyncWebServerRequest {
+private:
+  WebRequestMethodComposite _method;
+  String _url;
+  std::vector<AsyncWebParameter> _params;
+  std::vector<AsyncWebHeader> _headers;
+  size_t _contentLength = 0;
+  AsyncClient _client;
+  AsyncWebServerResponse *_response = nullptr;
+  ArDisconnectHandler _onDisconnect;
+
+public:
+  void *_tempObject = nullptr;  // Freed with the request, as in the library
+
+  AsyncWebServerRequest(WebRequestMethodComposite method, const String &url) : _method(method), _url(url) {}
+  ~AsyncWebServerRequest();
+  AsyncWebServerRequest(const AsyncWebServerRequest &) = delete;
+  AsyncWebServerRequest &operator=(const AsyncWebServerRequest &) = delete;
+
+  WebRequestMethodComposite method() const { return _method; }
+  const String &url() const { return _url; }
+  AsyncClient *client() { return &_client; }
+  size_t contentLength() const { return _contentLength; }
+
+  size_t params() const { return _params.size(); }
+  bool hasParam(const String &name, bool post = false, bool file = false) const {
+    return getParam(name, post, file) != nullptr;
+  }
+  const AsyncWebParameter *getParam(const String &name, bool post = false, bool file = false) const;
+  const AsyncWebParameter *getParam(size_t num) const { return num < _params.size() ? &_params[num] : nullptr; }
+  bool hasHeader(const String &name) const { return getHeader(name) != nullptr; }
+  const AsyncWebHeader *getHeader(const String &name) const;
+
+  AsyncWebServerResponse *beginResponse(int code, const String &contentType = String(),
+                                        const String &content = String()) {
+    return new AsyncWebServerResponse(code, contentType, content);
+  }
+  AsyncWebServerResponse *beginResponse(FS &fs, const String &path, const String &contentType = String(),
+                                        bool download = false);
+  AsyncResponseStream *beginResponseStream(const String &contentType, size_t bufferSize = 1460) {
+    return new AsyncResponseStream(contentType);
+  }
+  void send(AsyncWebServerResponse *response);
+  void send(int code, const String &contentType = String(), const String &content = String()) {
+    send(beginResponse(code, contentType, content));
+  }
+  void send(FS &fs, const String &path, const String &contentType = String(), bool download = false) {
+    send(beginResponse(fs, path, contentType, download));
+  }
+  void redirect(const String &url) {
+    AsyncWebServerResponse *response = beginResponse(302);
+    response->addHeader("Location", url);
+    send(response);
+  }
+  void onDisconnect(ArDisconnectHandler fn) { _onDisconnect = fn; }
+
+  // Simulator: request setup and the answer
+  void hostAddParam(const String &name, const String &value, bool post) { _params.emplace_back(name, value, post); }
+  void hostAddHeader(const String &name, const String &value) { _headers.emplace_back(name, value); }
+  void hostSetContentLength(size_t length) { _contentLength = length; }
+  const AsyncWebServerResponse *hostResponse() const { return _response; }
+};
+
+class AsyncWebHandler {
+protected:
+  ArRequestFilterFunction _filter;
+
+public:
+  virtual ~AsyncWebHandler() {}
+  AsyncWebHandler &setFilter(ArRequestFilterFunction fn) {
+    _filter = fn;
+    return *this;
+  }
+  bool filter(AsyncWebServerRequest *request) { return !_filter || _filter(request); }
+  virtual bool canHandle(AsyncWebServerRequest *request) { return false; }
+  virtual void handleRequest(AsyncWebServerRequest *request) {}
+  virtual void handleBody(AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total) {}
+};
+
+class AsyncCallbackWebHandler : public AsyncWebHandler {
+private:
+  String _uri;
+  WebRequestMethodComposite _method;
+  ArRequestHandlerFunction _onRequest;
+  ArBodyHandlerFunction _onBody;
+
+public:
+  AsyncCallbackWebHandler(const char *uri, WebRequestMethodComposite method, ArRequestHandlerFunction onRequest,
+                          ArBodyHandlerFunction onBody)
+    : _uri(uri), _method(method), _onRequest(onRequest), _onBody(onBody) {}
+  bool canHandle(AsyncWebServerRequest *request) override;
+  void handleRequest(AsyncWebServerRequest *request) override {
+    if (_onRequest) _onRequest(request);
+  }
+  void handleBody(AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total) override {
+    if (_onBody) _onBody(request, data, len, index, total);
+  }
+};
+
+class AsyncStaticWebHandler : public AsyncWebHandler {
+private:
+  String _uri;
+  String _path;
+
+public:
+  AsyncStaticWebHandler(const char *uri, const char *path) : _uri(uri), _path(path) {}
+  AsyncStaticWebHandler &setDefaultFile(const char *filename) { return *this; }
+  AsyncStaticWebHandler &setCacheControl(const char *cacheControl) { return *this; }
+  bool canHandle(AsyncWebServerRequest *request) override;
+  void handleRequest(AsyncWebServerRequest *request) override;
+};
+
+class AsyncEventSourceClient {
+private:
+  bool _connected = true;
+
+public:
+  void close() { _connected = false; }
+  bool connected() const { return _connected; }
+  void send(const char *message, const char *event = nullptr, uint32_t id = 0, uint32_t reconnect = 0);
+};
+
+// Clients are simulated ones (--events); what is sent to them is printed
+class AsyncEventSource : public AsyncWebHandler {
+private:
+  String _url;
+  std::vector<std::unique_ptr<AsyncEventSourceClient>> _clients;
+  ArEventHandlerFunction _onConnect;
+
+public:
+  AsyncEventSource(const String &url) : _url(url) {}
+  const char *url() const { return _url.c_str(); }
+  void onConnect(ArEventHandlerFunction cb) { _onConnect = cb; }
+  size_t count() const;
+  void send(const char *message, const char *event = nullptr, uint32_t id = 0, uint32_t reconnect = 0);
+
+  // Simulator: a client opens the stream; false if the filter refused it
+  bool hostConnect();
+};
+
+class AsyncWebServer {
+private:
+  std::vector<AsyncWebHandler *> _handlers;
+  std::vector<std::unique_ptr<AsyncWebHandler>> _owned;
+  ArRequestHandlerFunction _notFound;
+  bool _started = false;
+
+public:
+  static AsyncWebServer *hostInstance;  // The sketch has one server
+
+  AsyncWebServer(uint16_t port) { hostInstance = this; }
+  void begin() { _started = true; }
+  AsyncCallbackWebHandler &on(const char *uri, WebRequestMethodComposite method, ArRequestHandlerFunction onRequest,
+                              ArUploadHandlerFunction onUpload = nullptr, ArBodyHandlerFunction onBody = nullptr);
+  AsyncCallbackWebHandler &on(const char *uri, ArRequestHandlerFunction onRequest) {
+    return on(uri, HTTP_ANY, onRequest);
+  }
+  AsyncStaticWebHandler &serveStatic(const char *uri, FS &fs, const char *path, const char *cacheControl = nullptr);
+  AsyncWebHandler &addHandler(AsyncWebHandler *handler) {
+    _handlers.push_back(handler);
+    return *handler;
+  }
+  void onNotFound(ArRequestHandlerFunction fn) { _notFound = fn; }
+
+  // Simulator: runs a request through the handlers; false if the server
+  // was never started. The response stays with the request.
+  bool hostHandle(AsyncWebServerRequest &request, const uint8_t *body, size_t bodyLen);
+  AsyncEventSource *hostEventSource(const char *url);
+};
+
+#endif // HOST_SIM_ESPASYNCWEBSERVER_H
@@ -0,0 +1,49 @@
+#ifndef HOST_SIM_IPADDRESS_H
+#define HOST_SIM_IPADDRESS_H
+
+#include <Arduino.h>
+
+// IPv4 only; the first octet is the low byte of the uint32_t, as in lwIP
+class IPAddress : public Printable {
+private:
+  uint8_t _bytes[4];
+
+public:
+  IPAddress() : _bytes{0, 0, 0, 0} {}
+  IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) : _bytes{a, b, c, d} {}
+  IPAddress(uint32_t address) { memcpy(_bytes, &address, 4); }
+
+  operator uint32_t() const {
+    uint32_t address;
+    memcpy(&address, _bytes, 4);
+    return address;
+  }
+  bool operator==(const IPAddress &other) const { return memcmp(_bytes, other._bytes, 4) == 0; }
+  bool operator!=(const IPAddress &other) const { return !(*this == other); }
+  uint8_t operator[](int index) const { return _bytes[index]; }
+  uint8_t &operator[](int index) { return _bytes[index]; }
+  bool isSet() const { return (uint32_t)*this != 0; }
+
+  bool fromString(const char *address) {
+    unsigned parts[4];
+    char end;
+    if (!address || sscanf(address, "%u.%u.%u.%u%c", &parts[0], &parts[1], &parts[2], &parts[3], &end) != 4) {
+      return false;
+    }
+    for (int i = 0; i < 4; i++) {
+      if (parts[i] > 255) return false;
+    }
+    for (int i = 0; i < 4; i++) _bytes[i] = (uint8_t)parts[i];
+    return true;
+  }
+  bool fromString(const String &address) { return fromString(address.c_str()); }
+
+  String toString() const {
+    char buf[16];
+    snprintf(buf, sizeof(buf), "%u.%u.%u.%u", _bytes[0], _bytes[1], _bytes[2], _bytes[3]);
+    return String(buf);
+  }
+  size_t printTo(Print &p) const override { return p.print(toString()); }
+};
+
+#endif // HOST_SIM_IPADDRESS_H
@@ -0,0 +1,99 @@
+#ifndef HOST_SIM_LITTLEFS_H
+#define HOST_SIM_LITTLEFS_H
+
+// LittleFS backed by a host directory (the simulator's --fs). Paths are
+// absolute on the device ("/config.json") and resolve below that directory;
+// parent directories are created on write, as LittleFS does.
+
+#include <Arduino.h>
+#include <stdio.h>
+
+// Fault injection: the write that takes the disk past this many more bytes
+// is cut short there, once, as a full or failing flash would (-1 = none)
+extern long hostFsTornWriteAfter;
+
+namespace fs {
+
+struct FSInfo {
+  unsigned int totalBytes;  // size_t on the ESP8266
+  unsigned int usedBytes;
+  unsigned int blockSize;
+  unsigned int pageSize;
+  unsigned int maxOpenFiles;
+  unsigned int maxPathLength;
+};
+
+class File : public Stream {
+private:
+  std::shared_ptr<FILE> _file;
+  String _name;
+
+public:
+  File() {}
+  File(FILE *file, const char *name) : _file(file, fclose), _name(name) {}
+
+  explicit operator bool() const { return (bool)_file; }
+  size_t write(uint8_t c) override { return write(&c, 1); }
+  size_t write(const uint8_t *buffer, size_t size) override {
+    if (!_file) return 0;
+    if (hostFsTornWriteAfter >= 0) {
+      if ((long)size > hostFsTornWriteAfter) {
+        size = (size_t)hostFsTornWriteAfter;
+        hostFsTornWriteAfter = -1;
+      } else {
+        hostFsTornWriteAfter -= (long)size;
+      }
+    }
+    return fwrite(buffer, 1, size, _file.get());
+  }
+  using Print::write;
+  int available() override {
+    if (!_file) return 0;
+    long pos = ftell(_file.get());
+    return pos < 0 ? 0 : (int)(size() - (size_t)pos);
+  }
+  int read() override { return _file ? fgetc(_file.get()) : -1; }
+  size_t read(uint8_t *buffer, size_t size) { return _file ? fread(buffer, 1, size, _file.get()) : 0; }
+  int peek() override {
+    if (!_file) return -1;
+    int c = fgetc(_file.get());
+    if (c != EOF) ungetc(c, _file.get());
+    return c;
+  }
+  void flush() override {
+    if (_file) fflush(_file.get());
+  }
+  size_t size() const;
+  size_t position() const { return _file ? (size_t)ftell(_file.get()) : 0; }
+  bool seek(uint32_t pos) { return _file && fseek(_file.get(), pos, SEEK_SET) == 0; }
+  const char *name() const { return _name.c_str(); }
+  void close() { _file.reset(); }
+};
+
+class FS {
+public:
+  bool begin();
+  void end() {}
+  File open(const char *path, const char *mode);
+  File open(const String &path, const char *mode) { return open(path.c_str(), mode); }
+  bool exists(const char *path);
+  bool exists(const String &path) { return exists(path.c_str()); }
+  bool remove(const char *path);
+  bool remove(const String &path) { return remove(path.c_str()); }
+  bool rename(const char *from, const char *to);
+  bool rename(const String &from, const String &to) { return rename(from.c_str(), to.c_str()); }
+  bool info(FSInfo &info);
+
+  // Simulator: where a device path lives on the host
+  std::string hostPath(const char *path) const;
+};
+
+}  // namespace fs
+
+using fs::File;
+using fs::FS;
+using fs::FSInfo;
+
+extern FS LittleFS;
+
+#endif // HOST_SIM_LITTLEFS_H
@@ -0,0 +1,25 @@
+#ifndef HOST_SIM_MD_MAX72XX_H
+#define HOST_SIM_MD_MAX72XX_H
+
+#include <Arduino.h>
+
+// What the chain of MAX7219 modules shows. Columns run left to right as seen
+// on the front, bit 0 of each is the top row. MD_Parola draws here; the
+// simulator dumps it.
+#define HOST_DISPLAY_COLUMNS 32  // MAX_DEVICES * 8
+
+struct HostDisplay {
+  uint8_t columns[HOST_DISPLAY_COLUMNS];
+  uint8_t intensity;  // 0-15
+  bool shutdown;
+  uint32_t updates;   // Bumped whenever any of the above changes
+};
+extern HostDisplay hostDisplay;
+
+class MD_MAX72XX {
+public:
+  enum moduleType_t { GENERIC_HW, FC16_HW, PAROLA_HW, ICSTATION_HW, DR0CR0RR0_HW, DR1CR0RR0_HW };
+  typedef const uint8_t fontType_t;
+};
+
+#endif // HOST_SIM_MD_MAX72XX_H
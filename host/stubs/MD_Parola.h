@@ -0,0 +1,85 @@
+#ifndef HOST_SIM_MD_PAROLA_H
+#define HOST_SIM_MD_PAROLA_H
+
+// Single-zone MD_Parola drawing into hostDisplay with the sketch's font.
+// Text is laid out like the library does (glyph columns, charSpacing blank
+// columns between characters, aligned in the zone) and the effects the
+// sketch uses are animated one column per speed ms from displayAnimate():
+// PA_SCROLL_LEFT / PA_SCROLL_RIGHT in and out, PA_NO_EFFECT and PA_PRINT.
+// The text pointer is kept, not copied, as in the library.
+
+#include <MD_MAX72xx.h>
+
+enum textPosition_t { PA_LEFT, PA_CENTER, PA_RIGHT };
+
+enum textEffect_t {
+  PA_NO_EFFECT,
+  PA_PRINT,
+  PA_SCROLL_UP,
+  PA_SCROLL_DOWN,
+  PA_SCROLL_LEFT,
+  PA_SCROLL_RIGHT,
+  PA_FLIP_UD,
+  PA_FLIP_LR
+};
+
+class MD_Parola {
+private:
+  enum Phase { IDLE, PHASE_IN, PHASE_PAUSE, PHASE_OUT, DONE };
+
+  const uint8_t *_font = nullptr;
+  const uint8_t *_glyphs[256] = {};  // Width byte of each character in _font
+  const uint8_t *_userChars[256] = {};
+  const char *_text = "";
+  textPosition_t _align = PA_LEFT;
+  uint8_t _charSpacing = 1;
+  bool _invert = false;
+  bool _flipUD = false;
+  bool _flipLR = false;
+  uint16_t _speed = 0;
+  uint16_t _pause = 0;
+  textEffect_t _effectIn = PA_NO_EFFECT;
+  textEffect_t _effectOut = PA_NO_EFFECT;
+  Phase _phase = IDLE;
+  int _offset = 0;  // Display column of the first text column
+  unsigned long _lastTick = 0;
+  uint8_t _image[HOST_DISPLAY_COLUMNS] = {};  // Before invert and flips
+
+  const uint8_t *glyph(uint8_t code) const;
+  int textWidth() const;
+  int restingOffset(int width) const;
+  void drawText(int offset);
+  void clearImage();
+  void show();
+  bool step();
+
+public:
+  MD_Parola(MD_MAX72XX::moduleType_t mod, uint8_t dataPin, uint8_t clkPin, uint8_t csPin, uint8_t numDevices) {}
+
+  bool begin() { return begin(1); }
+  bool begin(uint8_t numZones);
+  void setFont(MD_MAX72XX::fontType_t *font);
+  bool addChar(uint16_t code, uint8_t *data);
+
+  void setTextAlignment(textPosition_t align) { _align = align; }
+  textPosition_t getTextAlignment() const { return _align; }
+  void setCharSpacing(uint8_t spacing) { _charSpacing = spacing; }
+  uint8_t getCharSpacing() const { return _charSpacing; }
+  void setInvert(bool invert);
+  bool getInvert() const { return _invert; }
+  void setZoneEffect(uint8_t zone, bool enable, textEffect_t effect);
+  void setIntensity(uint8_t intensity);
+  void displayShutdown(bool shutdown);
+  void displayClear();
+  void displayReset() { _phase = IDLE; }
+
+  void displayText(const char *text, textPosition_t align, uint16_t speed, uint16_t pause, textEffect_t effectIn,
+                   textEffect_t effectOut = PA_NO_EFFECT);
+  void displayScroll(const char *text, textPosition_t align, textEffect_t effect, uint16_t speed) {
+    displayText(text, align, speed, 0, effect, effect);
+  }
+  bool displayAnimate();
+  void print(const char *text);
+};
+
+#endif // HOST_SIM_MD_PAROLA_H
@@ -0,0 +1,6 @@
+#ifndef HOST_SIM_SPI_H
+#define HOST_SIM_SPI_H
+
+// The matrix is drawn by the MD_Parola stand-in, so there is no bus
+
+#endif // HOST_SIM_SPI_H
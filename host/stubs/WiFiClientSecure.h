@@ -0,0 +1,40 @@
+#ifndef HOST_SIM_WIFICLIENTSECURE_H
+#define HOST_SIM_WIFICLIENTSECURE_H
+
+// BearSSL client without the crypto: a connect costs the time of a full
+// handshake, or of an abbreviated one when the session set with setSession()
+// is from an earlier handshake with the same host. A full handshake
+// replaces the session's contents, a resumption leaves them as they were.
+
+#include <ESP8266WiFi.h>
+
+namespace BearSSL {
+
+class Session {
+private:
+  char _host[48] = "";
+  uint32_t _id = 0;  // 0 until a handshake filled it in
+
+  friend class WiFiClientSecure;
+};
+
+class WiFiClientSecure : public WiFiClient {
+private:
+  Session *_session = nullptr;
+
+public:
+  void setInsecure() {}
+  void setBufferSizes(int recv, int xmit) {}
+  void setSession(Session *session) { _session = session; }
+  int connect(const char *host, uint16_t port) override;
+  using WiFiClient::connect;
+
+  // Every fixture server accepts small records
+  static bool probeMaxFragmentLength(const char *host, uint16_t port, uint16_t len);
+};
+
+}  // namespace BearSSL
+
+using BearSSL::WiFiClientSecure;
+
+#endif // HOST_SIM_WIFICLIENTSECURE_H
@@ -0,0 +1,66 @@
+#ifndef HOST_SIM_WIFIUDP_H
+#define HOST_SIM_WIFIUDP_H
+
+// UDP socket that only reaches the simulated NTP servers: a request sent to
+// port 123 of an address from WiFi.hostByName() is answered with the world
+// time after that server's round trip.
+
+#include <Arduino.h>
+#include <IPAddress.h>
+#include <deque>
+#include <vector>
+
+class WiFiUDP : public Stream {
+private:
+  struct Datagram {
+    uint64_t atUs;
+    IPAddress from;
+    std::vector<uint8_t> data;
+  };
+  bool _open = false;
+  std::deque<Datagram> _queue;  // Sorted by arrival
+  std::vector<uint8_t> _current;
+  size_t _currentPos = 0;
+  IPAddress _currentFrom;
+  IPAddress _sendTo;
+  uint16_t _sendPort = 0;
+  std::vector<uint8_t> _send;
+
+public:
+  uint8_t begin(uint16_t port) {
+    _open = true;
+    return 1;
+  }
+  void stop() { _open = false; }
+  int beginPacket(IPAddress ip, uint16_t port) {
+    _sendTo = ip;
+    _sendPort = port;
+    _send.clear();
+    return 1;
+  }
+  size_t write(uint8_t c) override {
+    _send.push_back(c);
+    return 1;
+  }
+  size_t write(const uint8_t *buffer, size_t size) override {
+    _send.insert(_send.end(), buffer, buffer + size);
+    return size;
+  }
+  using Print::write;
+  int endPacket();
+
+  int parsePacket();
+  IPAddress remoteIP() const { return _currentFrom; }
+  int available() override { return (int)(_current.size() - _currentPos); }
+  int read() override { return _currentPos < _current.size() ? _current[_currentPos++] : -1; }
+  int read(uint8_t *buffer, size_t len) {
+    size_t n = std::min(len, _current.size() - _currentPos);
+    memcpy(buffer, _current.data() + _currentPos, n);
+    _currentPos += n;
+    return (int)n;
+  }
+  int peek() override { return _currentPos < _current.size() ? _current[_currentPos] : -1; }
+  void flush() override { _currentPos = _current.size(); }
+};
+
+#endif // HOST_SIM_WIFIUDP_H
@@ -0,0 +1,7 @@
+#ifndef HOST_SIM_SNTP_H
+#define HOST_SIM_SNTP_H
+
+// The SDK's SNTP client never runs on the host
+inline void sntp_stop() {}
+
+#endif // HOST_SIM_SNTP_H
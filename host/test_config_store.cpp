@@ -0,0 +1,228 @@
+// The sketch's config store on the directory-backed LittleFS: configUpdate()
+// and configFlush() as the web handlers call them, compaction once the
+// journal passes CONFIG_JOURNAL_COMPACT_BYTES, a short write the sketch
+// notices, and recoverConfigFiles() after a power cut at every byte of an
+// append (which the sketch only sees at the next boot).
+//
+// Patches are {"keyN": "value"} objects; the record format itself is tested
+// in tests/test_config_journal.cpp.
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <LittleFS.h>
+#include <map>
+#include <string>
+#include <unistd.h>
+#include "simulator.h"
+#include "../tests/check.h"
+
+typedef std::map<std::string, std::string> Config;
+
+// From the sketch
+void configUpdate(JsonDocument &patch);
+bool configFlush();
+bool configLoadDocument(JsonDocument &doc);
+void recoverConfigFiles();
+extern uint32_t configAppends;
+extern uint32_t configCompactions;
+extern bool configPending;
+
+#define JOURNAL "/config.jnl"
+#define COMPACT_BYTES 2048  // CONFIG_JOURNAL_COMPACT_BYTES in the sketch
+
+static std::string readFile(const char *path) {
+  std::string out;
+  File f = LittleFS.open(path, "r");
+  if (!f) return out;
+  int c;
+  while ((c = f.read()) >= 0) out += (char)c;
+  return out;
+}
+
+static void writeFile(const char *path, const std::string &data) {
+  if (data.empty()) {
+    LittleFS.remove(path);
+    return;
+  }
+  File f = LittleFS.open(path, "w");
+  f.write((const uint8_t *)data.data(), data.size());
+}
+
+static size_t fileSize(const char *path) {
+  File f = LittleFS.open(path, "r");
+  return f ? f.size() : 0;
+}
+
+// A fresh filesystem holding only the base config
+static void resetStore(const Config &base) {
+  configFlush();  // Nothing left pending from the previous test
+  LittleFS.remove(JOURNAL);
+  LittleFS.remove("/config.tmp");
+  LittleFS.remove("/config.bak");
+  DynamicJsonDocument doc(2048);
+  for (const auto &kv : base) doc[kv.first.c_str()] = kv.second.c_str();
+  String json;
+  serializeJson(doc, json);
+  writeFile("/config.json", json.c_str());
+}
+
+static void update(const std::string &key, const std::string &value) {
+  DynamicJsonDocument patch(256);
+  patch[key.c_str()] = value.c_str();
+  configUpdate(patch);
+}
+
+static Config effective() {
+  DynamicJsonDocument doc(4096);
+  Config config;
+  CHECK(configLoadDocument(doc));
+  for (JsonPair kv : doc.as<JsonObject>()) config[kv.key().c_str()] = kv.value().as<const char *>();
+  return config;
+}
+
+static std::string value(int i) {
+  return std::string(1 + (i * 37) % 90, (char)('a' + i % 26));
+}
+
+static std::string key(int i) {
+  return "key" + std::to_string(i % 5);
+}
+
+// Enough flushed updates to compact several times; the result is the same
+// as applying every patch in order, and the journal never grows far past
+// the threshold
+static void testCompaction() {
+  Config expected = {{"base", "1"}};
+  resetStore(expected);
+  uint32_t compactions = configCompactions;
+  for (int i = 0; i < 200; i++) {
+    update(key(i), value(i));
+    CHECK(configFlush());
+    expected[key(i)] = value(i);
+    CHECK(effective() == expected);
+    CHECK(fileSize(JOURNAL) <= COMPACT_BYTES);
+  }
+  CHECK(configCompactions - compactions > 2);
+}
+
+// Updates made before a flush land as one record
+static void testDebounce() {
+  Config expected = {{"base", "1"}};
+  resetStore(expected);
+  uint32_t appends = configAppends;
+  for (int i = 0; i < 4; i++) {
+    update(key(i), value(i));
+    expected[key(i)] = value(i);
+  }
+  CHECK(effective() == expected);  // Pending changes are part of it
+  CHECK_EQ(fileSize(JOURNAL), 0);
+  CHECK(configFlush());
+  CHECK_EQ(configAppends - appends, 1);
+  CHECK(effective() == expected);
+}
+
+// Power cut at every byte of an append: after boot the config is the old one
+// or the new one, the journal is gone, and the next update is not hidden
+// behind the torn tail
+static void testPowerCut() {
+  resetStore({{"base", "1"}});
+  for (int i = 0; i < 8; i++) {
+    update(key(i), value(i));
+    CHECK(configFlush());
+  }
+  const std::string base = readFile("/config.json");
+  const std::string journal = readFile(JOURNAL);
+  CHECK(!journal.empty());
+  Config before = effective();
+  Config after = before;
+  after["key9"] = "new";
+
+  update("key9", "new");
+  CHECK(configFlush());
+  size_t recordSize = fileSize(JOURNAL) - journal.size();
+  CHECK(recordSize > 8);
+
+  for (size_t keep = 0; keep <= recordSize; keep++) {
+    writeFile("/config.json", base);
+    writeFile(JOURNAL, journal);
+    update("key9", "new");
+    CHECK(configFlush());
+    CHECK(truncate((hostFsDir + JOURNAL).c_str(), (off_t)(journal.size() + keep)) == 0);
+
+    recoverConfigFiles();
+    CHECK(!LittleFS.exists(JOURNAL));
+    CHECK(effective() == (keep == recordSize ? after : before));
+
+    update("key0", "later");
+    CHECK(configFlush());
+    CHECK(effective()["key0"] == "later");
+  }
+}
+
+// A short write the sketch sees is compacted at once: nothing is left behind
+// the torn record, and the update is not lost
+static void testShortWrite() {
+  resetStore({{"base", "1"}});
+  for (int i = 0; i < 3; i++) {
+    update(key(i), value(i));
+    CHECK(configFlush());
+  }
+  Config expected = effective();
+  expected["key9"] = "new";
+
+  uint32_t compactions = configCompactions;
+  update("key9", "new");
+  hostFsTornWriteAfter = 5;
+  CHECK(configFlush());
+  CHECK_EQ(hostFsTornWriteAfter, -1);
+  CHECK_EQ(configCompactions - compactions, 1);
+  CHECK(!configPending);
+  CHECK(!LittleFS.exists(JOURNAL));
+  CHECK(effective() == expected);
+
+  update("key0", "later");
+  CHECK(configFlush());
+  expected["key0"] = "later";
+  CHECK(effective() == expected);
+}
+
+// An interrupted full rewrite: a valid /config.tmp wins over the base and
+// the journal, a torn one is dropped
+static void testInterruptedRewrite() {
+  resetStore({{"base", "1"}});
+  update("key0", "journaled");
+  CHECK(configFlush());
+
+  writeFile("/config.tmp", "{\"base\":\"2\"}");
+  recoverConfigFiles();
+  CHECK(!LittleFS.exists("/config.tmp"));
+  CHECK(effective() == (Config{{"base", "2"}}));
+
+  update("key0", "journaled");
+  CHECK(configFlush());
+  writeFile("/config.tmp", "{\"base\":\"3");
+  recoverConfigFiles();
+  CHECK(!LittleFS.exists("/config.tmp"));
+  CHECK(effective() == (Config{{"base", "2"}, {"key0", "journaled"}}));
+}
+
+int main() {
+  char dir[] = "build/test_config_store.XXXXXX";
+  if (!mkdtemp(dir)) {
+    perror(dir);
+    return 1;
+  }
+  hostFsDir = dir;
+  hostQuiet = true;
+  LittleFS.begin();
+
+  testCompaction();
+  testDebounce();
+  testPowerCut();
+  testShortWrite();
+  testInterruptedRewrite();
+
+  std::string cleanup = "rm -rf " + hostFsDir;
+  if (system(cleanup.c_str()) != 0) perror("rm");
+  return checkResult("test_config_store");
+}
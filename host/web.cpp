@@ -0,0 +1,245 @@
+// The sketch's web server without sockets: requests come from the simulator
+// (--request), answers and server-sent events are printed
+
+#include <ESPAsyncWebServer.h>
+#include "simulator.h"
+
+AsyncWebServer *AsyncWebServer::hostInstance = nullptr;
+
+// ---- Request ----
+
+AsyncWebServerRequest::~AsyncWebServerRequest() {
+  if (_onDisconnect) _onDisconnect();
+  delete _response;
+  free(_tempObject);
+}
+
+const AsyncWebParameter *AsyncWebServerRequest::getParam(const String &name, bool post, bool file) const {
+  for (const AsyncWebParameter &param : _params) {
+    if (param.name() == name && param.isPost() == post && param.isFile() == file) return &param;
+  }
+  return nullptr;
+}
+
+const AsyncWebHeader *AsyncWebServerRequest::getHeader(const String &name) const {
+  for (const AsyncWebHeader &header : _headers) {
+    if (strcasecmp(header.name().c_str(), name.c_str()) == 0) return &header;
+  }
+  return nullptr;
+}
+
+static const char *contentTypeOf(const String &path) {
+  static const char *const types[][2] = {
+    {".html", "text/html"}, {".css", "text/css"}, {".js", "application/javascript"},
+    {".json", "application/json"}, {".png", "image/png"}, {".ico", "image/x-icon"}, {".svg", "image/svg+xml"},
+  };
+  for (const auto &type : types) {
+    if (path.endsWith(type[0])) return type[1];
+  }
+  return "text/plain";
+}
+
+// The whole file is read into the response; a missing file is a 404. As in
+// the library, a compressed copy next to the path is served in its place.
+AsyncWebServerResponse *AsyncWebServerRequest::beginResponse(FS &fs, const String &path, const String &contentType,
+                                                             bool download) {
+  String type = contentType.length() ? contentType : String(contentTypeOf(path));
+  bool gzipped = !fs.exists(path) && fs.exists(path + ".gz");
+  File file = fs.open(gzipped ? path + ".gz" : path, "r");
+  if (!file) return new AsyncWebServerResponse(404, "text/plain", "Not found");
+  String content;
+  std::vector<uint8_t> data(file.size());
+  size_t n = file.read(data.data(), data.size());
+  content.concat((const char *)data.data(), n);
+  AsyncWebServerResponse *response = new AsyncWebServerResponse(200, type, content);
+  if (gzipped) response->addHeader("Content-Encoding", "gzip");
+  return response;
+}
+
+void AsyncWebServerRequest::send(AsyncWebServerResponse *response) {
+  delete _response;
+  _response = response;
+}
+
+// ---- Handlers ----
+
+static bool uriMatches(const String &uri, const String &url) {
+  return url == uri || url.startsWith(uri + "/");
+}
+
+bool AsyncCallbackWebHandler::canHandle(AsyncWebServerRequest *request) {
+  return (_method & request->method()) && uriMatches(_uri, request->url());
+}
+
+bool AsyncStaticWebHandler::canHandle(AsyncWebServerRequest *request) {
+  return request->method() == HTTP_GET && request->url().startsWith(_uri);
+}
+
+void AsyncStaticWebHandler::handleRequest(AsyncWebServerRequest *request) {
+  String path = _path + request->url().substring(_uri.length());
+  if (path.endsWith("/")) path += "index.htm";
+  request->send(LittleFS, path);
+}
+
+AsyncCallbackWebHandler &AsyncWebServer::on(const char *uri, WebRequestMethodComposite method,
+                                            ArRequestHandlerFunction onRequest, ArUploadHandlerFunction onUpload,
+                                            ArBodyHandlerFunction onBody) {
+  AsyncCallbackWebHandler *handler = new AsyncCallbackWebHandler(uri, method, onRequest, onBody);
+  _owned.emplace_back(handler);
+  _handlers.push_back(handler);
+  return *handler;
+}
+
+AsyncStaticWebHandler &AsyncWebServer::serveStatic(const char *uri, FS &fs, const char *path,
+                                                   const char *cacheControl) {
+  AsyncStaticWebHandler *handler = new AsyncStaticWebHandler(uri, path);
+  _owned.emplace_back(handler);
+  _handlers.push_back(handler);
+  return *handler;
+}
+
+bool AsyncWebServer::hostHandle(AsyncWebServerRequest &request, const uint8_t *body, size_t bodyLen) {
+  if (!_started) return false;
+  for (AsyncWebHandler *handler : _handlers) {
+    if (!handler->filter(&request) || !handler->canHandle(&request)) continue;
+    if (bodyLen) handler->handleBody(&request, (uint8_t *)body, bodyLen, 0, bodyLen);
+    handler->handleRequest(&request);
+    return true;
+  }
+  if (_notFound) {
+    _notFound(&request);
+  } else {
+    request.send(404);
+  }
+  return true;
+}
+
+AsyncEventSource *AsyncWebServer::hostEventSource(const char *url) {
+  for (AsyncWebHandler *handler : _handlers) {
+    AsyncEventSource *source = dynamic_cast<AsyncEventSource *>(handler);
+    if (source && strcmp(source->url(), url) == 0) return source;
+  }
+  return nullptr;
+}
+
+// ---- Server-sent events ----
+
+void AsyncEventSourceClient::send(const char *message, const char *event, uint32_t id, uint32_t reconnect) {
+  if (!_connected) return;
+  printf("[SSE  %10.3f] %s: %s\n", hostClockMicros / 1e6, event ? event : "message", message);
+}
+
+size_t AsyncEventSource::count() const {
+  size_t n = 0;
+  for (const auto &client : _clients) n += client->connected();
+  return n;
+}
+
+void AsyncEventSource::send(const char *message, const char *event, uint32_t id, uint32_t reconnect) {
+  for (const auto &client : _clients) client->send(message, event, id, reconnect);
+}
+
+bool AsyncEventSource::hostConnect() {
+  AsyncWebServerRequest request(HTTP_GET, _url);
+  if (!filter(&request)) return false;
+  _clients.emplace_back(new AsyncEventSourceClient());
+  if (_onConnect) _onConnect(_clients.back().get());
+  return _clients.back()->connected();
+}
+
+// ---- Simulator entry points ----
+
+static String urlDecode(const std::string &in) {
+  String out;
+  for (size_t i = 0; i < in.size(); i++) {
+    if (in[i] == '+') {
+      out += ' ';
+    } else if (in[i] == '%' && i + 2 < in.size() && isxdigit((unsigned char)in[i + 1]) &&
+               isxdigit((unsigned char)in[i + 2])) {
+      out += (char)strtol(in.substr(i + 1, 2).c_str(), nullptr, 16);
+      i += 2;
+    } else {
+      out += in[i];
+    }
+  }
+  return out;
+}
+
+static void addParams(AsyncWebServerRequest &request, const std::string &query, bool post) {
+  size_t start = 0;
+  while (start < query.size()) {
+    size_t end = query.find('&', start);
+    if (end == std::string::npos) end = query.size();
+    std::string pair = query.substr(start, end - start);
+    size_t eq = pair.find('=');
+    if (!pair.empty()) {
+      request.hostAddParam(urlDecode(pair.substr(0, eq)),
+                           eq == std::string::npos ? String() : urlDecode(pair.substr(eq + 1)), post);
+    }
+    start = end + 1;
+  }
+}
+
+bool hostWebRequest(const char *method, const char *target, const char *body) {
+  static const struct {
+    const char *name;
+    WebRequestMethod method;
+  } methods[] = {{"GET", HTTP_GET}, {"POST", HTTP_POST}, {"DELETE", HTTP_DELETE}, {"PUT", HTTP_PUT},
+                 {"PATCH", HTTP_PATCH}, {"HEAD", HTTP_HEAD}, {"OPTIONS", HTTP_OPTIONS}};
+  WebRequestMethodComposite code = 0;
+  for (const auto &m : methods) {
+    if (strcasecmp(method, m.name) == 0) code = m.method;
+  }
+  AsyncWebServer *server = AsyncWebServer::hostInstance;
+  if (!code || !server) return false;
+
+  std::string url = target;
+  std::string query;
+  size_t mark = url.find('?');
+  if (mark != std::string::npos) {
+    query = url.substr(mark + 1);
+    url.erase(mark);
+  }
+  AsyncWebServerRequest *request = new AsyncWebServerRequest(code, String(url.c_str()));
+  addParams(*request, query, false);
+
+  // JSON bodies go to the body callback, anything else is a form
+  size_t bodyLen = body ? strlen(body) : 0;
+  bool json = bodyLen && (body[0] == '{' || body[0] == '[');
+  if (bodyLen) {
+    request->hostSetContentLength(bodyLen);
+    request->hostAddHeader("Content-Type", json ? "application/json" : "application/x-www-form-urlencoded");
+    if (!json) addParams(*request, body, true);
+  }
+
+  bool handled = server->hostHandle(*request, json ? (const uint8_t *)body : nullptr, json ? bodyLen : 0);
+  const AsyncWebServerResponse *response = request->hostResponse();
+  // Printed even with --quiet: the answer is what the request was made for
+  double seconds = hostClockMicros / 1e6;
+  if (!handled) {
+    printf("[WEB  %10.3f] %s %s: server not started\n", seconds, method, target);
+  } else if (!response) {
+    printf("[WEB  %10.3f] %s %s: no response\n", seconds, method, target);
+  } else {
+    printf("[WEB  %10.3f] %s %s -> %d %s\n", seconds, method, target, response->code(),
+           response->contentType().c_str());
+    bool binary = false;
+    for (const AsyncWebHeader &header : response->headers()) {
+      printf("  %s: %s\n", header.name().c_str(), header.value().c_str());
+      binary |= header.name() == "Content-Encoding";
+    }
+    if (binary) {
+      printf("  <%u bytes>\n", response->content().length());
+    } else if (response->content().length()) {
+      printf("  %s\n", response->content().c_str());
+    }
+  }
+  delete request;
+  return handled;
+}
+
+bool hostWebEventsConnect() {
+  AsyncWebServer *server = AsyncWebServer::hostInstance;
+  AsyncEventSource *source = server ? server->hostEventSource("/api/events") : nullptr;
+  return source && source->hostConnect();
+}
@@ -0,0 +1,31 @@
+#ifndef HOST_ALLOC_COUNT_H
+#define HOST_ALLOC_COUNT_H
+
+// Replaces the global operator new/delete to count heap allocations. Include
+// it in exactly one translation unit per program.
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <new>
+
+inline uint64_t allocCount = 0;
+inline uint64_t allocBytes = 0;
+
+void *operator new(size_t size) {
+  allocCount++;
+  allocBytes += size;
+  void *p = malloc(size ? size : 1);
+  if (!p) throw std::bad_alloc();
+  return p;
+}
+void *operator new[](size_t size) { return operator new(size); }
+
+// Out of line, so the compiler does not pair the inlined free() with a
+// new-expression and warn about a mismatch
+__attribute__((noinline)) inline void allocRelease(void *p) { free(p); }
+void operator delete(void *p) noexcept { allocRelease(p); }
+void operator delete[](void *p) noexcept { allocRelease(p); }
+void operator delete(void *p, size_t) noexcept { allocRelease(p); }
+void operator delete[](void *p, size_t) noexcept { allocRelease(p); }
+
+#endif // HOST_ALLOC_COUNT_H
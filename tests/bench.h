@@ -0,0 +1,92 @@
+#ifndef HOST_BENCH_H
+#define HOST_BENCH_H
+
+// Microbenchmark harness for the host builds. Allocations are counted
+// through alloc_count.h, so include it in exactly one translation unit per
+// program.
+//
+// Each case runs until it has taken at least BENCH_MIN_NS, doubling the
+// iteration count, and reports ns/op plus heap allocations and bytes per
+// call. Results print as a table, or with --json as one JSON document:
+//   {"suite": "...", "results": [{"name": ..., "ns_per_op": ...,
+//     "allocs_per_op": ..., "bytes_per_op": ...}, ...]}
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include "alloc_count.h"
+
+#define BENCH_MIN_NS 200000000ULL  // 0.2 s per case
+#define BENCH_MAX_RESULTS 64
+
+// Keeps a result alive so the compiler cannot drop the call that made it
+template <typename T>
+inline void benchKeep(const T &value) {
+  asm volatile("" : : "g"(&value) : "memory");
+}
+
+struct BenchResult {
+  char name[64];
+  double nsPerOp;
+  double allocsPerOp;
+  double bytesPerOp;
+};
+
+class Bench {
+private:
+  const char *_suite;
+  bool _json;
+  BenchResult _results[BENCH_MAX_RESULTS];
+  int _count;
+
+public:
+  Bench(const char *suite, int argc, char **argv) : _suite(suite), _json(false), _count(0) {
+    for (int i = 1; i < argc; i++) {
+      if (strcmp(argv[i], "--json") == 0) _json = true;
+    }
+  }
+
+  template <typename Fn>
+  void run(const char *name, Fn fn) {
+    fn();  // Warm up, and let first-call allocations happen outside the count
+    uint64_t iterations = 1;
+    for (;;) {
+      uint64_t allocs = allocCount, bytes = allocBytes;
+      auto start = std::chrono::steady_clock::now();
+      for (uint64_t i = 0; i < iterations; i++) fn();
+      uint64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+      if (ns >= BENCH_MIN_NS || iterations >= (1ULL << 40)) {
+        if (_count < BENCH_MAX_RESULTS) {
+          BenchResult &result = _results[_count++];
+          snprintf(result.name, sizeof(result.name), "%s", name);
+          result.nsPerOp = (double)ns / iterations;
+          result.allocsPerOp = (double)(allocCount - allocs) / iterations;
+          result.bytesPerOp = (double)(allocBytes - bytes) / iterations;
+        }
+        return;
+      }
+      iterations *= 2;
+    }
+  }
+
+  int finish() const {
+    if (_json) {
+      printf("{\"suite\": \"%s\", \"results\": [", _suite);
+      for (int i = 0; i < _count; i++) {
+        printf("%s\n  {\"name\": \"%s\", \"ns_per_op\": %.1f, \"allocs_per_op\": %.2f, \"bytes_per_op\": %.1f}",
+               i ? "," : "", _results[i].name, _results[i].nsPerOp, _results[i].allocsPerOp, _results[i].bytesPerOp);
+      }
+      printf("\n]}\n");
+    } else {
+      printf("%-44s %12s %10s %10s\n", _suite, "ns/op", "allocs/op", "bytes/op");
+      for (int i = 0; i < _count; i++) {
+        printf("  %-42s %12.1f %10.2f %10.1f\n", _results[i].name, _results[i].nsPerOp, _results[i].allocsPerOp,
+               _results[i].bytesPerOp);
+      }
+    }
+    return 0;
+  }
+};
+
+#endif // HOST_BENCH_H
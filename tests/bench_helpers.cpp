@@ -0,0 +1,124 @@
+// The sketch's text and crypto helpers on the inputs they see on the device:
+// weather descriptions in several languages, long webhook texts, subscriber
+// counts of every size, the TOTP secret and login codes, and timezone names.
+// Each helper is measured on its own; getWeatherDescription() includes the
+// normalizeDisplayText() call it makes.
+
+#include <Arduino.h>
+#include "bench.h"
+#include "string_helpers.h"
+#include "totp.h"
+#include "tz_lookup.h"
+
+static const char *const webhookTexts[][2] = {
+  {"webhook_ascii",
+   "Deploy finished: 42 services updated, 0 failed, build 1887 took 6m12s. Next window starts at "
+   "22:00 UTC, on-call is Team B. All health checks green, latency p99 118 ms."},
+  {"webhook_latin",
+   "Backup auf dem Server ist fertig: 1.204 Dateien übertragen, 3 übersprungen. Nächster Lauf "
+   "Sonntag 02:00 - Größe 48,2 GB, Prüfsumme ok. Café ouvert jusqu'à minuit, à bientôt!"},
+  {"webhook_cyrillic", "Напоминание: встреча в 15:00, переговорная «Север». Не забудьте ноутбук."},
+};
+
+// OpenWeather / PirateWeather descriptions after normalizeDisplayText()
+static const char *const apiDescriptions[][2] = {
+  {"short", "MIST"},
+  {"two_terms", "LIGHT RAIN"},
+  {"phrase", "OVERCAST CLOUDS"},
+  {"long", "THUNDERSTORM WITH HEAVY RAIN"},
+};
+static const char *const languages[] = {"en", "de", "fr", "sr", "tr"};
+
+static const int weatherCodes[] = {0, 3, 45, 61, 75, 95};
+
+static const long subscriberCounts[] = {999, 1000, 12345, 1234567, 2000000000};
+static const bool shortFormats[] = {true, false};
+
+static const char *const zones[] = {"Africa/Abidjan", "Europe/Belgrade", "America/Argentina/Buenos_Aires",
+                                    "Pacific/Kiritimati", "Not/AZone"};
+
+int main(int argc, char **argv) {
+  Bench bench("helpers", argc, argv);
+  char name[64];
+
+  for (const auto &text : webhookTexts) {
+    String input(text[1]);
+    snprintf(name, sizeof(name), "normalizeDisplayText/%s", text[0]);
+    bench.run(name, [&]() {
+      String out = normalizeDisplayText(input);
+      benchKeep(out);
+    });
+  }
+
+  for (const char *lang : languages) {
+    const WeatherTermsMapping *terms = findWeatherTerms(lang);
+    for (const auto &desc : apiDescriptions) {
+      snprintf(name, sizeof(name), "translateAPIWeatherTerms/%s/%s", lang, desc[0]);
+      bench.run(name, [&]() {
+        String out(desc[1]);
+        translateAPIWeatherTerms(out, terms);
+        benchKeep(out);
+      });
+    }
+  }
+
+  for (const char *lang : languages) {
+    snprintf(name, sizeof(name), "getWeatherDescription/%s", lang);
+    bench.run(name, [&]() {
+      for (int code : weatherCodes) {
+        String out = getWeatherDescription(code, lang);
+        benchKeep(out);
+      }
+    });
+  }
+
+  for (long count : subscriberCounts) {
+    for (bool shortFormat : shortFormats) {
+      snprintf(name, sizeof(name), "formatSubscriberCount/%ld/%s", count, shortFormat ? "short" : "full");
+      bench.run(name, [&]() {
+        String out = formatSubscriberCount(count, shortFormat);
+        benchKeep(out);
+      });
+    }
+  }
+
+  const uint8_t secret[20] = {0x3d, 0xc6, 0xca, 0xa4, 0x82, 0x4a, 0x6d, 0x28, 0x87, 0x67,
+                              0xb2, 0x33, 0x1e, 0x20, 0xb4, 0x31, 0x66, 0xcb, 0x85, 0xd9};
+  char encoded[40];
+  bench.run("base32_encode/20_bytes", [&]() {
+    base32_encode(secret, sizeof(secret), encoded, sizeof(encoded));
+    benchKeep(encoded);
+  });
+  bench.run("base32_decode/32_chars", [&]() {
+    uint8_t decoded[20];
+    base32_decode(encoded, decoded, sizeof(decoded));
+    benchKeep(decoded);
+  });
+
+  SimpleTOTP totp(secret, sizeof(secret));
+  time_t now = 1760000000;
+  bench.run("SimpleTOTP::setSecret", [&]() {
+    SimpleTOTP fresh;
+    fresh.setSecret(secret, sizeof(secret));
+    benchKeep(fresh);
+  });
+  bench.run("SimpleTOTP::getCode", [&]() {
+    String code = totp.getCode(now);
+    benchKeep(code);
+  });
+  // Wrong code: every step of the window is computed, as for a failed login
+  bench.run("SimpleTOTP::verify/wrong_code_window_2", [&]() {
+    bool ok = totp.verify("000000", now, 2);
+    benchKeep(ok);
+  });
+
+  for (const char *zone : zones) {
+    snprintf(name, sizeof(name), "ianaToPosix/%s", zone);
+    bench.run(name, [&]() {
+      const char *posix = ianaToPosix(zone);
+      benchKeep(posix);
+    });
+  }
+
+  return bench.finish();
+}
@@ -0,0 +1,39 @@
+// normalizeDisplayText(): the old replace chain against the single-pass
+// transliterator, on text the clock actually shows.
+
+#include <Arduino.h>
+#include "bench.h"
+#include "translit_lookup.h"
+#include "legacy_normalize.h"
+
+static const char *const inputs[][2] = {
+  {"weather_en", "scattered clouds"},
+  {"weather_sr", "слаба киша са грмљавином"},
+  {"weather_ru", "небольшой снег, переменная облачность"},
+  {"webhook_latin",
+   "Backup auf dem Server ist fertig: 1.204 Dateien übertragen, 3 übersprungen. Nächster Lauf "
+   "Sonntag 02:00 - Größe 48,2 GB, Prüfsumme ok. Café ouvert jusqu'à minuit, à bientôt!"},
+  {"webhook_ascii",
+   "Deploy finished: 42 services updated, 0 failed, build 1887 took 6m12s. Next window starts at "
+   "22:00 UTC, on-call is Team B. All health checks green, latency p99 118 ms."},
+};
+
+int main(int argc, char **argv) {
+  Bench bench("translit", argc, argv);
+  char name[48];
+  for (const auto &input : inputs) {
+    String text(input[1]);
+    snprintf(name, sizeof(name), "legacy/%s", input[0]);
+    bench.run(name, [&]() {
+      String out = legacyNormalizeDisplayText(text);
+      benchKeep(out);
+    });
+    snprintf(name, sizeof(name), "single_pass/%s", input[0]);
+    bench.run(name, [&]() {
+      char out[256];
+      normalizeDisplayText(text.c_str(), out, sizeof(out));
+      benchKeep(out);
+    });
+  }
+  return bench.finish();
+}
@@ -0,0 +1,47 @@
+#ifndef HOST_CHECK_H
+#define HOST_CHECK_H
+
+// Minimal assertions for the host tests: failures are printed and counted,
+// and checkResult() turns the count into the process exit code.
+
+#include <stdio.h>
+#include <string.h>
+
+inline int checkFailures = 0;
+
+#define CHECK(cond) \
+  do { \
+    if (!(cond)) { \
+      fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+      checkFailures++; \
+    } \
+  } while (0)
+
+#define CHECK_EQ(a, b) \
+  do { \
+    long long checkA = (long long)(a), checkB = (long long)(b); \
+    if (checkA != checkB) { \
+      fprintf(stderr, "%s:%d: %s == %s failed (%lld != %lld)\n", __FILE__, __LINE__, #a, #b, checkA, checkB); \
+      checkFailures++; \
+    } \
+  } while (0)
+
+#define CHECK_STR(a, b) \
+  do { \
+    const char *checkA = (a), *checkB = (b); \
+    if (strcmp(checkA, checkB) != 0) { \
+      fprintf(stderr, "%s:%d: %s == %s failed (\"%s\" != \"%s\")\n", __FILE__, __LINE__, #a, #b, checkA, checkB); \
+      checkFailures++; \
+    } \
+  } while (0)
+
+inline int checkResult(const char *name) {
+  if (checkFailures) {
+    printf("%s: %d check(s) failed\n", name, checkFailures);
+    return 1;
+  }
+  printf("%s: ok\n", name);
+  return 0;
+}
+
+#endif // HOST_CHECK_H
@@ -0,0 +1,88 @@
+#ifndef LEGACY_WEATHER_TERMS_H
+#define LEGACY_WEATHER_TERMS_H
+
+#include <Arduino.h>
+#include "weather_lookup.h"
+
+// translateAPIWeatherTerms() as it was before the longest-match pass: one
+// String::replace() per English phrase, in this order, over the whole
+// description. Kept verbatim (only renamed) as the reference for the
+// equivalence test.
+inline void legacyTranslateAPIWeatherTerms(String& desc, const char* lang) {
+    desc.toUpperCase();
+
+    for (size_t i = 0; i < WEATHER_TERMS_COUNT; i++) {
+        if (strcmp(lang, weather_terms[i].lang) == 0) {
+            const WeatherTermsMapping& translation = weather_terms[i];
+
+            desc.replace("OVERCAST CLOUDS", translation.terms.overcast);
+            desc.replace("BROKEN CLOUDS", translation.terms.broken_clouds);
+            desc.replace("SCATTERED CLOUDS", translation.terms.scattered_clouds);
+            desc.replace("FEW CLOUDS", translation.terms.few_clouds);
+            desc.replace("CLEAR SKY", translation.terms.clear);
+            desc.replace("VOLCANIC ASH", String(translation.terms.volcanic) + " " + String(translation.terms.ash));
+            desc.replace("FREEZING RAIN", String(translation.terms.rain) + " " + String(translation.terms.freezing));
+            desc.replace("SHOWER RAIN", translation.terms.showers);
+            desc.replace("SHOWER SNOW", translation.terms.snow_showers);
+            desc.replace("SHOWER SLEET", String(translation.terms.shower) + " " + String(translation.terms.sleet));
+            desc.replace("RAIN AND SNOW", String(translation.terms.rain) + " " + String(translation.terms.snow));
+            desc.replace("SNOW SHOWERS", translation.terms.snow_showers);
+            desc.replace("HEAVY RAIN", translation.terms.heavy_rain);
+            desc.replace("MOSTLY CLEAR", translation.terms.mostly_clear);
+            desc.replace("MOSTLY CLOUDY", translation.terms.mostly_cloudy);
+            desc.replace("PARTLY CLOUDY", translation.terms.partly_cloudy);
+            desc.replace("FOGGY", translation.terms.fog);
+            desc.replace("MISTY", translation.terms.mist);
+            desc.replace("HAZY", translation.terms.haze);
+            desc.replace("RAINY", translation.terms.rain);
+            desc.replace("SNOWY", translation.terms.snow);
+            desc.replace("SMOKY", translation.terms.smoke);
+            desc.replace("WINDY", translation.terms.wind);
+            desc.replace("BREEZY", translation.terms.wind);
+            desc.replace("SQUALLS", translation.terms.squall);
+            desc.replace("SQUALL", translation.terms.squall);
+            desc.replace("TORNADO", translation.terms.tornado);
+            desc.replace("SAND", translation.terms.sand);
+            desc.replace("DUST", translation.terms.dust);
+            desc.replace("ASH", translation.terms.ash);
+            desc.replace("CLEAR", translation.terms.clear);
+            desc.replace("CLOUDY", translation.terms.cloudy);
+            desc.replace("OVERCAST", translation.terms.overcast);
+            desc.replace("FOG", translation.terms.fog);
+            desc.replace("MIST", translation.terms.mist);
+            desc.replace("HAZE", translation.terms.haze);
+            desc.replace("DRIZZLE", translation.terms.drizzle);
+            desc.replace("RAIN", translation.terms.rain);
+            desc.replace("SLEET", translation.terms.sleet);
+            desc.replace("SNOW", translation.terms.snow);
+            desc.replace("FLURRIES", translation.terms.flurries);
+            desc.replace("SHOWERS", translation.terms.showers);
+            desc.replace("SHOWER", translation.terms.shower);
+            desc.replace("THUNDERSTORM", translation.terms.thunderstorm);
+            desc.replace("HAIL", translation.terms.hail);
+            desc.replace("WIND", translation.terms.wind);
+            desc.replace("SMOKE", translation.terms.smoke);
+            desc.replace("PRECIPITATION", translation.terms.precipitation);
+            desc.replace("INTENSITY", translation.terms.intensity);
+            desc.replace("FREEZING", translation.terms.freezing);
+            desc.replace("EXTREME", translation.terms.extreme);
+            desc.replace("VERY", translation.terms.very);
+            desc.replace("LIGHT", translation.terms.light);
+            desc.replace("MODERATE", translation.terms.moderate);
+            desc.replace("HEAVY", translation.terms.heavy);
+            desc.replace("CLOUDS", "");
+            desc.replace("SKY", "");
+            desc.replace("WITH", "");
+            desc.replace("AND", "");
+
+            while (desc.indexOf("  ") >= 0) {
+                desc.replace("  ", " ");
+            }
+            desc.trim();
+
+            break;
+        }
+    }
+}
+
+#endif // LEGACY_WEATHER_TERMS_H
@@ -0,0 +1,310 @@
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+// Just enough of the Arduino core to compile the sketch's pure headers on a
+// desktop compiler: PROGMEM access, a few libc extras and a String that
+// allocates like the cores' own (11-char inline buffer, then a heap buffer
+// of the exact size on growth), so allocation counts are comparable.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+#include <ctype.h>
+#include <math.h>
+
+#define PROGMEM
+#define PGM_P const char *
+#define PSTR(s) (s)
+#define F(s) (s)
+#define pgm_read_byte(addr) (*(const uint8_t *)(addr))
+#define pgm_read_word(addr) (*(const uint16_t *)(addr))
+#define pgm_read_dword(addr) (*(const uint32_t *)(addr))
+#define pgm_read_ptr(addr) (*(void *const *)(addr))
+#define memcpy_P memcpy
+#define strcmp_P strcmp
+#define strlen_P strlen
+#define strncpy_P strncpy
+
+#ifndef __APPLE__
+inline size_t strlcpy(char *dst, const char *src, size_t size) {
+  size_t len = strlen(src);
+  if (size) {
+    size_t n = len < size - 1 ? len : size - 1;
+    memcpy(dst, src, n);
+    dst[n] = '\0';
+  }
+  return len;
+}
+#endif
+
+// Simulated clock: nothing advances it except delay() and the caller
+inline uint64_t hostClockMicros = 0;
+inline unsigned long millis() { return (unsigned long)(hostClockMicros / 1000); }
+inline unsigned long micros() { return (unsigned long)hostClockMicros; }
+inline void delay(unsigned long ms) { hostClockMicros += (uint64_t)ms * 1000; }
+inline void yield() {}
+
+class String {
+private:
+  static const size_t SSO_CAPACITY = 11;  // As on ESP8266; ESP32 keeps a little more inline
+  char *_buffer;                          // Heap buffer, or nullptr while the text fits _sso
+  char _sso[SSO_CAPACITY + 1];
+  size_t _capacity;
+  size_t _len;
+
+  char *data() { return _buffer ? _buffer : _sso; }
+
+  bool grow(size_t size) {
+    if (size <= _capacity) return true;
+    char *buffer = new char[size + 1];
+    memcpy(buffer, data(), _len + 1);
+    delete[] _buffer;
+    _buffer = buffer;
+    _capacity = size;
+    return true;
+  }
+
+  void assign(const char *s, size_t len) {
+    grow(len);
+    memmove(data(), s, len);
+    data()[len] = '\0';
+    _len = len;
+  }
+
+  void take(String &other) {
+    _buffer = other._buffer;
+    memcpy(_sso, other._sso, sizeof(_sso));
+    _capacity = other._capacity;
+    _len = other._len;
+    other._buffer = nullptr;
+    other._sso[0] = '\0';
+    other._capacity = SSO_CAPACITY;
+    other._len = 0;
+  }
+
+public:
+  String(const char *s = "") : _buffer(nullptr), _capacity(SSO_CAPACITY), _len(0) {
+    _sso[0] = '\0';
+    if (s) assign(s, strlen(s));
+  }
+  String(const String &other) : String() { assign(other.c_str(), other._len); }
+  String(String &&other) : String() { take(other); }
+  explicit String(char c) : String() { assign(&c, 1); }
+  explicit String(int value, unsigned char base = 10) : String((long)value, base) {}
+  explicit String(unsigned int value, unsigned char base = 10) : String((unsigned long)value, base) {}
+  explicit String(long value, unsigned char base = 10) : String() {
+    char buf[34];
+    if (base == 10) snprintf(buf, sizeof(buf), "%ld", value);
+    else snprintf(buf, sizeof(buf), base == 16 ? "%lx" : "%lo", value);
+    assign(buf, strlen(buf));
+  }
+  explicit String(unsigned long value, unsigned char base = 10) : String() {
+    char buf[34];
+    snprintf(buf, sizeof(buf), base == 16 ? "%lx" : (base == 8 ? "%lo" : "%lu"), value);
+    assign(buf, strlen(buf));
+  }
+  explicit String(float value, unsigned char decimals = 2) : String((double)value, decimals) {}
+  explicit String(double value, unsigned char decimals = 2) : String() {
+    char buf[40];
+    snprintf(buf, sizeof(buf), "%.*f", decimals, value);
+    assign(buf, strlen(buf));
+  }
+  ~String() { delete[] _buffer; }
+
+  String &operator=(const String &other) {
+    if (this != &other) assign(other.c_str(), other._len);
+    return *this;
+  }
+  String &operator=(String &&other) {
+    if (this != &other) {
+      delete[] _buffer;
+      take(other);
+    }
+    return *this;
+  }
+  String &operator=(const char *s) {
+    if (!s) s = "";
+    assign(s, strlen(s));
+    return *this;
+  }
+
+  const char *c_str() const { return _buffer ? _buffer : _sso; }
+  unsigned int length() const { return (unsigned int)_len; }
+  bool isEmpty() const { return _len == 0; }
+  bool reserve(unsigned int size) { return grow(size); }
+
+  bool concat(const char *s, size_t len) {
+    if (!s || len == 0) return true;
+    if (s >= c_str() && s < c_str() + _len) {  // Appending a part of itself
+      String copy(*this);
+      return concat(copy.c_str() + (s - c_str()), len);
+    }
+    grow(_len + len);
+    memcpy(data() + _len, s, len);
+    _len += len;
+    data()[_len] = '\0';
+    return true;
+  }
+  bool concat(const char *s) { return s ? concat(s, strlen(s)) : true; }
+  bool concat(const String &s) { return concat(s.c_str(), s._len); }
+  bool concat(char c) { return concat(&c, 1); }
+  bool concat(int value) { return concat(String(value)); }
+  bool concat(unsigned int value) { return concat(String(value)); }
+  bool concat(long value) { return concat(String(value)); }
+  bool concat(unsigned long value) { return concat(String(value)); }
+  bool concat(double value) { return concat(String(value)); }
+
+  template <typename T>
+  String &operator+=(const T &value) {
+    concat(value);
+    return *this;
+  }
+
+  char charAt(unsigned int i) const { return i < _len ? c_str()[i] : '\0'; }
+  char operator[](unsigned int i) const { return charAt(i); }
+  char &operator[](unsigned int i) { return data()[i]; }
+  void setCharAt(unsigned int i, char c) {
+    if (i < _len) data()[i] = c;
+  }
+
+  bool equals(const char *s) const { return strcmp(c_str(), s ? s : "") == 0; }
+  bool operator==(const String &s) const { return _len == s._len && equals(s.c_str()); }
+  bool operator==(const char *s) const { return equals(s); }
+  bool operator!=(const String &s) const { return !(*this == s); }
+  bool operator!=(const char *s) const { return !equals(s); }
+  bool equalsIgnoreCase(const String &s) const { return strcasecmp(c_str(), s.c_str()) == 0; }
+  bool startsWith(const String &s) const { return strncmp(c_str(), s.c_str(), s._len) == 0; }
+  bool endsWith(const String &s) const {
+    return s._len <= _len && strcmp(c_str() + _len - s._len, s.c_str()) == 0;
+  }
+
+  int indexOf(char c, unsigned int from = 0) const {
+    if (from >= _len) return -1;
+    const char *p = strchr(c_str() + from, c);
+    return p ? (int)(p - c_str()) : -1;
+  }
+  int indexOf(const String &s, unsigned int from = 0) const {
+    if (from > _len) return -1;
+    const char *p = strstr(c_str() + from, s.c_str());
+    return p ? (int)(p - c_str()) : -1;
+  }
+  int lastIndexOf(char c) const {
+    const char *p = strrchr(c_str(), c);
+    return p ? (int)(p - c_str()) : -1;
+  }
+
+  String substring(unsigned int from, unsigned int to) const {
+    if (from > to) {
+      unsigned int t = from;
+      from = to;
+      to = t;
+    }
+    if (from > _len) from = (unsigned int)_len;
+    if (to > _len) to = (unsigned int)_len;
+    String out;
+    out.concat(c_str() + from, to - from);
+    return out;
+  }
+  String substring(unsigned int from) const { return substring(from, (unsigned int)_len); }
+  void toCharArray(char *buf, unsigned int size, unsigned int index = 0) const {
+    if (!size) return;
+    size_t n = index < _len ? _len - index : 0;
+    if (n > size - 1) n = size - 1;
+    memcpy(buf, c_str() + index, n);
+    buf[n] = '\0';
+  }
+
+  // Replaces every occurrence, growing the buffer once if needed
+  void replace(const String &find, const String &with) {
+    if (_len == 0 || find._len == 0) return;
+    size_t count = 0;
+    for (const char *p = strstr(data(), find.c_str()); p; p = strstr(p + find._len, find.c_str())) count++;
+    if (count == 0) return;
+    size_t newLen = _len + count * with._len - count * find._len;
+    if (with._len <= find._len) {
+      char *out = data();
+      const char *in = data();
+      for (const char *p = strstr(in, find.c_str()); p; p = strstr(in, find.c_str())) {
+        size_t n = p - in;
+        memmove(out, in, n);
+        out += n;
+        memcpy(out, with.c_str(), with._len);
+        out += with._len;
+        in = p + find._len;
+      }
+      memmove(out, in, strlen(in) + 1);
+    } else {
+      size_t capacity = newLen > _capacity ? newLen : _capacity;
+      char *buffer = new char[capacity + 1];
+      char *out = buffer;
+      const char *in = data();
+      for (const char *p = strstr(in, find.c_str()); p; p = strstr(in, find.c_str())) {
+        size_t n = p - in;
+        memcpy(out, in, n);
+        out += n;
+        memcpy(out, with.c_str(), with._len);
+        out += with._len;
+        in = p + find._len;
+      }
+      memcpy(out, in, strlen(in) + 1);
+      delete[] _buffer;
+      _buffer = buffer;
+      _capacity = capacity;
+    }
+    _len = newLen;
+  }
+  void remove(unsigned int index, unsigned int count = (unsigned int)-1) {
+    if (index >= _len) return;
+    if (count > _len - index) count = (unsigned int)(_len - index);
+    memmove(data() + index, data() + index + count, _len - index - count + 1);
+    _len -= count;
+  }
+  void replace(char find, char with) {
+    for (size_t i = 0; i < _len; i++) {
+      if (data()[i] == find) data()[i] = with;
+    }
+  }
+
+  void toUpperCase() {
+    for (size_t i = 0; i < _len; i++) data()[i] = (char)toupper((unsigned char)data()[i]);
+  }
+  void toLowerCase() {
+    for (size_t i = 0; i < _len; i++) data()[i] = (char)tolower((unsigned char)data()[i]);
+  }
+  void trim() {
+    size_t start = 0, end = _len;
+    while (start < end && isspace((unsigned char)data()[start])) start++;
+    while (end > start && isspace((unsigned char)data()[end - 1])) end--;
+    memmove(data(), data() + start, end - start);
+    _len = end - start;
+    data()[_len] = '\0';
+  }
+  long toInt() const { return atol(c_str()); }
+  float toFloat() const { return (float)atof(c_str()); }
+};
+
+inline String operator+(const String &a, const String &b) {
+  String out(a);
+  out.concat(b);
+  return out;
+}
+inline String operator+(const String &a, const char *b) {
+  String out(a);
+  out.concat(b);
+  return out;
+}
+inline String operator+(const char *a, const String &b) {
+  String out(a);
+  out.concat(b);
+  return out;
+}
+inline String operator+(const String &a, char b) {
+  String out(a);
+  out.concat(b);
+  return out;
+}
+
+#endif // HOST_ARDUINO_H
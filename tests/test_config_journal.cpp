@@ -0,0 +1,142 @@
+// Fault injection for the /config.jnl record format in config_journal.h:
+// appends torn at every byte offset and corrupted bits. The sketch's store
+// on top of it (configFlush, compaction, recoverConfigFiles) is tested
+// against the real functions in host/test_config_store.cpp.
+//
+// Payloads here are "key=value" strings; the sketch uses JSON, which the
+// record format does not care about.
+
+#include <Arduino.h>
+#include <string>
+#include <vector>
+#include "config_journal.h"
+#include "check.h"
+
+typedef std::vector<uint8_t> Bytes;
+
+static Bytes record(const std::string &payload) {
+  Bytes out(CONFIG_JOURNAL_HEADER_SIZE + payload.size());
+  memcpy(out.data() + CONFIG_JOURNAL_HEADER_SIZE, payload.data(), payload.size());
+  configJournalHeader(out.data(), out.data() + CONFIG_JOURNAL_HEADER_SIZE, (uint16_t)payload.size());
+  return out;
+}
+
+static void append(Bytes &journal, const Bytes &bytes) {
+  journal.insert(journal.end(), bytes.begin(), bytes.end());
+}
+
+static void collect(const char *payload, size_t len, void *ctx) {
+  ((std::vector<std::string> *)ctx)->push_back(std::string(payload, len));
+}
+
+static std::vector<std::string> scan(const Bytes &journal, size_t *valid = nullptr) {
+  std::vector<std::string> records;
+  size_t n = configJournalScan(journal.data(), journal.size(), collect, &records);
+  if (valid) *valid = n;
+  return records;
+}
+
+static std::string patch(int i) {
+  std::string value(1 + (i * 37) % 90, (char)('a' + i % 26));
+  return "key" + std::to_string(i % 5) + "=" + value;
+}
+
+static void testCrc() {
+  CHECK_EQ(configJournalCrc32((const uint8_t *)"123456789", 9), 0xCBF43926UL);
+  CHECK_EQ(configJournalCrc32(nullptr, 0), 0);
+}
+
+static void testRoundTrip() {
+  Bytes journal;
+  std::vector<std::string> written;
+  for (size_t len : {1, 2, 7, 8, 9, 255, 256, 257, 1000, CONFIG_JOURNAL_MAX_PAYLOAD}) {
+    std::string payload(len, 'x');
+    for (size_t i = 0; i < len; i++) payload[i] = (char)(' ' + (i * 7 + len) % 90);
+    append(journal, record(payload));
+    written.push_back(payload);
+  }
+  size_t valid;
+  CHECK(scan(journal, &valid) == written);
+  CHECK_EQ(valid, journal.size());
+
+  // Longer than a record may be: rejected even with a matching CRC
+  Bytes big = record(std::string(CONFIG_JOURNAL_MAX_PAYLOAD + 1, 'y'));
+  CHECK(scan(big).empty());
+  CHECK(scan(Bytes()).empty());
+}
+
+// A journal cut anywhere, then padded with what unwritten or reused flash
+// may hold, yields exactly the records that were complete before the cut
+static void testTornWrites() {
+  Bytes journal;
+  std::vector<size_t> ends;
+  for (int i = 0; i < 6; i++) {
+    append(journal, record(patch(i)));
+    ends.push_back(journal.size());
+  }
+
+  const int fills[] = {-1, 0x00, 0xFF, CONFIG_JOURNAL_MAGIC};
+  for (size_t cut = 0; cut <= journal.size(); cut++) {
+    size_t complete = 0;
+    while (complete < ends.size() && ends[complete] <= cut) complete++;
+    size_t expectedValid = complete ? ends[complete - 1] : 0;
+
+    for (int fill : fills) {
+      Bytes torn(journal.begin(), journal.begin() + cut);
+      if (fill >= 0) torn.resize(journal.size() + CONFIG_JOURNAL_HEADER_SIZE, (uint8_t)fill);
+      size_t valid;
+      std::vector<std::string> records = scan(torn, &valid);
+      CHECK_EQ(records.size(), complete);
+      CHECK_EQ(valid, expectedValid);
+      for (size_t i = 0; i < records.size() && i < complete; i++) CHECK(records[i] == patch((int)i));
+    }
+  }
+
+  // A header whose magic bytes made it but whose length and CRC did not
+  Bytes header = {CONFIG_JOURNAL_MAGIC, (uint8_t)~CONFIG_JOURNAL_MAGIC, 0, 0, 0, 0, 0, 0, 'x'};
+  CHECK(scan(header).empty());
+}
+
+// Any single flipped bit stops the scan at the damaged record
+static void testBadCrc() {
+  Bytes journal;
+  std::vector<size_t> starts;
+  for (int i = 0; i < 3; i++) {
+    starts.push_back(journal.size());
+    append(journal, record(patch(i)));
+  }
+  for (size_t byte = 0; byte < journal.size(); byte++) {
+    size_t damaged = 0;
+    while (damaged + 1 < starts.size() && starts[damaged + 1] <= byte) damaged++;
+    for (int bit = 0; bit < 8; bit++) {
+      Bytes corrupt = journal;
+      corrupt[byte] ^= (uint8_t)(1 << bit);
+      size_t valid;
+      std::vector<std::string> records = scan(corrupt, &valid);
+      CHECK_EQ(records.size(), damaged);
+      CHECK_EQ(valid, starts[damaged]);
+    }
+  }
+}
+
+// Why the sketch compacts after a short write: a torn record hides every
+// record appended after it
+static void testTornHidesLater() {
+  Bytes journal = record(patch(0));
+  Bytes torn = record(patch(1));
+  torn.resize(torn.size() / 2);
+  append(journal, torn);
+  append(journal, record(patch(2)));
+  std::vector<std::string> records = scan(journal);
+  CHECK_EQ(records.size(), 1);
+  CHECK(records[0] == patch(0));
+}
+
+int main() {
+  testCrc();
+  testRoundTrip();
+  testTornWrites();
+  testBadCrc();
+  testTornHidesLater();
+  return checkResult("test_config_journal");
+}
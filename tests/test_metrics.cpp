@@ -0,0 +1,121 @@
+// LatencyHistogram from metrics.h: bucket placement at the bounds,
+// cumulative() counts, and percentile() on known distributions, covering
+// interpolation inside a bucket, the overflow bucket and the cap at the
+// largest value seen.
+
+#include <Arduino.h>
+#include "metrics.h"
+#include "check.h"
+
+static const uint32_t bounds[] = {10, 20, 50, 100};
+#define BUCKETS (sizeof(bounds) / sizeof(bounds[0]))
+
+static void testEmpty() {
+  LatencyHistogram h(bounds, BUCKETS);
+  CHECK_EQ(h.buckets(), BUCKETS);
+  CHECK_EQ(h.count(), 0);
+  CHECK_EQ(h.cumulative(BUCKETS), 0);
+  CHECK_EQ(h.percentile(50), 0);
+  CHECK_EQ(h.percentile(100), 0);
+}
+
+// Bounds are inclusive: a value equal to a bound is counted under it
+static void testBuckets() {
+  LatencyHistogram h(bounds, BUCKETS);
+  const uint32_t values[] = {0, 10, 11, 20, 21, 50, 100, 101, 5000};
+  for (uint32_t v : values) h.record(v);
+  CHECK_EQ(h.cumulative(0), 2);
+  CHECK_EQ(h.cumulative(1), 4);
+  CHECK_EQ(h.cumulative(2), 6);
+  CHECK_EQ(h.cumulative(3), 7);
+  CHECK_EQ(h.cumulative(BUCKETS), 9);  // With the overflow bucket
+  CHECK_EQ(h.cumulative(200), 9);
+  CHECK_EQ(h.count(), 9);
+  CHECK_EQ(h.sum(), 0 + 10 + 11 + 20 + 21 + 50 + 100 + 101 + 5000);
+  CHECK_EQ(h.max(), 5000);
+
+  h.reset();
+  CHECK_EQ(h.count(), 0);
+  CHECK_EQ(h.sum(), 0);
+  CHECK_EQ(h.max(), 0);
+  CHECK_EQ(h.cumulative(BUCKETS), 0);
+}
+
+// 1..100 once each fills every bucket evenly, so interpolation gives the
+// exact percentile wherever the rank falls
+static void testUniform() {
+  LatencyHistogram h(bounds, BUCKETS);
+  for (uint32_t v = 1; v <= 100; v++) h.record(v);
+  CHECK_EQ(h.cumulative(0), 10);
+  CHECK_EQ(h.cumulative(1), 20);
+  CHECK_EQ(h.cumulative(2), 50);
+  CHECK_EQ(h.cumulative(3), 100);
+  CHECK_EQ(h.cumulative(BUCKETS), 100);
+  const uint8_t pcts[] = {1, 5, 10, 15, 25, 50, 51, 75, 90, 99, 100};
+  for (uint8_t p : pcts) CHECK_EQ(h.percentile(p), p);
+}
+
+// Values all in one bucket interpolate up to the largest seen, not to the
+// bucket's bound
+static void testCappedAtMax() {
+  LatencyHistogram h(bounds, BUCKETS);
+  for (int i = 0; i < 10; i++) h.record(15);
+  CHECK_EQ(h.percentile(1), 10);   // Rank 1 of 10 between 10 and 15
+  CHECK_EQ(h.percentile(50), 12);
+  CHECK_EQ(h.percentile(100), 15);
+
+  LatencyHistogram single(bounds, BUCKETS);
+  single.record(60);
+  CHECK_EQ(single.percentile(1), 60);
+  CHECK_EQ(single.percentile(99), 60);
+
+  // Nothing above zero leaves no width to interpolate in
+  LatencyHistogram low(bounds, BUCKETS);
+  low.record(0);
+  low.record(0);
+  CHECK_EQ(low.percentile(50), 0);
+  CHECK_EQ(low.percentile(100), 0);
+}
+
+// The overflow bucket runs from the last bound to the largest value seen
+static void testOverflow() {
+  LatencyHistogram h(bounds, BUCKETS);
+  for (int i = 0; i < 90; i++) h.record(5);
+  for (uint32_t v = 200; v <= 1100; v += 100) h.record(v);
+  CHECK_EQ(h.cumulative(3), 90);
+  CHECK_EQ(h.cumulative(BUCKETS), 100);
+  CHECK_EQ(h.percentile(90), 10);   // The top of the first bucket
+  CHECK_EQ(h.percentile(91), 200);  // Rank 1 of 10 between 100 and 1100
+  CHECK_EQ(h.percentile(95), 600);
+  CHECK_EQ(h.percentile(99), 1000);
+  CHECK_EQ(h.percentile(100), 1100);
+
+  LatencyHistogram all(bounds, BUCKETS);
+  for (int i = 0; i < 3; i++) all.record(500);
+  CHECK_EQ(all.cumulative(3), 0);
+  CHECK_EQ(all.percentile(50), 366);  // Rank 2 of 3 between 100 and 500
+  CHECK_EQ(all.percentile(100), 500);
+}
+
+// More bounds than METRICS_MAX_BUCKETS: the rest count as overflow
+static void testTooManyBounds() {
+  uint32_t many[METRICS_MAX_BUCKETS + 4];
+  for (size_t i = 0; i < sizeof(many) / sizeof(many[0]); i++) many[i] = 10 * (i + 1);
+  LatencyHistogram h(many, sizeof(many) / sizeof(many[0]));
+  CHECK_EQ(h.buckets(), METRICS_MAX_BUCKETS);
+  h.record(many[METRICS_MAX_BUCKETS - 1]);
+  h.record(many[METRICS_MAX_BUCKETS]);
+  CHECK_EQ(h.cumulative(METRICS_MAX_BUCKETS - 1), 1);
+  CHECK_EQ(h.cumulative(METRICS_MAX_BUCKETS), 2);
+  CHECK_EQ(h.percentile(100), many[METRICS_MAX_BUCKETS]);
+}
+
+int main() {
+  testEmpty();
+  testBuckets();
+  testUniform();
+  testCappedAtMax();
+  testOverflow();
+  testTooManyBounds();
+  return checkResult("test_metrics");
+}
@@ -0,0 +1,174 @@
+// GlucoseHistory from nightscout_history.h: in-order insertion, the ring
+// wrapping past GLUCOSE_HISTORY_SIZE, delta() across sensor gaps, and the
+// row scaling of sparkline() (bit 0 is the top row).
+
+#include <Arduino.h>
+#include "nightscout_history.h"
+#include "check.h"
+
+#define READING_SEC 300
+#define MAX_GAP_SEC (2 * READING_SEC + 60)  // What the sketch passes to delta()
+
+static GlucoseReading reading(uint32_t time, int16_t mgdl) {
+  GlucoseReading r = {time, mgdl, GLUCOSE_DIR_FLAT};
+  return r;
+}
+
+static void testOrder() {
+  GlucoseHistory history;
+  CHECK_EQ(history.count(), 0);
+  CHECK(history.add(reading(1000, 110)));
+  CHECK(history.add(reading(1300, 115)));
+
+  // A poll returning what is already held, or older, adds nothing
+  CHECK(!history.add(reading(1300, 120)));
+  CHECK(!history.add(reading(1000, 110)));
+  CHECK(!history.add(reading(700, 105)));
+  // Nor does a reading without a value
+  CHECK(!history.add(reading(1600, 0)));
+  CHECK(!history.add(reading(1600, -5)));
+  CHECK_EQ(history.count(), 2);
+  CHECK_EQ(history.latest().time, 1300);
+  CHECK_EQ(history.latest().mgdl, 115);
+
+  CHECK(history.add(reading(1301, 118)));
+  CHECK_EQ(history.count(), 3);
+  CHECK_EQ(history.at(0).time, 1000);
+  CHECK_EQ(history.latest().mgdl, 118);
+
+  history.clear();
+  CHECK_EQ(history.count(), 0);
+  CHECK(history.add(reading(100, 90)));  // Older than before the clear
+  CHECK_EQ(history.latest().time, 100);
+}
+
+static void testWrap() {
+  GlucoseHistory history;
+  const int total = 3 * GLUCOSE_HISTORY_SIZE + 5;
+  for (int i = 0; i < total; i++) {
+    CHECK(history.add(reading(1000 + i * READING_SEC, 50 + i)));
+    int held = i + 1 < GLUCOSE_HISTORY_SIZE ? i + 1 : GLUCOSE_HISTORY_SIZE;
+    CHECK_EQ(history.count(), held);
+    // Oldest first, consecutive, ending with the one just added
+    for (int j = 0; j < held; j++) CHECK_EQ(history.at(j).mgdl, 50 + i - held + 1 + j);
+    CHECK_EQ(history.latest().mgdl, 50 + i);
+  }
+  // Ordering still holds against the newest reading after wrapping
+  CHECK(!history.add(reading(1000 + (total - 1) * READING_SEC, 10)));
+  CHECK_EQ(history.latest().mgdl, 50 + total - 1);
+}
+
+static void testDelta() {
+  GlucoseHistory history;
+  int change = 12345;
+  CHECK(!history.delta(change, MAX_GAP_SEC));
+  history.add(reading(1000, 120));
+  CHECK(!history.delta(change, MAX_GAP_SEC));
+  CHECK_EQ(change, 12345);
+
+  history.add(reading(1000 + READING_SEC, 126));
+  CHECK(history.delta(change, MAX_GAP_SEC));
+  CHECK_EQ(change, 6);
+  history.add(reading(1000 + 2 * READING_SEC, 111));
+  CHECK(history.delta(change, MAX_GAP_SEC));
+  CHECK_EQ(change, -15);
+
+  // One missed reading is still close enough, exactly at the limit too
+  history.add(reading(1000 + 2 * READING_SEC + MAX_GAP_SEC, 101));
+  CHECK(history.delta(change, MAX_GAP_SEC));
+  CHECK_EQ(change, -10);
+
+  // Past the gap there is no delta, until the next reading after it
+  uint32_t resumed = 1000 + 2 * READING_SEC + 2 * MAX_GAP_SEC + 1;
+  history.add(reading(resumed, 140));
+  change = 12345;
+  CHECK(!history.delta(change, MAX_GAP_SEC));
+  CHECK_EQ(change, 12345);
+  history.add(reading(resumed + READING_SEC, 143));
+  CHECK(history.delta(change, MAX_GAP_SEC));
+  CHECK_EQ(change, 3);
+}
+
+static void addValues(GlucoseHistory &history, const int16_t *values, int n) {
+  history.clear();
+  for (int i = 0; i < n; i++) CHECK(history.add(reading(1000 + i * READING_SEC, values[i])));
+}
+
+static void testSparkline() {
+  GlucoseHistory history;
+  uint8_t columns[8];
+  memset(columns, 0xAA, sizeof(columns));
+  history.sparkline(columns, sizeof(columns));
+  for (uint8_t c : columns) CHECK_EQ(c, 0);
+
+  // Lowest at the bottom row, highest at the top, right-aligned; the rise
+  // is filled in below the new point
+  const int16_t rise[] = {100, 170};
+  addValues(history, rise, 2);
+  history.sparkline(columns, 4);
+  CHECK_EQ(columns[0], 0);
+  CHECK_EQ(columns[1], 0);
+  CHECK_EQ(columns[2], 0x80);
+  CHECK_EQ(columns[3], 0x7F);
+
+  // A fall is filled in above the new point
+  const int16_t fall[] = {170, 100};
+  addValues(history, fall, 2);
+  history.sparkline(columns, 2);
+  CHECK_EQ(columns[0], 0x01);
+  CHECK_EQ(columns[1], 0xFE);
+
+  // Rows in between round to the nearest of the eight
+  const int16_t ramp[] = {100, 110, 120, 130, 140, 150, 160, 170};
+  addValues(history, ramp, 8);
+  history.sparkline(columns, 8);
+  for (int i = 0; i < 8; i++) CHECK_EQ(columns[i], 1 << (7 - i));
+
+  // Flat data sits in the middle of GLUCOSE_SPARKLINE_MIN_SPAN rather than
+  // being stretched to full height
+  const int16_t flat[] = {120, 120, 120};
+  addValues(history, flat, 3);
+  history.sparkline(columns, 3);
+  for (int i = 0; i < 3; i++) CHECK_EQ(columns[i], 0x08);
+  const int16_t small[] = {100, 120};  // Shown between 90 and 130
+  addValues(history, small, 2);
+  history.sparkline(columns, 2);
+  CHECK_EQ(columns[0], 0x20);
+  CHECK_EQ(columns[1], 0x1C);
+
+  // With more readings than columns only the newest are shown, and only
+  // they set the scale
+  const int16_t spike[] = {400, 40, 100, 170};
+  addValues(history, spike, 4);
+  history.sparkline(columns, 2);
+  CHECK_EQ(columns[0], 0x80);
+  CHECK_EQ(columns[1], 0x7F);
+
+  // A full, wrapped ring draws its newest readings
+  history.clear();
+  for (int i = 0; i < GLUCOSE_HISTORY_SIZE + 10; i++) {
+    history.add(reading(1000 + i * READING_SEC, i < GLUCOSE_HISTORY_SIZE + 2 ? 120 : 100 + (i % 2) * 70));
+  }
+  history.sparkline(columns, 4);
+  CHECK_EQ(columns[0], 0x80);
+  CHECK_EQ(columns[1], 0x7F);
+  CHECK_EQ(columns[2], 0xFE);
+  CHECK_EQ(columns[3], 0x7F);
+}
+
+static void testDirections() {
+  CHECK_EQ(glucoseDirectionFromName("Flat"), GLUCOSE_DIR_FLAT);
+  CHECK_EQ(glucoseDirectionFromName("DoubleDown"), GLUCOSE_DIR_DOUBLE_DOWN);
+  CHECK_EQ(glucoseDirectionFromName("NOT COMPUTABLE"), GLUCOSE_DIR_NONE);
+  CHECK_EQ(glucoseDirectionFromName("NONE"), GLUCOSE_DIR_NONE);
+  CHECK_EQ(glucoseDirectionFromName(nullptr), GLUCOSE_DIR_NONE);
+}
+
+int main() {
+  testOrder();
+  testWrap();
+  testDelta();
+  testSparkline();
+  testDirections();
+  return checkResult("test_nightscout_history");
+}
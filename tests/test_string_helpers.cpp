@@ -0,0 +1,75 @@
+// string_helpers.h: base32 against the RFC 4648 vectors, subscriber count
+// formatting and the weather code descriptions.
+
+#include <Arduino.h>
+#include "string_helpers.h"
+#include "check.h"
+
+static void testBase32() {
+  // RFC 4648 section 10, without the padding the sketch leaves off
+  const char *vectors[][2] = {
+    {"", ""}, {"f", "MY"}, {"fo", "MZXQ"}, {"foo", "MZXW6"},
+    {"foob", "MZXW6YQ"}, {"fooba", "MZXW6YTB"}, {"foobar", "MZXW6YTBOI"},
+  };
+  for (const auto &v : vectors) {
+    char encoded[16];
+    base32_encode((const uint8_t *)v[0], (int)strlen(v[0]), encoded, sizeof(encoded));
+    CHECK_STR(encoded, v[1]);
+
+    uint8_t decoded[8] = {};
+    base32_decode(v[1], decoded, sizeof(decoded));
+    CHECK(memcmp(decoded, v[0], strlen(v[0])) == 0);
+  }
+
+  // Padding, whitespace and lower case are accepted on input
+  uint8_t decoded[8] = {};
+  base32_decode("mzxw 6ytb\noi======", decoded, sizeof(decoded));
+  CHECK(memcmp(decoded, "foobar", 6) == 0);
+
+  // Output is cut to the buffer, still terminated
+  char small[5];
+  base32_encode((const uint8_t *)"foobar", 6, small, sizeof(small));
+  CHECK_STR(small, "MZXW");
+
+  // A 20-byte TOTP secret round trip
+  uint8_t secret[20];
+  for (int i = 0; i < 20; i++) secret[i] = (uint8_t)(i * 37 + 11);
+  char encoded[40];
+  base32_encode(secret, sizeof(secret), encoded, sizeof(encoded));
+  CHECK_EQ(strlen(encoded), 32);
+  uint8_t back[20];
+  base32_decode(encoded, back, sizeof(back));
+  CHECK(memcmp(secret, back, sizeof(secret)) == 0);
+}
+
+static void testSubscriberCount() {
+  struct { long count; const char *shortText; } cases[] = {
+    {0, "0"}, {999, "999"}, {1000, "1K"}, {12000, "12K"}, {12300, "12.3K"}, {12345, "12.345K"},
+    {999999, "999.999K"}, {1234567, "1.235M"}, {2000000000, "2.000B"},
+  };
+  for (const auto &c : cases) {
+    String shortText = formatSubscriberCount(c.count, true);
+    CHECK_STR(shortText.c_str(), c.shortText);
+    String fullText = formatSubscriberCount(c.count, false);
+    CHECK_EQ(fullText.toInt(), c.count);
+  }
+}
+
+static void testWeatherDescription() {
+  String clear = getWeatherDescription(0, "en");
+  CHECK_STR(clear.c_str(), "CLEAR");
+  String german = getWeatherDescription(95, "de");
+  String fallback = getWeatherDescription(95, "xx");
+  String english = getWeatherDescription(95, "en");
+  CHECK(german != english);
+  CHECK(fallback == english);
+  String unknown = getWeatherDescription(12345, "en");
+  CHECK_STR(unknown.c_str(), "UNKNOWN");
+}
+
+int main() {
+  testBase32();
+  testSubscriberCount();
+  testWeatherDescription();
+  return checkResult("test_string_helpers");
+}
@@ -0,0 +1,255 @@
+// timekeeper.h: NTP timestamp encoding, the four-timestamp offset and delay
+// math, the checks that tie a reply to its request, and ClockDiscipline's
+// drift estimate (clamp, step limit, minimum span) and slew corrections,
+// which must carry the sub-step remainder for either sign of drift.
+
+#include <Arduino.h>
+#include <initializer_list>
+#include "timekeeper.h"
+#include "check.h"
+
+#define T0 1767225600000000ULL  // 2026-01-01 00:00:00 UTC in microseconds
+
+static int64_t absDiff(uint64_t a, uint64_t b) {
+  return a > b ? (int64_t)(a - b) : (int64_t)(b - a);
+}
+
+static void testTimestamps() {
+  const uint64_t times[] = {0, 1, 999999, 1000000, T0, T0 + 1, T0 + 123456, T0 + 999999, 4102444800000000ULL};
+  for (uint64_t t : times) {
+    uint8_t p[8];
+    ntpWriteTimestamp(p, t);
+    CHECK(absDiff(ntpReadTimestamp(p), t) <= 1);  // 2^-32 s fractions
+  }
+
+  uint8_t p[8];
+  ntpWriteTimestamp(p, T0 + 500000);
+  CHECK_EQ(p[4], 0x80);  // Half a second
+  CHECK_EQ(((uint32_t)p[0] << 24 | p[1] << 16 | p[2] << 8 | p[3]), T0 / 1000000 + NTP_UNIX_EPOCH_OFFSET);
+
+  uint8_t request[NTP_PACKET_SIZE];
+  memset(request, 0xAA, sizeof(request));
+  ntpBuildRequest(request, T0);
+  CHECK_EQ(request[0], 0x23);  // Version 4, client
+  for (int i = 1; i < 40; i++) CHECK_EQ(request[i], 0);
+  CHECK_EQ(ntpReadTimestamp(request + 40), T0);
+}
+
+// A reply from a server whose clock is offsetUs ahead of ours, with the
+// given one-way delays and processing time
+static void buildReply(uint8_t *packet, uint64_t sentUs, int64_t offsetUs, uint32_t outUs, uint32_t backUs,
+                       uint32_t processingUs, uint64_t &receivedUs) {
+  memset(packet, 0, NTP_PACKET_SIZE);
+  packet[0] = 0x24;  // No leap warning, version 4, server
+  packet[1] = 2;
+  ntpWriteTimestamp(packet + 24, sentUs);
+  uint64_t serverReceived = sentUs + outUs + offsetUs;
+  uint64_t serverSent = serverReceived + processingUs;
+  ntpWriteTimestamp(packet + 32, serverReceived);
+  ntpWriteTimestamp(packet + 40, serverSent);
+  receivedUs = serverSent - offsetUs + backUs;
+}
+
+static void testFourTimestamps() {
+  uint8_t packet[NTP_PACKET_SIZE];
+  uint64_t received;
+  NtpSample sample;
+
+  // Symmetric path: the offset comes out exactly, the delay excludes the
+  // server's processing time
+  const int64_t offsets[] = {0, 1234567, -1234567, 250, -250, 3600000000LL, -3600000000LL};
+  for (int64_t offset : offsets) {
+    buildReply(packet, T0, offset, 20000, 20000, 3000, received);
+    CHECK(ntpParseReply(packet, sizeof(packet), T0, received, sample));
+    CHECK(absDiff(sample.offsetUs, offset) <= 1);
+    CHECK(absDiff(sample.delayUs, 40000) <= 2);
+    CHECK_EQ(sample.stratum, 2);
+  }
+
+  // An asymmetric path shifts the offset by half the difference
+  buildReply(packet, T0, 5000, 30000, 10000, 0, received);
+  CHECK(ntpParseReply(packet, sizeof(packet), T0, received, sample));
+  CHECK(absDiff(sample.offsetUs, 5000 + 10000) <= 1);
+  CHECK(absDiff(sample.delayUs, 40000) <= 2);
+
+  // Processing longer than the round trip (a broken server) is no delay
+  // rather than a huge unsigned one
+  buildReply(packet, T0, 0, 1000, 1000, 0, received);
+  ntpWriteTimestamp(packet + 40, T0 + 1000 + 50000);
+  CHECK(ntpParseReply(packet, sizeof(packet), T0, received, sample));
+  CHECK_EQ(sample.delayUs, 0);
+}
+
+static void testReplyChecks() {
+  uint8_t packet[NTP_PACKET_SIZE];
+  uint64_t received;
+  NtpSample sample;
+  buildReply(packet, T0, 1000, 20000, 20000, 100, received);
+  CHECK(ntpParseReply(packet, sizeof(packet), T0, received, sample));
+  CHECK(!ntpParseReply(packet, NTP_PACKET_SIZE - 1, T0, received, sample));
+
+  // The originate timestamp must be our transmit time, to the microsecond
+  CHECK(!ntpParseReply(packet, sizeof(packet), T0 + 1, received, sample));
+  CHECK(!ntpParseReply(packet, sizeof(packet), T0 - 1000000, received, sample));
+  uint8_t stale[NTP_PACKET_SIZE];
+  memcpy(stale, packet, sizeof(stale));
+  stale[31] ^= 1;
+  CHECK(!ntpParseReply(stale, sizeof(stale), T0, received, sample));
+
+  struct {
+    int offset;
+    uint8_t value;
+  } const bad[] = {
+    {0, 0xE4},  // Leap indicator 3: unsynchronized
+    {0, 0x23},  // Mode 3: a request, not a reply
+    {0, 0x25},  // Mode 5: broadcast
+    {1, 0},     // Stratum 0: kiss-o'-death
+    {1, 16},    // Stratum 16: unsynchronized
+  };
+  for (const auto &b : bad) {
+    uint8_t copy[NTP_PACKET_SIZE];
+    memcpy(copy, packet, sizeof(copy));
+    copy[b.offset] = b.value;
+    CHECK(!ntpParseReply(copy, sizeof(copy), T0, received, sample));
+  }
+  uint8_t leap[NTP_PACKET_SIZE];
+  memcpy(leap, packet, sizeof(leap));
+  leap[0] = 0x64;  // Leap indicator 1 is fine
+  CHECK(ntpParseReply(leap, sizeof(leap), T0, received, sample));
+
+  // Unset receive or transmit timestamps
+  for (int field : {32, 40}) {
+    uint8_t copy[NTP_PACKET_SIZE];
+    memcpy(copy, packet, sizeof(copy));
+    memset(copy + field, 0, 8);
+    CHECK(!ntpParseReply(copy, sizeof(copy), T0, received, sample));
+  }
+}
+
+static const uint64_t MINUTE = 60000000ULL;
+
+static void testDriftEstimate() {
+  ClockDiscipline clock;
+  CHECK(!clock.synced());
+  clock.sync(250000, 30000, 1000);  // First sync: nothing to compare with
+  CHECK(clock.synced());
+  CHECK_EQ(clock.driftPpb(), 0);
+  CHECK_EQ(clock.lastOffsetUs(), 250000);
+  CHECK_EQ(clock.lastDelayUs(), 30000);
+
+  // 12 ms over 20 minutes is 10 ppm slow
+  uint64_t now = 1000 + 20 * MINUTE;
+  clock.sync(12000, 30000, now);
+  CHECK_EQ(clock.driftPpb(), 10000);
+
+  // What the estimate still misses is added to it
+  now += 20 * MINUTE;
+  clock.sync(-2400, 30000, now);
+  CHECK_EQ(clock.driftPpb(), 8000);
+
+  // Too short a span says nothing about the rate, but still resets it
+  now += 10 * MINUTE;
+  clock.sync(50000, 30000, now);
+  CHECK_EQ(clock.driftPpb(), 8000);
+  CHECK_EQ(clock.lastOffsetUs(), 50000);
+  now += 15 * MINUTE - 1;
+  clock.sync(9000, 30000, now);
+  CHECK_EQ(clock.driftPpb(), 8000);
+  now += 15 * MINUTE;
+  clock.sync(9000, 30000, now);
+  CHECK_EQ(clock.driftPpb(), 18000);
+}
+
+static void testStepLimit() {
+  ClockDiscipline clock;
+  clock.sync(0, 0, 0);
+  // A step of a second or more (either way) is a clock jump, not drift
+  clock.sync(CLOCK_STEP_LIMIT_US, 0, 30 * MINUTE);
+  CHECK_EQ(clock.driftPpb(), 0);
+  clock.sync(-CLOCK_STEP_LIMIT_US, 0, 60 * MINUTE);
+  CHECK_EQ(clock.driftPpb(), 0);
+  CHECK_EQ(clock.lastOffsetUs(), -CLOCK_STEP_LIMIT_US);
+  // Just under the limit counts: 999.999 ms in an hour
+  clock.sync(CLOCK_STEP_LIMIT_US - 1, 0, 120 * MINUTE);
+  CHECK_EQ(clock.driftPpb(), 277777);
+}
+
+static void testDriftClamp() {
+  ClockDiscipline fast, slow;
+  fast.sync(0, 0, 0);
+  slow.sync(0, 0, 0);
+  fast.sync(900000, 0, 15 * MINUTE);  // 1000 ppm
+  slow.sync(-900000, 0, 15 * MINUTE);
+  CHECK_EQ(fast.driftPpb(), CLOCK_DRIFT_MAX_PPB);
+  CHECK_EQ(slow.driftPpb(), -CLOCK_DRIFT_MAX_PPB);
+  // Further error in the same direction stays clamped
+  fast.sync(500000, 0, 30 * MINUTE);
+  CHECK_EQ(fast.driftPpb(), CLOCK_DRIFT_MAX_PPB);
+
+  ClockDiscipline restored;
+  restored.restore(CLOCK_DRIFT_MAX_PPB + 1, 0);
+  CHECK_EQ(restored.driftPpb(), 0);
+  CHECK_EQ(restored.correction(60 * MINUTE), 0);
+  restored.restore(-CLOCK_DRIFT_MAX_PPB, 0);
+  CHECK_EQ(restored.driftPpb(), -CLOCK_DRIFT_MAX_PPB);
+}
+
+// Corrections come in whole steps; calling often must not lose the part of a
+// step that is due at each call
+static void checkSlew(int32_t driftPpb, uint64_t intervalUs) {
+  ClockDiscipline clock;
+  CHECK_EQ(clock.correction(MINUTE), 0);  // Nothing before a sync or restore
+  clock.restore(driftPpb, 0);
+  int64_t total = 0;
+  uint64_t last = 0;
+  for (uint64_t now = intervalUs; now <= 120 * MINUTE; now += intervalUs) {
+    int32_t step = clock.correction(now);
+    CHECK(step % CLOCK_SLEW_STEP_US == 0);
+    CHECK(step == 0 || (step > 0) == (driftPpb > 0));
+    total += step;
+    last = now;
+  }
+  // Never ahead of what is due, and behind by less than one step
+  int64_t exact = (int64_t)driftPpb * (int64_t)last / 1000000000LL;
+  int64_t behind = driftPpb > 0 ? exact - total : total - exact;
+  CHECK(behind >= 0);
+  CHECK(behind < CLOCK_SLEW_STEP_US);
+}
+
+static void testCorrection() {
+  const int32_t drifts[] = {3000, -3000, 10000, -10000, 123457, -123457, CLOCK_DRIFT_MAX_PPB, -CLOCK_DRIFT_MAX_PPB};
+  for (int32_t drift : drifts) {
+    checkSlew(drift, 5000);      // Every loop() pass
+    checkSlew(drift, 1000000);   // Every second
+    checkSlew(drift, 7 * MINUTE);
+  }
+
+  // 10 ppm: 1 ms is due every 100 s
+  ClockDiscipline clock;
+  clock.sync(0, 0, 0);
+  clock.restore(10000, 0);
+  CHECK_EQ(clock.correction(50000000), 0);
+  CHECK_EQ(clock.correction(100000000), 1000);
+  CHECK_EQ(clock.correction(150000000), 0);
+  CHECK_EQ(clock.correction(350000000), 2000);
+
+  // A sync restarts the slew from its own time
+  clock.sync(0, 0, 400000000);
+  CHECK_EQ(clock.correction(450000000), 0);
+  CHECK_EQ(clock.correction(500000000), 1000);
+
+  clock.restore(-10000, 500000000);
+  CHECK_EQ(clock.correction(599999999), 0);
+  CHECK_EQ(clock.correction(600000000), -1000);
+}
+
+int main() {
+  testTimestamps();
+  testFourTimestamps();
+  testReplyChecks();
+  testDriftEstimate();
+  testStepLimit();
+  testDriftClamp();
+  testCorrection();
+  return checkResult("test_timekeeper");
+}
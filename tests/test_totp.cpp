@@ -0,0 +1,201 @@
+// SimpleTOTP from totp.h: the RFC 4226 and RFC 6238 SHA-1 test vectors, a
+// comparison against a plain (unoptimized) HMAC-SHA1 for random keys and
+// counters, code parsing, the replay cache, and a verify() that must not
+// touch the heap.
+
+#include <Arduino.h>
+#include <random>
+#include "totp.h"
+#include "alloc_count.h"
+#include "check.h"
+
+static const uint8_t rfcSecret[] = "12345678901234567890";  // 20 bytes, both RFCs
+#define RFC_SECRET_LEN 20
+
+// ---- Reference HMAC-SHA1, written from FIPS 180-4 / RFC 2104 ----
+
+static uint32_t refRol(uint32_t x, int n) { return (x << n) | (x >> (32 - n)); }
+
+static void refSha1(const uint8_t *data, size_t len, uint8_t out[20]) {
+  uint32_t h[5] = {0x67452301UL, 0xefcdab89UL, 0x98badcfeUL, 0x10325476UL, 0xc3d2e1f0UL};
+  size_t total = ((len + 8) / 64 + 1) * 64;
+  uint8_t *msg = (uint8_t *)calloc(total, 1);
+  memcpy(msg, data, len);
+  msg[len] = 0x80;
+  uint64_t bits = (uint64_t)len * 8;
+  for (int i = 0; i < 8; i++) msg[total - 1 - i] = (uint8_t)(bits >> (8 * i));
+
+  for (size_t block = 0; block < total; block += 64) {
+    uint32_t w[80];
+    for (int i = 0; i < 16; i++) {
+      const uint8_t *p = msg + block + i * 4;
+      w[i] = ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+    }
+    for (int i = 16; i < 80; i++) w[i] = refRol(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+    uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4];
+    for (int i = 0; i < 80; i++) {
+      uint32_t f, k;
+      if (i < 20) { f = (b & c) | (~b & d); k = 0x5a827999UL; }
+      else if (i < 40) { f = b ^ c ^ d; k = 0x6ed9eba1UL; }
+      else if (i < 60) { f = (b & c) | (b & d) | (c & d); k = 0x8f1bbcdcUL; }
+      else { f = b ^ c ^ d; k = 0xca62c1d6UL; }
+      uint32_t temp = refRol(a, 5) + f + e + k + w[i];
+      e = d; d = c; c = refRol(b, 30); b = a; a = temp;
+    }
+    h[0] += a; h[1] += b; h[2] += c; h[3] += d; h[4] += e;
+  }
+  free(msg);
+  for (int i = 0; i < 20; i++) out[i] = (uint8_t)(h[i / 4] >> (24 - 8 * (i % 4)));
+}
+
+static uint32_t refCode(const uint8_t *key, size_t keyLen, uint64_t counter) {
+  uint8_t inner[64 + 8], outer[64 + 20];
+  for (int i = 0; i < 64; i++) {
+    uint8_t k = i < (int)keyLen ? key[i] : 0;
+    inner[i] = k ^ 0x36;
+    outer[i] = k ^ 0x5c;
+  }
+  for (int i = 0; i < 8; i++) inner[64 + i] = (uint8_t)(counter >> (56 - 8 * i));
+  refSha1(inner, sizeof(inner), outer + 64);
+  uint8_t mac[20];
+  refSha1(outer, sizeof(outer), mac);
+  int offset = mac[19] & 0x0F;
+  uint32_t binary = ((uint32_t)(mac[offset] & 0x7F) << 24) | ((uint32_t)mac[offset + 1] << 16) |
+                    ((uint32_t)mac[offset + 2] << 8) | mac[offset + 3];
+  return binary % 1000000;
+}
+
+static void testReferenceSha1() {
+  // FIPS 180 "abc"
+  uint8_t digest[20];
+  refSha1((const uint8_t *)"abc", 3, digest);
+  const uint8_t abc[20] = {0xa9, 0x99, 0x3e, 0x36, 0x47, 0x06, 0x81, 0x6a, 0xba, 0x3e,
+                           0x25, 0x71, 0x78, 0x50, 0xc2, 0x6c, 0x9c, 0xd0, 0xd8, 0x9d};
+  CHECK(memcmp(digest, abc, 20) == 0);
+}
+
+// RFC 4226 appendix D: HOTP values for counters 0..9
+static void testHotpVectors() {
+  const uint32_t expected[10] = {755224, 287082, 359152, 969429, 338314,
+                                 254676, 287922, 162583, 399871, 520489};
+  SimpleTOTP totp(rfcSecret, RFC_SECRET_LEN);
+  for (int i = 0; i < 10; i++) {
+    CHECK_EQ(totp.codeFromSteps(i), expected[i]);
+    CHECK_EQ(refCode(rfcSecret, RFC_SECRET_LEN, i), expected[i]);
+  }
+}
+
+// RFC 6238 appendix B, SHA-1 rows; the RFC prints 8 digits, the device
+// shows the low 6
+static void testTotpVectors() {
+  struct { time_t t; const char *code; } vectors[] = {
+    {59, "287082"},          // 94287082
+    {1111111109, "081804"},  // 07081804
+    {1111111111, "050471"},  // 14050471
+    {1234567890, "005924"},  // 89005924
+    {2000000000, "279037"},  // 69279037
+    {(time_t)20000000000LL, "353130"},  // 65353130, past 2038
+  };
+  SimpleTOTP totp(rfcSecret, RFC_SECRET_LEN);
+  for (auto &v : vectors) {
+    String code = totp.getCode(v.t);
+    CHECK_STR(code.c_str(), v.code);
+    SimpleTOTP fresh(rfcSecret, RFC_SECRET_LEN);
+    CHECK(fresh.verify(v.code, v.t, 0));
+  }
+}
+
+// Precomputed pad states give the same codes as a textbook HMAC for every
+// key length the setter accepts
+static void testAgainstReference() {
+  std::mt19937_64 rng(6238);
+  uint8_t key[64];
+  for (size_t keyLen = 1; keyLen <= 64; keyLen++) {
+    for (int round = 0; round < 20; round++) {
+      for (size_t i = 0; i < keyLen; i++) key[i] = (uint8_t)rng();
+      uint64_t counter = rng() >> (rng() % 64);
+      SimpleTOTP totp(key, keyLen);
+      CHECK_EQ(totp.codeFromSteps(counter), refCode(key, keyLen, counter));
+    }
+  }
+
+  SimpleTOTP totp;
+  CHECK(!totp.setSecret(key, 0));
+  CHECK(!totp.setSecret(key, 65));
+  String unset = totp.getCode(1234567890);
+  CHECK_STR(unset.c_str(), "000000");
+  CHECK(!totp.verify("000000", 1234567890));
+}
+
+static void testParsing() {
+  SimpleTOTP totp(rfcSecret, RFC_SECRET_LEN);
+  const time_t t = 1234567890;
+  const char *bad[] = {"", "5924", "05924", "0059240", "00592a", " 005924", "005924 ", "-05924"};
+  for (const char *code : bad) CHECK(!totp.verify(code, t, 0));
+  CHECK(!totp.verify((const char *)nullptr, t, 0));
+  CHECK(totp.verify(String("005924"), t, 0));
+}
+
+static void testReplay() {
+  SimpleTOTP totp(rfcSecret, RFC_SECRET_LEN);
+  const time_t t = 1111111111;  // Step 37037037
+  uint64_t step = t / 30;
+  String previous = totp.getCodeFromSteps(step - 1);
+  String current = totp.getCodeFromSteps(step);
+  String next = totp.getCodeFromSteps(step + 1);
+  String far = totp.getCodeFromSteps(step + 2);
+
+  // Each code inside the window works once
+  CHECK(totp.verify(current, t));
+  CHECK(!totp.verify(current, t));
+  CHECK_EQ(totp.replaysRejected, 1);
+  CHECK(totp.verify(previous, t));
+  CHECK(totp.verify(next, t));
+  CHECK(!totp.verify(previous, t));
+  CHECK(!totp.verify(next, t));
+  CHECK_EQ(totp.replaysRejected, 3);
+
+  // Still refused a step later, when it is the previous code
+  CHECK(!totp.verify(current, t + 30));
+  CHECK_EQ(totp.replaysRejected, 4);
+
+  // Outside the window: simply wrong, not counted as a replay
+  CHECK(!totp.verify(far, t));
+  CHECK_EQ(totp.replaysRejected, 4);
+
+  // Once later logins have pushed it out of the cache, the old code is
+  // outside the window anyway: refused as wrong, not as a replay
+  time_t later = t;
+  for (uint64_t s = step + 3; s < step + 3 + TOTP_REPLAY_SLOTS; s++) {
+    later = (time_t)(s * 30);
+    CHECK(totp.verify(totp.getCodeFromSteps(s), later));
+  }
+  CHECK(!totp.verify(current, later));
+  CHECK_EQ(totp.replaysRejected, 4);
+
+  // A new secret starts a new history
+  totp.setSecret(rfcSecret, RFC_SECRET_LEN);
+  CHECK(totp.verify(current, t));
+}
+
+static void testNoAllocation() {
+  SimpleTOTP totp(rfcSecret, RFC_SECRET_LEN);
+  uint64_t before = allocCount;
+  uint32_t accepted = 0;
+  for (time_t t = 1000000000; t < 1000000000 + 30 * 2000; t += 30) {
+    if (totp.verify("123456", t)) accepted++;
+  }
+  CHECK_EQ(allocCount - before, 0);
+  CHECK(accepted < 10);
+}
+
+int main() {
+  testReferenceSha1();
+  testHotpVectors();
+  testTotpVectors();
+  testAgainstReference();
+  testParsing();
+  testReplay();
+  testNoAllocation();
+  return checkResult("test_totp");
+}
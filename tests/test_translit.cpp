@@ -0,0 +1,157 @@
+// Checks translit_lookup.h's single-pass normalizeDisplayText() against the
+// replace chain it replaced, for every codepoint in both filter modes, for
+// malformed UTF-8 and for truncation into small buffers.
+
+#include <Arduino.h>
+#include "translit_lookup.h"
+#include "legacy_normalize.h"
+#include "check.h"
+
+static size_t encodeUtf8(uint32_t cp, char *out) {
+  if (cp < 0x80) {
+    out[0] = (char)cp;
+    return 1;
+  }
+  if (cp < 0x800) {
+    out[0] = (char)(0xC0 | (cp >> 6));
+    out[1] = (char)(0x80 | (cp & 0x3F));
+    return 2;
+  }
+  if (cp < 0x10000) {
+    out[0] = (char)(0xE0 | (cp >> 12));
+    out[1] = (char)(0x80 | ((cp >> 6) & 0x3F));
+    out[2] = (char)(0x80 | (cp & 0x3F));
+    return 3;
+  }
+  out[0] = (char)(0xF0 | (cp >> 18));
+  out[1] = (char)(0x80 | ((cp >> 12) & 0x3F));
+  out[2] = (char)(0x80 | ((cp >> 6) & 0x3F));
+  out[3] = (char)(0x80 | (cp & 0x3F));
+  return 4;
+}
+
+static int mismatches = 0;
+
+static void compare(const char *input, bool weatherMode) {
+  char out[256];
+  normalizeDisplayText(input, out, sizeof(out), weatherMode);
+  String expected = legacyNormalizeDisplayText(String(input), weatherMode);
+  if (strcmp(out, expected.c_str()) != 0) {
+    if (++mismatches <= 10) {
+      fprintf(stderr, "mismatch (weatherMode %d) for bytes:", weatherMode);
+      for (const uint8_t *p = (const uint8_t *)input; *p; p++) fprintf(stderr, " %02X", *p);
+      fprintf(stderr, "\n  new \"%s\", old \"%s\"\n", out, expected.c_str());
+    }
+  }
+}
+
+static void testEveryCodepoint() {
+  char input[16];
+  for (uint32_t cp = 1; cp <= 0x10FFFF; cp = cp < 0x10000 ? cp + 1 : cp + 0x3F) {
+    if (cp >= 0xD800 && cp <= 0xDFFF) continue;
+    input[0] = 'x';
+    size_t n = 1 + encodeUtf8(cp, input + 1);
+    input[n++] = '7';
+    input[n++] = '.';
+    input[n] = '\0';
+    compare(input, false);
+    compare(input, true);
+  }
+}
+
+// Every table entry must be something the old function mapped too
+static void testEveryMapping() {
+  for (size_t i = 0; i < TRANSLIT_MAPPINGS_COUNT; i++) {
+    char input[8];
+    input[encodeUtf8(translit_mappings[i].codepoint, input)] = '\0';
+    String expected = legacyNormalizeDisplayText(String(input));
+    CHECK(expected.length() > 0);
+    CHECK(findTranslit(translit_mappings[i].codepoint) == &translit_mappings[i]);
+  }
+  CHECK(findTranslit(0x00DE) == nullptr);
+  CHECK(findTranslit(0x0460) == nullptr);
+  CHECK(findTranslit(0x1F600) == nullptr);
+}
+
+static void testMalformed() {
+  const char *cases[] = {
+    "\xD0",              // Truncated at the end
+    "\xD0z",             // Truncated before ASCII
+    "\xD0\xD0\xB0",      // Lead byte followed by a full sequence
+    "\xB0\xB0\xB0",      // Stray continuation bytes
+    "\xE2\x82",          // Truncated 3-byte sequence
+    "\xF0\x9F\x98",      // Truncated 4-byte sequence
+    "\xF8\x88\x80\x80",  // 5-byte lead
+    "\xFF\xFE",
+    "\xC3",
+    "\xC3\xC3\xA9",
+    "\xC1\x81",          // Overlong 'A'
+    "\xE0\x83\x9F",      // Overlong U+00DF
+    "\xF0\x80\x83\x9F",  // Overlong U+00DF, 4 bytes
+    "\xE0\x90\xB0",      // Overlong U+0430
+    "\xED\xA0\x80",      // Surrogate
+  };
+  for (const char *input : cases) {
+    compare(input, false);
+    compare(input, true);
+  }
+}
+
+// Random mixes of ASCII, mapped characters and arbitrary bytes
+static void testFuzz() {
+  uint32_t seed = 12345;
+  auto next = [&seed]() {
+    seed = seed * 1103515245 + 12345;
+    return seed >> 8;
+  };
+  char input[128];
+  for (int round = 0; round < 200000; round++) {
+    size_t n = 0;
+    size_t parts = next() % 24;
+    for (size_t i = 0; i < parts && n < sizeof(input) - 5; i++) {
+      switch (next() % 4) {
+        case 0: input[n++] = (char)(0x20 + next() % 0x5F); break;
+        case 1: n += encodeUtf8(translit_mappings[next() % TRANSLIT_MAPPINGS_COUNT].codepoint, input + n); break;
+        case 2: n += encodeUtf8(0x80 + next() % 0x800, input + n); break;
+        default: {
+          uint8_t b = (uint8_t)(0x80 + next() % 0x80);
+          input[n++] = (char)b;
+          break;
+        }
+      }
+    }
+    input[n] = '\0';
+    compare(input, round & 1);
+  }
+}
+
+// Output is the old result cut to the buffer, always NUL-terminated
+static void testTruncation() {
+  const char *inputs[] = {"Щука ђак", "æøå ßœ", "Hello, wörld! 100%", "љубав њива џем"};
+  for (const char *input : inputs) {
+    String expected = legacyNormalizeDisplayText(String(input));
+    for (size_t size = 1; size <= expected.length() + 2; size++) {
+      char out[64];
+      memset(out, 'x', sizeof(out));
+      size_t n = normalizeDisplayText(input, out, size);
+      size_t want = expected.length() < size - 1 ? expected.length() : size - 1;
+      CHECK_EQ(n, want);
+      CHECK_EQ(out[n], '\0');
+      CHECK(strncmp(out, expected.c_str(), n) == 0);
+      CHECK_EQ(out[size], 'x');
+    }
+  }
+  char out[4] = "abc";
+  CHECK_EQ(normalizeDisplayText("abc", out, 0), 0);
+  CHECK_STR(out, "abc");
+}
+
+int main() {
+  testEveryCodepoint();
+  testEveryMapping();
+  testMalformed();
+  testFuzz();
+  testTruncation();
+  CHECK_EQ(mismatches, 0);
+  return checkResult("test_translit");
+}
@@ -0,0 +1,75 @@
+// Checks ianaToPosix() from tz_lookup.h against tz_zones.txt, the mapping
+// Scripts/gen_tz_lookup.py generated the table from, and reports the
+// table's flash footprint.
+
+#include <Arduino.h>
+#include "tz_lookup.h"
+#include "check.h"
+
+struct Zone {
+  char name[TZ_NAME_MAX_LEN + 1];
+  char posix[TZ_POSIX_MAX_LEN + 1];
+};
+
+static Zone zones[TZ_ZONE_COUNT + 1];
+static int zoneCount = 0;
+
+static void loadZones(const char *path) {
+  FILE *f = fopen(path, "r");
+  CHECK(f != nullptr);
+  if (!f) return;
+  char line[256];
+  while (fgets(line, sizeof(line), f) && zoneCount <= TZ_ZONE_COUNT) {
+    if (line[0] == '#') continue;
+    line[strcspn(line, "\r\n")] = '\0';
+    char *tab = strchr(line, '\t');
+    CHECK(tab != nullptr);
+    if (!tab) continue;
+    *tab = '\0';
+    CHECK(strlen(line) <= TZ_NAME_MAX_LEN && strlen(tab + 1) <= TZ_POSIX_MAX_LEN);
+    strlcpy(zones[zoneCount].name, line, sizeof(zones[0].name));
+    strlcpy(zones[zoneCount].posix, tab + 1, sizeof(zones[0].posix));
+    zoneCount++;
+  }
+  fclose(f);
+  CHECK_EQ(zoneCount, TZ_ZONE_COUNT);
+}
+
+// What ianaToPosix() should return for any name
+static const char *expectedPosix(const char *name) {
+  for (int i = 0; i < zoneCount; i++) {
+    if (strcmp(zones[i].name, name) == 0) return zones[i].posix;
+  }
+  return "UTC0";
+}
+
+static void testEveryZone() {
+  for (int i = 0; i < zoneCount; i++) {
+    CHECK_STR(ianaToPosix(zones[i].name), zones[i].posix);
+
+    // Near misses fall back rather than matching a neighbour
+    char probe[TZ_NAME_MAX_LEN + 3];
+    size_t len = strlcpy(probe, zones[i].name, sizeof(probe));
+    probe[len] = '~';
+    probe[len + 1] = '\0';
+    CHECK_STR(ianaToPosix(probe), expectedPosix(probe));
+    probe[len - 1] = '\0';
+    CHECK_STR(ianaToPosix(probe), expectedPosix(probe));
+  }
+}
+
+static void testUnknown() {
+  const char *probes[] = {"", "A", "Nowhere/City", "europe/paris", "Europe/Paris/", "Zulu~", "zzz", "\x7f"};
+  for (const char *probe : probes) CHECK_STR(ianaToPosix(probe), "UTC0");
+}
+
+int main(int argc, char **argv) {
+  loadZones(argc > 1 ? argv[1] : "tz_zones.txt");
+  testEveryZone();
+  testUnknown();
+
+  printf("tz_lookup.h: %d zones, %zu bytes of flash (names %zu, block index %zu, zone->posix %zu, posix pool %zu)\n",
+         TZ_ZONE_COUNT, sizeof(tz_zone_names) + sizeof(tz_block_index) + sizeof(tz_zone_posix) + sizeof(tz_posix_pool),
+         sizeof(tz_zone_names), sizeof(tz_block_index), sizeof(tz_zone_posix), sizeof(tz_posix_pool));
+  return checkResult("test_tz");
+}
@@ -0,0 +1,133 @@
+// Checks weather_lookup.h's longest-match translateWeatherTerms() against
+// the replace chain it replaced, for every language, on the OpenWeather and
+// PirateWeather descriptions and on every phrase of weather_phrases. The
+// intended differences are pinned separately: translations that contain AND
+// (German and Dutch SAND, Italian hail) are no longer cut down by the AND
+// rule, and Dutch FOG no longer turns into the mist term.
+
+#include <Arduino.h>
+#include "weather_lookup.h"
+#include "legacy_weather_terms.h"
+#include "check.h"
+
+// OpenWeather condition descriptions and PirateWeather summaries
+static const char *const descriptions[] = {
+  "thunderstorm with light rain", "thunderstorm with rain", "thunderstorm with heavy rain",
+  "light thunderstorm", "thunderstorm", "heavy thunderstorm", "ragged thunderstorm",
+  "thunderstorm with light drizzle", "thunderstorm with drizzle", "thunderstorm with heavy drizzle",
+  "light intensity drizzle", "drizzle", "heavy intensity drizzle", "light intensity drizzle rain",
+  "drizzle rain", "heavy intensity drizzle rain", "shower rain and drizzle",
+  "heavy shower rain and drizzle", "shower drizzle", "light rain", "moderate rain",
+  "heavy intensity rain", "very heavy rain", "extreme rain", "freezing rain",
+  "light intensity shower rain", "shower rain", "heavy intensity shower rain", "ragged shower rain",
+  "light snow", "snow", "heavy snow", "sleet", "light shower sleet", "shower sleet",
+  "light rain and snow", "rain and snow", "light shower snow", "shower snow", "heavy shower snow",
+  "mist", "smoke", "haze", "dust", "volcanic ash", "squalls", "tornado",
+  "clear sky", "few clouds", "scattered clouds", "broken clouds", "overcast clouds",
+  "Clear", "Mostly Clear", "Partly Cloudy", "Mostly Cloudy", "Cloudy", "Overcast", "Foggy",
+  "Windy", "Breezy", "Light Rain", "Drizzle", "Rain", "Heavy Rain", "Light Snow", "Snow",
+  "Heavy Snow", "Flurries", "Sleet", "Light Sleet", "Heavy Sleet", "Thunderstorm", "Hazy",
+  "Smoky", "Rainy", "Snowy", "Misty", "Windy and Partly Cloudy", "Breezy and Mostly Cloudy",
+  "Light Rain and Windy", "Possible Light Rain", "Possible Drizzle", "Light Precipitation",
+  "Heavy Precipitation", "Squall", "Hail", "Wind",
+};
+
+static int mismatches = 0;
+
+// The result stays valid until the next call
+static const char *translate(const char *input, const char *lang) {
+  static char out[128];
+  translateWeatherTerms(input, out, sizeof(out), findWeatherTerms(lang));
+  return out;
+}
+
+// The new output holds a translated term with AND in it, or is Dutch FOG
+static bool intendedDifference(const char *input, const String &out, const char *lang) {
+  const WeatherTermsMapping *terms = findWeatherTerms(lang);
+  if (!terms) return false;
+  for (uint8_t term = 0; term < WT_COUNT; term++) {
+    const char *text = weatherTermText(terms, term);
+    if (strstr(text, "AND") && out.indexOf(text) >= 0) return true;
+  }
+  String upper = input;
+  upper.toUpperCase();
+  return strcmp(lang, "nl") == 0 && upper.indexOf("FOG") >= 0;
+}
+
+static void compare(const char *input, const char *lang) {
+  String out = translate(input, lang);
+  if (intendedDifference(input, out, lang)) return;
+  String expected = input;
+  legacyTranslateAPIWeatherTerms(expected, lang);
+  if (out != expected) {
+    if (++mismatches <= 10) {
+      fprintf(stderr, "mismatch (%s) for \"%s\"\n  new \"%s\", old \"%s\"\n", lang, input, out.c_str(),
+              expected.c_str());
+    }
+  }
+}
+
+// Every language with terms, English and a language without terms (left as
+// is apart from upper case)
+static void testEveryLanguage() {
+  const char *others[] = {"en", "xx"};
+  for (size_t l = 0; l < WEATHER_TERMS_COUNT + 2; l++) {
+    const char *lang = l < WEATHER_TERMS_COUNT ? weather_terms[l].lang : others[l - WEATHER_TERMS_COUNT];
+    for (const char *description : descriptions) compare(description, lang);
+    for (size_t i = 0; i < WEATHER_PHRASES_COUNT; i++) {
+      compare(weather_phrases[i].phrase, lang);
+      String lower = weather_phrases[i].phrase;
+      lower.toLowerCase();
+      compare(lower.c_str(), lang);
+    }
+  }
+}
+
+// The old chain removed AND last, including from inside translations
+// (German and Dutch SAND became S and Z, Italian GRANDINE became GRINE).
+// Now every single-term phrase comes out as its term, as it is.
+static void testAndInsideTerms() {
+  int affected = 0;
+  for (size_t l = 0; l < WEATHER_TERMS_COUNT; l++) {
+    const WeatherTermsMapping &terms = weather_terms[l];
+    for (size_t i = 0; i < WEATHER_PHRASES_COUNT; i++) {
+      const WeatherPhraseMapping &phrase = weather_phrases[i];
+      if (phrase.first == WT_NONE || phrase.second != WT_NONE) continue;
+      const char *text = weatherTermText(&terms, phrase.first);
+      CHECK_STR(translate(phrase.phrase, terms.lang), text);
+      if (!strstr(text, "AND")) continue;
+      String legacy = phrase.phrase;
+      legacyTranslateAPIWeatherTerms(legacy, terms.lang);
+      CHECK(legacy != text);
+      affected++;
+    }
+  }
+  CHECK(affected > 0);
+  CHECK_STR(translate("sand", "de"), "SAND");
+  CHECK_STR(translate("sand", "nl"), "ZAND");
+  CHECK_STR(translate("hail", "it"), "GRANDINE");
+  CHECK_STR(translate("sand", "en"), "SAND");
+}
+
+// Dutch FOG: the fog term is MIST, which the old chain's later MIST rule
+// turned into the mist term
+static void testDutchFog() {
+  const WeatherTermsMapping *nl = findWeatherTerms("nl");
+  CHECK(nl != nullptr);
+  CHECK_STR(nl->terms.fog, "MIST");
+  CHECK_STR(translate("fog", "nl"), nl->terms.fog);
+  CHECK_STR(translate("Foggy", "nl"), nl->terms.fog);
+
+  String legacy = "fog";
+  legacyTranslateAPIWeatherTerms(legacy, "nl");
+  CHECK_STR(legacy.c_str(), nl->terms.mist);
+  CHECK(strcmp(nl->terms.fog, nl->terms.mist) != 0);
+}
+
+int main() {
+  testEveryLanguage();
+  testAndInsideTerms();
+  testDutchFog();
+  CHECK_EQ(mismatches, 0);
+  return checkResult("test_weather_terms");
+}
@@ -0,0 +1,302 @@
+// WebhookQueue from webhook_queue.h: ordering, eviction, coalescing, TTL
+// expiry across the millis() wrap, a randomized comparison against a plain
+// reference model, and a stress run that must not touch the heap.
+
+#include <Arduino.h>
+#include <deque>
+#include <string>
+#include "webhook_queue.h"
+#include "alloc_count.h"
+#include "check.h"
+
+static WebhookQueue queue;  // Static like messageQueue in the sketch
+
+static std::string popText() {
+  WebhookMessage m;
+  return queue.pop(m) ? std::string(m.text) : std::string("<empty>");
+}
+
+static void testOrder() {
+  queue.begin(10);
+  queue.push("low", 0, 5000, false, 0, 1, 0);
+  queue.push("normal a", 1, 5000, false, 0, 1, 0);
+  queue.push("high", 2, 5000, false, 0, 1, 0);
+  queue.push("normal b", 1, 5000, false, 0, 1, 0);
+  queue.push("clamped", 7, 5000, false, 0, 1, 0);
+  queue.push("negative", -3, 5000, false, 0, 1, 0);
+  CHECK_EQ(queue.size(), 6);
+  CHECK_STR(queue.peek()->text, "high");
+  CHECK(popText() == "high");
+  CHECK(popText() == "clamped");
+  CHECK(popText() == "normal a");
+  CHECK(popText() == "normal b");
+  CHECK(popText() == "low");
+  CHECK(popText() == "negative");
+  CHECK(popText() == "<empty>");
+  CHECK(queue.peek() == nullptr);
+}
+
+static void testEviction() {
+  queue.begin(3);
+  CHECK_EQ(queue.push("low 1", 0, 1, false, 0, 1, 0), WEBHOOK_QUEUED);
+  CHECK_EQ(queue.push("low 2", 0, 1, false, 0, 1, 0), WEBHOOK_QUEUED);
+  CHECK_EQ(queue.push("normal", 1, 1, false, 0, 1, 0), WEBHOOK_QUEUED);
+
+  // Full: a low message has nothing less urgent to displace
+  CHECK_EQ(queue.push("low 3", 0, 1, false, 0, 1, 0), WEBHOOK_REJECTED);
+  // A high one displaces the oldest low one, then the next oldest
+  CHECK_EQ(queue.push("high 1", 2, 1, false, 0, 1, 0), WEBHOOK_QUEUED_EVICTED);
+  CHECK_EQ(queue.push("high 2", 2, 1, false, 0, 1, 0), WEBHOOK_QUEUED_EVICTED);
+  // Then the normal one; then, with only urgent ones left, the oldest of those
+  CHECK_EQ(queue.push("high 3", 2, 1, false, 0, 1, 0), WEBHOOK_QUEUED_EVICTED);
+  CHECK_EQ(queue.push("normal 2", 1, 1, false, 0, 1, 0), WEBHOOK_REJECTED);
+  CHECK_EQ(queue.push("high 4", 2, 1, false, 0, 1, 0), WEBHOOK_QUEUED_EVICTED);
+  CHECK(popText() == "high 2");
+  CHECK(popText() == "high 3");
+  CHECK(popText() == "high 4");
+  CHECK_EQ(queue.evicted, 4);
+  CHECK_EQ(queue.rejected, 2);
+
+  // Capacity is clamped to the pool
+  queue.begin(0);
+  CHECK_EQ(queue.capacity(), 1);
+  queue.begin(1000);
+  CHECK_EQ(queue.capacity(), WEBHOOK_POOL_SIZE);
+  for (int i = 0; i < WEBHOOK_POOL_SIZE; i++) {
+    char text[16];
+    snprintf(text, sizeof(text), "msg %d", i);
+    CHECK_EQ(queue.push(text, 1, 1, false, 0, 1, 0), WEBHOOK_QUEUED);
+  }
+  CHECK_EQ(queue.push("one more", 1, 1, false, 0, 1, 0), WEBHOOK_REJECTED);
+}
+
+static void testCoalesce() {
+  queue.begin(5);
+  CHECK_EQ(queue.push("CPU 90%", 0, 1000, false, 0, 7, 100), WEBHOOK_QUEUED);
+  CHECK_EQ(queue.push("DISK OK", 0, 1000, false, 0, 7, 100), WEBHOOK_QUEUED);
+  // Same text, other sender: a separate message
+  CHECK_EQ(queue.push("CPU 90%", 0, 1000, false, 0, 8, 150), WEBHOOK_QUEUED);
+  // Same sender: refreshes the queued copy in place
+  CHECK_EQ(queue.push("CPU 90%", 0, 3000, true, 0, 7, 200), WEBHOOK_COALESCED);
+  CHECK_EQ(queue.size(), 3);
+  const WebhookMessage *first = queue.peek();
+  CHECK_STR(first->text, "CPU 90%");
+  CHECK_EQ(first->repeats, 1);
+  CHECK_EQ(first->duration, 3000);
+  CHECK(first->scroll);
+  CHECK_EQ(first->timestamp, 100);
+  CHECK_EQ(first->updated, 200);
+
+  // Resent more urgently: moves up, keeping its first-queued time
+  CHECK_EQ(queue.push("DISK OK", 2, 1000, false, 0, 7, 300), WEBHOOK_COALESCED);
+  CHECK_EQ(queue.size(), 3);
+  WebhookMessage m;
+  CHECK(queue.pop(m));
+  CHECK_STR(m.text, "DISK OK");
+  CHECK_EQ(m.priority, 2);
+  CHECK_EQ(m.repeats, 1);
+  CHECK_EQ(m.timestamp, 100);
+  CHECK_EQ(queue.coalesced, 2);
+  CHECK_EQ(queue.queued, 3);
+}
+
+static void testTtl() {
+  // Starts just before millis() wraps
+  uint32_t t = 0xFFFFFF00UL;
+  queue.begin(5);
+  queue.push("short", 1, 1, false, 1000, 1, t);
+  queue.push("long", 1, 1, false, 5000, 1, t);
+  queue.push("forever", 0, 1, false, 0, 1, t);
+  CHECK_EQ(queue.expire(t + 999), 0);
+  CHECK_EQ(queue.expire(t + 1000), 1);
+  // A coalesced resend restarts the TTL
+  CHECK_EQ(queue.push("long", 1, 1, false, 5000, 1, t + 4000), WEBHOOK_COALESCED);
+  CHECK_EQ(queue.expire(t + 8999), 0);
+  CHECK_EQ(queue.expire(t + 9000), 1);
+  CHECK_EQ(queue.expire(t + 0x7FFFFFFFUL), 0);
+  CHECK_EQ(queue.size(), 1);
+  CHECK(popText() == "forever");
+  CHECK_EQ(queue.expiredCount, 2);
+
+  // Expired messages also make room for a push
+  queue.begin(1);
+  queue.push("stale", 2, 1, false, 100, 1, 0);
+  CHECK_EQ(queue.push("fresh", 0, 1, false, 0, 1, 100), WEBHOOK_QUEUED);
+  CHECK(popText() == "fresh");
+}
+
+static void testTooLong() {
+  queue.begin(5);
+  char text[WEBHOOK_TEXT_MAX + 1];
+  memset(text, 'A', sizeof(text));
+  text[WEBHOOK_TEXT_MAX - 1] = '\0';
+  CHECK_EQ(queue.push(text, 1, 1, false, 0, 1, 0), WEBHOOK_QUEUED);
+  WebhookMessage m;
+  CHECK(queue.pop(m));
+  CHECK_EQ(strlen(m.text), WEBHOOK_TEXT_MAX - 1);
+
+  text[WEBHOOK_TEXT_MAX - 1] = 'A';
+  text[WEBHOOK_TEXT_MAX] = '\0';
+  CHECK_EQ(queue.push(text, 2, 1, false, 0, 1, 0), WEBHOOK_TOO_LONG);
+  CHECK(queue.empty());
+  CHECK_EQ(queue.rejected, 0);
+}
+
+// Straightforward model of the documented behaviour
+struct ModelMessage {
+  std::string text;
+  int priority;
+  uint32_t duration, timestamp, ttl, updated, source;
+  uint16_t repeats;
+};
+
+struct Model {
+  std::deque<ModelMessage> lists[WEBHOOK_PRIORITIES];
+  size_t capacity;
+
+  size_t size() const {
+    size_t n = 0;
+    for (const auto &list : lists) n += list.size();
+    return n;
+  }
+
+  void expire(uint32_t now) {
+    for (auto &list : lists) {
+      for (size_t i = 0; i < list.size();) {
+        if (list[i].ttl != 0 && now - list[i].updated >= list[i].ttl) list.erase(list.begin() + i);
+        else i++;
+      }
+    }
+  }
+
+  WebhookPushResult push(const std::string &text, int priority, uint32_t duration, uint32_t ttl, uint32_t source, uint32_t now) {
+    if (text.size() >= WEBHOOK_TEXT_MAX) return WEBHOOK_TOO_LONG;
+    priority = priority < 0 ? 0 : (priority >= WEBHOOK_PRIORITIES ? WEBHOOK_PRIORITIES - 1 : priority);
+    expire(now);
+    for (int p = 0; p < WEBHOOK_PRIORITIES; p++) {
+      for (size_t i = 0; i < lists[p].size(); i++) {
+        ModelMessage &m = lists[p][i];
+        if (m.source != source || m.text != text) continue;
+        if (priority > p) {
+          ModelMessage moved = {text, priority, duration, m.timestamp, ttl, now, source, (uint16_t)(m.repeats + 1)};
+          lists[p].erase(lists[p].begin() + i);
+          lists[priority].push_back(moved);
+        } else {
+          m.duration = duration;
+          m.ttl = ttl;
+          m.updated = now;
+          m.repeats++;
+        }
+        return WEBHOOK_COALESCED;
+      }
+    }
+    bool displaced = false;
+    if (size() >= capacity) {
+      int victim = 0;
+      while (victim < WEBHOOK_PRIORITIES && lists[victim].empty()) victim++;
+      if (victim == WEBHOOK_PRIORITIES) return WEBHOOK_REJECTED;
+      if (!(victim < priority || (victim == priority && priority == WEBHOOK_PRIORITIES - 1))) return WEBHOOK_REJECTED;
+      lists[victim].pop_front();
+      displaced = true;
+    }
+    lists[priority].push_back({text, priority, duration, now, ttl, now, source, 0});
+    return displaced ? WEBHOOK_QUEUED_EVICTED : WEBHOOK_QUEUED;
+  }
+
+  bool pop(ModelMessage &out) {
+    for (int p = WEBHOOK_PRIORITIES - 1; p >= 0; p--) {
+      if (!lists[p].empty()) {
+        out = lists[p].front();
+        lists[p].pop_front();
+        return true;
+      }
+    }
+    return false;
+  }
+};
+
+static uint32_t seed = 1;
+static uint32_t nextRandom() {
+  seed = seed * 1103515245 + 12345;
+  return seed >> 8;
+}
+
+static const char *const texts[] = {"CPU 12%", "CPU 90%", "BUILD OK", "BUILD FAILED", "DOOR OPEN", "RAIN", "", "BACKUP DONE"};
+
+static void testAgainstModel() {
+  int mismatches = 0;
+  for (int run = 0; run < 200 && mismatches < 5; run++) {
+    Model model;
+    model.capacity = 1 + nextRandom() % WEBHOOK_POOL_SIZE;
+    queue.begin((int)model.capacity);
+    uint32_t now = 0xFFFF0000UL + nextRandom() % 0x20000;  // Some runs cross the wrap
+
+    for (int op = 0; op < 1000; op++) {
+      now += nextRandom() % 3000;
+      uint32_t r = nextRandom() % 10;
+      if (r < 6) {
+        std::string text = texts[nextRandom() % 8];
+        if (nextRandom() % 50 == 0) text.assign(WEBHOOK_TEXT_MAX + nextRandom() % 3 - 2, 'X');
+        int priority = (int)(nextRandom() % 5) - 1;
+        uint32_t duration = 1000 + nextRandom() % 4000;
+        uint32_t ttl = (const uint32_t[]){0, 1000, 5000, 60000}[nextRandom() % 4];
+        uint32_t source = nextRandom() % 3;
+        WebhookPushResult a = queue.push(text.c_str(), priority, duration, false, ttl, source, now);
+        WebhookPushResult b = model.push(text, priority, duration, ttl, source, now);
+        if (a != b) mismatches++;
+      } else if (r < 9) {
+        queue.expire(now);
+        model.expire(now);
+        WebhookMessage got;
+        ModelMessage want;
+        bool a = queue.pop(got);
+        bool b = model.pop(want);
+        if (a != b) {
+          mismatches++;
+        } else if (a && (want.text != got.text || want.priority != got.priority || want.repeats != got.repeats ||
+                         want.timestamp != got.timestamp || want.duration != got.duration)) {
+          mismatches++;
+        }
+      } else {
+        queue.expire(now);
+        model.expire(now);
+      }
+      if (queue.size() != model.size()) mismatches++;
+    }
+  }
+  CHECK_EQ(mismatches, 0);
+}
+
+// Thousands of messages through a full queue without one allocation
+static void testNoAllocations() {
+  queue.begin(WEBHOOK_POOL_SIZE);
+  char text[WEBHOOK_TEXT_MAX];
+  uint64_t before = allocCount;
+  uint32_t now = 0;
+  uint32_t results[5] = {};
+  for (int i = 0; i < 100000; i++) {
+    now += nextRandom() % 500;
+    snprintf(text, sizeof(text), "STATUS %u %s", nextRandom() % 40, texts[nextRandom() % 8]);
+    results[queue.push(text, nextRandom() % 3, 1000, false, 30000, nextRandom() % 4, now)]++;
+    if (nextRandom() % 3 == 0) {
+      WebhookMessage m;
+      queue.pop(m);
+    }
+  }
+  CHECK_EQ(allocCount - before, 0);
+  CHECK(results[WEBHOOK_QUEUED] > 0);
+  CHECK(results[WEBHOOK_COALESCED] > 0);
+  CHECK(results[WEBHOOK_QUEUED_EVICTED] > 0);
+  CHECK(results[WEBHOOK_REJECTED] > 0);
+}
+
+int main() {
+  testOrder();
+  testEviction();
+  testCoalesce();
+  testTtl();
+  testTooLong();
+  testAgainstModel();
+  testNoAllocations();
+  return checkResult("test_webhook_queue");
+}